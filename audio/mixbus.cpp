@@ -0,0 +1,121 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audio/mixbus.h"
+#include "audio/rate.h"
+
+#include "common/textconsole.h"
+#include "common/util.h"
+
+namespace Audio {
+
+enum {
+	kUnityGain = 1 << 16,
+
+	/** The range of values on the bus which still fit into the output */
+	kBusMax = ST_SAMPLE_MAX << MixBus::kFracBits,
+	kBusMin = ST_SAMPLE_MIN * (1 << MixBus::kFracBits),
+
+	/**
+	 * The limiter gain recovers by 1/2^kReleaseShift of the remaining
+	 * distance to unity gain per sample pair, i.e. within a few thousand
+	 * sample pairs.
+	 */
+	kReleaseShift = 10
+};
+
+/**
+ * Return the largest limiter gain at which the given value from the bus
+ * still fits into the output.
+ */
+static uint32 maxGain(int32 sample) {
+	if (sample > kBusMax)
+		return (uint32)(((uint64)kBusMax << 16) / (uint32)sample);
+	else if (sample < kBusMin)
+		return (uint32)(((uint64)-(int64)kBusMin << 16) / (uint64)-(int64)sample);
+	else
+		return kUnityGain;
+}
+
+MixBus::MixBus() : _buffer(nullptr), _bufferFrames(0), _gain(kUnityGain), _ditherSeed(0x12345678) {
+}
+
+MixBus::~MixBus() {
+	free(_buffer);
+}
+
+int32 *MixBus::clear(uint frames) {
+	if (frames > _bufferFrames) {
+		free(_buffer);
+		_buffer = (int32 *)malloc(frames * 2 * sizeof(int32));
+		if (!_buffer)
+			error("[MixBus::clear] Cannot allocate memory for mix bus");
+		_bufferFrames = frames;
+	}
+
+	memset(_buffer, 0, frames * 2 * sizeof(int32));
+	return _buffer;
+}
+
+void MixBus::render(int16 *out, uint frames) {
+	assert(frames <= _bufferFrames);
+
+	const int32 *bus = _buffer;
+	for (; frames > 0; --frames) {
+		int32 left = bus[0];
+		int32 right = bus[1];
+		bus += 2;
+
+		// Lower the gain immediately if the current sample pair would clip
+		// at the current gain, and let it recover slowly afterwards
+		const uint32 fit = MIN(maxGain(left), maxGain(right));
+		if (_gain > fit)
+			_gain = fit;
+
+		if (_gain < kUnityGain) {
+			left = (int32)(((int64)left * _gain) >> 16);
+			right = (int32)(((int64)right * _gain) >> 16);
+
+			_gain += ((kUnityGain - _gain) >> kReleaseShift) + 1;
+			if (_gain > kUnityGain)
+				_gain = kUnityGain;
+		}
+
+		for (int i = 0; i < 2; ++i) {
+			// Triangular dither in the range of +/- half a sample step.
+			// Values which are exact multiples of a sample step are never
+			// affected by it, so sounds mixed at full volume stay bit-exact.
+			_ditherSeed = _ditherSeed * 1664525 + 1013904223;
+			const int32 dither = (int32)((_ditherSeed >> 24) & 0x7F) - (int32)((_ditherSeed >> 16) & 0x7F);
+
+			const int32 sample = (i == 0) ? left : right;
+			const int32 val = CLIP<int32>((sample + (1 << (kFracBits - 1)) + dither) >> kFracBits, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+
+#ifdef OUTPUT_UNSIGNED_AUDIO
+			*out++ = ((int16)val) ^ 0x8000;
+#else
+			*out++ = (int16)val;
+#endif
+		}
+	}
+}
+
+} // End of namespace Audio
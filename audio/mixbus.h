@@ -0,0 +1,91 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_MIXBUS_H
+#define AUDIO_MIXBUS_H
+
+#include "common/scummsys.h"
+
+namespace Audio {
+
+/**
+ * @defgroup audio_mixbus Mix bus
+ * @ingroup audio
+ *
+ * @brief 32-bit mix bus with a final limiter and dither stage.
+ * @{
+ */
+
+/**
+ * A 32-bit stereo mix bus.
+ *
+ * Channels are mixed into the bus with RateConverter::flowUnclamped(), which
+ * keeps kFracBits bits of precision below the 16-bit range and never clamps.
+ * Once all channels are mixed, render() converts the bus to 16-bit output
+ * samples in a single pass:
+ *
+ * - A peak limiter, which smoothly lowers the gain when the mix gets louder
+ *   than the output can represent, instead of letting it clip.
+ * - Triangular dither of +/- half a sample step, which decorrelates the
+ *   rounding error of quiet, volume scaled sounds from the signal, while
+ *   sounds played back at full volume pass through unchanged.
+ * - A single clamp per sample.
+ */
+class MixBus {
+public:
+	enum {
+		/** Bits of precision below the 16-bit sample range */
+		kFracBits = 8
+	};
+
+	MixBus();
+	~MixBus();
+
+	/**
+	 * Prepare the bus for mixing the given number of sample pairs.
+	 *
+	 * @return The silenced bus, with room for (at least) frames sample pairs.
+	 */
+	int32 *clear(uint frames);
+
+	/**
+	 * Limit, dither and clamp the bus into the output buffer.
+	 *
+	 * @param out    Buffer for frames 16-bit stereo sample pairs.
+	 * @param frames Number of sample pairs to convert; at most the number
+	 *               passed to the last clear() call.
+	 */
+	void render(int16 *out, uint frames);
+
+private:
+	int32 *_buffer;
+	uint _bufferFrames;
+
+	/** current limiter gain, 1 << 16 being unity */
+	uint32 _gain;
+
+	uint32 _ditherSeed;
+};
+
+/** @} */
+} // End of namespace Audio
+
+#endif
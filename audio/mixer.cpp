@@ -21,9 +21,11 @@
 
 #include "gui/EventRecorder.h"
 
+#include "common/config-manager.h"
 #include "common/util.h"
 #include "common/textconsole.h"
 
+#include "audio/mixbus.h"
 #include "audio/mixer_intern.h"
 #include "audio/rate.h"
 #include "audio/audiostream.h"
@@ -42,7 +44,7 @@ namespace Audio {
  */
 class Channel {
 public:
-	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent);
+	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, RateConverterType converterType);
 	~Channel();
 
 	/**
@@ -56,6 +58,13 @@ public:
 	 */
 	int mix(int16 *data, uint len);
 
+	/**
+	 * Mixes the channel's samples into the given 32-bit mix bus.
+	 *
+	 * @see MixBus
+	 */
+	int mix(int32 *data, uint len);
+
 	/**
 	 * Queries whether the channel is still playing or not.
 	 */
@@ -73,19 +82,6 @@ public:
 	 */
 	int getId() const { return _id; }
 
-	/**
-	 * Pauses or unpaused the channel in a recursive fashion.
-	 *
-	 * @param paused true, when the channel should be paused.
-	 *               false when it should be unpaused.
-	 */
-	void pause(bool paused);
-
-	/**
-	 * Queries whether the channel is currently paused.
-	 */
-	bool isPaused() const { return (_pauseLevel != 0); }
-
 	/**
 	 * Sets the channel's own volume.
 	 *
@@ -121,9 +117,21 @@ public:
 	void notifyGlobalVolChange() { updateChannelVolumes(); }
 
 	/**
-	 * Queries how long the channel has been playing.
+	 * Returns the number of samples mixed before the last mix.
+	 */
+	uint32 getSamplesConsumed() const { return _samplesConsumed; }
+
+	/**
+	 * Returns the time at which the last mix started, or 0 if the channel
+	 * has not been mixed yet.
+	 */
+	uint32 getMixerTimeStamp() const { return _mixerTimeStamp; }
+
+	/**
+	 * Computes how long a channel has been playing from its timing
+	 * information.
 	 */
-	Timestamp getElapsedTime();
+	static Timestamp getElapsedTime(const ChannelTiming &timing, uint rate);
 
 	/**
 	 * Replaces the channel's stream with a version that loops indefinitely.
@@ -151,7 +159,6 @@ private:
 	const Mixer::SoundType _type;
 	SoundHandle _handle;
 	bool _permanent;
-	int _pauseLevel;
 	int _id;
 
 	byte _volume;
@@ -160,13 +167,14 @@ private:
 	void updateChannelVolumes();
 	st_volume_t _volL, _volR;
 
+	/** Updates the timing information before mixing the next samples. */
+	void startMix();
+
 	Mixer *_mixer;
 
 	uint32 _samplesConsumed;
 	uint32 _samplesDecoded;
 	uint32 _mixerTimeStamp;
-	uint32 _pauseStartTime;
-	uint32 _pauseTime;
 
 	RateConverter *_converter;
 	Common::DisposablePtr<AudioStream> _stream;
@@ -177,23 +185,57 @@ private:
 #pragma mark -
 
 MixerImpl::MixerImpl(uint sampleRate, uint outBufSize)
-	: _mutex(), _sampleRate(sampleRate), _outBufSize(outBufSize), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _mutex(), _queueMutex(), _settingsSeq(0), _appliedSettingsSeq(0), _sampleRate(sampleRate), _outBufSize(outBufSize), _mixerReady(false), _handleSeed(0), _rateConverterType(kRateConverterDefault), _mixBus(nullptr), _soundTypeSettings() {
 
 	assert(sampleRate > 0);
 
-	for (int i = 0; i != NUM_CHANNELS; i++)
+	if (ConfMan.hasKey("audio_resampler")) {
+		const Common::String &resampler = ConfMan.get("audio_resampler");
+		if (resampler == "polyphase")
+			_rateConverterType = kRateConverterPolyphase;
+		else if (resampler != "default")
+			warning("Unknown audio resampler '%s'", resampler.c_str());
+	}
+
+	if (ConfMan.hasKey("audio_wide_mix_bus") && ConfMan.getBool("audio_wide_mix_bus"))
+		_mixBus = new MixBus();
+
+	for (int i = 0; i != NUM_CHANNELS; i++) {
 		_channels[i] = nullptr;
+		_channelStates[i].handle.store(kFreeSlot, Common::kMemoryOrderRelaxed);
+		_channelStates[i].pauseLevel = 0;
+	}
 }
 
 MixerImpl::~MixerImpl() {
+	// Pick up channels which were started but never mixed
+	addNewChannels();
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		delete _channels[i];
+
+	delete _mixBus;
 }
 
 void MixerImpl::setReady(bool ready) {
+	_mixerReady.store(ready, Common::kMemoryOrderRelease);
+}
+
+void MixerImpl::setRateConverterType(RateConverterType type) {
+	Common::StackLock lock(_queueMutex);
+
+	_rateConverterType = type;
+}
+
+void MixerImpl::setWideMixBus(bool enable) {
 	Common::StackLock lock(_mutex);
 
-	_mixerReady = ready;
+	if (enable && !_mixBus) {
+		_mixBus = new MixBus();
+	} else if (!enable) {
+		delete _mixBus;
+		_mixBus = nullptr;
+	}
 }
 
 uint MixerImpl::getOutputRate() const {
@@ -204,10 +246,99 @@ uint MixerImpl::getOutputBufSize() const {
 	return _outBufSize;
 }
 
+void MixerImpl::addNewChannels() {
+	Channel *chan;
+	while (_newChannels.pop(chan)) {
+		// The slot was only handed out after its previous channel was released
+		const int index = chan->getHandle()._val % NUM_CHANNELS;
+		assert(!_channels[index]);
+		_channels[index] = chan;
+
+		// The settings may have changed since the channel was queued
+		applySettings(index);
+	}
+}
+
+void MixerImpl::releaseChannel(int index) {
+	delete _channels[index];
+	_channels[index] = nullptr;
+	_channelStates[index].handle.store(kFreeSlot, Common::kMemoryOrderRelease);
+}
+
+void MixerImpl::publishTiming(int index, const Channel *chan) {
+	ChannelState &state = _channelStates[index];
+
+	// Readers retry while the counter is odd or has changed meanwhile
+	const uint32 seq = state.timingSeq.load(Common::kMemoryOrderRelaxed);
+	state.timingSeq.store(seq + 1, Common::kMemoryOrderRelaxed);
+	Common::atomicThreadFence(Common::kMemoryOrderRelease);
+
+	state.samplesConsumed.store(chan->getSamplesConsumed(), Common::kMemoryOrderRelaxed);
+	state.mixerTimeStamp.store(chan->getMixerTimeStamp(), Common::kMemoryOrderRelaxed);
+	state.mixPauseTime.store(state.pauseTime.load(Common::kMemoryOrderRelaxed), Common::kMemoryOrderRelaxed);
+
+	state.timingSeq.store(seq + 2, Common::kMemoryOrderRelease);
+}
+
+void MixerImpl::applySettings(int index) {
+	Channel *chan = _channels[index];
+	ChannelState &state = _channelStates[index];
+
+	// This also picks up the settings of the sound type
+	chan->setVolume(state.volume.load(Common::kMemoryOrderRelaxed));
+	chan->setBalance(state.balance.load(Common::kMemoryOrderRelaxed));
+
+	if (state.loop.exchange(false, Common::kMemoryOrderRelaxed))
+		chan->loop();
+}
+
+void MixerImpl::notifySettingsChanged() {
+	_settingsSeq.fetchAdd(1, Common::kMemoryOrderRelease);
+}
+
+void MixerImpl::pauseChannel(int index, bool paused, uint32 time) {
+	ChannelState &state = _channelStates[index];
+
+	if (paused) {
+		if (++state.pauseLevel != 1)
+			return;
+	} else {
+		if (state.pauseLevel == 0 || --state.pauseLevel != 0)
+			return;
+	}
+
+	// Readers retry while the counter is odd or has changed meanwhile
+	const uint32 seq = state.pauseSeq.load(Common::kMemoryOrderRelaxed);
+	state.pauseSeq.store(seq + 1, Common::kMemoryOrderRelaxed);
+	Common::atomicThreadFence(Common::kMemoryOrderRelease);
+
+	if (paused) {
+		state.pauseStartTime.store(time, Common::kMemoryOrderRelaxed);
+	} else {
+		const uint32 pauseTime = state.pauseTime.load(Common::kMemoryOrderRelaxed);
+		state.pauseTime.store(pauseTime + time - state.pauseStartTime.load(Common::kMemoryOrderRelaxed), Common::kMemoryOrderRelaxed);
+		state.pauseStartTime.store(0, Common::kMemoryOrderRelaxed);
+	}
+	state.paused.store(paused, Common::kMemoryOrderRelaxed);
+
+	state.pauseSeq.store(seq + 2, Common::kMemoryOrderRelease);
+}
+
+int MixerImpl::findChannel(SoundHandle handle) const {
+	if (handle._val == kFreeSlot)
+		return -1;
+
+	const int index = handle._val % NUM_CHANNELS;
+	if (_channelStates[index].handle.load(Common::kMemoryOrderAcquire) != handle._val)
+		return -1;
+
+	return index;
+}
+
 void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	int index = -1;
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] == nullptr) {
+		if (_channelStates[i].handle.load(Common::kMemoryOrderAcquire) == kFreeSlot) {
 			index = i;
 			break;
 		}
@@ -218,13 +349,36 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 		return;
 	}
 
-	_channels[index] = chan;
-
 	SoundHandle chanHandle;
 	chanHandle._val = index + (_handleSeed * NUM_CHANNELS);
 
 	chan->setHandle(chanHandle);
 	_handleSeed++;
+
+	// Nothing else writes the state of a free slot, as the audio thread only
+	// writes it for the channels it has picked up
+	ChannelState &state = _channelStates[index];
+	state.id.store(chan->getId(), Common::kMemoryOrderRelaxed);
+	state.type.store(chan->getType(), Common::kMemoryOrderRelaxed);
+	state.volume.store(chan->getVolume(), Common::kMemoryOrderRelaxed);
+	state.balance.store(chan->getBalance(), Common::kMemoryOrderRelaxed);
+	state.loop.store(false, Common::kMemoryOrderRelaxed);
+
+	state.pauseLevel = 0;
+	state.pauseSeq.store(0, Common::kMemoryOrderRelaxed);
+	state.pauseStartTime.store(0, Common::kMemoryOrderRelaxed);
+	state.pauseTime.store(0, Common::kMemoryOrderRelaxed);
+	state.paused.store(false, Common::kMemoryOrderRelaxed);
+
+	publishTiming(index, chan);
+	state.handle.store(chanHandle._val, Common::kMemoryOrderRelease);
+
+	// The channel holds its slot until the audio thread has picked it up,
+	// so there is always room
+	bool queued = _newChannels.push(chan);
+	assert(queued);
+	(void)queued;
+
 	if (handle)
 		*handle = chanHandle;
 }
@@ -237,20 +391,22 @@ void MixerImpl::playStream(
 			DisposeAfterUse::Flag autofreeStream,
 			bool permanent,
 			bool reverseStereo) {
-	Common::StackLock lock(_mutex);
-
 	if (stream == nullptr) {
 		warning("stream is 0");
 		return;
 	}
 
 
-	assert(_mixerReady);
+	assert(isReady());
+
+	_queueMutex.lock();
 
 	// Prevent duplicate sounds
 	if (id != -1) {
 		for (int i = 0; i != NUM_CHANNELS; i++)
-			if (_channels[i] != nullptr && _channels[i]->getId() == id) {
+			if (_channelStates[i].handle.load(Common::kMemoryOrderAcquire) != kFreeSlot && _channelStates[i].id.load(Common::kMemoryOrderRelaxed) == id) {
+				_queueMutex.unlock();
+
 				// Delete the stream if were asked to auto-dispose it.
 				// Note: This could cause trouble if the client code does not
 				// yet expect the stream to be gone. The primary example to
@@ -268,10 +424,12 @@ void MixerImpl::playStream(
 #endif
 
 	// Create the channel
-	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
+	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent, _rateConverterType);
 	chan->setVolume(volume);
 	chan->setBalance(balance);
 	insertChannel(handle, chan);
+
+	_queueMutex.unlock();
 }
 
 int MixerImpl::mixCallback(byte *samples, uint len) {
@@ -285,110 +443,146 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	len >>= 2;
 
 	// Since the mixer callback has been called, the mixer must be ready...
-	_mixerReady = true;
+	_mixerReady.store(true, Common::kMemoryOrderRelease);
 
-	//  zero the buf
-	memset(buf, 0, 2 * len * sizeof(int16));
+	addNewChannels();
+
+	// Apply the settings changed since the last mix
+	const uint32 settingsSeq = _settingsSeq.load(Common::kMemoryOrderAcquire);
+	if (settingsSeq != _appliedSettingsSeq) {
+		_appliedSettingsSeq = settingsSeq;
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_channels[i])
+				applySettings(i);
+		}
+	}
+
+	// zero the buf, or the mix bus if we have one
+	int32 *bus = nullptr;
+	if (_mixBus)
+		bus = _mixBus->clear(len);
+	else
+		memset(buf, 0, 2 * len * sizeof(int16));
 
 	// mix all channels
 	int res = 0, tmp;
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i]) {
 			if (_channels[i]->isFinished()) {
-				delete _channels[i];
-				_channels[i] = nullptr;
-			} else if (!_channels[i]->isPaused()) {
-				tmp = _channels[i]->mix(buf, len);
+				releaseChannel(i);
+			} else if (!_channelStates[i].paused.load(Common::kMemoryOrderAcquire)) {
+				if (bus)
+					tmp = _channels[i]->mix(bus, len);
+				else
+					tmp = _channels[i]->mix(buf, len);
 
 				if (tmp > res)
 					res = tmp;
+
+				publishTiming(i, _channels[i]);
 			}
 		}
 
+	if (_mixBus)
+		_mixBus->render(buf, len);
+
 	return res;
 }
 
+// Callers may delete the stream right after stopping a sound, so the methods
+// which stop sounds wait for the audio thread. They pick up the new channels
+// first, so that sounds which were never mixed get stopped as well.
+
 void MixerImpl::stopAll() {
 	Common::StackLock lock(_mutex);
+	Common::StackLock queueLock(_queueMutex);
+	addNewChannels();
+
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr && !_channels[i]->isPermanent()) {
-			delete _channels[i];
-			_channels[i] = nullptr;
-		}
+		if (_channels[i] != nullptr && !_channels[i]->isPermanent())
+			releaseChannel(i);
 	}
 }
 
 void MixerImpl::stopID(int id) {
 	Common::StackLock lock(_mutex);
+	Common::StackLock queueLock(_queueMutex);
+	addNewChannels();
+
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr && _channels[i]->getId() == id) {
-			delete _channels[i];
-			_channels[i] = nullptr;
-		}
+		if (_channels[i] != nullptr && _channels[i]->getId() == id)
+			releaseChannel(i);
 	}
 }
 
 void MixerImpl::stopHandle(SoundHandle handle) {
+	// Simply ignore stop requests for handles of sounds that already terminated
+	if (findChannel(handle) == -1)
+		return;
+
 	Common::StackLock lock(_mutex);
+	Common::StackLock queueLock(_queueMutex);
+	addNewChannels();
 
-	// Simply ignore stop requests for handles of sounds that already terminated
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return;
 
-	delete _channels[index];
-	_channels[index] = nullptr;
+	releaseChannel(index);
 }
 
+// The other control methods never wait for the audio thread. They change the
+// channel states, which the audio thread applies before it mixes again, and
+// which queries return right away.
+
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
-	_soundTypeSettings[type].mute = mute;
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	_soundTypeSettings[type].mute.store(mute, Common::kMemoryOrderRelaxed);
+	notifySettingsChanged();
 }
 
 bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
-	return _soundTypeSettings[type].mute;
+	return _soundTypeSettings[type].mute.load(Common::kMemoryOrderRelaxed);
 }
 
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_queueMutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findChannel(handle);
+	if (index == -1)
 		return;
 
-	_channels[index]->setVolume(volume);
+	_channelStates[index].volume.store(volume, Common::kMemoryOrderRelaxed);
+	notifySettingsChanged();
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findChannel(handle);
+	if (index == -1)
 		return 0;
 
-	return _channels[index]->getVolume();
+	return _channelStates[index].volume.load(Common::kMemoryOrderRelaxed);
 }
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_queueMutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findChannel(handle);
+	if (index == -1)
 		return;
 
-	_channels[index]->setBalance(balance);
+	_channelStates[index].balance.store(balance, Common::kMemoryOrderRelaxed);
+	notifySettingsChanged();
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findChannel(handle);
+	if (index == -1)
 		return 0;
 
-	return _channels[index]->getBalance();
+	return _channelStates[index].balance.load(Common::kMemoryOrderRelaxed);
 }
 
 uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
@@ -396,91 +590,102 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
 }
 
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findChannel(handle);
+	if (index == -1)
 		return Timestamp(0, _sampleRate);
 
-	return _channels[index]->getElapsedTime();
+	const ChannelState &state = _channelStates[index];
+	ChannelTiming timing;
+	uint32 pauseSeq, timingSeq;
+	do {
+		pauseSeq = state.pauseSeq.load(Common::kMemoryOrderAcquire);
+		timingSeq = state.timingSeq.load(Common::kMemoryOrderAcquire);
+		timing.samplesConsumed = state.samplesConsumed.load(Common::kMemoryOrderRelaxed);
+		timing.mixerTimeStamp = state.mixerTimeStamp.load(Common::kMemoryOrderRelaxed);
+		timing.mixPauseTime = state.mixPauseTime.load(Common::kMemoryOrderRelaxed);
+		timing.pauseStartTime = state.pauseStartTime.load(Common::kMemoryOrderRelaxed);
+		timing.pauseTime = state.pauseTime.load(Common::kMemoryOrderRelaxed);
+		timing.paused = state.paused.load(Common::kMemoryOrderRelaxed);
+		Common::atomicThreadFence(Common::kMemoryOrderAcquire);
+	} while (((pauseSeq | timingSeq) & 1) ||
+	         pauseSeq != state.pauseSeq.load(Common::kMemoryOrderRelaxed) ||
+	         timingSeq != state.timingSeq.load(Common::kMemoryOrderRelaxed));
+
+	return Channel::getElapsedTime(timing, _sampleRate);
 }
 
 void MixerImpl::loopChannel(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_queueMutex);
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findChannel(handle);
+	if (index == -1)
 		return;
 
-	_channels[index]->loop();
+	_channelStates[index].loop.store(true, Common::kMemoryOrderRelaxed);
+	notifySettingsChanged();
 }
 
 void MixerImpl::pauseAll(bool paused) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_queueMutex);
+
+	const uint32 time = g_system->getMillis(true);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr) {
-			_channels[i]->pause(paused);
-		}
+		if (_channelStates[i].handle.load(Common::kMemoryOrderAcquire) != kFreeSlot)
+			pauseChannel(i, paused, time);
 	}
 }
 
 void MixerImpl::pauseID(int id, bool paused) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_queueMutex);
+
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != nullptr && _channels[i]->getId() == id) {
-			_channels[i]->pause(paused);
+		if (_channelStates[i].handle.load(Common::kMemoryOrderAcquire) != kFreeSlot && _channelStates[i].id.load(Common::kMemoryOrderRelaxed) == id) {
+			pauseChannel(i, paused, g_system->getMillis(true));
 			return;
 		}
 	}
 }
 
 void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
-	Common::StackLock lock(_mutex);
+	Common::StackLock lock(_queueMutex);
 
 	// Simply ignore (un)pause requests for sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const int index = findChannel(handle);
+	if (index == -1)
 		return;
 
-	_channels[index]->pause(paused);
+	pauseChannel(index, paused, g_system->getMillis(true));
 }
 
 bool MixerImpl::isSoundIDActive(int id) {
-	Common::StackLock lock(_mutex);
-
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getId() == id)
+		if (_channelStates[i].handle.load(Common::kMemoryOrderAcquire) != kFreeSlot && _channelStates[i].id.load(Common::kMemoryOrderRelaxed) == id)
 			return true;
 	return false;
 }
 
 int MixerImpl::getSoundID(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-	const int index = handle._val % NUM_CHANNELS;
-	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
-		return _channels[index]->getId();
+	const int index = findChannel(handle);
+	if (index != -1)
+		return _channelStates[index].id.load(Common::kMemoryOrderRelaxed);
 	return 0;
 }
 
 bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
-
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
-	const int index = handle._val % NUM_CHANNELS;
-	return _channels[index] && _channels[index]->getHandle()._val == handle._val;
+	return findChannel(handle) != -1;
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
-	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i] && _channels[i]->getType() == type)
+		if (_channelStates[i].handle.load(Common::kMemoryOrderAcquire) != kFreeSlot && _channelStates[i].type.load(Common::kMemoryOrderRelaxed) == type)
 			return true;
 	return false;
 }
@@ -494,19 +699,14 @@ void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
 	// TODO: Maybe we should do logarithmic (not linear) volume
 	// scaling? See also Player_V2::setMasterVolume
 
-	Common::StackLock lock(_mutex);
-	_soundTypeSettings[type].volume = volume;
-
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	_soundTypeSettings[type].volume.store(volume, Common::kMemoryOrderRelaxed);
+	notifySettingsChanged();
 }
 
 int MixerImpl::getVolumeForSoundType(SoundType type) const {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
 
-	return _soundTypeSettings[type].volume;
+	return _soundTypeSettings[type].volume.load(Common::kMemoryOrderRelaxed);
 }
 
 
@@ -515,16 +715,17 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 #pragma mark -
 
 Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
-				 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
+				 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent,
+				 RateConverterType converterType)
 	: _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
-	  _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
-	  _pauseStartTime(0), _pauseTime(0), _converter(nullptr), _volL(0), _volR(0),
+	  _balance(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
+	  _converter(nullptr), _volL(0), _volR(0),
 	  _stream(stream, autofreeStream) {
 	assert(mixer);
 	assert(stream);
 
 	// Get a rate converter instance
-	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo);
+	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo, converterType);
 }
 
 Channel::~Channel() {
@@ -576,41 +777,24 @@ void Channel::updateChannelVolumes() {
 	}
 }
 
-void Channel::pause(bool paused) {
-	//assert((paused && _pauseLevel >= 0) || (!paused && _pauseLevel));
-
-	if (paused) {
-		_pauseLevel++;
-
-		if (_pauseLevel == 1)
-			_pauseStartTime = g_system->getMillis(true);
-	} else if (_pauseLevel > 0) {
-		_pauseLevel--;
-
-		if (!_pauseLevel) {
-			_pauseTime = (g_system->getMillis(true) - _pauseStartTime);
-			_pauseStartTime = 0;
-		}
-	}
-}
-
-Timestamp Channel::getElapsedTime() {
-	const uint32 rate = _mixer->getOutputRate();
+Timestamp Channel::getElapsedTime(const ChannelTiming &timing, uint rate) {
 	uint32 delta = 0;
 
 	Audio::Timestamp ts(0, rate);
 
-	if (_mixerTimeStamp == 0)
+	if (timing.mixerTimeStamp == 0)
 		return ts;
 
-	if (isPaused())
-		delta = _pauseStartTime - _mixerTimeStamp;
-	else
-		delta = g_system->getMillis(true) - _mixerTimeStamp - _pauseTime;
+	// Leave out the pauses since the last mix. A mix which was already
+	// running when the channel got paused may have started after the pause.
+	const uint32 now = timing.paused ? timing.pauseStartTime : g_system->getMillis(true);
+	const int32 playing = (int32)(now - timing.mixerTimeStamp - (timing.pauseTime - timing.mixPauseTime));
+	if (playing > 0)
+		delta = playing;
 
 	// Convert the number of samples into a time duration.
 
-	ts = ts.addFrames(_samplesConsumed);
+	ts = ts.addFrames(timing.samplesConsumed);
 	ts = ts.addMsecs(delta);
 
 	// In theory it would seem like a good idea to limit the approximation
@@ -634,6 +818,12 @@ void Channel::loop() {
 	}
 }
 
+void Channel::startMix() {
+	assert(_converter);
+	_samplesConsumed = _samplesDecoded;
+	_mixerTimeStamp = g_system->getMillis(true);
+}
+
 int Channel::mix(int16 *data, uint len) {
 	assert(_stream);
 
@@ -641,10 +831,7 @@ int Channel::mix(int16 *data, uint len) {
 	if (_stream->endOfData()) {
 		// TODO: call drain method
 	} else {
-		assert(_converter);
-		_samplesConsumed = _samplesDecoded;
-		_mixerTimeStamp = g_system->getMillis(true);
-		_pauseTime = 0;
+		startMix();
 		res = _converter->flow(*_stream, data, len, _volL, _volR);
 		_samplesDecoded += res;
 	}
@@ -652,4 +839,19 @@ int Channel::mix(int16 *data, uint len) {
 	return res;
 }
 
+int Channel::mix(int32 *data, uint len) {
+	assert(_stream);
+
+	int res = 0;
+	if (_stream->endOfData()) {
+		// TODO: call drain method
+	} else {
+		startMix();
+		res = _converter->flowUnclamped(*_stream, data, len, _volL, _volR);
+		_samplesDecoded += res;
+	}
+
+	return res;
+}
+
 } // End of namespace Audio
@@ -23,11 +23,34 @@
 #define AUDIO_MIXER_INTERN_H
 
 #include "common/scummsys.h"
+#include "common/atomic.h"
 #include "common/mutex.h"
+#include "common/spsc-queue.h"
 #include "audio/mixer.h"
+#include "audio/rate.h"
 
 namespace Audio {
 
+class MixBus;
+
+/**
+ * Snapshot of the timing information of a channel, from which the elapsed
+ * time of the sound is computed.
+ */
+struct ChannelTiming {
+	/** Number of samples mixed before the last mix */
+	uint32 samplesConsumed;
+	/** Time at which the last mix started, or 0 if the channel has not been mixed yet */
+	uint32 mixerTimeStamp;
+	/** Time at which the channel was paused */
+	uint32 pauseStartTime;
+	/** Total time spent in the pauses which have ended */
+	uint32 pauseTime;
+	/** Value of pauseTime at the last mix */
+	uint32 mixPauseTime;
+	bool paused;
+};
+
 /**
  * @defgroup audio_mixer_intern Mixer implementation
  * @ingroup audio
@@ -61,22 +84,87 @@ private:
 		NUM_CHANNELS = 32
 	};
 
+	/**
+	 * The state of a channel shared between the control methods and the audio
+	 * thread, so that neither of them ever has to wait for the other. The
+	 * control methods write the handle, the settings and the pause state, and
+	 * the audio thread applies the settings before it mixes. The audio thread
+	 * publishes the mix timing.
+	 */
+	struct ChannelState {
+		/** The handle of the channel, or kFreeSlot if the slot is unused */
+		Common::Atomic<uint32> handle;
+		Common::Atomic<int> id;
+		Common::Atomic<int> type;
+		Common::Atomic<byte> volume;
+		Common::Atomic<int8> balance;
+		/** Set when the channel should loop, until the audio thread has done so */
+		Common::Atomic<bool> loop;
+
+		/** Pause nesting level, only accessed with _queueMutex held */
+		int pauseLevel;
+		/** Sequence counter for the pause state below, odd while it is being written */
+		Common::Atomic<uint32> pauseSeq;
+		Common::Atomic<uint32> pauseStartTime;
+		Common::Atomic<uint32> pauseTime;
+		Common::Atomic<bool> paused;
+
+		/** Sequence counter for the mix timing below, odd while it is being written */
+		Common::Atomic<uint32> timingSeq;
+		Common::Atomic<uint32> samplesConsumed;
+		Common::Atomic<uint32> mixerTimeStamp;
+		Common::Atomic<uint32> mixPauseTime;
+	};
+
+	static const uint32 kFreeSlot = 0xFFFFFFFF;
+
+	/**
+	 * Held by the audio thread while mixing, and by the methods which stop
+	 * sounds. These wait for the current mix, since callers may delete the
+	 * stream as soon as the sound is stopped.
+	 */
 	Common::Mutex _mutex;
 
+	/**
+	 * Serializes the control methods, so that there is only one producer for
+	 * _newChannels and the channel states. It is never taken by the audio
+	 * thread. If both are needed, _mutex has to be taken first.
+	 */
+	Common::Mutex _queueMutex;
+
+	/**
+	 * Channels started by playStream(), which get moved into their slots the
+	 * next time the audio thread mixes, or before a sound is stopped. Each of
+	 * them holds a slot, so the queue cannot overflow.
+	 */
+	Common::SPSCQueue<Channel *, NUM_CHANNELS> _newChannels;
+
+	/** Incremented whenever the control methods change the channel settings */
+	Common::Atomic<uint32> _settingsSeq;
+	/** Value of _settingsSeq when the audio thread last applied the settings */
+	uint32 _appliedSettingsSeq;
+
 	const uint _sampleRate;
 	const uint _outBufSize;
-	bool _mixerReady;
+	Common::Atomic<bool> _mixerReady;
 	uint32 _handleSeed;
+	RateConverterType _rateConverterType;
+
+	/** The 32-bit mix bus, or nullptr when mixing directly into the output */
+	MixBus *_mixBus;
 
 	struct SoundTypeSettings {
 		SoundTypeSettings() : mute(false), volume(kMaxMixerVolume) {}
 
-		bool mute;
-		int volume;
+		Common::Atomic<bool> mute;
+		Common::Atomic<int> volume;
 	};
 
 	SoundTypeSettings _soundTypeSettings[4];
+
+	/** The channels, which are only accessed by the audio thread or with _mutex held */
 	Channel *_channels[NUM_CHANNELS];
+	ChannelState _channelStates[NUM_CHANNELS];
 
 
 public:
@@ -84,7 +172,7 @@ public:
 	MixerImpl(uint sampleRate, uint outBufSize = 0);
 	~MixerImpl();
 
-	virtual bool isReady() const { Common::StackLock lock(_mutex); return _mixerReady; }
+	virtual bool isReady() const { return _mixerReady.load(Common::kMemoryOrderAcquire); }
 
 	virtual Common::Mutex &mutex() { return _mutex; }
 
@@ -132,8 +220,43 @@ public:
 	virtual uint getOutputBufSize() const;
 
 protected:
+	/**
+	 * Find a free slot for the given channel and queue it for playback. Must
+	 * be called with _queueMutex held.
+	 */
 	void insertChannel(SoundHandle *handle, Channel *chan);
 
+private:
+	/** Move the queued new channels into their slots. Must be called with _mutex held. */
+	void addNewChannels();
+
+	/**
+	 * Delete the channel in the given slot and mark the slot as free. Must be
+	 * called with _mutex held.
+	 */
+	void releaseChannel(int index);
+
+	/** Publish the mix timing of the channel in the given slot. */
+	void publishTiming(int index, const Channel *chan);
+
+	/**
+	 * Apply the settings from the state of the channel in the given slot.
+	 * Must be called by the audio thread, or with _mutex held.
+	 */
+	void applySettings(int index);
+
+	/** Tell the audio thread that the channel settings have changed. */
+	void notifySettingsChanged();
+
+	/**
+	 * (Un)pause the channel in the given slot. Must be called with _queueMutex
+	 * held.
+	 */
+	void pauseChannel(int index, bool paused, uint32 time);
+
+	/** Return the index of the active channel with the given handle, or -1. */
+	int findChannel(SoundHandle handle) const;
+
 public:
 	/**
 	 * The mixer callback function, to be called at regular intervals by
@@ -146,6 +269,21 @@ public:
 	 */
 	int mixCallback(byte *samples, uint len);
 
+	/**
+	 * Set the sample rate conversion algorithm used for sounds started from
+	 * now on. The initial value is taken from the "audio_resampler" config
+	 * key, which can be either "default" or "polyphase".
+	 */
+	void setRateConverterType(RateConverterType type);
+
+	/**
+	 * Enable or disable the 32-bit mix bus. When enabled, channels are mixed
+	 * without clamping and the result is passed through a limiter and dither
+	 * stage once, instead of clamping after every channel. The initial value
+	 * is taken from the "audio_wide_mix_bus" config key.
+	 */
+	void setWideMixBus(bool enable);
+
 	/**
 	 * Set the internal 'is ready' flag of the mixer.
 	 * Backends should invoke Mixer::setReady(true) once initialisation of
@@ -16,6 +16,7 @@ MODULE_OBJS := \
 	midiplayer.o \
 	miles_adlib.o \
 	miles_midi.o \
+	mixbus.o \
 	mixer.o \
 	mpu401.o \
 	mt32gm.o \
@@ -93,6 +94,18 @@ MODULE_OBJS += \
 	decoders/ac3.o
 endif
 
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	rate_sse2.o
+
+$(MODULE)/rate_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	rate_neon.o
+endif
+
 ifdef USE_ALSA
 MODULE_OBJS += \
 	alsa_opl.o
@@ -29,8 +29,15 @@
 
 #include "audio/audiostream.h"
 #include "audio/rate.h"
+#include "audio/rate_intern.h"
 #include "audio/mixer.h"
+#include "common/algorithm.h"
+#include "common/array.h"
 #include "common/frac.h"
+#include "common/math.h"
+#include "common/mutex.h"
+#include "common/singleton.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 #include "common/util.h"
 
@@ -56,6 +63,128 @@ enum {
 	FRAC_HALF_LOW = (1L << (FRAC_BITS_LOW-1))
 };
 
+#pragma mark -
+
+
+void mixStereoSamplesGeneric(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+	for (; frames > 0; --frames) {
+		// output left channel
+		clampedAdd(obuf[0], (ibuf[0] * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+
+		// output right channel
+		clampedAdd(obuf[1], (ibuf[1] * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+
+		obuf += 2;
+		ibuf += 2;
+	}
+}
+
+void mixStereoSamplesWide(int32 *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+	// Simple enough for compilers to vectorize on their own
+	for (; frames > 0; --frames) {
+		obuf[0] += ibuf[0] * (int32)vol_l;
+		obuf[1] += ibuf[1] * (int32)vol_r;
+
+		obuf += 2;
+		ibuf += 2;
+	}
+}
+
+static MixStereoProc selectMixStereoProc() {
+#ifndef OUTPUT_UNSIGNED_AUDIO
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasCpuFeature(OSystem::kCpuFeatureSSE2))
+		return mixStereoSamplesSSE2;
+#endif
+#ifdef SCUMMVM_NEON
+	if (g_system->hasCpuFeature(OSystem::kCpuFeatureNEON))
+		return mixStereoSamplesNEON;
+#endif
+#endif
+	return mixStereoSamplesGeneric;
+}
+
+void mixStereoSamples(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+	// Pick the implementation once the backend is available to ask
+	static MixStereoProc mixProc = nullptr;
+	if (!mixProc && g_system)
+		mixProc = selectMixStereoProc();
+
+	// The SIMD versions rely on the scaled samples fitting into 16 bits
+	if (!mixProc || vol_l > Audio::Mixer::kMaxMixerVolume || vol_r > Audio::Mixer::kMaxMixerVolume)
+		mixStereoSamplesGeneric(obuf, ibuf, frames, vol_l, vol_r);
+	else
+		mixProc(obuf, ibuf, frames, vol_l, vol_r);
+}
+
+
+#pragma mark -
+
+
+/**
+ * Common base of the rate converters below. Subclasses resample the input
+ * into an intermediate buffer of interleaved stereo frames, already in
+ * output channel order; those frames are then scaled and mixed into the
+ * output buffer in a single pass by mixStereoSamples().
+ */
+class BufferedRateConverter : public RateConverter {
+protected:
+	st_sample_t _mixBuf[INTERMEDIATE_BUFFER_SIZE];
+
+	/** whether the subclass swaps the left and right channels */
+	const bool _reverseStereo;
+
+	/**
+	 * Resample (at most) the given number of sample pairs from the input
+	 * stream into obuf.
+	 *
+	 * @return Number of sample pairs written into the buffer.
+	 */
+	virtual int resample(AudioStream &input, st_sample_t *obuf, st_size_t osamp) = 0;
+
+	template<typename Sample, void (*mixProc)(Sample *, const st_sample_t *, st_size_t, st_volume_t, st_volume_t)>
+	int flowInternal(AudioStream &input, Sample *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+
+public:
+	BufferedRateConverter(bool reverseStereo) : _reverseStereo(reverseStereo) {}
+
+	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) override;
+	int flowUnclamped(AudioStream &input, int32 *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) override;
+	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) override {
+		return ST_SUCCESS;
+	}
+};
+
+template<typename Sample, void (*mixProc)(Sample *, const st_sample_t *, st_size_t, st_volume_t, st_volume_t)>
+int BufferedRateConverter::flowInternal(AudioStream &input, Sample *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	// The resampled frames are already swapped, so swap the volumes as well
+	const st_volume_t vol0 = _reverseStereo ? vol_r : vol_l;
+	const st_volume_t vol1 = _reverseStereo ? vol_l : vol_r;
+
+	st_size_t done = 0;
+	while (done < osamp) {
+		const st_size_t todo = MIN<st_size_t>(osamp - done, ARRAYSIZE(_mixBuf) / 2);
+		const int len = resample(input, _mixBuf, todo);
+		if (len <= 0)
+			break;
+
+		mixProc(obuf + done * 2, _mixBuf, len, vol0, vol1);
+		done += len;
+
+		if ((st_size_t)len < todo)
+			break;
+	}
+	return done;
+}
+
+int BufferedRateConverter::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	return flowInternal<st_sample_t, mixStereoSamples>(input, obuf, osamp, vol_l, vol_r);
+}
+
+int BufferedRateConverter::flowUnclamped(AudioStream &input, int32 *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	return flowInternal<int32, mixStereoSamplesWide>(input, obuf, osamp, vol_l, vol_r);
+}
+
 /**
  * Audio rate converter based on simple resampling. Used when no
  * interpolation is required.
@@ -63,7 +192,7 @@ enum {
  * Limited to sampling frequency <= 65535 Hz.
  */
 template<bool stereo, bool reverseStereo>
-class SimpleRateConverter : public RateConverter {
+class SimpleRateConverter : public BufferedRateConverter {
 protected:
 	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
 	const st_sample_t *inPtr;
@@ -76,12 +205,10 @@ protected:
 	/** fractional position increment in the output stream */
 	long opos_inc;
 
+	int resample(AudioStream &input, st_sample_t *obuf, st_size_t osamp) override;
+
 public:
 	SimpleRateConverter(st_rate_t inrate, st_rate_t outrate);
-	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) override;
-	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) override {
-		return ST_SUCCESS;
-	}
 };
 
 
@@ -89,7 +216,7 @@ public:
  * Prepare processing.
  */
 template<bool stereo, bool reverseStereo>
-SimpleRateConverter<stereo, reverseStereo>::SimpleRateConverter(st_rate_t inrate, st_rate_t outrate) {
+SimpleRateConverter<stereo, reverseStereo>::SimpleRateConverter(st_rate_t inrate, st_rate_t outrate) : BufferedRateConverter(reverseStereo) {
 	if ((inrate % outrate) != 0) {
 		error("Input rate must be a multiple of output rate to use rate effect");
 	}
@@ -111,7 +238,7 @@ SimpleRateConverter<stereo, reverseStereo>::SimpleRateConverter(st_rate_t inrate
  * Return number of sample pairs processed.
  */
 template<bool stereo, bool reverseStereo>
-int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+int SimpleRateConverter<stereo, reverseStereo>::resample(AudioStream &input, st_sample_t *obuf, st_size_t osamp) {
 	st_sample_t *ostart, *oend;
 
 	ostart = obuf;
@@ -142,11 +269,8 @@ int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 		// Increment output position
 		opos += opos_inc;
 
-		// output left channel
-		clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-		// output right channel
-		clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+		obuf[reverseStereo    ] = out0;
+		obuf[reverseStereo ^ 1] = out1;
 
 		obuf += 2;
 	}
@@ -165,7 +289,7 @@ int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
  */
 
 template<bool stereo, bool reverseStereo>
-class LinearRateConverter : public RateConverter {
+class LinearRateConverter : public BufferedRateConverter {
 protected:
 	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
 	const st_sample_t *inPtr;
@@ -182,12 +306,10 @@ protected:
 	/** current sample(s) in the input stream (left/right channel) */
 	st_sample_t icur0, icur1;
 
+	int resample(AudioStream &input, st_sample_t *obuf, st_size_t osamp) override;
+
 public:
 	LinearRateConverter(st_rate_t inrate, st_rate_t outrate);
-	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) override;
-	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) override {
-		return ST_SUCCESS;
-	}
 };
 
 
@@ -195,7 +317,7 @@ public:
  * Prepare processing.
  */
 template<bool stereo, bool reverseStereo>
-LinearRateConverter<stereo, reverseStereo>::LinearRateConverter(st_rate_t inrate, st_rate_t outrate) {
+LinearRateConverter<stereo, reverseStereo>::LinearRateConverter(st_rate_t inrate, st_rate_t outrate) : BufferedRateConverter(reverseStereo) {
 	if (inrate >= 131072 || outrate >= 131072) {
 		error("rate effect can only handle rates < 131072");
 	}
@@ -220,7 +342,7 @@ LinearRateConverter<stereo, reverseStereo>::LinearRateConverter(st_rate_t inrate
  * Return number of sample pairs processed.
  */
 template<bool stereo, bool reverseStereo>
-int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+int LinearRateConverter<stereo, reverseStereo>::resample(AudioStream &input, st_sample_t *obuf, st_size_t osamp) {
 	st_sample_t *ostart, *oend;
 
 	ostart = obuf;
@@ -257,11 +379,8 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 						  (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
 						  out0);
 
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+			obuf[reverseStereo    ] = out0;
+			obuf[reverseStereo ^ 1] = out1;
 
 			obuf += 2;
 
@@ -280,69 +399,311 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
  * Simple audio rate converter for the case that the inrate equals the outrate.
  */
 template<bool stereo, bool reverseStereo>
-class CopyRateConverter : public RateConverter {
-	st_sample_t *_buffer;
-	st_size_t _bufferSize;
+class CopyRateConverter : public BufferedRateConverter {
+protected:
+	int resample(AudioStream &input, st_sample_t *obuf, st_size_t osamp) override {
+		assert(input.isStereo() == stereo);
+
+		if (stereo) {
+			const int len = input.readBuffer(obuf, osamp * 2);
+			if (len <= 0)
+				return 0;
+
+			if (reverseStereo) {
+				for (int i = 0; i < len; i += 2)
+					SWAP(obuf[i], obuf[i + 1]);
+			}
+			return len / 2;
+		} else {
+			// Read into the upper half of the buffer and expand the mono
+			// samples to sample pairs front to back, which never overwrites
+			// a sample that has not been read yet
+			const st_sample_t *ptr = obuf + osamp;
+			const int len = input.readBuffer(obuf + osamp, osamp);
+			for (int i = 0; i < len; i++) {
+				const st_sample_t out = *ptr++;
+				obuf[i * 2    ] = out;
+				obuf[i * 2 + 1] = out;
+			}
+			return MAX(len, 0);
+		}
+	}
+
 public:
-	CopyRateConverter() : _buffer(nullptr), _bufferSize(0) {}
-	~CopyRateConverter() {
-		free(_buffer);
+	CopyRateConverter() : BufferedRateConverter(reverseStereo) {}
+};
+
+
+#pragma mark -
+
+
+/**
+ * Coefficients of a windowed-sinc lowpass filter, split into phases for
+ * polyphase resampling between one specific pair of sample rates.
+ *
+ * The output rate is interp / decim times the input rate, with the fraction
+ * reduced to lowest terms. Every output sample lies on one of interp evenly
+ * spaced positions between two input samples, and each of those positions
+ * has its own set of filter taps. If interp is too large, the positions are
+ * rounded down to the nearest of kMaxPhases precomputed ones.
+ */
+struct PolyphaseFilterBank {
+	enum {
+		/** fractional bits of the filter coefficients */
+		kCoefBits = 14,
+		/** number of taps used when not downsampling */
+		kBaseTaps = 32,
+		kMaxTaps = 256,
+		kMaxPhases = 1024
+	};
+
+	PolyphaseFilterBank(st_rate_t inrate, st_rate_t outrate);
+
+	st_rate_t inRate, outRate;
+
+	/** input position increment per output sample, in 1/interp input samples */
+	uint32 decim;
+	/** number of possible output positions between two input samples */
+	uint32 interp;
+	/** number of precomputed phases, at most interp */
+	uint32 phases;
+	/** filter taps per phase, always even */
+	uint32 taps;
+
+	/** phases * taps coefficients, the taps of each phase add up to 1 << kCoefBits */
+	Common::Array<int16> coefs;
+};
+
+PolyphaseFilterBank::PolyphaseFilterBank(st_rate_t inrate, st_rate_t outrate) : inRate(inrate), outRate(outrate) {
+	const uint32 div = Common::gcd<uint32>(inrate, outrate);
+	interp = outrate / div;
+	decim = inrate / div;
+	phases = MIN<uint32>(interp, kMaxPhases);
+
+	// When downsampling, the cutoff frequency has to drop below the output
+	// Nyquist frequency, which widens the filter accordingly. The cutoff is
+	// placed slightly below Nyquist, to leave room for the transition band.
+	const double ratio = MIN<double>(1.0, (double)outrate / inrate);
+	const double cutoff = 0.91 * ratio;
+	taps = MIN<uint32>(kMaxTaps, ((uint32)ceil(kBaseTaps / ratio) + 1) & ~1);
+
+	coefs.resize(phases * taps);
+
+	Common::Array<double> h(taps);
+	for (uint32 p = 0; p < phases; ++p) {
+		const double frac = (double)p / phases;
+
+		// Tap t is applied to the input sample which is at distance
+		// t - (taps / 2 - 1) - frac from the output position
+		double sum = 0.0;
+		for (uint32 t = 0; t < taps; ++t) {
+			const double x = (double)t - (taps / 2 - 1) - frac;
+			const double sinc = (x == 0.0) ? 1.0 : sin(M_PI * cutoff * x) / (M_PI * cutoff * x);
+			const double window = 0.42 + 0.5 * cos(2.0 * M_PI * x / taps) + 0.08 * cos(4.0 * M_PI * x / taps);
+			h[t] = sinc * window;
+			sum += h[t];
+		}
+
+		// Normalize every phase to unity gain, putting the rounding error
+		// into the center tap, so that constant input stays constant
+		int16 *phaseCoefs = &coefs[p * taps];
+		int total = 0;
+		for (uint32 t = 0; t < taps; ++t) {
+			phaseCoefs[t] = (int16)floor(h[t] / sum * (1 << kCoefBits) + 0.5);
+			total += phaseCoefs[t];
+		}
+		phaseCoefs[taps / 2 - 1] += (1 << kCoefBits) - total;
 	}
+}
 
-	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) override {
-		assert(input.isStereo() == stereo);
+/**
+ * Computing a filter bank takes a while, so all converters for the same pair
+ * of sample rates share one. Filter banks are never released, which is fine
+ * since only a handful of different sample rates are in use at any time.
+ */
+class PolyphaseFilterBankCache : public Common::Singleton<PolyphaseFilterBankCache> {
+public:
+	const PolyphaseFilterBank &get(st_rate_t inrate, st_rate_t outrate);
+
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+	PolyphaseFilterBankCache() {}
+	~PolyphaseFilterBankCache();
+
+	Common::Mutex _mutex;
+	Common::Array<PolyphaseFilterBank *> _banks;
+};
+
+PolyphaseFilterBankCache::~PolyphaseFilterBankCache() {
+	for (uint i = 0; i < _banks.size(); ++i)
+		delete _banks[i];
+}
+
+const PolyphaseFilterBank &PolyphaseFilterBankCache::get(st_rate_t inrate, st_rate_t outrate) {
+	Common::StackLock lock(_mutex);
+
+	for (uint i = 0; i < _banks.size(); ++i) {
+		if (_banks[i]->inRate == inrate && _banks[i]->outRate == outrate)
+			return *_banks[i];
+	}
+
+	_banks.push_back(new PolyphaseFilterBank(inrate, outrate));
+	return *_banks.back();
+}
+
+/**
+ * Audio rate converter based on a polyphase windowed-sinc filter. This is
+ * considerably slower than linear interpolation, but does not suffer from
+ * its aliasing artifacts, which are especially audible when upsampling low
+ * quality samples to today's common output rates.
+ */
+template<bool stereo, bool reverseStereo>
+class PolyphaseRateConverter : public BufferedRateConverter {
+protected:
+	const PolyphaseFilterBank &_bank;
+
+	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
+
+	/**
+	 * The input samples still needed by the filter, one array per channel,
+	 * each with room for histSize samples.
+	 */
+	st_sample_t *hist0, *hist1;
+	uint32 histSize;
+
+	/** number of valid samples in the history */
+	uint32 histLen;
+
+	/** index of the first input sample used for the next output sample */
+	uint32 histPos;
+
+	/** position of the next output sample after histPos, in 1/interp samples */
+	uint32 frac;
+
+	bool refill(AudioStream &input);
+	int resample(AudioStream &input, st_sample_t *obuf, st_size_t osamp) override;
+
+public:
+	PolyphaseRateConverter(const PolyphaseFilterBank &bank);
+	~PolyphaseRateConverter();
+};
 
-		st_sample_t *ptr;
-		st_size_t len;
+template<bool stereo, bool reverseStereo>
+PolyphaseRateConverter<stereo, reverseStereo>::PolyphaseRateConverter(const PolyphaseFilterBank &bank) : BufferedRateConverter(reverseStereo), _bank(bank) {
+	histSize = _bank.taps + INTERMEDIATE_BUFFER_SIZE;
+	hist0 = new st_sample_t[histSize];
+	hist1 = stereo ? new st_sample_t[histSize] : nullptr;
+
+	// Start with silence before the first input sample, so that the first
+	// output sample is centered on it
+	histLen = _bank.taps / 2 - 1;
+	memset(hist0, 0, histLen * sizeof(st_sample_t));
+	if (stereo)
+		memset(hist1, 0, histLen * sizeof(st_sample_t));
+
+	histPos = 0;
+	frac = 0;
+}
 
-		st_sample_t *ostart = obuf;
+template<bool stereo, bool reverseStereo>
+PolyphaseRateConverter<stereo, reverseStereo>::~PolyphaseRateConverter() {
+	delete[] hist0;
+	delete[] hist1;
+}
 
+/*
+ * Drop the input samples which are no longer needed and append new ones
+ * from the input stream to the history.
+ * Return false if the input stream did not provide any more samples.
+ */
+template<bool stereo, bool reverseStereo>
+bool PolyphaseRateConverter<stereo, reverseStereo>::refill(AudioStream &input) {
+	if (histPos > 0) {
+		histLen -= histPos;
+		memmove(hist0, hist0 + histPos, histLen * sizeof(st_sample_t));
 		if (stereo)
-			osamp *= 2;
+			memmove(hist1, hist1 + histPos, histLen * sizeof(st_sample_t));
+		histPos = 0;
+	}
 
-		// Reallocate temp buffer, if necessary
-		if (osamp > _bufferSize) {
-			free(_buffer);
-			_buffer = (st_sample_t *)malloc(osamp * 2);
-			_bufferSize = osamp;
-		}
+	const int space = MIN<int>(ARRAYSIZE(inBuf), (histSize - histLen) * (stereo ? 2 : 1));
+	const int len = input.readBuffer(inBuf, space);
+	if (len <= 0)
+		return false;
 
-		if (!_buffer)
-			error("[CopyRateConverter::flow] Cannot allocate memory for temp buffer");
+	const st_sample_t *inPtr = inBuf;
+	for (int i = 0; i < len; i += (stereo ? 2 : 1)) {
+		hist0[histLen] = *inPtr++;
+		if (stereo)
+			hist1[histLen] = *inPtr++;
+		histLen++;
+	}
+	return true;
+}
 
-		// Read up to 'osamp' samples into our temporary buffer
-		len = input.readBuffer(_buffer, osamp);
+template<bool stereo, bool reverseStereo>
+int PolyphaseRateConverter<stereo, reverseStereo>::resample(AudioStream &input, st_sample_t *obuf, st_size_t osamp) {
+	st_sample_t *ostart, *oend;
 
-		// Mix the data into the output buffer
-		ptr = _buffer;
-		for (; len > 0; len -= (stereo ? 2 : 1)) {
-			st_sample_t out0, out1;
-			out0 = *ptr++;
-			out1 = (stereo ? *ptr++ : out0);
+	ostart = obuf;
+	oend = obuf + osamp * 2;
 
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+	const uint32 taps = _bank.taps;
+	const uint32 decim = _bank.decim;
+	const uint32 interp = _bank.interp;
+	const uint32 phases = _bank.phases;
 
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+	while (obuf < oend) {
+		// make sure all samples covered by the filter are available
+		while (histPos + taps > histLen) {
+			if (!refill(input))
+				return (obuf - ostart) / 2;
+		}
 
-			obuf += 2;
+		const uint32 phase = (phases == interp) ? frac : (uint32)(((uint64)frac * phases) / interp);
+		const int16 *coefs = &_bank.coefs[phase * taps];
+
+		st_sample_t out0, out1;
+		int32 acc0 = 0;
+		const st_sample_t *in0 = hist0 + histPos;
+		for (uint32 t = 0; t < taps; ++t)
+			acc0 += coefs[t] * in0[t];
+		out0 = (st_sample_t)CLIP<int32>((acc0 + (1 << (PolyphaseFilterBank::kCoefBits - 1))) >> PolyphaseFilterBank::kCoefBits, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+
+		if (stereo) {
+			int32 acc1 = 0;
+			const st_sample_t *in1 = hist1 + histPos;
+			for (uint32 t = 0; t < taps; ++t)
+				acc1 += coefs[t] * in1[t];
+			out1 = (st_sample_t)CLIP<int32>((acc1 + (1 << (PolyphaseFilterBank::kCoefBits - 1))) >> PolyphaseFilterBank::kCoefBits, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+		} else {
+			out1 = out0;
 		}
-		return (obuf - ostart) / 2;
-	}
 
-	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) override {
-		return ST_SUCCESS;
+		obuf[reverseStereo    ] = out0;
+		obuf[reverseStereo ^ 1] = out1;
+
+		obuf += 2;
+
+		// Increment output position
+		frac += decim;
+		while (frac >= interp) {
+			frac -= interp;
+			histPos++;
+		}
 	}
-};
+	return (obuf - ostart) / 2;
+}
 
 
 #pragma mark -
 
 template<bool stereo, bool reverseStereo>
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, RateConverterType type) {
 	if (inrate != outrate) {
-		if ((inrate % outrate) == 0 && (inrate < 65536)) {
+		if (type == kRateConverterPolyphase) {
+			return new PolyphaseRateConverter<stereo, reverseStereo>(PolyphaseFilterBankCache::instance().get(inrate, outrate));
+		} else if ((inrate % outrate) == 0 && (inrate < 65536)) {
 			return new SimpleRateConverter<stereo, reverseStereo>(inrate, outrate);
 		} else {
 			return new LinearRateConverter<stereo, reverseStereo>(inrate, outrate);
@@ -355,14 +716,18 @@ RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
 /**
  * Create and return a RateConverter object for the specified input and output rates.
  */
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo, RateConverterType type) {
 	if (stereo) {
 		if (reverseStereo)
-			return makeRateConverter<true, true>(inrate, outrate);
+			return makeRateConverter<true, true>(inrate, outrate, type);
 		else
-			return makeRateConverter<true, false>(inrate, outrate);
+			return makeRateConverter<true, false>(inrate, outrate, type);
 	} else
-		return makeRateConverter<false, false>(inrate, outrate);
+		return makeRateConverter<false, false>(inrate, outrate, type);
 }
 
 } // End of namespace Audio
+
+namespace Common {
+DECLARE_SINGLETON(Audio::PolyphaseFilterBankCache);
+}
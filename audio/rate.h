@@ -71,6 +71,27 @@ static inline void clampedAdd(int16& a, int b) {
 #endif
 }
 
+/**
+ * Scale the interleaved stereo sample pairs in ibuf by the given left and
+ * right channel volumes and add them to obuf, clamping the results to the
+ * sample range.
+ *
+ * Uses a SIMD implementation if the host CPU supports one. All
+ * implementations produce bit-identical results.
+ */
+void mixStereoSamples(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r);
+
+/**
+ * Multiply the interleaved stereo sample pairs in ibuf by the given left and
+ * right channel volumes and add them to the 32-bit mix bus obuf.
+ *
+ * Unlike mixStereoSamples(), the results are neither scaled down by
+ * Mixer::kMaxMixerVolume nor clamped, so the bus keeps 8 more bits of
+ * precision than 16-bit samples, and enough headroom for mixing the
+ * maximum number of mixer channels at full volume.
+ */
+void mixStereoSamplesWide(int32 *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r);
+
 class RateConverter {
 public:
 	RateConverter() {}
@@ -81,10 +102,36 @@ public:
 	 */
 	virtual int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) = 0;
 
+	/**
+	 * Like flow(), but mix into a 32-bit mix bus as described for
+	 * mixStereoSamplesWide().
+	 *
+	 * @return Number of sample pairs written into the buffer.
+	 */
+	virtual int flowUnclamped(AudioStream &input, int32 *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) = 0;
+
 	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) = 0;
 };
 
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false);
+/**
+ * The available sample rate conversion algorithms.
+ */
+enum RateConverterType {
+	/**
+	 * Picks nearest neighbour or linear interpolation, depending on the
+	 * sample rates. Fast, but prone to aliasing.
+	 */
+	kRateConverterDefault,
+
+	/**
+	 * Polyphase windowed-sinc filter. Considerably slower, but much higher
+	 * quality. The filter coefficients are computed once per pair of sample
+	 * rates and shared between all converters.
+	 */
+	kRateConverterPolyphase
+};
+
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false, RateConverterType type = kRateConverterDefault);
 /** @} */
 } // End of namespace Audio
 
@@ -0,0 +1,52 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_RATE_INTERN_H
+#define AUDIO_RATE_INTERN_H
+
+#include "audio/rate.h"
+
+namespace Audio {
+
+/**
+ * The individual implementations of mixStereoSamples(). They are only
+ * exposed so that the test suite can compare them against each other;
+ * everyone else should call mixStereoSamples(), which picks the best one
+ * supported by the host CPU.
+ *
+ * The SIMD versions require both volumes to be at most
+ * Mixer::kMaxMixerVolume.
+ */
+typedef void (*MixStereoProc)(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r);
+
+void mixStereoSamplesGeneric(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r);
+
+#ifdef SCUMMVM_SSE2
+void mixStereoSamplesSSE2(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r);
+#endif
+
+#ifdef SCUMMVM_NEON
+void mixStereoSamplesNEON(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r);
+#endif
+
+} // End of namespace Audio
+
+#endif
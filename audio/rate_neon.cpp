@@ -0,0 +1,61 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <arm_neon.h>
+
+#include "audio/rate_intern.h"
+#include "audio/mixer.h"
+
+namespace Audio {
+
+void mixStereoSamplesNEON(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+	STATIC_ASSERT(Audio::Mixer::kMaxMixerVolume == 256, mixer_volume_must_be_a_shift_by_8);
+
+	const int16 volPairs[4] = { (int16)vol_l, (int16)vol_r, (int16)vol_l, (int16)vol_r };
+	const int16x4_t vol = vld1_s16(volPairs);
+
+	// Four sample pairs per iteration
+	for (st_size_t blocks = frames / 4; blocks > 0; --blocks) {
+		const int16x8_t in = vld1q_s16(ibuf);
+
+		// Widening multiplication of the samples with the volume
+		int32x4_t p0 = vmull_s16(vget_low_s16(in), vol);
+		int32x4_t p1 = vmull_s16(vget_high_s16(in), vol);
+
+		// Divide by kMaxMixerVolume. Negative values are biased by 255 first,
+		// so that this rounds towards zero just like the integer division in
+		// mixStereoSamplesGeneric() does.
+		p0 = vshrq_n_s32(vaddq_s32(p0, vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(p0, 31)), 24))), 8);
+		p1 = vshrq_n_s32(vaddq_s32(p1, vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(p1, 31)), 24))), 8);
+
+		// The scaled samples always fit into 16 bits, so the only clamping
+		// happens in the saturating add
+		const int16x8_t scaled = vcombine_s16(vmovn_s32(p0), vmovn_s32(p1));
+		vst1q_s16(obuf, vqaddq_s16(vld1q_s16(obuf), scaled));
+
+		ibuf += 8;
+		obuf += 8;
+	}
+
+	mixStereoSamplesGeneric(obuf, ibuf, frames % 4, vol_l, vol_r);
+}
+
+} // End of namespace Audio
@@ -0,0 +1,63 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <emmintrin.h>
+
+#include "audio/rate_intern.h"
+#include "audio/mixer.h"
+
+namespace Audio {
+
+void mixStereoSamplesSSE2(st_sample_t *obuf, const st_sample_t *ibuf, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+	STATIC_ASSERT(Audio::Mixer::kMaxMixerVolume == 256, mixer_volume_must_be_a_shift_by_8);
+
+	const __m128i vol = _mm_set_epi16(vol_r, vol_l, vol_r, vol_l, vol_r, vol_l, vol_r, vol_l);
+
+	// Four sample pairs per iteration
+	for (st_size_t blocks = frames / 4; blocks > 0; --blocks) {
+		const __m128i in = _mm_loadu_si128((const __m128i *)ibuf);
+
+		// Widening multiplication of the samples with the volume
+		const __m128i lo = _mm_mullo_epi16(in, vol);
+		const __m128i hi = _mm_mulhi_epi16(in, vol);
+		__m128i p0 = _mm_unpacklo_epi16(lo, hi);
+		__m128i p1 = _mm_unpackhi_epi16(lo, hi);
+
+		// Divide by kMaxMixerVolume. Negative values are biased by 255 first,
+		// so that this rounds towards zero just like the integer division in
+		// mixStereoSamplesGeneric() does.
+		p0 = _mm_srai_epi32(_mm_add_epi32(p0, _mm_srli_epi32(_mm_srai_epi32(p0, 31), 24)), 8);
+		p1 = _mm_srai_epi32(_mm_add_epi32(p1, _mm_srli_epi32(_mm_srai_epi32(p1, 31), 24)), 8);
+
+		// The scaled samples always fit into 16 bits, so the only clamping
+		// happens in the saturating add
+		const __m128i scaled = _mm_packs_epi32(p0, p1);
+		const __m128i out = _mm_loadu_si128((const __m128i *)obuf);
+		_mm_storeu_si128((__m128i *)obuf, _mm_adds_epi16(out, scaled));
+
+		ibuf += 8;
+		obuf += 8;
+	}
+
+	mixStereoSamplesGeneric(obuf, ibuf, frames % 4, vol_l, vol_r);
+}
+
+} // End of namespace Audio
@@ -172,6 +172,17 @@ public:
 	 */
 	virtual bool isWritable() const = 0;
 
+	/**
+	 * Retrieves the size and the time of last modification of the file
+	 * referred by this node, without opening it. The time is only meant to be
+	 * compared against other values returned by this method.
+	 *
+	 * The default implementation reports the information as unavailable.
+	 *
+	 * @return bool true if the information could be retrieved, false otherwise.
+	 */
+	virtual bool getFileInfo(int64 &size, int64 &modificationTime) const { return false; }
+
 
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
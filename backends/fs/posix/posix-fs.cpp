@@ -78,6 +78,17 @@ bool POSIXFilesystemNode::isWritable() const {
 	return retVal;
 }
 
+bool POSIXFilesystemNode::getFileInfo(int64 &size, int64 &modificationTime) const {
+	struct stat st;
+
+	if (stat(_path.c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+		return false;
+
+	size = st.st_size;
+	modificationTime = st.st_mtime;
+	return true;
+}
+
 void POSIXFilesystemNode::setFlags() {
 	struct stat st;
 
@@ -300,6 +311,12 @@ AbstractFSNode *POSIXFilesystemNode::getParent() const {
 }
 
 Common::SeekableReadStream *POSIXFilesystemNode::createReadStream() {
+#ifdef HAS_MMAP
+	PosixMmapStream *mappedStream = PosixMmapStream::makeFromPath(getPath());
+	if (mappedStream)
+		return mappedStream;
+#endif
+
 	return PosixIoStream::makeFromPath(getPath(), false);
 }
 
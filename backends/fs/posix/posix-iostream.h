@@ -44,4 +44,55 @@ public:
 	int64 size() const override;
 };
 
+#ifdef HAS_MMAP
+/**
+ * A read-only file stream backed by a memory mapping of the whole file.
+ *
+ * Reads are plain copies out of the mapping, seeks are free, and
+ * getBuffer() gives zero-copy access to the file contents.
+ *
+ * Accessing a mapping past the end of a file which was truncated meanwhile
+ * raises SIGBUS instead of failing the read. Only files which nobody has
+ * write permission for are mapped therefore: this excludes savefiles and
+ * anything else the game writes, and other processes would have to change
+ * the permissions of the file before they could truncate it.
+ */
+class PosixMmapStream final : public Common::SeekableReadStream {
+public:
+	/**
+	 * Files smaller than this are left to PosixIoStream, since mapping
+	 * them costs more than the buffered reads they would replace.
+	 */
+	static const int64 kMinMappedSize = 64 * 1024;
+
+	/**
+	 * Map the given file into memory.
+	 *
+	 * @return The new stream, or nullptr if the file is not a regular file,
+	 *         is writable, is smaller than kMinMappedSize or could not be
+	 *         mapped.
+	 */
+	static PosixMmapStream *makeFromPath(const Common::String &path);
+	~PosixMmapStream() override;
+
+	uint32 read(void *dataPtr, uint32 dataSize) override;
+	bool eos() const override { return _eos; }
+	void clearErr() override { _eos = false; }
+
+	int64 pos() const override { return _pos; }
+	int64 size() const override { return _size; }
+	bool seek(int64 offset, int whence = SEEK_SET) override;
+
+	const byte *getBuffer() const override { return _data; }
+
+private:
+	PosixMmapStream(const byte *data, uint32 size);
+
+	const byte *_data;
+	uint32 _size;
+	uint32 _pos;
+	bool _eos;
+};
+#endif
+
 #endif
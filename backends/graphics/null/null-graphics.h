@@ -23,10 +23,11 @@
 #define BACKENDS_GRAPHICS_NULL_H
 
 #include "backends/graphics/graphics.h"
+#include "graphics/surface.h"
 
 class NullGraphicsManager : public GraphicsManager {
 public:
-	virtual ~NullGraphicsManager() {}
+	virtual ~NullGraphicsManager() { _screen.free(); }
 
 	bool hasFeature(OSystem::Feature f) const override { return false; }
 	void setFeatureState(OSystem::Feature f, bool enable) override {}
@@ -51,6 +52,9 @@ public:
 		_width = width;
 		_height = height;
 		_format = format ? *format : Graphics::PixelFormat::createFormatCLUT8();
+		// Engines which draw into the locked screen need a real surface,
+		// even if nothing is ever displayed
+		_screen.create(width, height, _format);
 	}
 
 	int getScreenChangeID() const override { return 0; }
@@ -62,10 +66,16 @@ public:
 	int16 getWidth() const override { return _width; }
 	void setPalette(const byte *colors, uint start, uint num) override {}
 	void grabPalette(byte *colors, uint start, uint num) const override {}
-	void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) override {}
-	Graphics::Surface *lockScreen() override { return NULL; }
+	void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) override {
+		if (_screen.getPixels())
+			_screen.copyRectToSurface(buf, pitch, x, y, w, h);
+	}
+	Graphics::Surface *lockScreen() override { return _screen.getPixels() ? &_screen : NULL; }
 	void unlockScreen() override {}
-	void fillScreen(uint32 col) override {}
+	void fillScreen(uint32 col) override {
+		if (_screen.getPixels())
+			_screen.fillRect(Common::Rect(_screen.w, _screen.h), col);
+	}
 	void updateScreen() override {}
 	void setShakePos(int shakeXOffset, int shakeYOffset) override {}
 	void setFocusRectangle(const Common::Rect& rect) override {}
@@ -89,6 +99,7 @@ public:
 private:
 	uint _width, _height;
 	Graphics::PixelFormat _format;
+	Graphics::Surface _screen;
 	bool _overlayVisible;
 };
 
@@ -25,6 +25,7 @@ MODULE_OBJS := \
 	midi/timidity.o \
 	saves/savefile.o \
 	saves/default/default-saves.o \
+	threads/default/default-threadpool.o \
 	timer/default/default-timer.o
 
 ifdef USE_CLOUD
@@ -147,6 +148,7 @@ MODULE_OBJS += \
 	mixer/sdl/sdl-mixer.o \
 	mutex/sdl/sdl-mutex.o \
 	plugins/sdl/sdl-provider.o \
+	threads/sdl/sdl-threadpool.o \
 	timer/sdl/sdl-timer.o
 
 # SDL 2 removed audio CD support
@@ -348,6 +350,11 @@ endif
 ifeq ($(BACKEND),null)
 MODULE_OBJS += \
 	mixer/null/null-mixer.o
+ifdef HAS_PTHREAD
+MODULE_OBJS += \
+	mutex/pthread/pthread-mutex.o \
+	threads/pthread/pthread-threadpool.o
+endif
 endif
 
 ifeq ($(BACKEND),opendingux)
@@ -404,8 +411,11 @@ endif
 
 ifdef ENABLE_EVENTRECORDER
 MODULE_OBJS += \
-	mixer/null/null-mixer.o \
 	saves/recorder/recorder-saves.o
+ifneq ($(BACKEND),null)
+MODULE_OBJS += \
+	mixer/null/null-mixer.o
+endif
 endif
 
 # Include common rules
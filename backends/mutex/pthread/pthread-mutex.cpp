@@ -23,7 +23,7 @@
 
 #include "common/scummsys.h"
 
-#if defined(__ANDROID__) || defined(IPHONE)
+#if defined(__ANDROID__) || defined(IPHONE) || defined(HAS_PTHREAD)
 
 #include "backends/mutex/pthread/pthread-mutex.h"
 
@@ -48,16 +48,26 @@ typedef void (*sighandler_t)(int);
 
 #if defined(USE_NULL_DRIVER)
 #include "backends/modular-backend.h"
+#include "backends/graphics/null/null-graphics.h"
 #include "backends/mutex/null/null-mutex.h"
 #include "base/main.h"
 
+#ifdef HAS_PTHREAD
+#include "backends/mutex/pthread/pthread-mutex.h"
+#include "backends/threads/pthread/pthread-threadpool.h"
+#endif
+
 #ifndef NULL_DRIVER_USE_FOR_TEST
 #include "backends/saves/default/default-saves.h"
 #include "backends/timer/default/default-timer.h"
 #include "backends/events/default/default-events.h"
 #include "backends/mixer/null/null-mixer.h"
-#include "backends/graphics/null/null-graphics.h"
 #include "gui/debugger.h"
+
+#ifdef ENABLE_EVENTRECORDER
+#include "common/config-manager.h"
+#include "gui/EventRecorder.h"
+#endif
 #endif
 
 /*
@@ -85,10 +95,19 @@ public:
 	virtual bool pollEvent(Common::Event &event);
 
 	virtual Common::MutexInternal *createMutex();
+#ifdef HAS_PTHREAD
+	virtual Common::ThreadPoolInternal *createThreadPool(uint numThreads);
+#endif
 	virtual uint32 getMillis(bool skipRecord = false);
 	virtual void delayMillis(uint msecs);
 	virtual void getTimeAndDate(TimeDate &td, bool skipRecord = false) const;
 
+#if defined(ENABLE_EVENTRECORDER) && !defined(NULL_DRIVER_USE_FOR_TEST)
+	virtual MixerManager *getMixerManager();
+	virtual Common::TimerManager *getTimerManager();
+	virtual Common::SaveFileManager *getSavefileManager();
+#endif
+
 	virtual void quit();
 
 	virtual void logMessage(LogMessageType::Type type, const char *message);
@@ -101,6 +120,11 @@ private:
 #elif defined(WIN32)
 	DWORD _startTime;
 #endif
+
+#if defined(ENABLE_EVENTRECORDER) && !defined(NULL_DRIVER_USE_FOR_TEST)
+	/** Real time in microseconds, used to benchmark replays */
+	static uint64 getBenchmarkMicros();
+#endif
 };
 
 OSystem_NULL::OSystem_NULL() {
@@ -117,6 +141,12 @@ OSystem_NULL::OSystem_NULL() {
 	#else
 		#error Unknown and unsupported FS backend
 	#endif
+
+#ifdef NULL_DRIVER_USE_FOR_TEST
+	// The tests do not initialize the backend, but video decoders need
+	// to know the screen format
+	_graphicsManager = new NullGraphicsManager();
+#endif
 }
 
 OSystem_NULL::~OSystem_NULL() {
@@ -145,13 +175,22 @@ void OSystem_NULL::initBackend() {
 	last_handler = signal(SIGINT, intHandler);
 #endif
 
-	_timerManager = new DefaultTimerManager();
 	_eventManager = new DefaultEventManager(this);
 	_savefileManager = new DefaultSaveFileManager();
 	_graphicsManager = new NullGraphicsManager();
 	_mixerManager = new NullMixerManager();
 	// Setup and start mixer
 	_mixerManager->init();
+
+#ifdef ENABLE_EVENTRECORDER
+	g_eventRec.registerMixerManager(_mixerManager);
+	g_eventRec.registerTimerManager(new DefaultTimerManager());
+
+	if (!ConfMan.get("benchmark_replay").empty())
+		g_eventRec.setBenchmarkClock(getBenchmarkMicros);
+#else
+	_timerManager = new DefaultTimerManager();
+#endif
 #endif
 
 	BaseBackend::initBackend();
@@ -185,25 +224,47 @@ bool OSystem_NULL::pollEvent(Common::Event &event) {
 }
 
 Common::MutexInternal *OSystem_NULL::createMutex() {
+#ifdef HAS_PTHREAD
+	// Tasks of the thread pool need working mutexes
+	return createPthreadMutexInternal();
+#else
 	return new NullMutexInternal();
+#endif
 }
 
+#ifdef HAS_PTHREAD
+Common::ThreadPoolInternal *OSystem_NULL::createThreadPool(uint numThreads) {
+	return createPthreadThreadPoolInternal(numThreads);
+}
+#endif
+
 uint32 OSystem_NULL::getMillis(bool skipRecord) {
 #ifdef POSIX
 	timeval curTime;
 
 	gettimeofday(&curTime, 0);
 
-	return (uint32)(((curTime.tv_sec - _startTime.tv_sec) * 1000) +
+	uint32 millis = (uint32)(((curTime.tv_sec - _startTime.tv_sec) * 1000) +
 			((curTime.tv_usec - _startTime.tv_usec) / 1000));
 #elif defined(WIN32)
-	return GetTickCount() - _startTime;
+	uint32 millis = GetTickCount() - _startTime;
 #else
-	return 0;
+	uint32 millis = 0;
+#endif
+
+#if defined(ENABLE_EVENTRECORDER) && !defined(NULL_DRIVER_USE_FOR_TEST)
+	g_eventRec.processMillis(millis, skipRecord);
 #endif
+
+	return millis;
 }
 
 void OSystem_NULL::delayMillis(uint msecs) {
+#if defined(ENABLE_EVENTRECORDER) && !defined(NULL_DRIVER_USE_FOR_TEST)
+	if (g_eventRec.processDelayMillis())
+		return;
+#endif
+
 #ifdef POSIX
 	usleep(msecs * 1000);
 #elif defined(WIN32)
@@ -221,9 +282,47 @@ void OSystem_NULL::getTimeAndDate(TimeDate &td, bool skipRecord) const {
 	td.tm_mon = t.tm_mon;
 	td.tm_year = t.tm_year;
 	td.tm_wday = t.tm_wday;
+
+#if defined(ENABLE_EVENTRECORDER) && !defined(NULL_DRIVER_USE_FOR_TEST)
+	g_eventRec.processTimeAndDate(td, skipRecord);
+#endif
+}
+
+#if defined(ENABLE_EVENTRECORDER) && !defined(NULL_DRIVER_USE_FOR_TEST)
+MixerManager *OSystem_NULL::getMixerManager() {
+	return g_eventRec.getMixerManager();
 }
 
+Common::TimerManager *OSystem_NULL::getTimerManager() {
+	return g_eventRec.getTimerManager();
+}
+
+Common::SaveFileManager *OSystem_NULL::getSavefileManager() {
+	return g_eventRec.getSaveManager(_savefileManager);
+}
+
+uint64 OSystem_NULL::getBenchmarkMicros() {
+#ifdef POSIX
+	timeval curTime;
+	gettimeofday(&curTime, 0);
+	return (uint64)curTime.tv_sec * 1000000 + curTime.tv_usec;
+#elif defined(WIN32)
+	LARGE_INTEGER counter, frequency;
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+	return (uint64)(counter.QuadPart / frequency.QuadPart * 1000000 +
+			counter.QuadPart % frequency.QuadPart * 1000000 / frequency.QuadPart);
+#else
+	return 0;
+#endif
+}
+#endif
+
 void OSystem_NULL::quit() {
+#if defined(ENABLE_EVENTRECORDER) && !defined(NULL_DRIVER_USE_FOR_TEST)
+	// The playback ends by quitting once the recording runs out of events
+	g_eventRec.writeBenchmarkReport();
+#endif
 	exit(0);
 }
 
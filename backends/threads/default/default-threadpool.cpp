@@ -0,0 +1,79 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "backends/threads/default/default-threadpool.h"
+
+DefaultThreadPoolInternal::DefaultThreadPoolInternal() : _numThreads(0), _quit(false) {
+}
+
+void DefaultThreadPoolInternal::submit(Common::ThreadPoolTask *task) {
+	lock();
+	_queue.push_back(task);
+	signalCondition(kConditionWork);
+	unlock();
+}
+
+void DefaultThreadPoolInternal::wait(Common::ThreadPoolTask *task) {
+	lock();
+	while (!task->isDone()) {
+		// Help out instead of just blocking. This also keeps tasks which
+		// wait for other tasks from starving the pool.
+		if (!_queue.empty()) {
+			Common::ThreadPoolTask *next = _queue.front();
+			_queue.pop_front();
+			runLocked(next);
+		} else {
+			waitCondition(kConditionDone);
+		}
+	}
+	unlock();
+}
+
+void DefaultThreadPoolInternal::workerLoop() {
+	lock();
+	for (;;) {
+		while (_queue.empty() && !_quit)
+			waitCondition(kConditionWork);
+
+		if (_queue.empty())
+			break;
+
+		Common::ThreadPoolTask *task = _queue.front();
+		_queue.pop_front();
+		runLocked(task);
+	}
+	unlock();
+}
+
+void DefaultThreadPoolInternal::shutdown() {
+	lock();
+	_quit = true;
+	broadcastCondition(kConditionWork);
+	unlock();
+}
+
+void DefaultThreadPoolInternal::runLocked(Common::ThreadPoolTask *task) {
+	unlock();
+	task->execute();
+	lock();
+	broadcastCondition(kConditionDone);
+}
@@ -0,0 +1,75 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef BACKENDS_THREADS_DEFAULT_H
+#define BACKENDS_THREADS_DEFAULT_H
+
+#include "common/list.h"
+#include "common/threadpool.h"
+
+/**
+ * Task queue shared by the thread pool implementations. Subclasses provide
+ * a lock with two condition variables, start the worker threads, which
+ * have to call workerLoop(), and call shutdown() in their destructor before
+ * joining the threads.
+ */
+class DefaultThreadPoolInternal : public Common::ThreadPoolInternal {
+public:
+	DefaultThreadPoolInternal();
+
+	uint getThreadCount() const override { return _numThreads; }
+	void submit(Common::ThreadPoolTask *task) override;
+	void wait(Common::ThreadPoolTask *task) override;
+
+protected:
+	enum Condition {
+		/** Signaled when a task gets queued or the pool shuts down */
+		kConditionWork,
+		/** Broadcast when a task is done */
+		kConditionDone
+	};
+
+	virtual void lock() = 0;
+	virtual void unlock() = 0;
+
+	/** Wait for a condition. The lock must be held, and is held again on return. */
+	virtual void waitCondition(Condition cond) = 0;
+	virtual void signalCondition(Condition cond) = 0;
+	virtual void broadcastCondition(Condition cond) = 0;
+
+	/** Run queued tasks until shutdown() is called. */
+	void workerLoop();
+
+	/** Run the remaining tasks and make the worker threads leave workerLoop(). */
+	void shutdown();
+
+	uint _numThreads;
+
+private:
+	/** Run a task. Must be called with the lock held, returns with it held. */
+	void runLocked(Common::ThreadPoolTask *task);
+
+	Common::List<Common::ThreadPoolTask *> _queue;
+	bool _quit;
+};
+
+#endif
@@ -0,0 +1,116 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+#define FORBIDDEN_SYMBOL_EXCEPTION_unistd_h
+
+#include "common/scummsys.h"
+
+#if defined(HAS_PTHREAD)
+
+#include "backends/threads/pthread/pthread-threadpool.h"
+#include "backends/threads/default/default-threadpool.h"
+#include "common/array.h"
+#include "common/textconsole.h"
+
+#include <pthread.h>
+#include <unistd.h>
+
+/**
+ * pthreads thread pool implementation
+ */
+class PthreadThreadPoolInternal final : public DefaultThreadPoolInternal {
+public:
+	PthreadThreadPoolInternal();
+	~PthreadThreadPoolInternal() override;
+
+	/** Start the worker threads, returns false if not even one could be started. */
+	bool start(uint numThreads);
+
+protected:
+	void lock() override { pthread_mutex_lock(&_mutex); }
+	void unlock() override { pthread_mutex_unlock(&_mutex); }
+
+	void waitCondition(Condition cond) override { pthread_cond_wait(&_conditions[cond], &_mutex); }
+	void signalCondition(Condition cond) override { pthread_cond_signal(&_conditions[cond]); }
+	void broadcastCondition(Condition cond) override { pthread_cond_broadcast(&_conditions[cond]); }
+
+private:
+	static void *threadMain(void *pool);
+
+	pthread_mutex_t _mutex;
+	pthread_cond_t _conditions[2];
+	Common::Array<pthread_t> _threads;
+};
+
+PthreadThreadPoolInternal::PthreadThreadPoolInternal() {
+	pthread_mutex_init(&_mutex, nullptr);
+	pthread_cond_init(&_conditions[kConditionWork], nullptr);
+	pthread_cond_init(&_conditions[kConditionDone], nullptr);
+}
+
+PthreadThreadPoolInternal::~PthreadThreadPoolInternal() {
+	shutdown();
+	for (uint i = 0; i < _threads.size(); ++i)
+		pthread_join(_threads[i], nullptr);
+
+	pthread_cond_destroy(&_conditions[kConditionWork]);
+	pthread_cond_destroy(&_conditions[kConditionDone]);
+	pthread_mutex_destroy(&_mutex);
+}
+
+bool PthreadThreadPoolInternal::start(uint numThreads) {
+	for (uint i = 0; i < numThreads; ++i) {
+		pthread_t thread;
+		if (pthread_create(&thread, nullptr, threadMain, this) != 0) {
+			warning("pthread_create() failed");
+			break;
+		}
+		_threads.push_back(thread);
+	}
+
+	_numThreads = _threads.size();
+	return _numThreads != 0;
+}
+
+void *PthreadThreadPoolInternal::threadMain(void *pool) {
+	((PthreadThreadPoolInternal *)pool)->workerLoop();
+	return nullptr;
+}
+
+Common::ThreadPoolInternal *createPthreadThreadPoolInternal(uint numThreads) {
+	if (numThreads == 0) {
+		const long cores = sysconf(_SC_NPROCESSORS_ONLN);
+		if (cores <= 1)
+			return nullptr;
+		numThreads = cores;
+	}
+
+	PthreadThreadPoolInternal *pool = new PthreadThreadPoolInternal();
+	if (!pool->start(numThreads)) {
+		delete pool;
+		return nullptr;
+	}
+	return pool;
+}
+
+#endif
@@ -0,0 +1,123 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#if defined(SDL_BACKEND)
+
+#include "backends/threads/sdl/sdl-threadpool.h"
+#include "backends/threads/default/default-threadpool.h"
+#include "backends/platform/sdl/sdl-sys.h"
+#include "common/array.h"
+#include "common/textconsole.h"
+
+/**
+ * SDL thread pool implementation
+ */
+class SdlThreadPoolInternal final : public DefaultThreadPoolInternal {
+public:
+	SdlThreadPoolInternal();
+	~SdlThreadPoolInternal() override;
+
+	/** Start the worker threads, returns false if not even one could be started. */
+	bool start(uint numThreads);
+
+protected:
+	void lock() override { SDL_LockMutex(_mutex); }
+	void unlock() override { SDL_UnlockMutex(_mutex); }
+
+	void waitCondition(Condition cond) override { SDL_CondWait(_conditions[cond], _mutex); }
+	void signalCondition(Condition cond) override { SDL_CondSignal(_conditions[cond]); }
+	void broadcastCondition(Condition cond) override { SDL_CondBroadcast(_conditions[cond]); }
+
+private:
+	static int SDLCALL threadMain(void *pool);
+
+	SDL_mutex *_mutex;
+	SDL_cond *_conditions[2];
+	Common::Array<SDL_Thread *> _threads;
+};
+
+SdlThreadPoolInternal::SdlThreadPoolInternal() {
+	_mutex = SDL_CreateMutex();
+	_conditions[kConditionWork] = SDL_CreateCond();
+	_conditions[kConditionDone] = SDL_CreateCond();
+}
+
+SdlThreadPoolInternal::~SdlThreadPoolInternal() {
+	shutdown();
+	for (uint i = 0; i < _threads.size(); ++i)
+		SDL_WaitThread(_threads[i], nullptr);
+
+	SDL_DestroyCond(_conditions[kConditionWork]);
+	SDL_DestroyCond(_conditions[kConditionDone]);
+	SDL_DestroyMutex(_mutex);
+}
+
+bool SdlThreadPoolInternal::start(uint numThreads) {
+	if (!_mutex || !_conditions[kConditionWork] || !_conditions[kConditionDone])
+		return false;
+
+	for (uint i = 0; i < numThreads; ++i) {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+		SDL_Thread *thread = SDL_CreateThread(threadMain, "ScummVM worker", this);
+#else
+		SDL_Thread *thread = SDL_CreateThread(threadMain, this);
+#endif
+		if (!thread) {
+			warning("SDL_CreateThread() failed: %s", SDL_GetError());
+			break;
+		}
+		_threads.push_back(thread);
+	}
+
+	_numThreads = _threads.size();
+	return _numThreads != 0;
+}
+
+int SDLCALL SdlThreadPoolInternal::threadMain(void *pool) {
+	((SdlThreadPoolInternal *)pool)->workerLoop();
+	return 0;
+}
+
+Common::ThreadPoolInternal *createSdlThreadPoolInternal(uint numThreads) {
+	if (numThreads == 0) {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+		const int cores = SDL_GetCPUCount();
+		if (cores <= 1)
+			return nullptr;
+		numThreads = cores;
+#else
+		// SDL 1.2 cannot tell the number of cores
+		return nullptr;
+#endif
+	}
+
+	SdlThreadPoolInternal *pool = new SdlThreadPoolInternal();
+	if (!pool->start(numThreads)) {
+		delete pool;
+		return nullptr;
+	}
+	return pool;
+}
+
+#endif
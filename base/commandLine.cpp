@@ -190,6 +190,8 @@ static const char HELP_STRING4[] =
 	"  --screenshot-period=NUM  When recording, trigger a screenshot every NUM milliseconds\n"
 	"                           (default: 60000)\n"
 	"  --list-records           Display a list of recordings for the target specified\n"
+	"  --benchmark-replay=FILE  Replay a recording as fast as possible and print the\n"
+	"                           time taken by each frame as JSON (null backend only)\n"
 #endif
 	"\n"
 #if defined(ENABLE_SKY) || defined(ENABLE_QUEEN)
@@ -294,6 +296,9 @@ void registerDefaults() {
 	ConfMan.registerDefault("speech_mute", false);
 	ConfMan.registerDefault("mute", false);
 
+	ConfMan.registerDefault("audio_resampler", "default");
+	ConfMan.registerDefault("audio_wide_mix_bus", false);
+
 	ConfMan.registerDefault("multi_midi", false);
 	ConfMan.registerDefault("native_mt32", false);
 	ConfMan.registerDefault("dump_midi", false);
@@ -706,6 +711,9 @@ Common::String parseCommandLine(Common::StringMap &settings, int argc, const cha
 
 			DO_LONG_OPTION_INT("screenshot-period")
 			END_OPTION
+
+			DO_LONG_OPTION("benchmark-replay")
+			END_OPTION
 #endif
 
 			DO_LONG_OPTION("opl-driver")
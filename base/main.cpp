@@ -596,8 +596,11 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 #ifdef ENABLE_EVENTRECORDER
 			Common::String recordMode = ConfMan.get("record_mode");
 			Common::String recordFileName = ConfMan.get("record_file_name");
+			Common::String benchmarkFileName = ConfMan.get("benchmark_replay");
 
-			if (recordMode == "record") {
+			if (!benchmarkFileName.empty()) {
+				g_eventRec.init(benchmarkFileName, GUI::EventRecorder::kRecorderPlayback);
+			} else if (recordMode == "record") {
 				Common::String targetFileName = ConfMan.hasKey("record_file_name") ? recordFileName : g_eventRec.generateRecordFileName(ConfMan.getActiveDomainName());
 				g_eventRec.init(targetFileName, GUI::EventRecorder::kRecorderRecord);
 			} else if (recordMode == "update") {
@@ -741,6 +741,8 @@ DetectionResults EngineManager::detectGames(const Common::FSList &fslist, uint32
 		}
 	}
 
+	MD5Man.flushPersistent();
+
 	return DetectionResults(candidates);
 }
 
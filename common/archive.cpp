@@ -61,6 +61,14 @@ int Archive::listMatchingMembers(ArchiveMemberList &list, const Path &pattern) c
 }
 
 
+namespace {
+
+uint32 lastSearchSetGeneration = 0;
+
+} // End of anonymous namespace
+
+SearchSet::SearchSet() : _ignoreClashes(false), _nestedSets(0), _generation(0), _lookupCacheGeneration(0) {
+}
 
 SearchSet::ArchiveNodeList::iterator SearchSet::find(const String &name) {
 	ArchiveNodeList::iterator it = _list.begin();
@@ -92,12 +100,15 @@ void SearchSet::insert(const Node &node) {
 			break;
 	}
 	_list.insert(it, node);
+	if (node._set)
+		_nestedSets++;
 }
 
 void SearchSet::add(const String &name, Archive *archive, int priority, bool autoFree) {
 	if (find(name) == _list.end()) {
 		Node node(priority, name, archive, autoFree);
 		insert(node);
+		updateGeneration();
 	} else {
 		if (autoFree)
 			delete archive;
@@ -170,9 +181,12 @@ void SearchSet::addSubDirectoriesMatching(const FSNode &directory, String origPa
 void SearchSet::remove(const String &name) {
 	ArchiveNodeList::iterator it = find(name);
 	if (it != _list.end()) {
+		if (it->_set)
+			_nestedSets--;
 		if (it->_autoFree)
 			delete it->_arc;
 		_list.erase(it);
+		updateGeneration();
 	}
 }
 
@@ -187,6 +201,8 @@ void SearchSet::clear() {
 	}
 
 	_list.clear();
+	_nestedSets = 0;
+	updateGeneration();
 }
 
 void SearchSet::setPriority(const String &name, int priority) {
@@ -200,22 +216,71 @@ void SearchSet::setPriority(const String &name, int priority) {
 		return;
 
 	Node node(*it);
+	if (node._set)
+		_nestedSets--;
 	_list.erase(it);
 	node._priority = priority;
 	insert(node);
+	updateGeneration();
 }
 
-bool SearchSet::hasFile(const Path &path) const {
-	if (path.empty())
-		return false;
+void SearchSet::updateGeneration() {
+	_generation = ++lastSearchSetGeneration;
+}
+
+uint32 SearchSet::getGeneration() const {
+	uint32 generation = _generation;
+	if (_nestedSets) {
+		ArchiveNodeList::const_iterator it = _list.begin();
+		for (; it != _list.end(); ++it) {
+			if (it->_set)
+				generation = MAX(generation, it->_set->getGeneration());
+		}
+	}
+	return generation;
+}
+
+Archive *SearchSet::findArchive(const Path &path) const {
+	Archive *archive = nullptr;
+	if (lookupCached(path, archive))
+		return archive;
 
 	ArchiveNodeList::const_iterator it = _list.begin();
 	for (; it != _list.end(); ++it) {
-		if (it->_arc->hasFile(path))
-			return true;
+		if (it->_arc->hasFile(path)) {
+			archive = it->_arc;
+			break;
+		}
+	}
+
+	cacheLookup(path, archive);
+	return archive;
+}
+
+bool SearchSet::lookupCached(const Path &path, Archive *&archive) const {
+	const uint32 generation = getGeneration();
+	if (generation != _lookupCacheGeneration) {
+		// This set or one nested in it changed
+		_lookupCache.clear();
+		_lookupCacheGeneration = generation;
+		return false;
 	}
+	return _lookupCache.tryGetVal(path, archive);
+}
+
+void SearchSet::cacheLookup(const Path &path, Archive *archive) const {
+	// Simply start over instead of letting the cache grow without bounds
+	if (_lookupCache.size() >= kMaxLookupCacheSize)
+		_lookupCache.clear();
+
+	_lookupCache[path] = archive;
+}
 
-	return false;
+bool SearchSet::hasFile(const Path &path) const {
+	if (path.empty())
+		return false;
+
+	return findArchive(path) != nullptr;
 }
 
 int SearchSet::listMatchingMembers(ArchiveMemberList &list, const Path &pattern) const {
@@ -242,11 +307,9 @@ const ArchiveMemberPtr SearchSet::getMember(const Path &path) const {
 	if (path.empty())
 		return ArchiveMemberPtr();
 
-	ArchiveNodeList::const_iterator it = _list.begin();
-	for (; it != _list.end(); ++it) {
-		if (it->_arc->hasFile(path))
-			return it->_arc->getMember(path);
-	}
+	Archive *archive = findArchive(path);
+	if (archive)
+		return archive->getMember(path);
 
 	return ArchiveMemberPtr();
 }
@@ -255,13 +318,27 @@ SeekableReadStream *SearchSet::createReadStreamForMember(const Path &path) const
 	if (path.empty())
 		return nullptr;
 
+	Archive *archive = nullptr;
+	if (lookupCached(path, archive)) {
+		if (!archive)
+			return nullptr;
+
+		SeekableReadStream *stream = archive->createReadStreamForMember(path);
+		if (stream)
+			return stream;
+	}
+
+	// Not cached, or the cached archive failed to open the file after all
 	ArchiveNodeList::const_iterator it = _list.begin();
 	for (; it != _list.end(); ++it) {
 		SeekableReadStream *stream = it->_arc->createReadStreamForMember(path);
-		if (stream)
+		if (stream) {
+			cacheLookup(path, it->_arc);
 			return stream;
+		}
 	}
 
+	cacheLookup(path, nullptr);
 	return nullptr;
 }
 
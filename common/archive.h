@@ -23,6 +23,7 @@
 #define COMMON_ARCHIVE_H
 
 #include "common/str.h"
+#include "common/flat-hashmap.h"
 #include "common/list.h"
 #include "common/path.h"
 #include "common/ptr.h"
@@ -153,9 +154,10 @@ class SearchSet : public Archive {
 		int		_priority;
 		String	_name;
 		Archive	*_arc;
+		const SearchSet *_set;	//!< _arc if it is a SearchSet itself, nullptr otherwise
 		bool	_autoFree;
 		Node(int priority, const String &name, Archive *arc, bool autoFree)
-			: _priority(priority), _name(name), _arc(arc), _autoFree(autoFree) {
+			: _priority(priority), _name(name), _arc(arc), _set(dynamic_cast<const SearchSet *>(arc)), _autoFree(autoFree) {
 		}
 	};
 	typedef List<Node> ArchiveNodeList;
@@ -168,8 +170,49 @@ class SearchSet : public Archive {
 
 	bool _ignoreClashes;
 
+	enum {
+		kMaxLookupCacheSize = 4096
+	};
+
+	/** Number of archives in _list which are SearchSets themselves. */
+	uint _nestedSets;
+
+	/**
+	 * Changes whenever the archives or their order change. The values are
+	 * taken from a counter shared by all sets, so that getGeneration() never
+	 * returns the same value again once anything changed.
+	 */
+	uint32 _generation;
+
+	/**
+	 * The archive which contains a path, or nullptr if none of them does.
+	 * Keys are compared case-sensitively, since archives are free to do so.
+	 * This is dropped whenever getGeneration() changes, so files appear and
+	 * disappear with the archives containing them. The archives are expected
+	 * to keep their contents while they are in the set, as FSDirectory only
+	 * lists its directory once. Like the archives, which may cache their
+	 * contents on lookup too, this is not thread safe.
+	 */
+	typedef FlatHashMap<Path, Archive *, Path::IgnoreCase_Hash> LookupCache;
+	mutable LookupCache _lookupCache;
+	mutable uint32 _lookupCacheGeneration;
+
+	/** Give this set a new generation, after its archives or their order changed. */
+	void updateGeneration();
+
+	/**
+	 * Return the generation of this set and of all sets nested in it. It
+	 * changes whenever any of them changes.
+	 */
+	uint32 getGeneration() const;
+
+	/** Return the first archive containing the given path, or nullptr if there is none. */
+	Archive *findArchive(const Path &path) const;
+	bool lookupCached(const Path &path, Archive *&archive) const;
+	void cacheLookup(const Path &path, Archive *archive) const;
+
 public:
-	SearchSet() : _ignoreClashes(false) { }
+	SearchSet();
 	virtual ~SearchSet() { clear(); }
 
 	/**
@@ -0,0 +1,112 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_ATOMIC_H
+#define COMMON_ATOMIC_H
+
+#include "common/noncopyable.h"
+#include "common/scummsys.h"
+
+#include <atomic>
+
+namespace Common {
+
+/**
+ * @defgroup common_atomic Atomic variables
+ * @ingroup common
+ *
+ * @brief Variables which can be shared between threads without locking.
+ *
+ * Code should get its atomics from here rather than from <atomic>, so that
+ * a port whose toolchain lacks them only has to replace this header.
+ * @{
+ */
+
+/** Ordering constraints of an atomic operation, see std::memory_order. */
+enum MemoryOrder {
+	kMemoryOrderRelaxed,
+	kMemoryOrderAcquire,
+	kMemoryOrderRelease,
+	kMemoryOrderAcquireRelease,
+	kMemoryOrderSequential
+};
+
+namespace Internal {
+
+inline std::memory_order toStdMemoryOrder(MemoryOrder order) {
+	switch (order) {
+	case kMemoryOrderRelaxed:
+		return std::memory_order_relaxed;
+	case kMemoryOrderAcquire:
+		return std::memory_order_acquire;
+	case kMemoryOrderRelease:
+		return std::memory_order_release;
+	case kMemoryOrderAcquireRelease:
+		return std::memory_order_acq_rel;
+	default:
+		return std::memory_order_seq_cst;
+	}
+}
+
+} // End of namespace Internal
+
+/**
+ * A variable of an integral, boolean or pointer type whose operations are
+ * atomic.
+ */
+template<class T>
+class Atomic : NonCopyable {
+public:
+	Atomic() : _value(T()) {}
+	explicit Atomic(T value) : _value(value) {}
+
+	T load(MemoryOrder order = kMemoryOrderSequential) const {
+		return _value.load(Internal::toStdMemoryOrder(order));
+	}
+
+	void store(T value, MemoryOrder order = kMemoryOrderSequential) {
+		_value.store(value, Internal::toStdMemoryOrder(order));
+	}
+
+	/** Replace the value, and return the previous one. */
+	T exchange(T value, MemoryOrder order = kMemoryOrderSequential) {
+		return _value.exchange(value, Internal::toStdMemoryOrder(order));
+	}
+
+	/** Add to the value, and return the previous one. */
+	T fetchAdd(T value, MemoryOrder order = kMemoryOrderSequential) {
+		return _value.fetch_add(value, Internal::toStdMemoryOrder(order));
+	}
+
+private:
+	std::atomic<T> _value;
+};
+
+/** Order the memory accesses around this call, see std::atomic_thread_fence. */
+inline void atomicThreadFence(MemoryOrder order) {
+	std::atomic_thread_fence(Internal::toStdMemoryOrder(order));
+}
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -0,0 +1,133 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/dir-scanner.h"
+#include "common/algorithm.h"
+#include "common/threadpool.h"
+
+namespace Common {
+
+/**
+ * Lists a directory on a worker thread. The task works on its own node, so
+ * that no reference counts are shared with the scanning thread.
+ */
+class DirectoryScanner::ListTask : public ThreadPoolTask {
+public:
+	explicit ListTask(const FSNode &dir) : _dir(Path(String(dir.getPath().c_str()))), _success(false) {}
+
+	void run() override {
+		_success = _dir.getChildren(_contents, FSNode::kListAll);
+	}
+
+	FSNode _dir;
+	FSList _contents;
+	bool _success;
+};
+
+DirectoryScanner::DirectoryScanner(const FSNode &root, int maxDepth, ThreadPool *pool) :
+		_maxDepth(maxDepth), _pool(pool), _scannedCount(0), _foundCount(1) {
+	if (_pool && _pool->getThreadCount() == 0)
+		_pool = nullptr;
+
+	Job job;
+	job.dir = root;
+	job.depth = 0;
+	job.task = nullptr;
+	_queue.push_back(job);
+}
+
+DirectoryScanner::~DirectoryScanner() {
+	for (List<Job>::iterator i = _queue.begin(); i != _queue.end(); ++i) {
+		if (i->task) {
+			_pool->wait(i->task);
+			delete i->task;
+		}
+	}
+}
+
+bool DirectoryScanner::nextDirectory(FSNode &dir, FSList &contents) {
+	while (!_queue.empty()) {
+		const Job job = _queue.front();
+		_queue.pop_front();
+
+		contents.clear();
+		bool success;
+		if (job.task) {
+			_pool->wait(job.task);
+			success = job.task->_success;
+			contents = job.task->_contents;
+			delete job.task;
+		} else {
+			success = job.dir.getChildren(contents, FSNode::kListAll);
+		}
+
+		if (!success)
+			continue;
+
+		if (_maxDepth < 0 || job.depth < _maxDepth) {
+			FSList subdirs;
+			for (FSList::const_iterator i = contents.begin(); i != contents.end(); ++i) {
+				if (i->isDirectory())
+					subdirs.push_back(*i);
+			}
+			sort(subdirs.begin(), subdirs.end());
+
+			// Queue the subdirectories in front of everything else, in
+			// reverse since each goes to the front. The queued nodes are
+			// created anew, so that they share no reference counts with
+			// the contents handed out.
+			for (uint i = subdirs.size(); i-- > 0; ) {
+				Job subdirJob;
+				subdirJob.dir = FSNode(Path(String(subdirs[i].getPath().c_str())));
+				subdirJob.depth = job.depth + 1;
+				subdirJob.task = nullptr;
+				_queue.push_front(subdirJob);
+			}
+			_foundCount += subdirs.size();
+		}
+
+		prefetch();
+
+		dir = job.dir;
+		++_scannedCount;
+		return true;
+	}
+
+	return false;
+}
+
+void DirectoryScanner::prefetch() {
+	if (!_pool)
+		return;
+
+	// Keep every worker busy, with one more directory in line each
+	uint inFlight = 0;
+	const uint maxInFlight = _pool->getThreadCount() * 2;
+	for (List<Job>::iterator i = _queue.begin(); i != _queue.end() && inFlight < maxInFlight; ++i, ++inFlight) {
+		if (!i->task) {
+			i->task = new ListTask(i->dir);
+			_pool->submit(i->task);
+		}
+	}
+}
+
+} // End of namespace Common
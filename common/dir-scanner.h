@@ -0,0 +1,114 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef COMMON_DIR_SCANNER_H
+#define COMMON_DIR_SCANNER_H
+
+#include "common/fs.h"
+#include "common/list.h"
+#include "common/noncopyable.h"
+
+namespace Common {
+
+class ThreadPool;
+
+/**
+ * @defgroup common_dir_scanner Directory scanner
+ * @ingroup common
+ *
+ * @brief Depth first walk over a directory tree, e.g. for mass game detection.
+ *
+ * @{
+ */
+
+/**
+ * Walks a directory tree and hands out the contents of one directory at a
+ * time, so that the caller can process each of them in turn, for example by
+ * running the game detectors on it.
+ *
+ * Directories are handed out depth first, each one before its
+ * subdirectories, which are visited in the order of their names. The result
+ * of a scan therefore does not depend on the order in which the file system
+ * lists directory contents.
+ *
+ * With a thread pool, the directories next in line are listed ahead of time
+ * on the worker threads, while the caller processes the current one.
+ * Directories are still handed out in the same order.
+ *
+ * The nodes handed out share nothing with the nodes the scanner keeps, so
+ * the caller may pass them on to another thread.
+ */
+class DirectoryScanner : NonCopyable {
+public:
+	/**
+	 * Create a scanner for the directory tree below @p root.
+	 *
+	 * @param root      Directory to start the scan at. It is handed out first.
+	 * @param maxDepth  Number of subdirectory levels to descend into, or -1
+	 *                  to scan the whole tree.
+	 * @param pool      Optional thread pool for listing directories in advance.
+	 */
+	DirectoryScanner(const FSNode &root, int maxDepth = -1, ThreadPool *pool = nullptr);
+	~DirectoryScanner();
+
+	/**
+	 * Get the next directory along with the files and directories inside it.
+	 * Directories which cannot be listed are skipped.
+	 *
+	 * @return False once the whole tree has been scanned.
+	 */
+	bool nextDirectory(FSNode &dir, FSList &contents);
+
+	/** Return true if no more directories are left to scan. */
+	bool empty() const { return _queue.empty(); }
+
+	/** Return the number of directories handed out so far. */
+	uint getScannedCount() const { return _scannedCount; }
+
+	/** Return the number of directories found so far, including the ones already handed out. */
+	uint getFoundCount() const { return _foundCount; }
+
+private:
+	class ListTask;
+
+	struct Job {
+		FSNode dir;
+		int depth;
+		/** Listing of the directory running on the thread pool, if any */
+		ListTask *task;
+	};
+
+	/** Start listing the directories next in line on the thread pool. */
+	void prefetch();
+
+	List<Job> _queue;
+	const int _maxDepth;
+	ThreadPool *_pool;
+	uint _scannedCount;
+	uint _foundCount;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -132,6 +132,11 @@ int64 File::size() const {
 	return _handle->size();
 }
 
+const byte *File::getBuffer() const {
+	assert(_handle);
+	return _handle->getBuffer();
+}
+
 bool File::seek(int64 offs, int whence) {
 	assert(_handle);
 	return _handle->seek(offs, whence);
@@ -0,0 +1,650 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_FLAT_HASHMAP_H
+#define COMMON_FLAT_HASHMAP_H
+
+#include "common/hashmap.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_flat_hashmap Open addressing hash table (FlatHashMap)
+ * @ingroup common
+ *
+ * @brief API for operations on a hash table which stores its elements inline.
+ *
+ * @{
+ */
+
+/**
+ * FlatHashMap<Key,Val> is a drop-in replacement for HashMap<Key,Val> which
+ * stores the elements directly in the table instead of allocating a node for
+ * each of them. Collisions are resolved with Robin Hood hashing: the elements
+ * are kept ordered by their home position, so that a lookup can stop as soon
+ * as it reaches an element which is closer to its home position than the key
+ * would be. Erased elements are removed by shifting the following ones back,
+ * so no tombstones are left behind.
+ *
+ * This makes lookups touch far less memory than with HashMap, at the price of
+ * moving elements around when inserting or erasing. Keep in mind that:
+ * - references and pointers to keys and values are invalidated by inserting
+ *   or erasing other elements (HashMap keeps them valid until the element
+ *   itself is erased);
+ * - elements are copied when they are moved, so large values should rather
+ *   be stored by pointer;
+ * - erasing the element an iterator points to and then advancing the
+ *   iterator is fine, as with HashMap. Erasing other elements during the
+ *   iteration may make the iteration return an element twice.
+ */
+template<class Key, class Val, class HashFunc = Hash<Key>, class EqualFunc = EqualTo<Key> >
+class FlatHashMap {
+public:
+	typedef uint size_type;
+
+	struct Node {
+		Val _value;
+		const Key _key;
+		explicit Node(const Key &key) : _value(), _key(key) {}
+		Node(const Key &key, const Val &value) : _value(value), _key(key) {}
+	};
+
+private:
+
+	typedef FlatHashMap<Key, Val, HashFunc, EqualFunc> HM_t;
+
+	enum {
+		FLATHASHMAP_MIN_CAPACITY = 16,
+
+		// The probe distance is stored in a byte, see _dist
+		FLATHASHMAP_MAX_DISTANCE = 254,
+
+		// The quotient of the next two constants controls how much the
+		// internal storage of the hashmap may fill up before being
+		// increased automatically.
+		FLATHASHMAP_LOADFACTOR_NUMERATOR = 7,
+		FLATHASHMAP_LOADFACTOR_DENOMINATOR = 8
+	};
+
+	/** Default value, returned by the const getVal. */
+	Val _defaultVal;
+
+	Node *_nodes;         ///< The elements; only slots with a non-zero _dist are constructed.
+	byte *_dist;          ///< Probe distance plus one of each slot, 0 for empty slots.
+	size_type *_hashes;   ///< Hash of the key in each slot, to avoid comparing keys and to rehash quickly.
+	size_type _capacity;  ///< Number of home positions; must be a power of two.
+	size_type _maxDist;   ///< Largest probe distance allowed.
+	size_type _slots;     ///< Number of slots, i.e. _capacity + _maxDist. There is one more _dist entry, which is always 0.
+	size_type _shift;     ///< Shift to get the home position from a mixed hash.
+	size_type _size;
+
+	HashFunc _hash;
+	EqualFunc _equal;
+
+	size_type homePosition(size_type hash) const {
+		// Fibonacci hashing, so that hash functions which are weak in the
+		// lower bits (like the identity for integers) still spread well.
+		return (size_type)((uint32)hash * 0x9E3779B1U) >> _shift;
+	}
+
+	void allocStorage(size_type capacity);
+	void freeStorage();
+	void assign(const HM_t &map);
+	size_type lookup(const Key &key) const { return lookup(key, _hash(key)); }
+	size_type lookup(const Key &key, size_type hash) const;
+	size_type lookupAndCreateIfMissing(const Key &key);
+	bool insertNew(size_type hash, const Key &key, const Val *val, size_type &pos);
+	void moveNode(size_type from, size_type to);
+	void eraseAt(size_type pos);
+	void expandStorage(size_type newCapacity);
+
+	template<class T> friend class IteratorImpl;
+
+	/**
+	 * Simple FlatHashMap iterator implementation. Iterates from the last slot
+	 * to the first one, so that the elements moved back when erasing the
+	 * current element have already been visited.
+	 */
+	template<class NodeType>
+	class IteratorImpl {
+		friend class FlatHashMap;
+		template<class T> friend class IteratorImpl;
+	protected:
+		typedef const FlatHashMap hashmap_t;
+
+		size_type _idx;
+		hashmap_t *_hashmap;
+
+	protected:
+		IteratorImpl(size_type idx, hashmap_t *hashmap) : _idx(idx), _hashmap(hashmap) {}
+
+		NodeType *deref() const {
+			assert(_hashmap != nullptr);
+			assert(_idx < _hashmap->_slots);
+			assert(_hashmap->_dist[_idx] != 0);
+			return &_hashmap->_nodes[_idx];
+		}
+
+	public:
+		IteratorImpl() : _idx(0), _hashmap(nullptr) {}
+		template<class T>
+		IteratorImpl(const IteratorImpl<T> &c) : _idx(c._idx), _hashmap(c._hashmap) {}
+
+		NodeType &operator*() const { return *deref(); }
+		NodeType *operator->() const { return deref(); }
+
+		bool operator==(const IteratorImpl &iter) const { return _idx == iter._idx && _hashmap == iter._hashmap; }
+		bool operator!=(const IteratorImpl &iter) const { return !(*this == iter); }
+
+		IteratorImpl &operator++() {
+			assert(_hashmap);
+			// Counting down from 0 ends up at (size_type)-1, which is end()
+			do {
+				_idx--;
+			} while (_idx != (size_type)-1 && _hashmap->_dist[_idx] == 0);
+
+			return *this;
+		}
+
+		IteratorImpl operator++(int) {
+			IteratorImpl old = *this;
+			operator ++();
+			return old;
+		}
+	};
+
+public:
+	typedef IteratorImpl<Node> iterator;
+	typedef IteratorImpl<const Node> const_iterator;
+
+	FlatHashMap();
+	FlatHashMap(const HM_t &map);
+	~FlatHashMap();
+
+	HM_t &operator=(const HM_t &map) {
+		if (this == &map)
+			return *this;
+
+		// Remove the previous content and ...
+		freeStorage();
+		// ... copy the new stuff.
+		assign(map);
+		return *this;
+	}
+
+	bool contains(const Key &key) const;
+
+	Val &operator[](const Key &key);
+	const Val &operator[](const Key &key) const;
+
+	Val &getOrCreateVal(const Key &key);
+	Val &getVal(const Key &key);
+	const Val &getVal(const Key &key) const;
+	const Val &getValOrDefault(const Key &key) const;
+	const Val &getValOrDefault(const Key &key, const Val &defaultVal) const;
+	bool tryGetVal(const Key &key, Val &out) const;
+	void setVal(const Key &key, const Val &val);
+
+	void clear(bool shrinkArray = 0);
+
+	void erase(iterator entry);
+	void erase(const Key &key);
+
+	size_type size() const { return _size; }
+
+	iterator	begin() {
+		// Find and return the last non-empty slot
+		for (size_type ctr = _slots; ctr-- > 0; ) {
+			if (_dist[ctr])
+				return iterator(ctr, this);
+		}
+		return end();
+	}
+	iterator	end() {
+		return iterator((size_type)-1, this);
+	}
+
+	const_iterator	begin() const {
+		// Find and return the last non-empty slot
+		for (size_type ctr = _slots; ctr-- > 0; ) {
+			if (_dist[ctr])
+				return const_iterator(ctr, this);
+		}
+		return end();
+	}
+	const_iterator	end() const {
+		return const_iterator((size_type)-1, this);
+	}
+
+	iterator	find(const Key &key) {
+		return iterator(lookup(key), this);
+	}
+
+	const_iterator	find(const Key &key) const {
+		return const_iterator(lookup(key), this);
+	}
+
+	/** Return true if hashmap is empty. */
+	bool empty() const {
+		return (_size == 0);
+	}
+};
+
+//-------------------------------------------------------
+// FlatHashMap functions
+
+/**
+ * Base constructor, creates an empty hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap() : _defaultVal() {
+	allocStorage(FLATHASHMAP_MIN_CAPACITY);
+}
+
+/**
+ * Copy constructor, creates a full copy of the given hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap(const HM_t &map) :
+	_defaultVal() {
+	assign(map);
+}
+
+/**
+ * Destructor, frees all used memory.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::~FlatHashMap() {
+	freeStorage();
+}
+
+/**
+ * Internal method for allocating empty storage with the given number of
+ * home positions.
+ *
+ * @note The previous storage is *not* deallocated here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::allocStorage(size_type capacity) {
+	assert(capacity >= FLATHASHMAP_MIN_CAPACITY && (capacity & (capacity - 1)) == 0);
+
+	_capacity = capacity;
+	_maxDist = MIN<size_type>(capacity, FLATHASHMAP_MAX_DISTANCE);
+	_slots = _capacity + _maxDist;
+
+	_shift = 32;
+	for (size_type c = capacity; c > 1; c >>= 1)
+		_shift--;
+
+	_nodes = (Node *)malloc(_slots * sizeof(Node));
+	_dist = new byte[_slots + 1];
+	_hashes = new size_type[_slots];
+	assert(_nodes != nullptr);
+	memset(_dist, 0, _slots + 1);
+
+	_size = 0;
+}
+
+/**
+ * Internal method for destroying all elements and deallocating the storage.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::freeStorage() {
+	for (size_type ctr = 0; ctr < _slots; ++ctr) {
+		if (_dist[ctr])
+			_nodes[ctr].~Node();
+	}
+
+	free(_nodes);
+	delete[] _dist;
+	delete[] _hashes;
+}
+
+/**
+ * Internal method for assigning the content of another FlatHashMap
+ * to this one.
+ *
+ * @note The previous storage here is *not* deallocated here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::assign(const HM_t &map) {
+	allocStorage(map._capacity);
+
+	// The layout only depends on the capacity, so simply clone the slots
+	for (size_type ctr = 0; ctr < _slots; ++ctr) {
+		if (map._dist[ctr]) {
+			new (&_nodes[ctr]) Node(map._nodes[ctr]._key, map._nodes[ctr]._value);
+			_hashes[ctr] = map._hashes[ctr];
+			_dist[ctr] = map._dist[ctr];
+		}
+	}
+	_size = map._size;
+}
+
+/**
+ * Clear all values in the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::clear(bool shrinkArray) {
+	if (shrinkArray && _capacity > FLATHASHMAP_MIN_CAPACITY) {
+		freeStorage();
+		allocStorage(FLATHASHMAP_MIN_CAPACITY);
+		return;
+	}
+
+	for (size_type ctr = 0; ctr < _slots; ++ctr) {
+		if (_dist[ctr]) {
+			_nodes[ctr].~Node();
+			_dist[ctr] = 0;
+		}
+	}
+	_size = 0;
+}
+
+/**
+ * Internal method for moving an element into an empty slot.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::moveNode(size_type from, size_type to) {
+	assert(_dist[from] != 0 && _dist[to] == 0);
+
+	new (&_nodes[to]) Node(_nodes[from]._key, _nodes[from]._value);
+	_nodes[from].~Node();
+
+	_hashes[to] = _hashes[from];
+	_dist[to] = _dist[from] + to - from;
+	_dist[from] = 0;
+}
+
+/**
+ * Internal method for inserting a key which is known not to be in the map
+ * yet. The elements between the insert position and the next empty slot are
+ * shifted forward by one to make room.
+ *
+ * @return false if this would exceed the maximal probe distance, in which
+ *         case the map is left unchanged.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::insertNew(size_type hash, const Key &key, const Val *val, size_type &pos) {
+	// Find the first element which is closer to its home position than the
+	// new one would be
+	size_type idx = homePosition(hash);
+	size_type dist = 1;
+	while (_dist[idx] >= dist) {
+		idx++;
+		dist++;
+	}
+	if (dist > _maxDist + 1)
+		return false;
+
+	size_type last = idx;
+	while (_dist[last] != 0) {
+		if (_dist[last] > _maxDist)
+			return false;
+		last++;
+	}
+	// Do not run into the sentinel
+	if (last >= _slots)
+		return false;
+
+	for (; last > idx; --last)
+		moveNode(last - 1, last);
+
+	if (val)
+		new (&_nodes[idx]) Node(key, *val);
+	else
+		new (&_nodes[idx]) Node(key);
+	_hashes[idx] = hash;
+	_dist[idx] = dist;
+	_size++;
+
+	pos = idx;
+	return true;
+}
+
+/**
+ * Internal method for removing the element in the given slot. The following
+ * elements which are not at their home position are shifted back by one.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::eraseAt(size_type pos) {
+	assert(pos < _slots && _dist[pos] != 0);
+
+	_nodes[pos].~Node();
+	_dist[pos] = 0;
+	_size--;
+
+	for (size_type next = pos + 1; _dist[next] > 1; ++next)
+		moveNode(next, next - 1);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::expandStorage(size_type newCapacity) {
+	assert(newCapacity > _capacity);
+
+	const size_type oldSize = _size;
+	const size_type oldSlots = _slots;
+	Node *oldNodes = _nodes;
+	byte *oldDist = _dist;
+	size_type *oldHashes = _hashes;
+
+	// Rehash all the old elements, without having to call _hash() or
+	// _equal(). If too many of them collide, try again with more space.
+	for (;;) {
+		allocStorage(newCapacity);
+
+		bool success = true;
+		for (size_type ctr = 0; ctr < oldSlots && success; ++ctr) {
+			size_type pos;
+			if (oldDist[ctr])
+				success = insertNew(oldHashes[ctr], oldNodes[ctr]._key, &oldNodes[ctr]._value, pos);
+		}
+		if (success)
+			break;
+
+		freeStorage();
+		newCapacity *= 2;
+	}
+
+	// Perform a sanity check: Old number of elements should match the new one!
+	assert(_size == oldSize);
+	(void)oldSize;
+
+	for (size_type ctr = 0; ctr < oldSlots; ++ctr) {
+		if (oldDist[ctr])
+			oldNodes[ctr].~Node();
+	}
+	free(oldNodes);
+	delete[] oldDist;
+	delete[] oldHashes;
+}
+
+/**
+ * Internal method for finding a key.
+ *
+ * @return the slot containing the key, or (size_type)-1 if it is not present.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookup(const Key &key, size_type hash) const {
+	size_type idx = homePosition(hash);
+
+	// The elements are ordered by their home position, so the key can not
+	// come after an element which is closer to its home position. The
+	// sentinel stops the loop at the end of the table.
+	for (size_type dist = 1; _dist[idx] >= dist; ++idx, ++dist) {
+		if (_dist[idx] == dist && _hashes[idx] == hash && _equal(_nodes[idx]._key, key))
+			return idx;
+	}
+
+	return (size_type)-1;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookupAndCreateIfMissing(const Key &key) {
+	const size_type hash = _hash(key);
+	size_type ctr = lookup(key, hash);
+	if (ctr != (size_type)-1)
+		return ctr;
+
+	// Keep the load factor below a certain threshold
+	if ((_size + 1) * FLATHASHMAP_LOADFACTOR_DENOMINATOR > _capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR)
+		expandStorage(_capacity * 2);
+
+	while (!insertNew(hash, key, nullptr, ctr)) {
+		// Even a mostly empty table did not help, so there must be
+		// hundreds of keys with the very same hash
+		if (_size < _capacity / 8)
+			error("FlatHashMap: Too many colliding keys");
+		expandStorage(_capacity * 2);
+	}
+
+	return ctr;
+}
+
+/**
+ * Check whether the hashmap contains the given key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::contains(const Key &key) const {
+	return lookup(key) != (size_type)-1;
+}
+
+/**
+ * Get a value from the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) {
+	return getOrCreateVal(key);
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) const {
+	return getVal(key);
+}
+
+/**
+ * Get a value from the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getOrCreateVal(const Key &key) {
+	// Inserting may reallocate _nodes, so do not read it before
+	const size_type ctr = lookupAndCreateIfMissing(key);
+	return _nodes[ctr]._value;
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		return _nodes[ctr]._value;
+	else
+		// See comment in HashMap::getVal().
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) const {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		return _nodes[ctr]._value;
+	else
+		// See comment in HashMap::getVal().
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key) const {
+	return getValOrDefault(key, _defaultVal);
+}
+
+/**
+ * Get a value from the hashmap. If the key is not present, then return @p defaultVal.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key, const Val &defaultVal) const {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		return _nodes[ctr]._value;
+	else
+		return defaultVal;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::tryGetVal(const Key &key, Val &out) const {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1) {
+		out = _nodes[ctr]._value;
+		return true;
+	} else {
+		return false;
+	}
+}
+
+/**
+ * Assign an element specified by @p key to a value @p val.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::setVal(const Key &key, const Val &val) {
+	const size_type ctr = lookupAndCreateIfMissing(key);
+	_nodes[ctr]._value = val;
+}
+
+/**
+ * Erase an element referred to by an iterator.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(iterator entry) {
+	// Check whether we have a valid iterator
+	assert(entry._hashmap == this);
+	eraseAt(entry._idx);
+}
+
+/**
+ * Erase an element specified by a key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		eraseAt(ctr);
+}
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
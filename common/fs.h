@@ -223,6 +223,18 @@ public:
 	 */
 	bool isWritable() const;
 
+	/**
+	 * Retrieve the size and the time of last modification of the file
+	 * referred by this node, without opening it.
+	 *
+	 * The modification time uses a backend specific clock, and is only
+	 * meant to detect whether a file changed since it was last looked at.
+	 * Not all backends can provide this information.
+	 *
+	 * @return True if the information could be retrieved, false otherwise.
+	 */
+	bool getFileInfo(int64 &size, int64 &modificationTime) const;
+
 	/**
 	 * Create a SeekableReadStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -78,6 +78,8 @@ public:
 	int64 size() const { return _size; }
 
 	bool seek(int64 offs, int whence = SEEK_SET);
+
+	const byte *getBuffer() const { return _ptrOrig; }
 };
 
 
@@ -8,6 +8,7 @@ MODULE_OBJS := \
 	coroutines.o \
 	dcl.o \
 	debug.o \
+	dir-scanner.o \
 	error.o \
 	events.o \
 	file.o \
@@ -44,6 +45,7 @@ MODULE_OBJS := \
 	system.o \
 	textconsole.o \
 	text-to-speech.o \
+	threadpool.o \
 	tokenizer.o \
 	translation.o \
 	unarj.o \
@@ -20,18 +20,20 @@
  */
 
 #include "common/path.h"
+#include "common/hash-str.h"
 
 namespace Common {
 
 Path::Path(const Path &path) {
 	_str = path.rawString();
+	_hashIgnoreCase = path._hashIgnoreCase;
 }
 
-Path::Path(const char *str, char separator) {
+Path::Path(const char *str, char separator) : _hashIgnoreCase(0) {
 	set(str, separator);
 }
 
-Path::Path(const String &str, char separator) {
+Path::Path(const String &str, char separator) : _hashIgnoreCase(0) {
 	if (separator == DIR_SEPARATOR)
 		_str = str;
 	else
@@ -75,12 +77,28 @@ bool Path::operator!=(const Path &x) const {
 	return _str != x.rawString();
 }
 
+bool Path::equalsIgnoreCase(const Path &x) const {
+	// Only compare the hashes if they are known already
+	if (_hashIgnoreCase && x._hashIgnoreCase && _hashIgnoreCase != x._hashIgnoreCase)
+		return false;
+
+	return _str.equalsIgnoreCase(x.rawString());
+}
+
+uint Path::computeHashIgnoreCase() const {
+	const uint hash = hashit_lower(_str.c_str());
+
+	// 0 marks the hash as not computed yet
+	return hash ? hash : 1;
+}
+
 bool Path::empty() const {
 	return _str.empty();
 }
 
 Path &Path::operator=(const Path &path) {
 	_str = path.rawString();
+	_hashIgnoreCase = path._hashIgnoreCase;
 	return *this;
 }
 
@@ -96,23 +114,28 @@ Path &Path::operator=(const String &str) {
 
 void Path::set(const char *str, char separator) {
 	_str.clear();
+	_hashIgnoreCase = 0;
 	appendInPlace(str, separator);
 }
 
 Path &Path::appendInPlace(const Path &x) {
 	_str += x.rawString();
+	_hashIgnoreCase = 0;
 	return *this;
 }
 
 Path &Path::appendInPlace(const String &str, char separator) {
-	if (separator == DIR_SEPARATOR)
+	if (separator == DIR_SEPARATOR) {
 		_str += str;
-	else
+		_hashIgnoreCase = 0;
+	} else {
 		appendInPlace(str.c_str(), separator);
+	}
 	return *this;
 }
 
 Path &Path::appendInPlace(const char *str, char separator) {
+	_hashIgnoreCase = 0;
 	for (; *str; str++) {
 		if (*str == separator)
 			_str += DIR_SEPARATOR;
@@ -146,6 +169,7 @@ Path &Path::joinInPlace(const Path &x) {
 		_str += DIR_SEPARATOR;
 
 	_str += x.rawString();
+	_hashIgnoreCase = 0;
 
 	return *this;
 }
@@ -161,6 +185,7 @@ Path &Path::joinInPlace(const char *str, char separator) {
 	if (!_str.empty() && _str.lastChar() != DIR_SEPARATOR && *str != separator)
 		_str += DIR_SEPARATOR;
 
+	// Resets the cached hash
 	appendInPlace(str, separator);
 
 	return *this;
@@ -182,4 +207,13 @@ Path Path::join(const char *str, char separator) const {
 	return temp;
 }
 
+const Path &PathInterner::intern(const Path &path) {
+	PathSet::const_iterator it = _paths.find(path);
+	if (it == _paths.end()) {
+		_paths[path] = true;
+		it = _paths.find(path);
+	}
+	return it->_key;
+}
+
 } // End of namespace Common
@@ -24,6 +24,7 @@
 
 #include "common/scummsys.h"
 #include "common/str.h"
+#include "common/hashmap.h"
 
 namespace Common {
 
@@ -51,9 +52,22 @@ class Path {
 private:
 	String _str;
 
+	/** Cached result of hashIgnoreCase(), or 0 if it has not been computed yet. */
+	mutable uint _hashIgnoreCase;
+
 public:
+	/** Hash functor using the cached case-insensitive hash of a path. */
+	struct IgnoreCase_Hash {
+		uint operator()(const Path &x) const { return x.hashIgnoreCase(); }
+	};
+
+	/** Equality functor comparing paths case-insensitively. */
+	struct IgnoreCase_EqualTo {
+		bool operator()(const Path &x, const Path &y) const { return x.equalsIgnoreCase(y); }
+	};
+
 	/** Construct a new empty path. */
-	Path() {}
+	Path() : _hashIgnoreCase(0) {}
 
 	/** Construct a copy of the given path. */
 	Path(const Path &path);
@@ -113,6 +127,20 @@ public:
 	/** Check whether this path is different than path @p x. */
 	bool operator!=(const Path &x) const;
 
+	/** Check whether this path is identical to path @p x, ignoring the case. */
+	bool equalsIgnoreCase(const Path &x) const;
+
+	/**
+	 * Returns a case-insensitive hash of this path. It is only computed
+	 * once, and is kept when the path is copied, so that looking up the
+	 * same path repeatedly does not have to hash it again.
+	 */
+	uint hashIgnoreCase() const {
+		if (!_hashIgnoreCase)
+			_hashIgnoreCase = computeHashIgnoreCase();
+		return _hashIgnoreCase;
+	}
+
 	/** Return if this path is empty */
 	bool empty() const;
 
@@ -175,6 +203,43 @@ public:
 
 	/** @overload */
 	Path join(const char *str, char separator = '/') const;
+
+private:
+	uint computeHashIgnoreCase() const;
+};
+
+/**
+ * A set of paths in which each path is only stored once.
+ *
+ * Code which looks up the same paths over and over again (e.g. when loading
+ * a scene) can intern them and keep the interned copies. Their hash is
+ * computed when interning, so hash map lookups with them only have to
+ * compare the paths. The interned copies share their string buffer with the
+ * copy stored in the set.
+ *
+ * Like String, this is not thread safe. Use one set per thread.
+ */
+class PathInterner {
+public:
+	/**
+	 * Return the copy of the given path stored in the set, adding it if it
+	 * is not present yet. The reference stays valid until the set is cleared
+	 * or destroyed.
+	 */
+	const Path &intern(const Path &path);
+
+	/** Return the number of different paths stored. */
+	uint size() const { return _paths.size(); }
+
+	/** Remove all paths from the set. */
+	void clear() { _paths.clear(); }
+
+private:
+	// Paths which only differ in case are different paths, but have the same
+	// case-insensitive hash. Since HashMap never moves its nodes, the
+	// references to the keys stay valid.
+	typedef HashMap<Path, bool, Path::IgnoreCase_Hash> PathSet;
+	PathSet _paths;
 };
 
 /** @} */
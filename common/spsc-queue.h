@@ -0,0 +1,111 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_SPSC_QUEUE_H
+#define COMMON_SPSC_QUEUE_H
+
+#include "common/atomic.h"
+#include "common/scummsys.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_spsc_queue Lock-free queue
+ * @ingroup common
+ *
+ * @brief Fixed size queue for passing data between two threads without locking.
+ * @{
+ */
+
+/**
+ * Fixed size ring buffer which can be used by exactly one producer thread
+ * and exactly one consumer thread at the same time without any locking.
+ *
+ * push() and full() may only be called by the producer, pop() and empty()
+ * only by the consumer. If there are several producers or consumers, they
+ * have to be serialized among themselves, e.g. with a Common::Mutex.
+ *
+ * @tparam T     Element type, which is copied in and out of the queue.
+ * @tparam SIZE  Number of elements the queue can hold, must be a power of two.
+ */
+template<class T, uint SIZE>
+class SPSCQueue {
+public:
+	SPSCQueue() : _head(0), _tail(0) {
+		STATIC_ASSERT((SIZE & (SIZE - 1)) == 0, SIZE_must_be_a_power_of_two);
+	}
+
+	/**
+	 * Append an element to the queue.
+	 *
+	 * @return false if the queue is full, in which case nothing is added.
+	 */
+	bool push(const T &x) {
+		const uint tail = _tail.load(kMemoryOrderRelaxed);
+		if (tail - _head.load(kMemoryOrderAcquire) == SIZE)
+			return false;
+
+		_storage[tail & (SIZE - 1)] = x;
+		_tail.store(tail + 1, kMemoryOrderRelease);
+		return true;
+	}
+
+	/**
+	 * Remove the oldest element from the queue.
+	 *
+	 * @return false if the queue is empty, in which case x is left untouched.
+	 */
+	bool pop(T &x) {
+		const uint head = _head.load(kMemoryOrderRelaxed);
+		if (head == _tail.load(kMemoryOrderAcquire))
+			return false;
+
+		x = _storage[head & (SIZE - 1)];
+		_head.store(head + 1, kMemoryOrderRelease);
+		return true;
+	}
+
+	bool empty() const {
+		return _head.load(kMemoryOrderRelaxed) == _tail.load(kMemoryOrderAcquire);
+	}
+
+	bool full() const {
+		return _tail.load(kMemoryOrderRelaxed) - _head.load(kMemoryOrderAcquire) == SIZE;
+	}
+
+	uint capacity() const {
+		return SIZE;
+	}
+
+private:
+	T _storage[SIZE];
+
+	/** Number of elements popped so far, only written by the consumer */
+	Atomic<uint> _head;
+	/** Number of elements pushed so far, only written by the producer */
+	Atomic<uint> _tail;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
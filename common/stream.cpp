@@ -270,6 +270,14 @@ bool SeekableSubReadStream::seek(int64 offset, int whence) {
 	return ret;
 }
 
+const byte *SeekableSubReadStream::getBuffer() const {
+	const byte *buffer = _parentStream->getBuffer();
+	if (!buffer || _end > _parentStream->size())
+		return nullptr;
+
+	return buffer + _begin;
+}
+
 uint32 SafeSeekableSubReadStream::read(void *dataPtr, uint32 dataSize) {
 	// Make sure the parent stream is at the right position
 	seek(0, SEEK_CUR);
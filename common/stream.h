@@ -699,6 +699,21 @@ public:
 	 */
 	virtual bool skip(uint32 offset) { return seek(offset, SEEK_CUR); }
 
+	/**
+	 * Obtain direct access to the contents of the stream, if they are
+	 * already available in memory, for example because the stream wraps
+	 * a memory buffer or a memory mapped file.
+	 *
+	 * The returned pointer addresses size() bytes, starting at the
+	 * beginning of the stream regardless of the current position, and
+	 * stays valid for as long as the stream exists. This allows parsing
+	 * data in place instead of copying it into a separate buffer first.
+	 *
+	 * @return Pointer to the stream contents, or nullptr if the stream
+	 *         does not support direct access.
+	 */
+	virtual const byte *getBuffer() const { return nullptr; }
+
 	/**
 	 * Read at most one less than the number of characters specified
 	 * by @p bufSize from the stream and store them in the string buffer.
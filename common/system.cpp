@@ -32,6 +32,7 @@
 #include "common/str-enc.h"
 #include "common/textconsole.h"
 #include "common/text-to-speech.h"
+#include "common/threadpool.h"
 
 #include "backends/audiocd/default/default-audiocd.h"
 #include "backends/fs/fs-factory.h"
@@ -56,6 +57,7 @@ OSystem::OSystem() {
 #endif
 	_fsFactory = nullptr;
 	_backendInitialized = false;
+	_threadPool = nullptr;
 }
 
 OSystem::~OSystem() {
@@ -114,12 +116,23 @@ void OSystem::initBackend() {
 }
 
 void OSystem::destroy() {
+	// The worker threads come from the backend, so they have to be gone
+	// before it shuts down
+	delete _threadPool;
+	_threadPool = nullptr;
+
 	_backendInitialized = false;
 	Common::String::releaseMemoryPoolMutex();
 	Common::releaseCJKTables();
 	delete this;
 }
 
+Common::ThreadPool &OSystem::getThreadPool() {
+	if (!_threadPool)
+		_threadPool = new Common::ThreadPool();
+	return *_threadPool;
+}
+
 bool OSystem::setGraphicsMode(const char *name) {
 	if (!name)
 		return false;
@@ -194,6 +207,41 @@ Common::String OSystem::getSystemLanguage() const {
 	return "en_US";
 }
 
+bool OSystem::hasCpuFeature(CpuFeature feature) {
+	switch (feature) {
+	case kCpuFeatureSSE2:
+#if defined(SCUMMVM_SSE2)
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+		// SSE2 is part of the x86-64 baseline
+		return true;
+#elif defined(__GNUC__)
+		return __builtin_cpu_supports("sse2");
+#else
+		return false;
+#endif
+#else
+		return false;
+#endif
+
+	case kCpuFeatureAVX2:
+#if defined(SCUMMVM_AVX2) && defined(__GNUC__)
+		return __builtin_cpu_supports("avx2");
+#else
+		return false;
+#endif
+
+	case kCpuFeatureNEON:
+#if defined(SCUMMVM_NEON) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+		return true;
+#else
+		return false;
+#endif
+
+	default:
+		return false;
+	}
+}
+
 bool OSystem::isConnectionLimited() {
 	warning("OSystem::isConnectionLimited(): not limited by default");
 	return false;
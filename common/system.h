@@ -58,6 +58,8 @@ class TaskbarManager;
 class UpdateManager;
 #endif
 class TextToSpeechManager;
+class ThreadPool;
+class ThreadPoolInternal;
 #if defined(USE_SYSDIALOGS)
 class DialogManager;
 #endif
@@ -257,6 +259,11 @@ private:
 	 */
 	bool _backendInitialized;
 
+	/**
+	 * The pool returned by getThreadPool(), or 0 if it was not used yet.
+	 */
+	Common::ThreadPool *_threadPool;
+
 	//@}
 
 public:
@@ -517,6 +524,36 @@ public:
 	 */
 	virtual bool getFeatureState(Feature f) { return false; }
 
+	/**
+	 * CPU instruction set extensions that optimized code paths may use.
+	 */
+	enum CpuFeature {
+		/**
+		 * SSE2 on x86 and x86-64.
+		 */
+		kCpuFeatureSSE2,
+
+		/**
+		 * AVX2 on x86 and x86-64.
+		 */
+		kCpuFeatureAVX2,
+
+		/**
+		 * Advanced SIMD (NEON) on ARM and AArch64.
+		 */
+		kCpuFeatureNEON
+	};
+
+	/**
+	 * Determine whether the host CPU supports the specified instruction
+	 * set extension, and ScummVM was built with code that uses it.
+	 *
+	 * The default implementation derives this from the build configuration
+	 * and, where possible, from the compiler's CPU detection. Backends that
+	 * have a more reliable way to query the CPU may override it.
+	 */
+	virtual bool hasCpuFeature(CpuFeature feature);
+
 	/** @} */
 
 
@@ -1429,6 +1466,44 @@ public:
 	/** @} */
 
 
+	/**
+	 * @defgroup common_system_threadpool Thread pool
+	 * @ingroup common_system
+	 * @{
+	 *
+	 * Engines and subsystems that want to spread work over several CPU cores
+	 * do so through Common::ThreadPool, which gets its worker threads from
+	 * the backend. Backends without threads, or running on a single core,
+	 * do not need to implement anything: the pool then runs all tasks
+	 * synchronously.
+	 *
+	 * Backends which implement this must also return real mutexes from
+	 * createMutex(), since tasks use common code that relies on them.
+	 */
+
+	/**
+	 * Create the backend part of a Common::ThreadPool.
+	 *
+	 * @param numThreads  Number of worker threads, or 0 to use one per CPU core.
+	 *
+	 * @return The newly created thread pool, or 0 if tasks should be run
+	 *         synchronously.
+	 */
+	virtual Common::ThreadPoolInternal *createThreadPool(uint numThreads) { return nullptr; }
+
+	/**
+	 * Return the thread pool shared by all engines and subsystems, with one
+	 * worker thread per CPU core. Prefer it over creating a pool of your
+	 * own, so that the number of threads stays bounded.
+	 *
+	 * The pool is created on first use, which must happen on the main
+	 * thread. It is destroyed by destroy().
+	 */
+	Common::ThreadPool &getThreadPool();
+
+	/** @} */
+
+
 
 	/** @defgroup common_system_sound Sound
 	 *  @ingroup common_system
@@ -0,0 +1,66 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/threadpool.h"
+#include "common/system.h"
+
+namespace Common {
+
+ThreadPool::ThreadPool(uint numThreads) {
+	_internal = g_system->createThreadPool(numThreads);
+}
+
+ThreadPool::~ThreadPool() {
+	delete _internal;
+}
+
+uint ThreadPool::getThreadCount() const {
+	return _internal ? _internal->getThreadCount() : 0;
+}
+
+void ThreadPool::submit(ThreadPoolTask *task) {
+	task->markPending();
+	if (_internal)
+		_internal->submit(task);
+	else
+		task->execute();
+}
+
+void ThreadPool::wait(ThreadPoolTask *task) {
+	if (_internal && !task->isDone())
+		_internal->wait(task);
+}
+
+void TaskGroup::add(ThreadPoolTask *task) {
+	_tasks.push_back(task);
+	_pool.submit(task);
+}
+
+void TaskGroup::wait() {
+	for (uint i = 0; i < _tasks.size(); ++i) {
+		_pool.wait(_tasks[i]);
+		delete _tasks[i];
+	}
+	_tasks.clear();
+}
+
+} // End of namespace Common
@@ -0,0 +1,279 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef COMMON_THREADPOOL_H
+#define COMMON_THREADPOOL_H
+
+#include "common/array.h"
+#include "common/atomic.h"
+#include "common/noncopyable.h"
+#include "common/ptr.h"
+#include "common/scummsys.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_threadpool Thread pool
+ * @ingroup common
+ *
+ * @brief API for running work on other CPU cores.
+ *
+ * Tasks run concurrently with the code that submitted them, so they must
+ * only touch data that no other thread uses until the task is done. Note
+ * that the reference counts of String, SharedPtr and FSNode are not
+ * atomic: a task should work on its own copies, and hand its results back
+ * only through the task object itself.
+ *
+ * Backends that cannot run code in parallel do not have to implement
+ * anything. The pool then runs every task synchronously as soon as it is
+ * submitted, so callers do not need a separate code path for them.
+ * @{
+ */
+
+/**
+ * A unit of work for a ThreadPool.
+ */
+class ThreadPoolTask : NonCopyable {
+public:
+	ThreadPoolTask() : _done(true) {}
+	virtual ~ThreadPoolTask() {}
+
+	/** Do the work. Called once per submission, possibly on another thread. */
+	virtual void run() = 0;
+
+	/**
+	 * Check whether the task has finished. Once this returns true, all
+	 * changes the task made are visible to the calling thread.
+	 */
+	bool isDone() const { return _done.load(kMemoryOrderAcquire); }
+
+	/** Called by the pool when the task gets submitted. */
+	void markPending() { _done.store(false, kMemoryOrderRelaxed); }
+
+	/** Called by the pool to run a submitted task. */
+	void execute() {
+		run();
+		_done.store(true, kMemoryOrderRelease);
+	}
+
+private:
+	Atomic<bool> _done;
+};
+
+/**
+ * The backend part of a ThreadPool, created by OSystem::createThreadPool().
+ */
+class ThreadPoolInternal {
+public:
+	virtual ~ThreadPoolInternal() {}
+
+	/** Return the number of worker threads. */
+	virtual uint getThreadCount() const = 0;
+
+	/**
+	 * Queue a task. A worker thread calls ThreadPoolTask::execute() on it
+	 * later on.
+	 */
+	virtual void submit(ThreadPoolTask *task) = 0;
+
+	/**
+	 * Block until the specified task is done. While waiting, the calling
+	 * thread has to run queued tasks itself, so that tasks can wait for
+	 * other tasks without exhausting the workers.
+	 */
+	virtual void wait(ThreadPoolTask *task) = 0;
+};
+
+template<class T>
+class Future;
+
+/**
+ * A set of worker threads running ThreadPoolTask objects.
+ *
+ * Destroying the pool runs all tasks which are still queued first.
+ */
+class ThreadPool : NonCopyable {
+public:
+	/**
+	 * Create a new pool.
+	 *
+	 * @param numThreads  Number of worker threads, or 0 to use one per CPU core.
+	 */
+	explicit ThreadPool(uint numThreads = 0);
+	~ThreadPool();
+
+	/**
+	 * Return the number of worker threads. This is 0 if the backend cannot
+	 * run tasks concurrently, and every task runs when it is submitted.
+	 */
+	uint getThreadCount() const;
+
+	/**
+	 * Queue a task for running on a worker thread. The task is not owned
+	 * by the pool and must stay alive until it is done.
+	 */
+	void submit(ThreadPoolTask *task);
+
+	/** Wait until the specified task is done. */
+	void wait(ThreadPoolTask *task);
+
+	/**
+	 * Run a function object on a worker thread. Function objects without
+	 * a result can be run with a TaskGroup instead.
+	 *
+	 * @return A future for the result of the call.
+	 */
+	template<class F>
+	auto async(F func) -> Future<decltype(func())>;
+
+private:
+	ThreadPoolInternal *_internal;
+};
+
+/**
+ * Task which produces a result of type T.
+ */
+template<class T>
+class ResultTask : public ThreadPoolTask {
+public:
+	/** Return the result. Only valid once the task is done. */
+	virtual const T &getResult() const = 0;
+};
+
+/**
+ * Task which calls a function object and keeps its result.
+ */
+template<class T, class F>
+class FunctionTask : public ResultTask<T> {
+public:
+	explicit FunctionTask(F func) : _func(func), _result() {}
+
+	void run() override { _result = _func(); }
+	const T &getResult() const override { return _result; }
+
+private:
+	F _func;
+	T _result;
+};
+
+/** Specialization for function objects without a result. */
+template<class F>
+class FunctionTask<void, F> : public ThreadPoolTask {
+public:
+	explicit FunctionTask(F func) : _func(func) {}
+
+	void run() override { _func(); }
+
+private:
+	F _func;
+};
+
+/**
+ * Result of ThreadPool::async(). Copies share the same result. When the
+ * last copy goes away, it waits for the call to finish.
+ */
+template<class T>
+class Future {
+public:
+	Future() : _pool(nullptr) {}
+
+	/** Check whether the future refers to a call at all. */
+	bool isValid() const { return (bool)_task; }
+
+	/** Check whether the call has finished. */
+	bool isReady() const { return !_task || _task->isDone(); }
+
+	/** Wait for the call to finish. */
+	void wait() const {
+		if (_task)
+			_pool->wait(_task.get());
+	}
+
+	/** Wait for the call to finish and return its result. */
+	const T &get() const {
+		wait();
+		return _task->getResult();
+	}
+
+private:
+	friend class ThreadPool;
+
+	/** Waits for the task before deleting it. */
+	struct Deleter {
+		ThreadPool *_pool;
+		void operator()(ResultTask<T> *task) {
+			_pool->wait(task);
+			delete task;
+		}
+	};
+
+	Future(ThreadPool *pool, ResultTask<T> *task) : _pool(pool) {
+		Deleter deleter = { pool };
+		_task = SharedPtr<ResultTask<T> >(task, deleter);
+		pool->submit(task);
+	}
+
+	ThreadPool *_pool;
+	SharedPtr<ResultTask<T> > _task;
+};
+
+template<class F>
+auto ThreadPool::async(F func) -> Future<decltype(func())> {
+	return Future<decltype(func())>(this, new FunctionTask<decltype(func()), F>(func));
+}
+
+/**
+ * A group of tasks that can be waited for together.
+ *
+ * The group owns the tasks added to it. Destroying the group waits for
+ * all of them.
+ */
+class TaskGroup : NonCopyable {
+public:
+	explicit TaskGroup(ThreadPool &pool) : _pool(pool) {}
+	~TaskGroup() { wait(); }
+
+	/** Submit a task to the pool and take ownership of it. */
+	void add(ThreadPoolTask *task);
+
+	/** Submit a call of a function object without result. */
+	template<class F>
+	void run(F func) {
+		add(new FunctionTask<void, F>(func));
+	}
+
+	/** Wait until all tasks of the group are done, then delete them. */
+	void wait();
+
+	/** Return the number of tasks waiting to be deleted by wait(). */
+	uint size() const { return _tasks.size(); }
+
+private:
+	ThreadPool &_pool;
+	Array<ThreadPoolTask *> _tasks;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -96,9 +96,11 @@ typedef struct {
 
 #endif  // !USE_ZLIB
 
+#include "common/bufferedstream.h"
 #include "common/fs.h"
 #include "common/unzip.h"
 #include "common/memstream.h"
+#include "common/ptr.h"
 
 #include "common/hashmap.h"
 #include "common/hash-str.h"
@@ -374,6 +376,7 @@ typedef Common::HashMap<Common::String, cached_file_in_zip, Common::IgnoreCase_H
 /* unz_s contain internal information about the zipfile
 */
 typedef struct {
+	Common::SharedPtr<Common::SeekableReadStream> _archiveStream;	/* owner of the zipfile stream */
 	Common::SeekableReadStream *_stream;				/* io structore of the zipfile */
 	unz_global_info gi;				/* public global information */
 	uLong byte_before_the_zipfile;	/* byte before the zipfile, (>0 for sfx)*/
@@ -536,6 +539,7 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 
 	int err=UNZ_OK;
 
+	us->_archiveStream = Common::SharedPtr<Common::SeekableReadStream>(stream);
 	us->_stream = stream;
 
 	central_pos = unzlocal_SearchCentralDir(*us->_stream);
@@ -588,7 +592,6 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 		err=UNZ_BADZIPFILE;
 
 	if (err != UNZ_OK) {
-		delete us->_stream;
 		delete us;
 		return nullptr;
 	}
@@ -598,6 +601,12 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 	us->central_pos = central_pos;
 	us->pfile_in_zip_read = nullptr;
 
+	// Build the index from a single read of the central directory, instead
+	// of seeking around the archive stream for every field of every entry
+	Common::SeekableReadStream *centralDir = Common::wrapBufferedSeekableReadStream(stream,
+		MAX<uLong>(us->size_central_dir, 1), DisposeAfterUse::NO);
+	us->_stream = centralDir;
+
 	err = unzGoToFirstFile((unzFile)us);
 
 	while (err == UNZ_OK) {
@@ -619,6 +628,10 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 		// Move to the next file
 		err = unzGoToNextFile((unzFile)us);
 	}
+
+	us->_stream = stream;
+	delete centralDir;
+
 	return (unzFile)us;
 }
 
@@ -637,7 +650,6 @@ int unzClose(unzFile file) {
 	if (s->pfile_in_zip_read != nullptr)
 		unzCloseCurrentFile(file);
 
-	delete s->_stream;
 	delete s;
 	return UNZ_OK;
 }
@@ -1412,11 +1424,221 @@ int unzGetGlobalComment(unzFile file, char *szComment, uLong uSizeBuf) {
 
 namespace Common {
 
+/**
+ * A stream which decompresses a ZIP member on demand, so that the start of
+ * a large member can be read before the rest of it has been inflated.
+ *
+ * A buffer for the whole uncompressed member is allocated up front, so this
+ * saves time but not memory compared to decompressing the member in one go.
+ * The member is decompressed chunk by chunk into that buffer as reading
+ * progresses, which keeps seeking backwards cheap. The stream holds its own
+ * reference to the archive stream, so it may outlive the ZipArchive it was
+ * created from, just like the memory streams used for small members.
+ */
+class ZipMemberStream : public SeekableReadStream {
+public:
+	/** Minimum amount of data decompressed at once. */
+	static const uint32 kChunkSize = 64 * 1024;
+
+	ZipMemberStream(const SharedPtr<SeekableReadStream> &archiveStream, uint32 dataOffset, const unz_file_info &fileInfo);
+	~ZipMemberStream();
+
+	bool err() const override { return _err; }
+	void clearErr() override { _eos = false; _err = false; }
+	bool eos() const override { return _eos; }
+
+	int64 pos() const override { return _pos; }
+	int64 size() const override { return _size; }
+	bool seek(int64 offset, int whence = SEEK_SET) override;
+	uint32 read(void *dataPtr, uint32 dataSize) override;
+
+	const byte *getBuffer() const override;
+
+private:
+	bool fill(uint32 end);
+	void finish();
+
+	SharedPtr<SeekableReadStream> _archiveStream;
+	const uint32 _dataOffset;
+	const uint32 _compressedSize;
+	const uint32 _size;
+	const uLong _crc;
+	const bool _stored;
+
+	byte *_buffer;
+	byte *_inBuffer;
+	uint32 _compressedRead;
+	uint32 _filled;
+	uLong _crcData;
+	z_stream _zStream;
+	bool _zInitialized;
+
+	uint32 _pos;
+	bool _eos;
+	bool _err;
+};
+
+ZipMemberStream::ZipMemberStream(const SharedPtr<SeekableReadStream> &archiveStream, uint32 dataOffset, const unz_file_info &fileInfo) :
+		_archiveStream(archiveStream), _dataOffset(dataOffset), _compressedSize(fileInfo.compressed_size),
+		_size(fileInfo.uncompressed_size), _crc(fileInfo.crc), _stored(fileInfo.compression_method == 0),
+		_inBuffer(nullptr), _compressedRead(0), _filled(0), _crcData(0), _zInitialized(false),
+		_pos(0), _eos(false), _err(false) {
+	memset(&_zStream, 0, sizeof(_zStream));
+
+	_buffer = (byte *)malloc(_size);
+	if (!_buffer) {
+		_err = true;
+		return;
+	}
+
+	if (!_stored) {
+#ifdef USE_ZLIB
+		_inBuffer = (byte *)malloc(UNZ_BUFSIZE);
+		_zInitialized = _inBuffer && inflateInit2(&_zStream, -MAX_WBITS) == Z_OK;
+#endif
+		if (!_zInitialized)
+			_err = true;
+	}
+}
+
+ZipMemberStream::~ZipMemberStream() {
+	finish();
+	free(_buffer);
+}
+
+void ZipMemberStream::finish() {
+#ifdef USE_ZLIB
+	if (_zInitialized)
+		inflateEnd(&_zStream);
+#endif
+	_zInitialized = false;
+
+	free(_inBuffer);
+	_inBuffer = nullptr;
+
+	// Let go of the archive as soon as possible, so the file can be closed
+	// once the archive itself is gone
+	_archiveStream.reset();
+}
+
+bool ZipMemberStream::fill(uint32 end) {
+	// Decompress a bit more than asked for, so that a sequence of small reads
+	// does not go through the archive stream every time
+	end = MIN(MAX(end, _filled + kChunkSize), _size);
+
+	// Nothing can be decompressed if setting up the stream failed, even if
+	// the error has been cleared since
+	if (_filled < end && (!_buffer || (!_stored && !_zInitialized)))
+		_err = true;
+
+	while (_filled < end && !_err) {
+		const byte *newData = _buffer + _filled;
+
+		if (_stored) {
+			const uint32 length = end - _filled;
+			_archiveStream->seek(_dataOffset + _filled, SEEK_SET);
+			if (_archiveStream->read(_buffer + _filled, length) != length) {
+				_err = true;
+				break;
+			}
+			_filled += length;
+		} else {
+#ifdef USE_ZLIB
+			if (_zStream.avail_in == 0) {
+				const uint32 length = MIN<uint32>(UNZ_BUFSIZE, _compressedSize - _compressedRead);
+				_archiveStream->seek(_dataOffset + _compressedRead, SEEK_SET);
+				if (length == 0 || _archiveStream->read(_inBuffer, length) != length) {
+					_err = true;
+					break;
+				}
+				_compressedRead += length;
+				_zStream.next_in = _inBuffer;
+				_zStream.avail_in = length;
+			}
+
+			_zStream.next_out = _buffer + _filled;
+			_zStream.avail_out = end - _filled;
+			const int zErr = inflate(&_zStream, Z_SYNC_FLUSH);
+			_filled = _zStream.next_out - _buffer;
+
+			if (zErr != Z_OK && !(zErr == Z_STREAM_END && _filled == _size)) {
+				_err = true;
+				break;
+			}
+#endif
+		}
+
+#ifdef USE_ZLIB
+		_crcData = crc32(_crcData, newData, _buffer + _filled - newData);
+#endif
+	}
+
+	if (_filled == _size && _archiveStream) {
+#ifdef USE_ZLIB
+		if (_crcData != _crc) {
+			warning("ZipMemberStream: CRC mismatch");
+			_err = true;
+		}
+#endif
+		finish();
+	}
+
+	return !_err;
+}
+
+bool ZipMemberStream::seek(int64 offset, int whence) {
+	switch (whence) {
+	case SEEK_END:
+		offset += _size;
+		break;
+	case SEEK_CUR:
+		offset += _pos;
+		break;
+	case SEEK_SET:
+	default:
+		break;
+	}
+
+	if (offset < 0 || offset > _size)
+		return false;
+
+	_pos = offset;
+	_eos = false;
+	return true;
+}
+
+uint32 ZipMemberStream::read(void *dataPtr, uint32 dataSize) {
+	if (dataSize > _size - _pos) {
+		dataSize = _size - _pos;
+		_eos = true;
+	}
+
+	if (_pos + dataSize > _filled && !fill(_pos + dataSize))
+		dataSize = MIN(dataSize, _filled - MIN(_filled, _pos));
+
+	memcpy(dataPtr, _buffer + _pos, dataSize);
+	_pos += dataSize;
+	return dataSize;
+}
+
+const byte *ZipMemberStream::getBuffer() const {
+	if (_filled < _size && !const_cast<ZipMemberStream *>(this)->fill(_size))
+		return nullptr;
+
+	return _err ? nullptr : _buffer;
+}
+
 
 class ZipArchive : public Archive {
 	unzFile _zipFile;
 
 public:
+	/**
+	 * Members at least this large are decompressed on demand by a
+	 * ZipMemberStream, smaller ones are decompressed in one go.
+	 */
+	static const uint32 kMinStreamedSize = 256 * 1024;
+
 	ZipArchive(unzFile zipFile);
 
 
@@ -1455,8 +1677,8 @@ ZipArchive::~ZipArchive() {
 }
 
 bool ZipArchive::hasFile(const Path &path) const {
-	String name = path.toString();
-	return (unzLocateFile(_zipFile, name.c_str(), 2) == UNZ_OK);
+	const unz_s *const archive = (const unz_s *)_zipFile;
+	return archive->_hash.contains(path.toString());
 }
 
 int ZipArchive::listMembers(ArchiveMemberList &list) const {
@@ -1486,10 +1708,37 @@ SeekableReadStream *ZipArchive::createReadStreamForMember(const Path &path) cons
 		return nullptr;
 
 	unz_file_info fileInfo;
-	if (unzOpenCurrentFile(_zipFile) != UNZ_OK)
+	if (unzGetCurrentFileInfo(_zipFile, &fileInfo, nullptr, 0, nullptr, 0, nullptr, 0) != UNZ_OK)
 		return nullptr;
 
-	if (unzGetCurrentFileInfo(_zipFile, &fileInfo, nullptr, 0, nullptr, 0, nullptr, 0) != UNZ_OK)
+	// Reject the methods neither path can decode up front, like
+	// unzOpenCurrentFile does for the small members
+	if (fileInfo.compression_method != 0 && fileInfo.compression_method != Z_DEFLATED)
+		return nullptr;
+#ifndef USE_ZLIB
+	if (fileInfo.compression_method != 0)
+		return nullptr;
+#endif
+
+	if (fileInfo.uncompressed_size >= kMinStreamedSize) {
+		unz_s *const archive = (unz_s *)_zipFile;
+		uInt headerSize;
+		uLong extraFieldOffset;
+		uInt extraFieldSize;
+		if (unzlocal_CheckCurrentFileCoherencyHeader(archive, &headerSize, &extraFieldOffset, &extraFieldSize) != UNZ_OK)
+			return nullptr;
+
+		const uint32 dataOffset = archive->byte_before_the_zipfile +
+			archive->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER + headerSize;
+		ZipMemberStream *stream = new ZipMemberStream(archive->_archiveStream, dataOffset, fileInfo);
+		if (stream->err()) {
+			delete stream;
+			return nullptr;
+		}
+		return stream;
+	}
+
+	if (unzOpenCurrentFile(_zipFile) != UNZ_OK)
 		return nullptr;
 
 	byte *buffer = (byte *)malloc(fileInfo.uncompressed_size);
@@ -1506,11 +1755,6 @@ SeekableReadStream *ZipArchive::createReadStreamForMember(const Path &path) cons
 	}
 
 	return new MemoryReadStream(buffer, fileInfo.uncompressed_size, DisposeAfterUse::YES);
-
-	// FIXME: instead of reading all into a memory stream, we could
-	// instead create a new ZipStream class. But then we have to be
-	// careful to handle the case where the client code opens multiple
-	// files in the archive and tries to use them independently.
 }
 
 Archive *makeZipArchive(const String &name) {
@@ -385,6 +385,7 @@ Common::Error AdvancedMetaEngineDetection::createInstance(OSystem *syst, Engine
 
 	// Run the detector on this
 	ADDetectedGames matches = detectGame(files.begin()->getParent(), allFiles, language, platform, extra);
+	MD5Man.flushPersistent();
 
 	if (cleanupPirated(matches))
 		return Common::kNoGameDataFoundError;
@@ -504,6 +505,109 @@ namespace Common {
 	DECLARE_SINGLETON(MD5CacheManager);
 }
 
+static const char *const kMD5CacheFileName = "scummvm-md5.cache";
+static const char *const kMD5CacheHeader = "ScummVM MD5 cache 1";
+
+Common::String MD5CacheManager::persistentKey(const Common::String &key, const Common::FSNode &node) {
+	return key + ":" + node.getPath();
+}
+
+Common::FSNode MD5CacheManager::getPersistentFile() const {
+	// Keep the cache next to the configuration file
+	Common::String configFile = ConfMan.getCustomConfigFileName();
+	if (configFile.empty())
+		configFile = g_system->getDefaultConfigFileName();
+
+	Common::FSNode dir = Common::FSNode(configFile).getParent();
+	if (dir.isDirectory())
+		return dir.getChild(kMD5CacheFileName);
+
+	return Common::FSNode(kMD5CacheFileName);
+}
+
+void MD5CacheManager::loadPersistent() {
+	_persistentLoaded = true;
+
+	Common::ScopedPtr<Common::SeekableReadStream> stream(getPersistentFile().createReadStream());
+	if (!stream)
+		return;
+
+	// Caches written by other versions are simply rebuilt
+	if (stream->readLine() != kMD5CacheHeader)
+		return;
+
+	while (!stream->eos() && !stream->err()) {
+		Common::StringTokenizer tokenizer(stream->readLine(), "\t");
+
+		PersistentEntry entry;
+		entry.fileSize = tokenizer.nextToken().asUint64();
+		entry.modificationTime = tokenizer.nextToken().asUint64();
+		entry.size = tokenizer.nextToken().asUint64();
+		entry.md5 = tokenizer.nextToken();
+		Common::String key = tokenizer.nextToken();
+
+		if (!key.empty() && tokenizer.empty())
+			_persistent[key] = entry;
+	}
+
+	debugC(2, kDebugGlobalDetection, "Loaded %u entries from the MD5 cache", _persistent.size());
+}
+
+bool MD5CacheManager::getPersistent(const Common::String &key, const Common::FSNode &node, FileProperties &fileProps) {
+	if (!_persistentLoaded)
+		loadPersistent();
+
+	int64 fileSize, modificationTime;
+	if (_persistent.empty() || !node.getFileInfo(fileSize, modificationTime))
+		return false;
+
+	PersistentMap::const_iterator i = _persistent.find(persistentKey(key, node));
+	if (i == _persistent.end() || i->_value.fileSize != fileSize || i->_value.modificationTime != modificationTime)
+		return false;
+
+	fileProps.size = i->_value.size;
+	fileProps.md5 = i->_value.md5;
+	return true;
+}
+
+void MD5CacheManager::setPersistent(const Common::String &key, const Common::FSNode &node, const FileProperties &fileProps) {
+	if (!_persistentLoaded)
+		loadPersistent();
+
+	PersistentEntry entry;
+	if (!node.getFileInfo(entry.fileSize, entry.modificationTime))
+		return;
+
+	entry.size = fileProps.size;
+	entry.md5 = fileProps.md5;
+	_persistent[persistentKey(key, node)] = entry;
+	_persistentDirty = true;
+}
+
+void MD5CacheManager::flushPersistent() {
+	if (!_persistentDirty)
+		return;
+
+	Common::ScopedPtr<Common::WriteStream> stream(getPersistentFile().createWriteStream());
+	if (!stream) {
+		warning("Unable to write the MD5 cache");
+		return;
+	}
+
+	stream->writeString(kMD5CacheHeader);
+	stream->writeByte('\n');
+
+	for (PersistentMap::const_iterator i = _persistent.begin(); i != _persistent.end(); ++i) {
+		const PersistentEntry &entry = i->_value;
+		stream->writeString(Common::String::format("%llu\t%llu\t%llu\t%s\t%s\n",
+			(unsigned long long)entry.fileSize, (unsigned long long)entry.modificationTime,
+			(unsigned long long)entry.size, entry.md5.c_str(), i->_key.c_str()));
+	}
+
+	stream->finalize();
+	_persistentDirty = false;
+}
+
 // Sync with engines/game.cpp
 static char flagsToMD5Prefix(uint32 flags) {
 	if (flags & ADGF_MACRESFORK) {
@@ -528,7 +632,24 @@ bool AdvancedMetaEngineDetection::getFileProperties(const FileMap &allFiles, con
 		return true;
 	}
 
-	bool res = getFilePropertiesIntern(_md5Bytes, allFiles, game, fname, fileProps);
+	// Results are stored in the persistent cache under the node of the file
+	// itself. Resource forks are not cached there: MacResManager may read
+	// them from a separate file (AppleDouble, MacBinary, __MACOSX), and
+	// changes to that file would go unnoticed.
+	const Common::FSNode *node = nullptr;
+	if (!(game.flags & ADGF_MACRESFORK) && allFiles.contains(fname))
+		node = &allFiles[fname];
+	Common::String persistentKey = Common::String::format("%c:%d", flagsToMD5Prefix(game.flags), _md5Bytes);
+
+	bool res;
+	if (node && MD5Man.getPersistent(persistentKey, *node, fileProps)) {
+		res = true;
+	} else {
+		res = getFilePropertiesIntern(_md5Bytes, allFiles, game, fname, fileProps);
+
+		if (res && node)
+			MD5Man.setPersistent(persistentKey, *node, fileProps);
+	}
 
 	if (res) {
 		MD5Man.setMD5(hashname, fileProps.md5);
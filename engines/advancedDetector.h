@@ -534,6 +534,11 @@ public:
 
 /**
  * Singleton Cache Storage for Computed MD5s
+ *
+ * Besides the cache for the current detection run, this keeps a persistent
+ * cache next to the configuration file, which remembers the properties of
+ * files between runs for as long as their size and modification time stay
+ * the same. This makes detecting an unchanged game collection again cheap.
  */
 class MD5CacheManager : public Common::Singleton<MD5CacheManager> {
 public:
@@ -557,18 +562,52 @@ public:
 		return (md5HashMap.contains(fname) && sizeHashMap.contains(fname));
 	}
 
-	MD5CacheManager() {
+	MD5CacheManager() : _persistentLoaded(false), _persistentDirty(false) {
 		clear();
 	}
 
+	/** Clear the cache of the current detection run. The persistent cache is kept. */
 	void clear() {
 		md5HashMap.clear(true);
 		sizeHashMap.clear(true);
 	}
 
+	/**
+	 * Look up the properties of a file in the persistent cache.
+	 *
+	 * @param key   Identifies what was computed, without the file path.
+	 * @param node  The file the properties were computed from.
+	 *
+	 * @return True if an entry exists and the file is unchanged since.
+	 */
+	bool getPersistent(const Common::String &key, const Common::FSNode &node, FileProperties &fileProps);
+
+	/** Store the properties of a file in the persistent cache. */
+	void setPersistent(const Common::String &key, const Common::FSNode &node, const FileProperties &fileProps);
+
+	/** Write the persistent cache back to disk, if it changed. */
+	void flushPersistent();
+
 private:
 	friend class Common::Singleton<MD5CacheManager>;
 
+	struct PersistentEntry {
+		int64 fileSize;
+		int64 modificationTime;
+		int64 size;
+		Common::String md5;
+	};
+
+	typedef Common::HashMap<Common::String, PersistentEntry> PersistentMap;
+
+	Common::FSNode getPersistentFile() const;
+	void loadPersistent();
+	static Common::String persistentKey(const Common::String &key, const Common::FSNode &node);
+
+	PersistentMap _persistent;
+	bool _persistentLoaded;
+	bool _persistentDirty;
+
 	typedef Common::HashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> FileHashMap;
 	typedef Common::HashMap<Common::String, int64, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> SizeHashMap;
 	FileHashMap md5HashMap;
@@ -146,6 +146,8 @@ Common::Error AGSEngine::run() {
 
 #ifdef ENABLE_AGS_TESTS
 	AGS3::Test_DoAllTests();
+	if (debugChannelSet(-1, kDebugGraphics))
+		AGS3::Test_GfxSpeed();
 	return Common::kNoError;
 #endif
 
@@ -221,6 +221,7 @@ public:
 	int _trans_blend_green = 0;
 	int _trans_blend_blue = 0;
 	BlenderMode __blender_mode = kRgbToRgbBlender;
+	bool __blender_row_kernels = true; // Blend whole 32-bit rows at once, where possible
 	/* current format information and worker routines */
 	int _utype = U_UTF8;
 
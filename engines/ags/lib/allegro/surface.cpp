@@ -22,6 +22,7 @@
 #include "ags/lib/allegro/gfx.h"
 #include "ags/lib/allegro/color.h"
 #include "ags/lib/allegro/flood.h"
+#include "ags/lib/allegro/surface_dsp.h"
 #include "ags/ags.h"
 #include "ags/globals.h"
 #include "common/textconsole.h"
@@ -107,6 +108,17 @@ void BITMAP::floodfill(int x, int y, int color) {
 const int SCALE_THRESHOLD = 0x100;
 #define VGA_COLOR_TRANS(x) ((x) * 255 / 63)
 
+// Return the row kernel of the current blender mode, if there is one for
+// blending between the given formats
+static BlenderRowFunc getBlenderRow(const Graphics::PixelFormat &srcFormat, const Graphics::PixelFormat &destFormat, bool scaled) {
+	if (!_G(_blender_row_kernels) || srcFormat != destFormat ||
+	        destFormat != Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24))
+		return nullptr;
+
+	const BlenderDSP &dsp = getBlenderDSP();
+	return scaled ? dsp.blendScaledRow[_G(_blender_mode)] : dsp.blendRow[_G(_blender_mode)];
+}
+
 void BITMAP::draw(const BITMAP *srcBitmap, const Common::Rect &srcRect,
                   int dstX, int dstY, bool horizFlip, bool vertFlip,
                   bool skipTrans, int srcAlpha, int tintRed, int tintGreen,
@@ -166,6 +178,11 @@ void BITMAP::draw(const BITMAP *srcBitmap, const Common::Rect &srcRect,
 	int xStart = (dstRect.left < destRect.left) ? dstRect.left - destRect.left : 0;
 	int yStart = (dstRect.top < destRect.top) ? dstRect.top - destRect.top : 0;
 
+	// Flipped rows step backwards through the source, like scaled ones
+	const BlenderRowFunc blendRow = (srcAlpha != -1 && !useTint) ? getBlenderRow(src.format, format, horizFlip) : nullptr;
+	const int rowStart = -xStart;
+	const int rowCount = MIN<int>(dstRect.width(), destArea.w - xStart) - rowStart;
+
 	for (int destY = yStart, yCtr = 0; yCtr < dstRect.height(); ++destY, ++yCtr) {
 		if (destY < 0 || destY >= destArea.h)
 			continue;
@@ -175,6 +192,19 @@ void BITMAP::draw(const BITMAP *srcBitmap, const Common::Rect &srcRect,
 		                       vertFlip ? srcArea.bottom - 1 - yCtr :
 		                       srcArea.top + yCtr);
 
+		if (blendRow) {
+			BlenderRow row;
+			row.dest = (uint32 *)destP;
+			row.src = (const uint32 *)srcP;
+			row.count = rowCount;
+			row.srcX = xDir * rowStart * SCALE_THRESHOLD;
+			row.srcStep = xDir * SCALE_THRESHOLD;
+			row.alpha = srcAlpha;
+			row.skipTrans = skipTrans;
+			blendRow(row);
+			continue;
+		}
+
 		// Loop through the pixels of the row
 		for (int destX = xStart, xCtr = 0, xCtrBpp = 0; xCtr < dstRect.width(); ++destX, ++xCtr, xCtrBpp += src.format.bytesPerPixel) {
 			if (destX < 0 || destX >= destArea.w)
@@ -293,6 +323,10 @@ void BITMAP::stretchDraw(const BITMAP *srcBitmap, const Common::Rect &srcRect,
 	int xStart = (dstRect.left < destRect.left) ? dstRect.left - destRect.left : 0;
 	int yStart = (dstRect.top < destRect.top) ? dstRect.top - destRect.top : 0;
 
+	const BlenderRowFunc blendRow = (srcAlpha != -1) ? getBlenderRow(src.format, format, true) : nullptr;
+	const int rowStart = -xStart;
+	const int rowCount = MIN<int>(dstRect.width(), destArea.w - xStart) - rowStart;
+
 	for (int destY = yStart, yCtr = 0, scaleYCtr = 0; yCtr < dstRect.height();
 	        ++destY, ++yCtr, scaleYCtr += scaleY) {
 		if (destY < 0 || destY >= destArea.h)
@@ -301,6 +335,19 @@ void BITMAP::stretchDraw(const BITMAP *srcBitmap, const Common::Rect &srcRect,
 		const byte *srcP = (const byte *)src.getBasePtr(
 		                       srcRect.left, srcRect.top + scaleYCtr / SCALE_THRESHOLD);
 
+		if (blendRow) {
+			BlenderRow row;
+			row.dest = (uint32 *)destP;
+			row.src = (const uint32 *)srcP;
+			row.count = rowCount;
+			row.srcX = rowStart * scaleX;
+			row.srcStep = scaleX;
+			row.alpha = srcAlpha;
+			row.skipTrans = skipTrans;
+			blendRow(row);
+			continue;
+		}
+
 		// Loop through the pixels of the row
 		for (int destX = xStart, xCtr = 0, scaleXCtr = 0; xCtr < dstRect.width();
 		        ++destX, ++xCtr, scaleXCtr += scaleX) {
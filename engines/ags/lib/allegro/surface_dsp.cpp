@@ -0,0 +1,107 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/system.h"
+#include "ags/lib/allegro/surface_dsp.h"
+
+namespace AGS3 {
+
+// Same as BITMAP::rgbBlend, on whole pixels
+static inline uint32 rgbBlend(uint32 src, uint32 dst, uint32 alpha) {
+	if (alpha)
+		alpha++;
+
+	const uint32 x = src & 0xFFFFFF;
+	const uint32 y = dst & 0xFFFFFF;
+	const uint32 res = ((x & 0xFF00FF) - (y & 0xFF00FF)) * alpha / 256 + y;
+	const uint32 g = ((x & 0xFF00) - (y & 0xFF00)) * alpha / 256 + (y & 0xFF00);
+	return (res & 0xFF00FF) | (g & 0xFF00);
+}
+
+template <int kMode>
+static inline uint32 blendPixel(uint32 src, uint32 dst, uint32 alpha) {
+	const uint32 aSrc = src >> 24;
+	switch (kMode) {
+	case kSourceAlphaBlender:
+		return rgbBlend(src, dst, aSrc);
+	case kArgbToRgbBlender:
+		return rgbBlend(src, dst, alpha == 0 ? aSrc : aSrc * ((alpha & 0xff) + 1) / 256);
+	case kRgbToRgbBlender:
+		return rgbBlend(src, dst, alpha);
+	case kAlphaPreservedBlenderMode:
+		return rgbBlend(src, dst, alpha) | (dst & 0xFF000000);
+	case kOpaqueBlenderMode:
+		return src | 0xFF000000;
+	case kAdditiveBlenderMode:
+	default:
+		return (src & 0xFFFFFF) | (MIN<uint32>(aSrc + (dst >> 24), 0xff) << 24);
+	}
+}
+
+template <int kMode, bool kScaled>
+static void blendRow(const BlenderRow &row) {
+	for (int i = 0; i < row.count; i++) {
+		const uint32 src = kScaled ? row.src[(row.srcX + i * row.srcStep) / 256] : row.src[row.srcX / 256 + i];
+		if (row.skipTrans && (src & 0xFFFFFF) == 0xFF00FF)
+			continue;
+		row.dest[i] = blendPixel<kMode>(src, row.dest[i], row.alpha);
+	}
+}
+
+template <int kMode>
+static void setKernels(BlenderDSP &dsp) {
+	dsp.blendRow[kMode] = blendRow<kMode, false>;
+	dsp.blendScaledRow[kMode] = blendRow<kMode, true>;
+}
+
+void initBlenderDSP(BlenderDSP &dsp) {
+	for (int i = 0; i <= kTintLightBlenderMode; i++)
+		dsp.blendRow[i] = dsp.blendScaledRow[i] = nullptr;
+
+	setKernels<kSourceAlphaBlender>(dsp);
+	setKernels<kArgbToRgbBlender>(dsp);
+	setKernels<kRgbToRgbBlender>(dsp);
+	setKernels<kAlphaPreservedBlenderMode>(dsp);
+	setKernels<kOpaqueBlenderMode>(dsp);
+	setKernels<kAdditiveBlenderMode>(dsp);
+}
+
+static BlenderDSP selectBlenderDSP() {
+	BlenderDSP dsp;
+	initBlenderDSP(dsp);
+
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasCpuFeature(OSystem::kCpuFeatureSSE2))
+		initBlenderDSPSSE2(dsp);
+#endif
+#ifdef SCUMMVM_NEON
+	if (g_system->hasCpuFeature(OSystem::kCpuFeatureNEON))
+		initBlenderDSPNEON(dsp);
+#endif
+	return dsp;
+}
+
+const BlenderDSP &getBlenderDSP() {
+	static const BlenderDSP dsp = selectBlenderDSP();
+	return dsp;
+}
+
+} // namespace AGS3
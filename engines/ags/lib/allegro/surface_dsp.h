@@ -0,0 +1,78 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AGS_LIB_ALLEGRO_SURFACE_DSP_H
+#define AGS_LIB_ALLEGRO_SURFACE_DSP_H
+
+#include "common/scummsys.h"
+#include "ags/lib/allegro/color.h"
+
+namespace AGS3 {
+
+/**
+ * One row of a blended blit between 32-bit bitmaps, which both use the
+ * ARGB format of create_bitmap_ex(). Destination pixel i gets blended with
+ * source pixel src[(srcX + i * srcStep) / 256]; rows which are neither
+ * scaled nor flipped step by 256.
+ */
+struct BlenderRow {
+	uint32 *dest;
+	const uint32 *src;
+	int count;
+	int srcX, srcStep;
+	/** The alpha passed on to the blender, as given to BITMAP::draw. */
+	uint32 alpha;
+	/** Leave the destination alone where the source is the mask color. */
+	bool skipTrans;
+};
+
+typedef void (*BlenderRowFunc)(const BlenderRow &row);
+
+/**
+ * The row kernels of the BITMAP blenders, for the modes whose integer math
+ * can be done on several pixels at once. They give exactly the pixels the
+ * BITMAP blender functions give. The other modes have no kernels, and get
+ * blended pixel by pixel.
+ */
+struct BlenderDSP {
+	/** Kernels for rows which step by 256 through the source. */
+	BlenderRowFunc blendRow[kTintLightBlenderMode + 1];
+	/** Kernels for any step, as used by scaled and flipped blits. */
+	BlenderRowFunc blendScaledRow[kTintLightBlenderMode + 1];
+};
+
+/** Set up the plain C++ kernels. */
+void initBlenderDSP(BlenderDSP &dsp);
+
+#ifdef SCUMMVM_SSE2
+void initBlenderDSPSSE2(BlenderDSP &dsp);
+#endif
+
+#ifdef SCUMMVM_NEON
+void initBlenderDSPNEON(BlenderDSP &dsp);
+#endif
+
+/** Return the fastest kernels the host CPU supports. */
+const BlenderDSP &getBlenderDSP();
+
+} // namespace AGS3
+
+#endif
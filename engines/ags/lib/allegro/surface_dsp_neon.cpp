@@ -0,0 +1,129 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <arm_neon.h>
+
+#include "ags/lib/allegro/surface_dsp.h"
+
+namespace AGS3 {
+
+// Same as BITMAP::rgbBlend, wrap around of the products included
+static inline uint32x4_t rgbBlend(uint32x4_t src, uint32x4_t dst, uint32x4_t alpha) {
+	const uint32x4_t rbMask = vdupq_n_u32(0xFF00FF);
+	const uint32x4_t gMask = vdupq_n_u32(0xFF00);
+	alpha = vsubq_u32(alpha, vmvnq_u32(vceqq_u32(alpha, vdupq_n_u32(0))));
+
+	const uint32x4_t y = vandq_u32(dst, vdupq_n_u32(0xFFFFFF));
+	const uint32x4_t res = vaddq_u32(vshrq_n_u32(vmulq_u32(vsubq_u32(vandq_u32(src, rbMask), vandq_u32(y, rbMask)), alpha), 8), y);
+	const uint32x4_t yG = vandq_u32(y, gMask);
+	const uint32x4_t g = vaddq_u32(vshrq_n_u32(vmulq_u32(vsubq_u32(vandq_u32(src, gMask), yG), alpha), 8), yG);
+	return vorrq_u32(vandq_u32(res, rbMask), vandq_u32(g, gMask));
+}
+
+template <int kMode>
+static inline uint32x4_t blendPixels(uint32x4_t src, uint32x4_t dst, uint32x4_t alpha) {
+	const uint32x4_t aSrc = vshrq_n_u32(src, 24);
+	const uint32x4_t alphaMask = vdupq_n_u32(0xFF000000);
+	switch (kMode) {
+	case kSourceAlphaBlender:
+		return rgbBlend(src, dst, aSrc);
+	case kArgbToRgbBlender:
+		// alpha is the same in all lanes
+		if (vgetq_lane_u32(alpha, 0) == 0)
+			return rgbBlend(src, dst, aSrc);
+		return rgbBlend(src, dst, vshrq_n_u32(vmulq_u32(aSrc, vaddq_u32(vandq_u32(alpha, vdupq_n_u32(0xff)), vdupq_n_u32(1))), 8));
+	case kRgbToRgbBlender:
+		return rgbBlend(src, dst, alpha);
+	case kAlphaPreservedBlenderMode:
+		return vorrq_u32(rgbBlend(src, dst, alpha), vandq_u32(dst, alphaMask));
+	case kOpaqueBlenderMode:
+		return vorrq_u32(src, alphaMask);
+	case kAdditiveBlenderMode:
+	default: {
+		const uint32x4_t a = vminq_u32(vaddq_u32(aSrc, vshrq_n_u32(dst, 24)), vdupq_n_u32(0xff));
+		return vorrq_u32(vbicq_u32(src, alphaMask), vshlq_n_u32(a, 24));
+	}
+	}
+}
+
+template <int kMode>
+static inline void blendFour(uint32 *dest, uint32x4_t src, uint32x4_t alpha, bool skipTrans) {
+	const uint32x4_t dst = vld1q_u32(dest);
+	uint32x4_t result = blendPixels<kMode>(src, dst, alpha);
+	if (skipTrans) {
+		const uint32x4_t trans = vceqq_u32(vandq_u32(src, vdupq_n_u32(0xFFFFFF)), vdupq_n_u32(0xFF00FF));
+		result = vbslq_u32(trans, dst, result);
+	}
+	vst1q_u32(dest, result);
+}
+
+template <int kMode, bool kScaled>
+static void blendRow(const BlenderRow &row) {
+	const uint32x4_t alpha = vdupq_n_u32(row.alpha);
+	const uint32 *src = row.src + (kScaled ? 0 : row.srcX / 256);
+
+	int i = 0;
+	for (; i + 4 <= row.count; i += 4) {
+		uint32x4_t s;
+		if (kScaled) {
+			const int x = row.srcX + i * row.srcStep;
+			const uint32 pixels[4] = {
+				src[x / 256], src[(x + row.srcStep) / 256],
+				src[(x + 2 * row.srcStep) / 256], src[(x + 3 * row.srcStep) / 256]
+			};
+			s = vld1q_u32(pixels);
+		} else {
+			s = vld1q_u32(src + i);
+		}
+		blendFour<kMode>(row.dest + i, s, alpha, row.skipTrans);
+	}
+
+	const int left = row.count - i;
+	if (left > 0) {
+		// Go through a copy, so that nothing beyond the row gets touched
+		uint32 srcPixels[4] = { 0, 0, 0, 0 };
+		uint32 destPixels[4] = { 0, 0, 0, 0 };
+		for (int j = 0; j < left; j++) {
+			srcPixels[j] = kScaled ? src[(row.srcX + (i + j) * row.srcStep) / 256] : src[i + j];
+			destPixels[j] = row.dest[i + j];
+		}
+		blendFour<kMode>(destPixels, vld1q_u32(srcPixels), alpha, row.skipTrans);
+		for (int j = 0; j < left; j++)
+			row.dest[i + j] = destPixels[j];
+	}
+}
+
+template <int kMode>
+static void setKernels(BlenderDSP &dsp) {
+	dsp.blendRow[kMode] = blendRow<kMode, false>;
+	dsp.blendScaledRow[kMode] = blendRow<kMode, true>;
+}
+
+void initBlenderDSPNEON(BlenderDSP &dsp) {
+	setKernels<kSourceAlphaBlender>(dsp);
+	setKernels<kArgbToRgbBlender>(dsp);
+	setKernels<kRgbToRgbBlender>(dsp);
+	setKernels<kAlphaPreservedBlenderMode>(dsp);
+	setKernels<kOpaqueBlenderMode>(dsp);
+	setKernels<kAdditiveBlenderMode>(dsp);
+}
+
+} // namespace AGS3
@@ -0,0 +1,142 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <emmintrin.h>
+
+#include "ags/lib/allegro/surface_dsp.h"
+
+namespace AGS3 {
+
+static inline __m128i mullo32(__m128i a, __m128i b) {
+	// SSE2 only multiplies the even lanes into 64-bit products
+	const __m128i even = _mm_mul_epu32(a, b);
+	const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+static inline __m128i selectLanes(__m128i mask, __m128i a, __m128i b) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// Same as BITMAP::rgbBlend, wrap around of the products included
+static inline __m128i rgbBlend(__m128i src, __m128i dst, __m128i alpha) {
+	const __m128i rbMask = _mm_set1_epi32(0xFF00FF);
+	const __m128i gMask = _mm_set1_epi32(0xFF00);
+	const __m128i isZero = _mm_cmpeq_epi32(alpha, _mm_setzero_si128());
+	alpha = _mm_sub_epi32(alpha, _mm_andnot_si128(isZero, _mm_set1_epi32(-1)));
+
+	const __m128i x = src;
+	const __m128i y = _mm_and_si128(dst, _mm_set1_epi32(0xFFFFFF));
+	const __m128i res = _mm_add_epi32(_mm_srli_epi32(mullo32(_mm_sub_epi32(_mm_and_si128(x, rbMask), _mm_and_si128(y, rbMask)), alpha), 8), y);
+	const __m128i yG = _mm_and_si128(y, gMask);
+	const __m128i g = _mm_add_epi32(_mm_srli_epi32(mullo32(_mm_sub_epi32(_mm_and_si128(x, gMask), yG), alpha), 8), yG);
+	return _mm_or_si128(_mm_and_si128(res, rbMask), _mm_and_si128(g, gMask));
+}
+
+template <int kMode>
+static inline __m128i blendPixels(__m128i src, __m128i dst, __m128i alpha) {
+	const __m128i aSrc = _mm_srli_epi32(src, 24);
+	const __m128i alphaMask = _mm_set1_epi32((int)0xFF000000);
+	switch (kMode) {
+	case kSourceAlphaBlender:
+		return rgbBlend(src, dst, aSrc);
+	case kArgbToRgbBlender: {
+		// alpha is the same in all lanes
+		if (_mm_cvtsi128_si32(alpha) == 0)
+			return rgbBlend(src, dst, aSrc);
+		const __m128i scale = _mm_add_epi32(_mm_and_si128(alpha, _mm_set1_epi32(0xff)), _mm_set1_epi32(1));
+		return rgbBlend(src, dst, _mm_srli_epi32(_mm_mullo_epi16(aSrc, scale), 8));
+	}
+	case kRgbToRgbBlender:
+		return rgbBlend(src, dst, alpha);
+	case kAlphaPreservedBlenderMode:
+		return _mm_or_si128(rgbBlend(src, dst, alpha), _mm_and_si128(dst, alphaMask));
+	case kOpaqueBlenderMode:
+		return _mm_or_si128(src, alphaMask);
+	case kAdditiveBlenderMode:
+	default: {
+		// Both alphas fit into signed 16 bits, and so does their sum
+		const __m128i a = _mm_min_epi16(_mm_add_epi32(aSrc, _mm_srli_epi32(dst, 24)), _mm_set1_epi32(0xff));
+		return _mm_or_si128(_mm_andnot_si128(alphaMask, src), _mm_slli_epi32(a, 24));
+	}
+	}
+}
+
+template <int kMode>
+static inline void blendFour(uint32 *dest, __m128i src, __m128i alpha, bool skipTrans) {
+	const __m128i dst = _mm_loadu_si128((const __m128i *)dest);
+	__m128i result = blendPixels<kMode>(src, dst, alpha);
+	if (skipTrans) {
+		const __m128i trans = _mm_cmpeq_epi32(_mm_and_si128(src, _mm_set1_epi32(0xFFFFFF)), _mm_set1_epi32(0xFF00FF));
+		result = selectLanes(trans, dst, result);
+	}
+	_mm_storeu_si128((__m128i *)dest, result);
+}
+
+template <int kMode, bool kScaled>
+static void blendRow(const BlenderRow &row) {
+	const __m128i alpha = _mm_set1_epi32((int)row.alpha);
+	const uint32 *src = row.src + (kScaled ? 0 : row.srcX / 256);
+
+	int i = 0;
+	for (; i + 4 <= row.count; i += 4) {
+		__m128i s;
+		if (kScaled) {
+			const int x = row.srcX + i * row.srcStep;
+			s = _mm_set_epi32((int)src[(x + 3 * row.srcStep) / 256], (int)src[(x + 2 * row.srcStep) / 256],
+			                  (int)src[(x + row.srcStep) / 256], (int)src[x / 256]);
+		} else {
+			s = _mm_loadu_si128((const __m128i *)(src + i));
+		}
+		blendFour<kMode>(row.dest + i, s, alpha, row.skipTrans);
+	}
+
+	const int left = row.count - i;
+	if (left > 0) {
+		// Go through a copy, so that nothing beyond the row gets touched
+		uint32 srcPixels[4] = { 0, 0, 0, 0 };
+		uint32 destPixels[4] = { 0, 0, 0, 0 };
+		for (int j = 0; j < left; j++) {
+			srcPixels[j] = kScaled ? src[(row.srcX + (i + j) * row.srcStep) / 256] : src[i + j];
+			destPixels[j] = row.dest[i + j];
+		}
+		blendFour<kMode>(destPixels, _mm_loadu_si128((const __m128i *)srcPixels), alpha, row.skipTrans);
+		for (int j = 0; j < left; j++)
+			row.dest[i + j] = destPixels[j];
+	}
+}
+
+template <int kMode>
+static void setKernels(BlenderDSP &dsp) {
+	dsp.blendRow[kMode] = blendRow<kMode, false>;
+	dsp.blendScaledRow[kMode] = blendRow<kMode, true>;
+}
+
+void initBlenderDSPSSE2(BlenderDSP &dsp) {
+	setKernels<kSourceAlphaBlender>(dsp);
+	setKernels<kArgbToRgbBlender>(dsp);
+	setKernels<kRgbToRgbBlender>(dsp);
+	setKernels<kAlphaPreservedBlenderMode>(dsp);
+	setKernels<kOpaqueBlenderMode>(dsp);
+	setKernels<kAdditiveBlenderMode>(dsp);
+}
+
+} // namespace AGS3
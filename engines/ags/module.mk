@@ -24,6 +24,7 @@ MODULE_OBJS = \
 	lib/allegro/math.o \
 	lib/allegro/rotate.o \
 	lib/allegro/surface.o \
+	lib/allegro/surface_dsp.o \
 	lib/allegro/system.o \
 	lib/allegro/unicode.o \
 	lib/std/std.o \
@@ -358,6 +359,18 @@ MODULE_OBJS = \
 	plugins/ags_waves/warper.o \
 	plugins/ags_waves/weather.o
 
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	lib/allegro/surface_dsp_sse2.o
+
+$(MODULE)/lib/allegro/surface_dsp_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	lib/allegro/surface_dsp_neon.o
+endif
+
 ifdef ENABLE_AGS_TESTS
 MODULE_OBJS += \
 	tests/test_all.o \
@@ -369,6 +382,9 @@ MODULE_OBJS += \
 	tests/test_sprintf.o \
 	tests/test_string.o \
 	tests/test_version.o
+
+# Let the engine run the tests instead of the game
+$(addprefix $(MODULE)/, $(MODULE_OBJS)): CPPFLAGS += -DENABLE_AGS_TESTS
 endif
 
 # This module can be built as a plugin
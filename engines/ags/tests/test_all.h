@@ -34,6 +34,10 @@ extern void Test_IniFile();
 
 // Graphics tests
 extern void Test_Gfx();
+extern void Test_BlenderModes();
+
+// Graphics benchmarks, not run by Test_DoAllTests
+extern void Test_GfxSpeed();
 
 // Memory / bit-byte operations
 extern void Test_Memory();
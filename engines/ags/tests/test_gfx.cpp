@@ -22,12 +22,128 @@
 #include "common/scummsys.h"
 #include "ags/shared/core/platform.h"
 #include "ags/shared/gfx/gfx_def.h"
-#include "ags/shared/debugging/assert.h"
+#include "ags/lib/allegro/color.h"
+#include "ags/lib/allegro/surface.h"
+#include "ags/globals.h"
+#include "common/debug.h"
+#include "common/system.h"
 
 namespace AGS3 {
 
 namespace GfxDef = AGS::Shared::GfxDef;
 
+static const BlenderMode BLENDER_MODES[] = {
+	kSourceAlphaBlender, kArgbToArgbBlender, kArgbToRgbBlender, kRgbToArgbBlender,
+	kRgbToRgbBlender, kAlphaPreservedBlenderMode, kOpaqueBlenderMode, kAdditiveBlenderMode,
+	kTintBlenderMode, kTintLightBlenderMode
+};
+
+static void fillRandom(BITMAP *bmp, uint32 &seed) {
+	for (int y = 0; y < bmp->h; ++y) {
+		uint32 *pixels = (uint32 *)bmp->getBasePtr(0, y);
+		for (int x = 0; x < bmp->w; ++x) {
+			seed = seed * 1103515245 + 12345;
+			// Sprinkle in some mask color pixels, with random alphas
+			if ((seed >> 8) % 7 == 0)
+				pixels[x] = (seed & 0xFF000000) | 0xFF00FF;
+			else
+				pixels[x] = (seed >> 16) | (seed << 16);
+		}
+	}
+}
+
+// Blit with and without the blender row kernels, which have to give the same pixels
+static void testBlit(BlenderMode mode, int srcAlpha, bool skipTrans, bool horizFlip, bool scaled, int dstX, int dstY) {
+	uint32 seed = mode * 1000 + srcAlpha;
+	BITMAP *src = create_bitmap_ex(32, 37, 23);
+	BITMAP *dest[2];
+	fillRandom(src, seed);
+	for (int i = 0; i < 2; ++i) {
+		dest[i] = create_bitmap_ex(32, 64, 48);
+		uint32 destSeed = seed;
+		fillRandom(dest[i], destSeed);
+	}
+
+	set_blender_mode(mode, 0, 0, 0, 0);
+	for (int i = 0; i < 2; ++i) {
+		_G(_blender_row_kernels) = (i == 1);
+		if (scaled)
+			dest[i]->stretchDraw(src, Common::Rect(2, 1, 35, 22), Common::Rect(dstX, dstY, dstX + 51, dstY + 17), skipTrans, srcAlpha);
+		else
+			dest[i]->draw(src, Common::Rect(0, 0, src->w, src->h), dstX, dstY, horizFlip, false, skipTrans, srcAlpha);
+	}
+
+	for (int y = 0; y < dest[0]->h; ++y)
+		assert(memcmp(dest[0]->getBasePtr(0, y), dest[1]->getBasePtr(0, y), dest[0]->w * 4) == 0);
+
+	destroy_bitmap(src);
+	destroy_bitmap(dest[0]);
+	destroy_bitmap(dest[1]);
+}
+
+void Test_BlenderModes() {
+	const BlenderMode oldMode = _G(_blender_mode);
+	const bool oldRowKernels = _G(_blender_row_kernels);
+
+	const int alphas[] = { 0, 1, 77, 128, 254, 255 };
+	for (size_t m = 0; m < ARRAYSIZE(BLENDER_MODES); ++m) {
+		// The tint modes have no row kernels, and expect lower alphas
+		if (BLENDER_MODES[m] == kTintBlenderMode || BLENDER_MODES[m] == kTintLightBlenderMode)
+			continue;
+		for (size_t a = 0; a < ARRAYSIZE(alphas); ++a) {
+			for (int skipTrans = 0; skipTrans < 2; ++skipTrans) {
+				testBlit(BLENDER_MODES[m], alphas[a], skipTrans, false, false, 5, 7);
+				testBlit(BLENDER_MODES[m], alphas[a], skipTrans, true, false, -3, 30);
+				testBlit(BLENDER_MODES[m], alphas[a], skipTrans, false, false, 40, -4);
+				testBlit(BLENDER_MODES[m], alphas[a], skipTrans, false, true, -6, 2);
+				testBlit(BLENDER_MODES[m], alphas[a], skipTrans, false, true, 20, 35);
+			}
+		}
+	}
+
+	_G(_blender_row_kernels) = oldRowKernels;
+	set_blender_mode(oldMode, 0, 0, 0, 0);
+}
+
+// Times blended sprite blits, as done by draw_trans_sprite, with and without
+// the blender row kernels. This is not part of Test_Gfx, and only runs with
+// the graphics debug channel enabled.
+void Test_GfxSpeed() {
+	const BlenderMode oldMode = _G(_blender_mode);
+	const bool oldRowKernels = _G(_blender_row_kernels);
+	const int BLIT_COUNT = 2000;
+
+	uint32 seed = 1;
+	BITMAP *sprite = create_bitmap_ex(32, 100, 100);
+	BITMAP *dest = create_bitmap_ex(32, 640, 480);
+	fillRandom(sprite, seed);
+	fillRandom(dest, seed);
+
+	for (size_t m = 0; m < ARRAYSIZE(BLENDER_MODES); ++m) {
+		set_blender_mode(BLENDER_MODES[m], 0, 0, 0, 0);
+		for (int rowKernels = 0; rowKernels < 2; ++rowKernels) {
+			_G(_blender_row_kernels) = rowKernels;
+			uint32 start = g_system->getMillis();
+			for (int i = 0; i < BLIT_COUNT; ++i)
+				dest->draw(sprite, Common::Rect(0, 0, 100, 100), (i * 37) % 540, (i * 23) % 380, false, false, true, 128);
+			const uint32 drawTime = g_system->getMillis() - start;
+
+			start = g_system->getMillis();
+			for (int i = 0; i < BLIT_COUNT; ++i)
+				dest->stretchDraw(sprite, Common::Rect(0, 0, 100, 100), Common::Rect(0, 0, 150, 130), true, 128);
+			const uint32 stretchTime = g_system->getMillis() - start;
+
+			debug("Blender mode %d%s: %d blits in %u ms, %d scaled blits in %u ms", BLENDER_MODES[m],
+			      rowKernels ? " (row kernels)" : "", BLIT_COUNT, drawTime, BLIT_COUNT, stretchTime);
+		}
+	}
+
+	destroy_bitmap(sprite);
+	destroy_bitmap(dest);
+	_G(_blender_row_kernels) = oldRowKernels;
+	set_blender_mode(oldMode, 0, 0, 0, 0);
+}
+
 void Test_Gfx() {
 	// Test that every transparency which is a multiple of 10 is converted
 	// forth and back without loosing precision
@@ -41,6 +157,8 @@ void Test_Gfx() {
 		trans100_back[i] = GfxDef::LegacyTrans255ToTrans100(trans255[i]);
 		assert(trans100[i] == trans100_back[i]);
 	}
+
+	Test_BlenderModes();
 }
 
 } // namespace AGS3
@@ -385,6 +385,7 @@ void ModalVideoPlayer::play(const char *filename) {
 	uint16 x = (g_system->getWidth() - _decoder.getWidth()) / 2;
 	uint16 y = (g_system->getHeight() - _decoder.getHeight()) / 2;
 
+	_decoder.setOutputPixelFormat(g_system->getScreenFormat());
 	_decoder.start();
 
 	while (!g_nmi->shouldQuit() && !_decoder.endOfVideo()) {
@@ -45,6 +45,8 @@ void PrinceEngine::playVideo(Common::String videoFilename) {
 		return;
 	}
 
+	// Have true color frames decoded in the screen format
+	videoDecoder->setOutputPixelFormat(_system->getScreenFormat());
 	videoDecoder->start();
 
 	bool skipVideo = false;
@@ -53,7 +55,7 @@ void PrinceEngine::playVideo(Common::String videoFilename) {
 		if (videoDecoder->needsUpdate()) {
 			const Graphics::Surface *frame = videoDecoder->decodeNextFrame();
 			if (frame) {
-				if (frame->format.bytesPerPixel > 1) {
+				if (frame->format.bytesPerPixel > 1 && frame->format != _system->getScreenFormat()) {
 					Graphics::Surface *frame1 = frame->convertTo(_system->getScreenFormat());
 					_system->copyRectToScreen(frame1->getPixels(), frame1->pitch, 0, 0, frame1->w, frame1->h);
 					frame1->free();
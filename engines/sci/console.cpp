@@ -53,6 +53,7 @@
 #include "sci/video/seq_decoder.h"
 #ifdef ENABLE_SCI32
 #include "common/memstream.h"
+#include "sci/graphics/celobj32.h"
 #include "sci/graphics/frameout.h"
 #include "sci/graphics/paint32.h"
 #include "sci/graphics/palette32.h"
@@ -84,6 +85,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	// Variables
 	registerVar("sleeptime_factor",	&g_debug_sleeptime_factor);
 	registerVar("gc_interval",		&engine->_gamestate->scriptGCInterval);
+	registerVar("gc_incremental",		&engine->_gamestate->_segMan->getIncrementalGC()->_enabled);
 	registerVar("simulated_key",		&g_debug_simulated_key);
 	registerVar("track_mouse_clicks",	&g_debug_track_mouse_clicks);
 	// FIXME: This actually passes an enum type instead of an integer but no
@@ -151,6 +153,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("vpi",                WRAP_METHOD(Console, cmdVisiblePlaneItemList));	// alias
 	registerCmd("saved_bits",         WRAP_METHOD(Console, cmdSavedBits));
 	registerCmd("show_saved_bits",    WRAP_METHOD(Console, cmdShowSavedBits));
+	registerCmd("cel_cache",          WRAP_METHOD(Console, cmdCelCache));
 	// Segments
 	registerCmd("segment_table",		WRAP_METHOD(Console, cmdPrintSegmentTable));
 	registerCmd("segtable",			WRAP_METHOD(Console, cmdPrintSegmentTable));	// alias
@@ -164,6 +167,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("gc_reachable",		WRAP_METHOD(Console, cmdGCShowReachable));
 	registerCmd("gc_freeable",		WRAP_METHOD(Console, cmdGCShowFreeable));
 	registerCmd("gc_normalize",		WRAP_METHOD(Console, cmdGCNormalize));
+	registerCmd("gc_timings",		WRAP_METHOD(Console, cmdGCTimings));
 	// Music/SFX
 	registerCmd("songlib",			WRAP_METHOD(Console, cmdSongLib));
 	registerCmd("songinfo",			WRAP_METHOD(Console, cmdSongInfo));
@@ -318,6 +322,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf("---------\n");
 	debugPrintf("sleeptime_factor: Factor to multiply with wait times in kWait()\n");
 	debugPrintf("gc_interval: Number of kernel calls in between garbage collections\n");
+	debugPrintf("gc_incremental: Set to true to collect garbage incrementally, in small steps\n");
 	debugPrintf("simulated_key: Add a key with the specified scan code to the event list\n");
 	debugPrintf("track_mouse_clicks: Toggles mouse click tracking to the console\n");
 	debugPrintf("script_abort_flag: Set to 1 to abort script execution. Set to 2 to force a replay afterwards\n");
@@ -386,6 +391,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" visible_plane_items / vpi - Shows a list of all items for a plane in the visible draw list (SCI2+)\n");
 	debugPrintf(" saved_bits - List saved bits on the hunk\n");
 	debugPrintf(" show_saved_bits - Display saved bits\n");
+	debugPrintf(" cel_cache - Shows the statistics of the cel cache, or empties it (SCI2+)\n");
 	debugPrintf("\n");
 	debugPrintf("Segments:\n");
 	debugPrintf(" segment_table / segtable - Lists all segments\n");
@@ -398,6 +404,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" gc_reachable - Lists all addresses directly reachable from a given memory object\n");
 	debugPrintf(" gc_freeable - Lists all addresses freeable in a given segment\n");
 	debugPrintf(" gc_normalize - Prints the \"normal\" address of a given address\n");
+	debugPrintf(" gc_timings - Compares the pauses of full and incremental garbage collections\n");
 	debugPrintf("\n");
 	debugPrintf("Music/SFX:\n");
 	debugPrintf(" songlib - Shows the song library\n");
@@ -2339,6 +2346,35 @@ bool Console::cmdShowSavedBits(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdCelCache(int argc, const char **argv) {
+	if (argc > 2 || (argc == 2 && strcmp(argv[1], "clear") != 0)) {
+		debugPrintf("Shows the statistics of the cel cache, or empties it.\n");
+		debugPrintf("Usage: %s [clear]\n", argv[0]);
+		return true;
+	}
+
+#ifdef ENABLE_SCI32
+	CelCache *cache = CelObj::getCache();
+	if (!cache) {
+		debugPrintf("This SCI version does not have a cel cache\n");
+		return true;
+	}
+
+	if (argc == 2) {
+		cache->clear();
+		debugPrintf("Cel cache cleared\n");
+	}
+
+	const CelCacheStats &stats = cache->getStats();
+	debugPrintf("Entries: %u\n", stats.entries);
+	debugPrintf("Size: %u of %u KiB\n", stats.size / 1024, stats.maxSize / 1024);
+	debugPrintf("Hits: %u, misses: %u, evictions: %u\n", stats.hits, stats.misses, stats.evictions);
+#else
+	debugPrintf("SCI32 isn't included in this compiled executable\n");
+#endif
+	return true;
+}
+
 
 bool Console::cmdParseGrammar(int argc, const char **argv) {
 	debugPrintf("Parse grammar, in strict GNF:\n");
@@ -2866,6 +2902,36 @@ bool Console::cmdGCNormalize(int argc, const char **argv) {
 	return true;
 }
 
+static void printGCPauses(Console *console, const char *name, const GCPauseStats &stats) {
+	console->debugPrintf("%s: %u, average %.2f ms, longest %u ms, last %u ms\n", name, stats.count,
+		stats.count ? (double)stats.total / stats.count : 0.0, stats.max, stats.last);
+}
+
+bool Console::cmdGCTimings(int argc, const char **argv) {
+	if (argc > 2 || (argc == 2 && strcmp(argv[1], "reset") != 0)) {
+		debugPrintf("Shows how long the scripts were paused by garbage collections,\n");
+		debugPrintf("or resets these timings.\n");
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		debugPrintf("Set the gc_incremental variable to switch between the collectors.\n");
+		return true;
+	}
+
+	IncrementalGC *gc = _engine->_gamestate->_segMan->getIncrementalGC();
+
+	if (argc == 2) {
+		gc->resetStats();
+		debugPrintf("Garbage collection timings reset\n");
+		return true;
+	}
+
+	debugPrintf("Current collector: %s\n", gc->_enabled ? "incremental" : "full");
+	printGCPauses(this, "Full collections", gc->getFullPauses());
+	debugPrintf("Incremental collections: %u\n", gc->getCycleCount());
+	printGCPauses(this, " Steps", gc->getStepPauses());
+	printGCPauses(this, " Final root scans", gc->getRemarkPauses());
+	return true;
+}
+
 bool Console::cmdVMVarlist(int argc, const char **argv) {
 	EngineState *s = _engine->_gamestate;
 	const char *varnames[] = {"global", "local", "temp", "param"};
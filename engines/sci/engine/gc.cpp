@@ -21,6 +21,8 @@
 
 #include "sci/engine/gc.h"
 #include "common/array.h"
+#include "common/config-manager.h"
+#include "common/system.h"
 #include "sci/graphics/ports.h"
 
 #ifdef ENABLE_SCI32
@@ -98,10 +100,22 @@ static void processWorkList(SegManager *segMan, WorklistManager &wm, const Commo
 	}
 }
 
-AddrSet *findAllActiveReferences(EngineState *s) {
-	assert(!s->_executionStack.empty());
+/**
+ * Scans a single object for outgoing references. Unlike processWorkList(),
+ * this skips objects which have been freed since they were added to the work
+ * list, which can happen during incremental collections.
+ */
+static void scanObject(const Common::Array<SegmentObj *> &heap, SegmentId stackSegment, WorklistManager &wm, reg_t reg) {
+	if (reg.getSegment() == stackSegment || reg.getSegment() >= heap.size())
+		return;
 
-	WorklistManager wm;
+	const SegmentObj *mobj = heap[reg.getSegment()];
+	if (mobj && mobj->isValidOffset(reg.getOffset()))
+		wm.pushArray(mobj->listAllOutgoingReferences(reg));
+}
+
+static void pushRootSet(EngineState *s, WorklistManager &wm) {
+	assert(!s->_executionStack.empty());
 
 	// Initialize registers
 	wm.push(s->r_acc);
@@ -169,7 +183,14 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 	}
 
 	debugC(kDebugLevelGC, "[GC] -- Finished explicitly loaded scripts, done with root set");
+}
 
+AddrSet *findAllActiveReferences(EngineState *s) {
+	WorklistManager wm;
+
+	pushRootSet(s, wm);
+
+	const Common::Array<SegmentObj *> &heap = s->_segMan->getSegments();
 	processWorkList(s->_segMan, wm, heap);
 
 	if (g_sci->_gfxPorts)
@@ -180,6 +201,10 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 
 void run_gc(EngineState *s) {
 	SegManager *segMan = s->_segMan;
+	const uint32 startTime = g_system->getMillis();
+
+	// A full collection makes any incremental one in progress pointless
+	segMan->getIncrementalGC()->cancel();
 
 	// Some debug stuff
 	debugC(kDebugLevelGC, "[GC] Running...");
@@ -225,6 +250,8 @@ void run_gc(EngineState *s) {
 
 	delete activeRefs;
 
+	segMan->getIncrementalGC()->recordFullPause(g_system->getMillis() - startTime);
+
 #ifdef GC_DEBUG_CODE
 	// Output debug summary of garbage collection
 	debugC(kDebugLevelGC, "[GC] Summary:");
@@ -234,4 +261,200 @@ void run_gc(EngineState *s) {
 #endif
 }
 
+#pragma mark -
+#pragma mark IncrementalGC
+
+void GCPauseStats::add(uint32 millis) {
+	++count;
+	total += millis;
+	max = MAX(max, millis);
+	last = millis;
+}
+
+IncrementalGC::IncrementalGC(SegManager *segMan) :
+	_enabled(ConfMan.hasKey("sci_incremental_gc") && ConfMan.getBool("sci_incremental_gc")),
+	_segMan(segMan),
+	_phase(kPhaseIdle),
+	_sweepSegment(0),
+	_cycles(0) {}
+
+void IncrementalGC::setPhase(Phase phase) {
+	_phase = phase;
+	_segMan->_gcMarking = (phase == kPhaseMark);
+}
+
+void IncrementalGC::start(EngineState *s) {
+	assert(!isRunning());
+	debugC(kDebugLevelGC, "[GC] Starting incremental collection");
+
+	const uint32 startTime = g_system->getMillis();
+	setPhase(kPhaseMark);
+	pushRootSet(s, _wm);
+	_stepPauses.add(g_system->getMillis() - startTime);
+}
+
+void IncrementalGC::step(EngineState *s) {
+	if (!_enabled) {
+		cancel();
+		return;
+	}
+
+	const uint32 startTime = g_system->getMillis();
+
+	switch (_phase) {
+	case kPhaseMark:
+		// Kernel functions do not go through the write barrier, so marking
+		// may only end once all kernel calls have returned and had their
+		// arguments scanned again
+		if (markStep(kStepBudget) && !s->_executionStack.empty()) {
+			bool inKernelCall = false;
+			for (Common::List<ExecStack>::const_iterator it = s->_executionStack.begin(); it != s->_executionStack.end(); ++it) {
+				if (it->type == EXEC_STACK_TYPE_KERNEL) {
+					inKernelCall = true;
+					break;
+				}
+			}
+
+			if (!inKernelCall) {
+				finishMarking(s);
+				_remarkPauses.add(g_system->getMillis() - startTime);
+				return;
+			}
+		}
+		break;
+	case kPhaseNormalize:
+		normalizeStep(kStepBudget);
+		break;
+	case kPhaseSweep:
+		sweepStep(kStepBudget);
+		break;
+	default:
+		return;
+	}
+
+	_stepPauses.add(g_system->getMillis() - startTime);
+}
+
+void IncrementalGC::cancel() {
+	if (isRunning())
+		debugC(kDebugLevelGC, "[GC] Abandoning incremental collection");
+
+	setPhase(kPhaseIdle);
+	_wm._worklist.clear();
+	_wm._map.clear();
+	_rescanList.clear();
+	_live.clear();
+}
+
+void IncrementalGC::shade(reg_t value) {
+	if (isMarking())
+		_wm.push(value);
+}
+
+void IncrementalGC::rescanKernelArguments(const reg_t *argv, int argc) {
+	for (int i = 0; i < argc; ++i) {
+		const reg_t value = argv[i];
+		if (!value.getSegment())
+			continue;
+
+		if (_wm._map.contains(value))
+			_rescanList.push_back(value);
+		else
+			_wm.push(value);
+	}
+}
+
+void IncrementalGC::markAllocated(reg_t addr) {
+	if (isMarking())
+		_wm.push(addr);
+	else
+		_live.setVal(addr, true);
+}
+
+void IncrementalGC::resetStats() {
+	_fullPauses = GCPauseStats();
+	_stepPauses = GCPauseStats();
+	_remarkPauses = GCPauseStats();
+	_cycles = 0;
+}
+
+bool IncrementalGC::markStep(uint budget) {
+	const Common::Array<SegmentObj *> &heap = _segMan->getSegments();
+	const SegmentId stackSegment = _segMan->findSegmentByType(SEG_TYPE_STACK);
+
+	for (; budget && !_rescanList.empty(); --budget) {
+		const reg_t reg = _rescanList.back();
+		_rescanList.pop_back();
+		scanObject(heap, stackSegment, _wm, reg);
+	}
+
+	for (; budget && !_wm._worklist.empty(); --budget) {
+		const reg_t reg = _wm._worklist.back();
+		_wm._worklist.pop_back();
+		debugC(kDebugLevelGC, "[GC] Checking %04x:%04x", PRINT_REG(reg));
+		scanObject(heap, stackSegment, _wm, reg);
+	}
+
+	return _rescanList.empty() && _wm._worklist.empty();
+}
+
+void IncrementalGC::finishMarking(EngineState *s) {
+	// The stack and registers have changed without a write barrier, so scan
+	// them again, along with anything that became reachable from them
+	pushRootSet(s, _wm);
+	while (!markStep(kStepBudget)) {}
+
+	if (g_sci->_gfxPorts)
+		g_sci->_gfxPorts->processEngineHunkList(_wm);
+
+	debugC(kDebugLevelGC, "[GC] Finished marking %u references", _wm._map.size());
+
+	setPhase(kPhaseNormalize);
+	_normalizeIterator = _wm._map.begin();
+}
+
+void IncrementalGC::normalizeStep(uint budget) {
+	for (; budget && _normalizeIterator != _wm._map.end(); --budget, ++_normalizeIterator) {
+		const reg_t reg = _normalizeIterator->_key;
+		const SegmentObj *mobj = _segMan->getSegmentObj(reg.getSegment());
+		if (mobj)
+			_live.setVal(mobj->findCanonicAddress(_segMan, reg), true);
+	}
+
+	if (_normalizeIterator == _wm._map.end()) {
+		_wm._map.clear();
+		setPhase(kPhaseSweep);
+		_sweepSegment = 1;
+	}
+}
+
+void IncrementalGC::sweepStep(uint budget) {
+	const Common::Array<SegmentObj *> &heap = _segMan->getSegments();
+
+	while (budget && _sweepSegment < heap.size()) {
+		SegmentObj *mobj = heap[_sweepSegment];
+
+		if (mobj) {
+			const Common::Array<reg_t> tmp = mobj->listAllDeallocatable(_sweepSegment);
+			for (Common::Array<reg_t>::const_iterator it = tmp.begin(); it != tmp.end(); ++it) {
+				const reg_t addr = *it;
+				if (!_live.contains(addr)) {
+					mobj->freeAtAddress(_segMan, addr);
+					debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
+				}
+			}
+			budget -= MIN<uint>(budget, tmp.size());
+		}
+
+		++_sweepSegment;
+	}
+
+	if (_sweepSegment >= heap.size()) {
+		debugC(kDebugLevelGC, "[GC] Finished incremental collection");
+		_live.clear();
+		setPhase(kPhaseIdle);
+		++_cycles;
+	}
+}
+
 } // End of namespace Sci
@@ -62,6 +62,153 @@ struct WorklistManager {
 	void pushArray(const Common::Array<reg_t> &tmp);
 };
 
+/**
+ * Pause lengths of the garbage collector, in milliseconds.
+ */
+struct GCPauseStats {
+	uint32 count;
+	uint32 total;
+	uint32 max;
+	uint32 last;
+
+	GCPauseStats() : count(0), total(0), max(0), last(0) {}
+
+	void add(uint32 millis);
+};
+
+/**
+ * An incremental mark and sweep garbage collector.
+ *
+ * Instead of stopping the scripts for a full collection like run_gc() does,
+ * the work is split into small steps, which are run before kernel calls.
+ * While objects are being marked, references stored into the heap have to go
+ * through SegManager::writeBarrier(), and the arguments of kernel calls are
+ * scanned again after the call. The roots are scanned once more at the end
+ * of marking, in a single step, because the stack and registers have no
+ * write barrier. Objects which are allocated during a collection are never
+ * freed by it.
+ */
+class IncrementalGC {
+public:
+	IncrementalGC(SegManager *segMan);
+
+	/**
+	 * Whether collections are incremental. Set by the `sci_incremental_gc`
+	 * config key, and by the console.
+	 */
+	bool _enabled;
+
+	/**
+	 * Whether a collection is in progress.
+	 */
+	bool isRunning() const { return _phase != kPhaseIdle; }
+
+	/**
+	 * Whether a collection is marking objects, and thus needs the write
+	 * barrier.
+	 */
+	bool isMarking() const { return _phase == kPhaseMark; }
+
+	/**
+	 * Starts a new collection.
+	 */
+	void start(EngineState *s);
+
+	/**
+	 * Does a bounded amount of work on the collection in progress.
+	 */
+	void step(EngineState *s);
+
+	/**
+	 * Abandons the collection in progress without freeing anything.
+	 */
+	void cancel();
+
+	/**
+	 * Marks a reference which has been stored into the heap, see
+	 * SegManager::writeBarrier().
+	 */
+	void shade(reg_t value);
+
+	/**
+	 * Schedules the arguments of a kernel call to be scanned again, since the
+	 * kernel function may have changed them.
+	 */
+	void rescanKernelArguments(const reg_t *argv, int argc);
+
+	/**
+	 * Marks an object which has been allocated during the collection.
+	 */
+	void markAllocated(reg_t addr);
+
+	/**
+	 * Records the pause of a full collection by run_gc(), so it can be
+	 * compared to the pauses of incremental collections.
+	 */
+	void recordFullPause(uint32 millis) { _fullPauses.add(millis); }
+
+	const GCPauseStats &getFullPauses() const { return _fullPauses; }
+	const GCPauseStats &getStepPauses() const { return _stepPauses; }
+	const GCPauseStats &getRemarkPauses() const { return _remarkPauses; }
+	uint32 getCycleCount() const { return _cycles; }
+
+	void resetStats();
+
+private:
+	enum Phase {
+		kPhaseIdle,
+		kPhaseMark,
+		kPhaseNormalize,
+		kPhaseSweep
+	};
+
+	enum {
+		/**
+		 * The number of objects which are scanned, normalised or swept in
+		 * one step.
+		 */
+		kStepBudget = 256
+	};
+
+	SegManager *_segMan;
+	Phase _phase;
+
+	/**
+	 * The objects which are waiting to be scanned, and all marked references.
+	 */
+	WorklistManager _wm;
+
+	/**
+	 * Marked objects which have to be scanned again.
+	 */
+	Common::Array<reg_t> _rescanList;
+
+	/**
+	 * The canonic addresses of all marked references, which is built from
+	 * `_wm._map` once marking is done.
+	 */
+	AddrSet _live;
+
+	AddrSet::const_iterator _normalizeIterator;
+	uint _sweepSegment;
+
+	GCPauseStats _fullPauses;
+	GCPauseStats _stepPauses;
+	GCPauseStats _remarkPauses;
+	uint32 _cycles;
+
+	void setPhase(Phase phase);
+
+	/**
+	 * Scans up to `budget` objects. Returns true if there is nothing left to
+	 * scan.
+	 */
+	bool markStep(uint budget);
+	void finishMarking(EngineState *s);
+	void normalizeStep(uint budget);
+	void sweepStep(uint budget);
+};
+
 
 } // End of namespace Sci
 
@@ -440,6 +440,11 @@ reg_t kDeleteKey(EngineState *s, int argc, reg_t *argv) {
 	if (!n->succ.isNull())
 		s->_segMan->lookupNode(n->succ)->pred = n->pred;
 
+	// The neighbours of the node are now linked to each other, without being
+	// passed to this kernel call
+	s->_segMan->writeBarrier(n->pred);
+	s->_segMan->writeBarrier(n->succ);
+
 	// Erase references to the predecessor and successor nodes, as the game
 	// scripts could reference the node itself again.
 	// Happens in the intro of QFG1 and in Longbow, when exiting the cave.
@@ -20,6 +20,7 @@
  */
 
 #include "sci/sci.h"
+#include "sci/engine/gc.h"
 #include "sci/engine/seg_manager.h"
 #include "sci/engine/state.h"
 #include "sci/engine/script.h"
@@ -31,7 +32,8 @@ namespace Sci {
 
 
 SegManager::SegManager(ResourceManager *resMan, ScriptPatcher *scriptPatcher)
-	: _resMan(resMan), _scriptPatcher(scriptPatcher) {
+	: _resMan(resMan), _scriptPatcher(scriptPatcher),
+	  _incrementalGC(new IncrementalGC(this)), _gcMarking(false) {
 	_heap.push_back(0);
 
 	_clonesSegId = 0;
@@ -52,9 +54,13 @@ SegManager::SegManager(ResourceManager *resMan, ScriptPatcher *scriptPatcher)
 
 SegManager::~SegManager() {
 	resetSegMan();
+	delete _incrementalGC;
 }
 
 void SegManager::resetSegMan() {
+	// Any collection in progress refers to the old segments
+	_incrementalGC->cancel();
+
 	// Free memory
 	for (uint i = 0; i < _heap.size(); i++) {
 		if (_heap[i])
@@ -81,6 +87,15 @@ void SegManager::resetSegMan() {
 	createClassTable();
 }
 
+void SegManager::shadeForGC(reg_t value) {
+	_incrementalGC->shade(value);
+}
+
+void SegManager::markAllocatedForGC(reg_t addr) {
+	if (_incrementalGC->isRunning())
+		_incrementalGC->markAllocated(addr);
+}
+
 void SegManager::initSysStrings() {
 	if (getSciVersion() <= SCI_VERSION_1_1) {
 		// We need to allocate system strings in one segment, for compatibility reasons
@@ -133,6 +148,7 @@ Script *SegManager::allocateScript(int script_nr, SegmentId *segid) {
 	// does, return that segment.
 	*segid = _scriptSegMap.getValOrDefault(script_nr, 0);
 	if (*segid > 0) {
+		markAllocatedForGC(make_reg(*segid, 0));
 		return (Script *)_heap[*segid];
 	}
 
@@ -141,6 +157,7 @@ Script *SegManager::allocateScript(int script_nr, SegmentId *segid) {
 
 	// Add the script to the "script id -> segment id" hashmap
 	_scriptSegMap[script_nr] = *segid;
+	markAllocatedForGC(make_reg(*segid, 0));
 
 	return (Script *)mem;
 }
@@ -464,6 +481,7 @@ reg_t SegManager::allocateHunkEntry(const char *hunk_type, int size) {
 	h->size = size;
 	h->type = hunk_type;
 
+	markAllocatedForGC(addr);
 	return addr;
 }
 
@@ -490,6 +508,7 @@ Clone *SegManager::allocateClone(reg_t *addr) {
 	offset = table->allocEntry();
 
 	*addr = make_reg(_clonesSegId, offset);
+	markAllocatedForGC(*addr);
 	return &table->at(offset);
 }
 
@@ -504,6 +523,7 @@ List *SegManager::allocateList(reg_t *addr) {
 	offset = table->allocEntry();
 
 	*addr = make_reg(_listsSegId, offset);
+	markAllocatedForGC(*addr);
 	return &table->at(offset);
 }
 
@@ -518,6 +538,7 @@ Node *SegManager::allocateNode(reg_t *addr) {
 	offset = table->allocEntry();
 
 	*addr = make_reg(_nodesSegId, offset);
+	markAllocatedForGC(*addr);
 	return &table->at(offset);
 }
 
@@ -901,6 +922,7 @@ byte *SegManager::allocDynmem(int size, const char *descr, reg_t *addr) {
 	SegmentId seg;
 	SegmentObj *mobj = allocSegment(new DynMem(), &seg);
 	*addr = make_reg(seg, 0);
+	markAllocatedForGC(*addr);
 
 	DynMem &d = *(DynMem *)mobj;
 
@@ -945,6 +967,7 @@ SciArray *SegManager::allocateArray(SciArrayType type, uint16 size, reg_t *addr)
 	offset = table->allocEntry();
 
 	*addr = make_reg(_arraysSegId, offset);
+	markAllocatedForGC(*addr);
 
 	SciArray *array = &table->at(offset);
 	array->setType(type);
@@ -1001,6 +1024,7 @@ SciBitmap *SegManager::allocateBitmap(reg_t *addr, const int16 width, const int1
 	offset = table->allocEntry();
 
 	*addr = make_reg(_bitmapSegId, offset);
+	markAllocatedForGC(*addr);
 	SciBitmap &bitmap = table->at(offset);
 
 	bitmap.create(width, height, skipColor, originX, originY, xResolution, yResolution, paletteSize, remap, gc);
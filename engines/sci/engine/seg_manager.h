@@ -43,6 +43,7 @@ enum ScriptLoadType {
 	SCRIPT_GET_LOCK = 3 /**< Load, if neccessary, and lock */
 };
 
+class IncrementalGC;
 class Script;
 
 class SegManager : public Common::Serializable {
@@ -462,7 +463,35 @@ public:
 
 	const Common::Array<SegmentObj *> &getSegments() const { return _heap; }
 
+	/**
+	 * Returns the incremental garbage collector.
+	 */
+	IncrementalGC *getIncrementalGC() const { return _incrementalGC; }
+
+	/**
+	 * Write barrier for the incremental garbage collector. This must be
+	 * called with every reference that gets stored into an object, list,
+	 * node or local variable while the scripts are running.
+	 */
+	void writeBarrier(const reg_t value) {
+		if (_gcMarking && value.getSegment())
+			shadeForGC(value);
+	}
+
 private:
+	friend class IncrementalGC;
+
+	IncrementalGC *_incrementalGC;
+
+	/**
+	 * Whether the incremental garbage collector is marking, and thus needs
+	 * the write barrier.
+	 */
+	bool _gcMarking;
+
+	void shadeForGC(reg_t value);
+	void markAllocatedForGC(reg_t addr);
+
 	Common::Array<SegmentObj *> _heap;
 	Common::Array<Class> _classTable; /**< Table of all classes */
 	/** Map script ids to segment ids. */
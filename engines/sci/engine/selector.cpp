@@ -287,6 +287,7 @@ void writeSelector(SegManager *segMan, reg_t object, Selector selectorId, reg_t
 	}
 
 	*address.getPointer(segMan) = value;
+	segMan->writeBarrier(value);
 #ifdef ENABLE_SCI32
 	updateInfoFlagViewVisible(segMan->getObject(object), address.varindex);
 #endif
@@ -187,6 +187,7 @@ static void write_var(EngineState *s, int type, int index, reg_t value) {
 				if (lookupSelector(s->_segMan, stopGroopPos, SELECTOR(client), &varp, nullptr) == kSelectorVariable) {
 					reg_t *clientVar = varp.getPointer(s->_segMan);
 					*clientVar = value;
+					s->_segMan->writeBarrier(value);
 				}
 			}
 		}
@@ -200,6 +201,10 @@ static void write_var(EngineState *s, int type, int index, reg_t value) {
 
 		s->variables[type][index] = value;
 
+		// Globals and locals live in the heap, temps and params on the stack
+		if (type == VAR_GLOBAL || type == VAR_LOCAL)
+			s->_segMan->writeBarrier(value);
+
 		g_sci->_guestAdditions->writeVarHook(type, index, value);
 	}
 }
@@ -248,6 +253,7 @@ static void _exec_varselectors(EngineState *s) {
 			// varselector access?
 			if (xs.argc) { // write?
 				*var = xs.variables_argp[1];
+				s->_segMan->writeBarrier(*var);
 
 #ifdef ENABLE_SCI32
 				updateInfoFlagViewVisible(s->_segMan->getObject(xs.addr.varp.obj), xs.addr.varp.varindex);
@@ -881,10 +887,17 @@ void run_vm(EngineState *s) {
 		}
 
 		case op_callk: { // 0x21 (33)
-			// Run the garbage collector, if needed
-			if (s->gcCountDown-- <= 0) {
+			// Run the garbage collector, if needed. An incremental collection
+			// which is in progress does a bit of its work on every kernel call.
+			IncrementalGC *gc = s->_segMan->getIncrementalGC();
+			if (gc->isRunning()) {
+				gc->step(s);
+			} else if (s->gcCountDown-- <= 0) {
 				s->gcCountDown = s->scriptGCInterval;
-				run_gc(s);
+				if (gc->_enabled)
+					gc->start(s);
+				else
+					run_gc(s);
 			}
 
 			// Call kernel function
@@ -899,8 +912,14 @@ void run_vm(EngineState *s) {
 			if (!oldScriptHeader)
 				argc += s->r_rest;
 
+			const StackPtr argv = s->xs->sp + 1;
 			callKernelFunc(s, opparams[0], argc);
 
+			// The kernel function may have changed anything that was passed
+			// to it without going through the write barrier
+			if (gc->isMarking())
+				gc->rescanKernelArguments(argv, argc);
+
 			if (!oldScriptHeader)
 				s->r_rest = 0;
 
@@ -966,6 +985,7 @@ void run_vm(EngineState *s) {
 					reg_t *var = old_xs->getVarPointer(s->_segMan);
 					if (old_xs->argc) { // write?
 						*var = old_xs->variables_argp[1];
+						s->_segMan->writeBarrier(*var);
 
 #ifdef ENABLE_SCI32
 						updateInfoFlagViewVisible(s->_segMan->getObject(old_xs->addr.varp.obj), old_xs->addr.varp.varindex);
@@ -1152,6 +1172,7 @@ void run_vm(EngineState *s) {
 			}
 
 			opProperty = s->r_acc;
+			s->_segMan->writeBarrier(opProperty);
 #ifdef ENABLE_SCI32
 			updateInfoFlagViewVisible(obj, opparams[0], true);
 #endif
@@ -1182,6 +1203,7 @@ void run_vm(EngineState *s) {
 				                    s->_segMan, BREAK_SELECTORWRITE);
 			}
 			opProperty = newValue;
+			s->_segMan->writeBarrier(opProperty);
 #ifdef ENABLE_SCI32
 			updateInfoFlagViewVisible(obj, opparams[0], true);
 #endif
@@ -1208,6 +1230,7 @@ void run_vm(EngineState *s) {
 				opProperty += 1;
 			else
 				opProperty -= 1;
+			s->_segMan->writeBarrier(opProperty);
 
 			if (g_sci->_debugState._activeBreakpointTypes & BREAK_SELECTORWRITE) {
 				debugPropertyAccess(obj, s->xs->objp, opparams[0], NULL_SELECTOR,
@@ -24,6 +24,7 @@
 #include "sci/engine/seg_manager.h"
 #include "sci/engine/state.h"
 #include "sci/graphics/celobj32.h"
+#include "sci/graphics/celobj32_dsp.h"
 #include "sci/graphics/frameout.h"
 #include "sci/graphics/palette32.h"
 #include "sci/graphics/remap32.h"
@@ -84,13 +85,42 @@ const CelScalerTable &CelScaler::getScalerTable(const Ratio &scaleX, const Ratio
 #pragma mark -
 #pragma mark CelObj
 bool CelObj::_drawBlackLines = false;
+int8 CelObj::_larryScaleSetting = -1;
 
 void CelObj::init() {
 	CelObj::deinit();
 	_drawBlackLines = false;
-	_nextCacheId = 1;
 	_scaler = new CelScaler();
-	_cache = new CelCache(100);
+
+	uint32 cacheSize = kDefaultCacheSize;
+	if (ConfMan.hasKey("sci_cel_cache_size")) {
+		// Sizes of 4 GiB and beyond do not fit, and get clamped
+		const uint64 cacheKiB = MAX(ConfMan.getInt("sci_cel_cache_size"), 0);
+		cacheSize = (uint32)MIN<uint64>(cacheKiB * 1024, 0xFFFFFFFF);
+	}
+	_cache = new CelCache(cacheSize);
+}
+
+bool CelObj::beginThreadedDraw() {
+	assert(_larryScaleSetting == -1);
+	if (isLarryScaleEnabled()) {
+		return false;
+	}
+
+	_larryScaleSetting = 0;
+	return true;
+}
+
+void CelObj::endThreadedDraw() {
+	_larryScaleSetting = -1;
+}
+
+bool CelObj::isLarryScaleEnabled() {
+	if (_larryScaleSetting != -1) {
+		return _larryScaleSetting;
+	}
+
+	return Common::checkGameGUIOption(GAMEOPTION_LARRYSCALE, ConfMan.get("guioptions")) && ConfMan.getBool("enable_larryscale");
 }
 
 void CelObj::deinit() {
@@ -148,6 +178,25 @@ struct SCALER_NoScale {
 			return *_row++;
 		}
 	}
+
+	/**
+	 * Reads the next `width` pixels in target order. Unmirrored rows are
+	 * returned directly from the source data, other rows are put into
+	 * `buffer`.
+	 */
+	inline const byte *readRow(byte *buffer, const int16 width) {
+		if (FLIP) {
+			for (int16 i = 0; i < width; ++i) {
+				buffer[i] = read();
+			}
+			return buffer;
+		} else {
+			const byte *row = _row;
+			_row += width;
+			assert(_row <= _rowEdge);
+			return row;
+		}
+	}
 };
 
 template<bool FLIP, typename READER>
@@ -162,8 +211,10 @@ struct SCALER_Scale {
 	// image and takes precedence over _reader.
 	Common::SharedPtr<Buffer> _sourceBuffer;
 	int16 _x;
-	static int16 _valuesX[kCelScalerTableSize];
-	static int16 _valuesY[kCelScalerTableSize];
+	// These are per scaler, instead of static like in SSCI, so that cels can
+	// be drawn on several threads
+	int16 _valuesX[kCelScalerTableSize];
+	int16 _valuesY[kCelScalerTableSize];
 
 	SCALER_Scale(const CelObj &celObj, const Common::Rect &targetRect, const Common::Point &scaledPosition, const Ratio scaleX, const Ratio scaleY) :
 	_row(nullptr),
@@ -202,9 +253,7 @@ struct SCALER_Scale {
 		// games which use global scaling are the ones that use low-resolution
 		// script coordinates too.
 
-		const CelScalerTable &table = CelObj::_scaler->getScalerTable(scaleX, scaleY);
-
-		const bool useLarryScale = Common::checkGameGUIOption(GAMEOPTION_LARRYSCALE, ConfMan.get("guioptions")) && ConfMan.getBool("enable_larryscale");
+		const bool useLarryScale = CelObj::isLarryScaleEnabled();
 		if (useLarryScale) {
 			// LarryScale is an alternative, high-quality cel scaler implemented
 			// for ScummVM. Due to the nature of smooth upscaling, it does *not*
@@ -255,6 +304,9 @@ struct SCALER_Scale {
 				_valuesY[y] = CLIP<int16>(unsafeValue, 0, scaledImageRect.height() - 1);
 			}
 		} else {
+			Common::StackLock lock(CelObj::_scaler->getMutex());
+			const CelScalerTable &table = CelObj::_scaler->getScalerTable(scaleX, scaleY);
+
 			const bool useGlobalScaling = g_sci->_gfxFrameout->getScriptWidth() == kLowResX;
 			if (useGlobalScaling) {
 				const int16 unscaledX = (scaledPosition.x / scaleX).toInt();
@@ -304,12 +356,20 @@ struct SCALER_Scale {
 		assert(_x >= _minX && _x <= _maxX);
 		return _row[_valuesX[_x++]];
 	}
-};
 
-template<bool FLIP, typename READER>
-int16 SCALER_Scale<FLIP, READER>::_valuesX[kCelScalerTableSize];
-template<bool FLIP, typename READER>
-int16 SCALER_Scale<FLIP, READER>::_valuesY[kCelScalerTableSize];
+	/**
+	 * Reads the next `width` scaled pixels into `buffer`.
+	 */
+	inline const byte *readRow(byte *buffer, const int16 width) {
+		assert(_x + width - 1 <= _maxX);
+		const int16 *valuesX = _valuesX + _x;
+		for (int16 i = 0; i < width; ++i) {
+			buffer[i] = _row[valuesX[i]];
+		}
+		_x += width;
+		return buffer;
+	}
+};
 
 #pragma mark -
 #pragma mark CelObj - Resource readers
@@ -328,7 +388,12 @@ public:
 	_sourceHeight(celObj._height),
 #endif
 	_sourceWidth(celObj._width) {
-		const SciSpan<const byte> resource = celObj.getResPointer();
+		if (celObj._decompressedPixels) {
+			_pixels = (const byte *)celObj._decompressedPixels->getPixels();
+			return;
+		}
+
+		const SciSpan<const byte> resource = celObj.getDrawResPointer();
 		const uint32 pixelsOffset = resource.getUint32SEAt(celObj._celHeaderOffset + 24);
 		const int32 numPixels = MIN<int32>(resource.size() - pixelsOffset, celObj._width * celObj._height);
 
@@ -362,7 +427,7 @@ private:
 
 public:
 	READER_Compressed(const CelObj &celObj, const int16 maxWidth) :
-	_resource(celObj.getResPointer()),
+	_resource(celObj.getDrawResPointer()),
 	_y(-1),
 	_sourceHeight(celObj._height),
 	_skipColor(celObj._skipColor),
@@ -458,15 +523,20 @@ inline byte translateMacColor(bool isMacSource, byte color) {
 	return color;
 }
 
+// The pixel mappers work on whole rows, so that the common cases can use
+// the SIMD kernels from CelObjDSP.
+
 /**
  * Pixel mapper for a CelObj with transparent pixels and no
  * remapping data.
  */
 struct MAPPER_NoMD {
-	inline void draw(byte *target, const byte pixel, const uint8 skipColor, const bool isMacSource) const {
-		if (pixel != skipColor) {
-			*target = translateMacColor(isMacSource, pixel);
-		}
+	const CelObjDSP &_dsp;
+
+	MAPPER_NoMD() : _dsp(getCelObjDSP()) {}
+
+	inline void drawRow(byte *target, const byte *source, const int16 width, const uint8 skipColor, const bool isMacSource) const {
+		_dsp.drawRow(target, source, width, skipColor, kCelNoColorLimit, isMacSource);
 	}
 };
 
@@ -475,8 +545,16 @@ struct MAPPER_NoMD {
  * no remapping data.
  */
 struct MAPPER_NoMDNoSkip {
-	inline void draw(byte *target, const byte pixel, const uint8, const bool isMacSource) const {
-		*target = translateMacColor(isMacSource, pixel);
+	const CelObjDSP &_dsp;
+
+	MAPPER_NoMDNoSkip() : _dsp(getCelObjDSP()) {}
+
+	inline void drawRow(byte *target, const byte *source, const int16 width, const uint8, const bool isMacSource) const {
+		if (isMacSource) {
+			_dsp.drawRow(target, source, width, kCelNoColorLimit, kCelNoColorLimit, isMacSource);
+		} else {
+			memcpy(target, source, width);
+		}
 	}
 };
 
@@ -485,14 +563,23 @@ struct MAPPER_NoMDNoSkip {
  * remapping data, and remapping enabled.
  */
 struct MAPPER_Map {
-	inline void draw(byte *target, const byte pixel, const uint8 skipColor, const bool isMacSource) const {
-		if (pixel != skipColor) {
-			// For some reason, SSCI never checks if the source pixel is *above*
-			// the range of remaps, so we do not either.
-			if (pixel < g_sci->_gfxRemap32->getStartColor()) {
-				*target = translateMacColor(isMacSource, pixel);
-			} else if (g_sci->_gfxRemap32->remapEnabled(pixel)) {
-				*target = g_sci->_gfxRemap32->remapColor(translateMacColor(isMacSource, pixel), *target);
+	const CelObjDSP &_dsp;
+
+	MAPPER_Map() : _dsp(getCelObjDSP()) {}
+
+	inline void drawRow(byte *target, const byte *source, const int16 width, const uint8 skipColor, const bool isMacSource) const {
+		// For some reason, SSCI never checks if the source pixel is *above*
+		// the range of remaps, so we do not either.
+		const uint8 startColor = g_sci->_gfxRemap32->getStartColor();
+		if (!_dsp.drawRow(target, source, width, skipColor, startColor, isMacSource)) {
+			return;
+		}
+
+		// Remap the pixels which the kernel left out
+		for (int16 i = 0; i < width; ++i) {
+			const byte pixel = source[i];
+			if (pixel != skipColor && pixel >= startColor && g_sci->_gfxRemap32->remapEnabled(pixel)) {
+				target[i] = g_sci->_gfxRemap32->remapColor(translateMacColor(isMacSource, pixel), target[i]);
 			}
 		}
 	}
@@ -503,28 +590,35 @@ struct MAPPER_Map {
  * remapping data, and remapping disabled.
  */
 struct MAPPER_NoMap {
-	inline void draw(byte *target, const byte pixel, const uint8 skipColor, const bool isMacSource) const {
+	const CelObjDSP &_dsp;
+
+	MAPPER_NoMap() : _dsp(getCelObjDSP()) {}
+
+	inline void drawRow(byte *target, const byte *source, const int16 width, const uint8 skipColor, const bool isMacSource) const {
 		// For some reason, SSCI never checks if the source pixel is *above* the
 		// range of remaps, so we do not either.
-		if (pixel != skipColor && pixel < g_sci->_gfxRemap32->getStartColor()) {
-			*target = translateMacColor(isMacSource, pixel);
-		}
+		_dsp.drawRow(target, source, width, skipColor, g_sci->_gfxRemap32->getStartColor(), isMacSource);
 	}
 };
 
 void CelObj::draw(Buffer &target, const ScreenItem &screenItem, const Common::Rect &targetRect) const {
-	const Common::Point &scaledPosition = screenItem._scaledPosition;
-	const Ratio &scaleX = screenItem._ratioX;
-	const Ratio &scaleY = screenItem._ratioY;
 	_drawBlackLines = screenItem._drawBlackLines;
+	CelObj::drawPart(target, screenItem, targetRect);
+	_drawBlackLines = false;
+}
+
+void CelObj::drawPart(Buffer &target, const ScreenItem &screenItem, const Common::Rect &targetRect) const {
+	drawPart(target, targetRect, screenItem._scaledPosition, screenItem._ratioX, screenItem._ratioY);
+}
 
+void CelObj::drawPart(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition, const Ratio &scaleX, const Ratio &scaleY) const {
 	if (_remap) {
 		// In SSCI, this check was `g_Remap_numActiveRemaps && _remap`, but
 		// since we are already in a `_remap` branch, there is no reason to
 		// check that again
 		if (g_sci->_gfxRemap32->getRemapCount()) {
 			if (scaleX.isOne() && scaleY.isOne()) {
-				if (_compressionType == kCelCompressionNone) {
+				if (hasUncompressedPixels()) {
 					if (_drawMirrored) {
 						drawUncompHzFlipMap(target, targetRect, scaledPosition);
 					} else {
@@ -538,7 +632,7 @@ void CelObj::draw(Buffer &target, const ScreenItem &screenItem, const Common::Re
 					}
 				}
 			} else {
-				if (_compressionType == kCelCompressionNone) {
+				if (hasUncompressedPixels()) {
 					scaleDrawUncompMap(target, scaleX, scaleY, targetRect, scaledPosition);
 				} else {
 					scaleDrawMap(target, scaleX, scaleY, targetRect, scaledPosition);
@@ -546,7 +640,7 @@ void CelObj::draw(Buffer &target, const ScreenItem &screenItem, const Common::Re
 			}
 		} else {
 			if (scaleX.isOne() && scaleY.isOne()) {
-				if (_compressionType == kCelCompressionNone) {
+				if (hasUncompressedPixels()) {
 					if (_drawMirrored) {
 						drawUncompHzFlip(target, targetRect, scaledPosition);
 					} else {
@@ -560,7 +654,7 @@ void CelObj::draw(Buffer &target, const ScreenItem &screenItem, const Common::Re
 					}
 				}
 			} else {
-				if (_compressionType == kCelCompressionNone) {
+				if (hasUncompressedPixels()) {
 					scaleDrawUncomp(target, scaleX, scaleY, targetRect, scaledPosition);
 				} else {
 					scaleDraw(target, scaleX, scaleY, targetRect, scaledPosition);
@@ -569,8 +663,10 @@ void CelObj::draw(Buffer &target, const ScreenItem &screenItem, const Common::Re
 		}
 	} else {
 		if (scaleX.isOne() && scaleY.isOne()) {
-			if (_compressionType == kCelCompressionNone) {
-				if (_transparent) {
+			if (hasUncompressedPixels()) {
+				// Compressed cels were always drawn with skipping, so keep
+				// doing that for their decompressed pixels
+				if (_transparent || _compressionType != kCelCompressionNone) {
 					if (_drawMirrored) {
 						drawUncompHzFlipNoMD(target, targetRect, scaledPosition);
 					} else {
@@ -591,15 +687,13 @@ void CelObj::draw(Buffer &target, const ScreenItem &screenItem, const Common::Re
 				}
 			}
 		} else {
-			if (_compressionType == kCelCompressionNone) {
+			if (hasUncompressedPixels()) {
 				scaleDrawUncompNoMD(target, scaleX, scaleY, targetRect, scaledPosition);
 			} else {
 				scaleDrawNoMD(target, scaleX, scaleY, targetRect, scaledPosition);
 			}
 		}
 	}
-
-	_drawBlackLines = false;
 }
 
 void CelObj::draw(Buffer &target, const ScreenItem &screenItem, const Common::Rect &targetRect, bool mirrorX) {
@@ -607,6 +701,34 @@ void CelObj::draw(Buffer &target, const ScreenItem &screenItem, const Common::Re
 	draw(target, screenItem, targetRect);
 }
 
+void CelObj::prepareDrawPart(const bool mirrorX) {
+	assert(!_drawData);
+	_drawMirrored = mirrorX;
+
+	if (_info.type == kCelTypeView || _info.type == kCelTypePic) {
+		const ResourceType type = _info.type == kCelTypeView ? kResourceTypeView : kResourceTypePic;
+		_lockedResource = g_sci->getResMan()->findResource(ResourceId(type, _info.resourceId), true);
+		if (_lockedResource == nullptr) {
+			error("Failed to load %s from resource manager", _info.toString().c_str());
+		}
+		_drawData = _lockedResource->data();
+		_drawDataSize = _lockedResource->size();
+	} else if (_info.type == kCelTypeMem) {
+		const SciSpan<const byte> data = getResPointer();
+		_drawData = data.data();
+		_drawDataSize = data.size();
+	}
+}
+
+void CelObj::finishDrawPart() {
+	if (_lockedResource) {
+		g_sci->getResMan()->unlockResource(_lockedResource);
+		_lockedResource = nullptr;
+	}
+	_drawData = nullptr;
+	_drawDataSize = 0;
+}
+
 void CelObj::draw(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition, const bool mirrorX) {
 	_drawMirrored = mirrorX;
 	Ratio square;
@@ -616,7 +738,7 @@ void CelObj::draw(Buffer &target, const Common::Rect &targetRect, const Common::
 void CelObj::drawTo(Buffer &target, Common::Rect const &targetRect, Common::Point const &scaledPosition, Ratio const &scaleX, Ratio const &scaleY) const {
 	if (_remap) {
 		if (scaleX.isOne() && scaleY.isOne()) {
-			if (_compressionType == kCelCompressionNone) {
+			if (hasUncompressedPixels()) {
 				if (_drawMirrored) {
 					drawUncompHzFlipMap(target, targetRect, scaledPosition);
 				} else {
@@ -630,7 +752,7 @@ void CelObj::drawTo(Buffer &target, Common::Rect const &targetRect, Common::Poin
 				}
 			}
 		} else {
-			if (_compressionType == kCelCompressionNone) {
+			if (hasUncompressedPixels()) {
 				scaleDrawUncompMap(target, scaleX, scaleY, targetRect, scaledPosition);
 			} else {
 				scaleDrawMap(target, scaleX, scaleY, targetRect, scaledPosition);
@@ -638,7 +760,7 @@ void CelObj::drawTo(Buffer &target, Common::Rect const &targetRect, Common::Poin
 		}
 	} else {
 		if (scaleX.isOne() && scaleY.isOne()) {
-			if (_compressionType == kCelCompressionNone) {
+			if (hasUncompressedPixels()) {
 				if (_drawMirrored) {
 					drawUncompHzFlipNoMD(target, targetRect, scaledPosition);
 				} else {
@@ -652,7 +774,7 @@ void CelObj::drawTo(Buffer &target, Common::Rect const &targetRect, Common::Poin
 				}
 			}
 		} else {
-			if (_compressionType == kCelCompressionNone) {
+			if (hasUncompressedPixels()) {
 				scaleDrawUncompNoMD(target, scaleX, scaleY, targetRect, scaledPosition);
 			} else {
 				scaleDrawNoMD(target, scaleX, scaleY, targetRect, scaledPosition);
@@ -666,7 +788,7 @@ uint8 CelObj::readPixel(uint16 x, const uint16 y, bool mirrorX) const {
 		x = _width - x - 1;
 	}
 
-	if (_compressionType == kCelCompressionNone) {
+	if (hasUncompressedPixels()) {
 		READER_Uncompressed reader(*this, x + 1);
 		return reader.getRow(y)[x];
 	} else {
@@ -686,45 +808,100 @@ void CelObj::submitPalette() const {
 #pragma mark -
 #pragma mark CelObj - Caching
 
-int CelObj::_nextCacheId = 1;
 CelCache *CelObj::_cache = nullptr;
 
-int CelObj::searchCache(const CelInfo32 &celInfo, int *const nextInsertIndex) const {
-	*nextInsertIndex = -1;
-	int oldestId = _nextCacheId + 1;
-	int oldestIndex = 0;
+CelCache::CelCache(const uint32 maxSize) {
+	_stats.hits = 0;
+	_stats.misses = 0;
+	_stats.evictions = 0;
+	_stats.entries = 0;
+	_stats.size = 0;
+	_stats.maxSize = maxSize;
+}
 
-	for (int i = 0, len = _cache->size(); i < len; ++i) {
-		CelCacheEntry &entry = (*_cache)[i];
+CelCache::~CelCache() {
+	clear();
+}
 
-		if (entry.celObj == nullptr) {
-			if (*nextInsertIndex == -1) {
-				*nextInsertIndex = i;
-			}
-		} else if (entry.celObj->_info == celInfo) {
-			entry.id = ++_nextCacheId;
-			return i;
-		} else if (oldestId > entry.id) {
-			oldestId = entry.id;
-			oldestIndex = i;
-		}
+const CelObj *CelCache::find(const CelInfo32 &celInfo) {
+	EntryMap::iterator it = _index.find(celInfo);
+	if (it == _index.end()) {
+		++_stats.misses;
+		return nullptr;
 	}
 
-	if (*nextInsertIndex == -1) {
-		*nextInsertIndex = oldestIndex;
+	++_stats.hits;
+	if (it->_value != _entries.begin()) {
+		const Entry entry = *it->_value;
+		_entries.erase(it->_value);
+		_entries.push_front(entry);
+		it->_value = _entries.begin();
 	}
+	return _entries.front().celObj;
+}
 
-	return -1;
+void CelCache::add(CelObj *celObj, const uint32 size) {
+	EntryMap::iterator it = _index.find(celObj->_info);
+	if (it != _index.end()) {
+		evict(it->_value);
+	}
+
+	if (!fits(size)) {
+		delete celObj;
+		return;
+	}
+
+	while (_stats.size + size > _stats.maxSize) {
+		evict(--_entries.end());
+		++_stats.evictions;
+	}
+
+	Entry entry;
+	entry.celObj = celObj;
+	entry.size = size;
+	_entries.push_front(entry);
+	_index[celObj->_info] = _entries.begin();
+	++_stats.entries;
+	_stats.size += size;
+}
+
+void CelCache::clear() {
+	while (!_entries.empty()) {
+		evict(_entries.begin());
+	}
+}
+
+void CelCache::evict(const EntryList::iterator &it) {
+	_index.erase(it->celObj->_info);
+	--_stats.entries;
+	_stats.size -= it->size;
+	delete it->celObj;
+	_entries.erase(it);
+}
+
+const CelObj *CelObj::searchCache(const CelInfo32 &celInfo) const {
+	return _cache->find(celInfo);
 }
 
-void CelObj::putCopyInCache(const int cacheIndex) const {
-	if (cacheIndex == -1) {
-		error("Invalid cache index");
+void CelObj::putCopyInCache() {
+	uint32 size = sizeof(*this);
+
+	if (!hasUncompressedPixels() && _cache->fits(size + _width * _height)) {
+		Buffer *pixels = new Buffer();
+		pixels->create(_width, _height, Graphics::PixelFormat::createFormatCLUT8());
+		_decompressedPixels = Common::SharedPtr<Buffer>(pixels, Graphics::SurfaceDeleter());
+
+		READER_Compressed reader(*this, _width);
+		for (int16 y = 0; y < _height; ++y) {
+			memcpy(pixels->getBasePtr(0, y), reader.getRow(y), _width);
+		}
 	}
 
-	CelCacheEntry &entry = (*_cache)[cacheIndex];
-	entry.celObj.reset(duplicate());
-	entry.id = ++_nextCacheId;
+	if (_decompressedPixels) {
+		size += _width * _height;
+	}
+
+	_cache->add(duplicate(), size);
 }
 
 #pragma mark -
@@ -746,23 +923,20 @@ struct RENDERER {
 	inline void draw(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition) const {
 		byte *targetPixel = (byte *)target.getPixels() + target.w * targetRect.top + targetRect.left;
 
-		const int16 skipStride = target.w - targetRect.width();
 		const int16 targetWidth = targetRect.width();
 		const int16 targetHeight = targetRect.height();
+		assert(targetWidth <= kCelScalerTableSize);
+		byte rowBuffer[kCelScalerTableSize];
 		for (int16 y = 0; y < targetHeight; ++y) {
 			if (DRAW_BLACK_LINES && (y % 2) == 0) {
 				memset(targetPixel, 0, targetWidth);
-				targetPixel += targetWidth + skipStride;
+				targetPixel += target.w;
 				continue;
 			}
 
 			_scaler.setTarget(targetRect.left, targetRect.top + y);
-
-			for (int16 x = 0; x < targetWidth; ++x) {
-				_mapper.draw(targetPixel++, _scaler.read(), _skipColor, _isMacSource);
-			}
-
-			targetPixel += skipStride;
+			_mapper.drawRow(targetPixel, _scaler.readRow(rowBuffer, targetWidth), targetWidth, _skipColor, _isMacSource);
+			targetPixel += target.w;
 		}
 	}
 };
@@ -971,16 +1145,13 @@ CelObjView::CelObjView(const GuiResourceId viewId, const int16 loopNo, const int
 	_compressionType = kCelCompressionInvalid;
 	_transparent = true;
 
-	int cacheInsertIndex;
-	const int cacheIndex = searchCache(_info, &cacheInsertIndex);
-	if (cacheIndex != -1) {
-		CelCacheEntry &entry = (*_cache)[cacheIndex];
-		const CelObjView *const cachedCelObj = dynamic_cast<CelObjView *>(entry.celObj.get());
+	const CelObj *const cacheEntry = searchCache(_info);
+	if (cacheEntry != nullptr) {
+		const CelObjView *const cachedCelObj = dynamic_cast<const CelObjView *>(cacheEntry);
 		if (cachedCelObj == nullptr) {
-			error("Expected a CelObjView in cache slot %d", cacheIndex);
+			error("Expected a CelObjView in cache for %s", _info.toString().c_str());
 		}
 		*this = *cachedCelObj;
-		entry.id = ++_nextCacheId;
 		return;
 	}
 
@@ -1078,7 +1249,7 @@ CelObjView::CelObjView(const GuiResourceId viewId, const int16 loopNo, const int
 		_remap = analyzeForRemap();
 	}
 
-	putCopyInCache(cacheInsertIndex);
+	putCopyInCache();
 }
 
 bool CelObjView::analyzeUncompressedForRemap() const {
@@ -1179,16 +1350,13 @@ CelObjPic::CelObjPic(const GuiResourceId picId, const int16 celNo) {
 	_transparent = true;
 	_remap = false;
 
-	int cacheInsertIndex;
-	const int cacheIndex = searchCache(_info, &cacheInsertIndex);
-	if (cacheIndex != -1) {
-		CelCacheEntry &entry = (*_cache)[cacheIndex];
-		const CelObjPic *const cachedCelObj = dynamic_cast<CelObjPic *>(entry.celObj.get());
+	const CelObj *const cacheEntry = searchCache(_info);
+	if (cacheEntry != nullptr) {
+		const CelObjPic *const cachedCelObj = dynamic_cast<const CelObjPic *>(cacheEntry);
 		if (cachedCelObj == nullptr) {
-			error("Expected a CelObjPic in cache slot %d", cacheIndex);
+			error("Expected a CelObjPic in cache for %s", _info.toString().c_str());
 		}
 		*this = *cachedCelObj;
-		entry.id = ++_nextCacheId;
 		return;
 	}
 
@@ -1252,7 +1420,7 @@ CelObjPic::CelObjPic(const GuiResourceId picId, const int16 celNo) {
 		}
 	}
 
-	putCopyInCache(cacheInsertIndex);
+	putCopyInCache();
 }
 
 bool CelObjPic::analyzeUncompressedForSkip() const {
@@ -1363,6 +1531,10 @@ void CelObjColor::draw(Buffer &target, const Common::Rect &targetRect) const {
 	target.fillRect(targetRect, translateMacColor(_isMacSource, _info.color));
 }
 
+void CelObjColor::drawPart(Buffer &target, const ScreenItem &, const Common::Rect &targetRect) const {
+	draw(target, targetRect);
+}
+
 CelObjColor *CelObjColor::duplicate() const {
 	return new CelObjColor(*this);
 }
@@ -22,6 +22,10 @@
 #ifndef SCI_GRAPHICS_CELOBJ32_H
 #define SCI_GRAPHICS_CELOBJ32_H
 
+#include "common/hashmap.h"
+#include "common/list.h"
+#include "common/mutex.h"
+#include "common/ptr.h"
 #include "common/rational.h"
 #include "common/rect.h"
 #include "sci/resource/resource.h"
@@ -105,7 +109,7 @@ struct CelInfo32 {
 
 	// This is the equivalence criteria used by CelObj::searchCache in at least
 	// SSCI SQ6. Notably, it does not check the color field.
-	inline bool operator==(const CelInfo32 &other) {
+	inline bool operator==(const CelInfo32 &other) const {
 		return (
 			type == other.type &&
 			resourceId == other.resourceId &&
@@ -115,7 +119,7 @@ struct CelInfo32 {
 		);
 	}
 
-	inline bool operator!=(const CelInfo32 &other) {
+	inline bool operator!=(const CelInfo32 &other) const {
 		return !(*this == other);
 	}
 
@@ -138,18 +142,87 @@ struct CelInfo32 {
 	}
 };
 
+struct CelInfo32_Hash {
+	uint operator()(const CelInfo32 &info) const {
+		return (info.type << 28) ^ (info.resourceId << 12) ^ (info.loopNo << 6) ^ info.celNo ^
+			(info.bitmap.getSegment() << 16) ^ info.bitmap.getOffset();
+	}
+};
+
+/**
+ * Usage statistics of the cel cache.
+ */
+struct CelCacheStats {
+	uint32 hits;
+	uint32 misses;
+	uint32 evictions;
+	uint32 entries;
+	uint32 size;
+	uint32 maxSize;
+};
+
 class CelObj;
-struct CelCacheEntry {
+
+/**
+ * A cache of cel objects used to avoid reinitialisation overhead for cels
+ * with the same CelInfo32. Cached cels may hold their decompressed pixels,
+ * so the cache is limited by the number of bytes its entries take up instead
+ * of by a number of entries, and the least recently used entries are dropped
+ * first.
+ */
+class CelCache {
+public:
+	CelCache(const uint32 maxSize);
+	~CelCache();
+
 	/**
-	 * A monotonically increasing cache ID used to identify the least recently
-	 * used item in the cache for replacement.
+	 * Returns the cached cel object matching the given CelInfo32 and marks it
+	 * as the most recently used one, or returns null if there is none.
 	 */
-	int id;
-	Common::ScopedPtr<CelObj> celObj;
-	CelCacheEntry() : id(0) {}
-};
+	const CelObj *find(const CelInfo32 &celInfo);
+
+	/**
+	 * Adds the given cel object to the cache, which takes ownership of it.
+	 * `size` is the number of bytes held by the cel object. Older entries are
+	 * dropped until the new one fits.
+	 */
+	void add(CelObj *celObj, const uint32 size);
+
+	/**
+	 * Returns true if an entry of the given size fits into the cache at all.
+	 */
+	bool fits(const uint32 size) const { return size <= _stats.maxSize; }
+
+	/**
+	 * Drops all entries from the cache.
+	 */
+	void clear();
 
-typedef Common::Array<CelCacheEntry> CelCache;
+	const CelCacheStats &getStats() const { return _stats; }
+
+private:
+	struct Entry {
+		CelObj *celObj;
+		uint32 size;
+	};
+
+	typedef Common::List<Entry> EntryList;
+	typedef Common::HashMap<CelInfo32, EntryList::iterator, CelInfo32_Hash> EntryMap;
+
+	/**
+	 * The cached entries, from the most to the least recently used one.
+	 */
+	EntryList _entries;
+
+	/**
+	 * The position of every cached entry in `_entries`.
+	 */
+	EntryMap _index;
+
+	CelCacheStats _stats;
+
+	void evict(const EntryList::iterator &it);
+};
 
 #pragma mark -
 #pragma mark CelScaler
@@ -212,6 +285,11 @@ class CelScaler {
 	 */
 	void buildLookupTable(int *table, const Ratio &ratio, const int size);
 
+	/**
+	 * Guards the scale tables while cels are drawn on several threads.
+	 */
+	Common::Mutex _mutex;
+
 public:
 	CelScaler() :
 		_scaleTables(),
@@ -229,9 +307,13 @@ public:
 	}
 
 	/**
-	 * Retrieves scaler tables for the given X and Y ratios.
+	 * Retrieves scaler tables for the given X and Y ratios. The tables may be
+	 * replaced by the next call, so callers which may run on different
+	 * threads must hold the mutex until they are done with them.
 	 */
 	const CelScalerTable &getScalerTable(const Ratio &scaleX, const Ratio &scaleY);
+
+	Common::Mutex &getMutex() { return _mutex; }
 };
 
 #pragma mark -
@@ -262,6 +344,31 @@ protected:
 	 */
 	bool _drawMirrored;
 
+	/**
+	 * The LarryScale setting while cels are drawn on worker threads, which
+	 * must not use the config manager, or -1 to read it on every scaled draw.
+	 */
+	static int8 _larryScaleSetting;
+
+	/**
+	 * The resource locked by prepareDrawPart(), if any.
+	 */
+	Resource *_lockedResource;
+
+	/**
+	 * The pixel data of the cel while it is prepared for drawPart(). Cels
+	 * are read from here instead of `getResPointer()`, which is not safe to
+	 * call from worker threads.
+	 */
+	const byte *_drawData;
+	uint32 _drawDataSize;
+
+	CelObj() :
+		_drawMirrored(false),
+		_lockedResource(nullptr),
+		_drawData(nullptr),
+		_drawDataSize(0) {}
+
 public:
 	static CelScaler *_scaler;
 
@@ -328,6 +435,20 @@ public:
 	 */
 	bool _remap;
 
+	/**
+	 * For compressed cels that went through the cel cache, the decompressed
+	 * pixel data of the cel, which is shared by all copies of the cel.
+	 */
+	Common::SharedPtr<Buffer> _decompressedPixels;
+
+	/**
+	 * Whether or not the pixels of the cel can be read without decompressing
+	 * them.
+	 */
+	bool hasUncompressedPixels() const {
+		return _compressionType == kCelCompressionNone || _decompressedPixels;
+	}
+
 	/**
 	 * If true, the cel contains pre-mirrored picture data. This value comes
 	 * directly from the resource data and is XORed with the `_mirrorX` property
@@ -351,6 +472,11 @@ public:
 	 */
 	static void deinit();
 
+	/**
+	 * Returns the cel cache.
+	 */
+	static CelCache *getCache() { return _cache; }
+
 	virtual ~CelObj() {};
 
 	/**
@@ -360,6 +486,62 @@ public:
 	 */
 	void draw(Buffer &target, const ScreenItem &screenItem, const Common::Rect &targetRect) const;
 
+	/**
+	 * Draws the part of the cel for the given screen item which lies within
+	 * `targetRect`, like draw() does. Unlike draw(), this does not change any
+	 * state, so that different parts of the target can be drawn on several
+	 * threads at once. The cel must have been set up with prepareDrawPart(),
+	 * and the screen item must not draw black lines.
+	 */
+	virtual void drawPart(Buffer &target, const ScreenItem &screenItem, const Common::Rect &targetRect) const;
+
+	/**
+	 * Draws the part of the cel which lies within `targetRect` at the given
+	 * position and scale, like drawPart() with a screen item does.
+	 */
+	void drawPart(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition, const Ratio &scaleX, const Ratio &scaleY) const;
+
+	/**
+	 * Sets the mirroring of the cel for drawPart() and locks its pixel data
+	 * in memory until finishDrawPart() is called, since worker threads must
+	 * not use the resource manager.
+	 */
+	void prepareDrawPart(const bool mirrorX);
+
+	/**
+	 * Unlocks the pixel data locked by prepareDrawPart().
+	 */
+	void finishDrawPart();
+
+	/**
+	 * Fixes the LarryScale setting while cels are drawn on worker threads.
+	 *
+	 * @returns false if LarryScale is enabled. Its cels are drawn in one
+	 * piece, so they cannot be drawn in parts.
+	 */
+	static bool beginThreadedDraw();
+
+	/**
+	 * Goes back to reading the LarryScale setting on every scaled draw.
+	 */
+	static void endThreadedDraw();
+
+	/**
+	 * Returns true if scaled cels are drawn with LarryScale.
+	 */
+	static bool isLarryScaleEnabled();
+
+	/**
+	 * Retrieves the data for drawing the cel, which is the data locked by
+	 * prepareDrawPart() or else the raw resource data.
+	 */
+	const SciSpan<const byte> getDrawResPointer() const {
+		if (_drawData) {
+			return SciSpan<const byte>(_drawData, _drawDataSize);
+		}
+		return getResPointer();
+	}
+
 	/**
 	 * Draws the cel to the target buffer using the priority and positioning
 	 * information from the given screen item and the given mirror flag.
@@ -454,10 +636,10 @@ private:
 #pragma mark CelObj - Caching
 protected:
 	/**
-	 * A monotonically increasing cache ID used to identify the least recently
-	 * used item in the cache for replacement.
+	 * The default budget of the cel cache in bytes, which can be changed with
+	 * the `sci_cel_cache_size` config key (in KiB).
 	 */
-	static int _nextCacheId;
+	enum { kDefaultCacheSize = 16 * 1024 * 1024 };
 
 	/**
 	 * A cache of cel objects used to avoid reinitialisation overhead for cels
@@ -466,17 +648,17 @@ protected:
 	static CelCache *_cache;
 
 	/**
-	 * Searches the cel cache for a CelObj matching the provided CelInfo32. If
-	 * not found, -1 is returned. `nextInsertIndex` will receive the index of
-	 * the oldest item in the cache, which can be used to replace the oldest
-	 * item with a newer item.
+	 * Searches the cel cache for a CelObj matching the provided CelInfo32.
+	 * Returns null if not found.
 	 */
-	int searchCache(const CelInfo32 &celInfo, int *nextInsertIndex) const;
+	const CelObj *searchCache(const CelInfo32 &celInfo) const;
 
 	/**
-	 * Puts a copy of this CelObj into the cache at the given cache index.
+	 * Puts a copy of this CelObj into the cache. Compressed cels are
+	 * decompressed first if their pixels fit into the cache, so later copies
+	 * of the cel can skip decompressing them on every draw.
 	 */
-	void putCopyInCache(int index) const;
+	void putCopyInCache();
 };
 
 #pragma mark -
@@ -599,6 +781,7 @@ public:
 	void draw(Buffer &target, const Common::Rect &targetRect) const;
 	void draw(Buffer &target, const ScreenItem &screenItem, const Common::Rect &targetRect, const bool mirrorX) override;
 	void draw(Buffer &target, const Common::Rect &targetRect, const Common::Point &scaledPosition, const bool mirrorX) override;
+	void drawPart(Buffer &target, const ScreenItem &screenItem, const Common::Rect &targetRect) const override;
 
 	CelObjColor *duplicate() const override;
 	const SciSpan<const byte> getResPointer() const override;
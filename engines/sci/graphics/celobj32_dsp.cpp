@@ -0,0 +1,75 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/system.h"
+
+#include "sci/graphics/celobj32_dsp.h"
+
+namespace Sci {
+
+bool drawRowGeneric(byte *target, const byte *source, uint width, uint skipColor, uint remapStartColor, bool isMacSource) {
+	bool hasRemap = false;
+	for (uint i = 0; i < width; ++i) {
+		const byte pixel = source[i];
+		if (pixel == skipColor) {
+			continue;
+		}
+
+		if (pixel >= remapStartColor) {
+			hasRemap = true;
+		} else if (isMacSource && (pixel == 0 || pixel == 255)) {
+			target[i] = 255 - pixel;
+		} else {
+			target[i] = pixel;
+		}
+	}
+	return hasRemap;
+}
+
+void initCelObjDSP(CelObjDSP &dsp) {
+	dsp.drawRow = drawRowGeneric;
+}
+
+static CelObjDSP selectCelObjDSP() {
+	CelObjDSP dsp;
+	initCelObjDSP(dsp);
+
+	if (!g_system)
+		return dsp;
+
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasCpuFeature(OSystem::kCpuFeatureSSE2))
+		initCelObjDSPSSE2(dsp);
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasCpuFeature(OSystem::kCpuFeatureAVX2))
+		initCelObjDSPAVX2(dsp);
+#endif
+	return dsp;
+}
+
+const CelObjDSP &getCelObjDSP() {
+	static const CelObjDSP dsp = selectCelObjDSP();
+	return dsp;
+}
+
+} // End of namespace Sci
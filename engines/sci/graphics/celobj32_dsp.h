@@ -0,0 +1,75 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef SCI_GRAPHICS_CELOBJ32_DSP_H
+#define SCI_GRAPHICS_CELOBJ32_DSP_H
+
+#include "common/scummsys.h"
+
+namespace Sci {
+
+enum {
+	/**
+	 * Passed as the skip color or the remap start color to the row kernels
+	 * to disable the respective test.
+	 */
+	kCelNoColorLimit = 256
+};
+
+/**
+ * The pixel kernels of the SCI32 cel renderer, which are worth running
+ * through SIMD code. They work on whole rows of pixels, which the scalers
+ * have already read from the cel in target order.
+ */
+struct CelObjDSP {
+	/**
+	 * Copies a row of cel pixels to the target. Pixels which equal
+	 * `skipColor` are left out, and so are pixels at or above
+	 * `remapStartColor`, which the caller may remap afterwards. The colors 0
+	 * and 255 are swapped for Mac sources.
+	 *
+	 * @returns true if any pixels were left out because of
+	 * `remapStartColor`.
+	 */
+	bool (*drawRow)(byte *target, const byte *source, uint width, uint skipColor, uint remapStartColor, bool isMacSource);
+};
+
+/** The plain C++ row kernel, which the SIMD kernels use for the ends of rows. */
+bool drawRowGeneric(byte *target, const byte *source, uint width, uint skipColor, uint remapStartColor, bool isMacSource);
+
+/** Set up the plain C++ kernels. */
+void initCelObjDSP(CelObjDSP &dsp);
+
+#ifdef SCUMMVM_SSE2
+void initCelObjDSPSSE2(CelObjDSP &dsp);
+#endif
+
+#ifdef SCUMMVM_AVX2
+void initCelObjDSPAVX2(CelObjDSP &dsp);
+#endif
+
+/** Return the fastest kernels the host CPU supports. */
+const CelObjDSP &getCelObjDSP();
+
+} // End of namespace Sci
+
+#endif
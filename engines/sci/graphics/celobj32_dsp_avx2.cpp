@@ -0,0 +1,81 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#include <immintrin.h>
+
+#include "sci/graphics/celobj32_dsp.h"
+
+namespace Sci {
+
+namespace {
+
+bool drawRowAVX2(byte *target, const byte *source, uint width, uint skipColor, uint remapStartColor, bool isMacSource) {
+	// A remap range starting at 0 cannot be tested with an unsigned minimum
+	// below, but does not occur in practice
+	if (remapStartColor == 0) {
+		return drawRowGeneric(target, source, width, skipColor, remapStartColor, isMacSource);
+	}
+
+	// Tests which are disabled use masks which never match, so that the
+	// loop needs no branches
+	const __m256i ones = _mm256_set1_epi8(-1);
+	const __m256i skipValue = _mm256_set1_epi8((char)skipColor);
+	const __m256i skipEnabled = skipColor < kCelNoColorLimit ? ones : _mm256_setzero_si256();
+	const __m256i remapMax = _mm256_set1_epi8((char)(remapStartColor - 1));
+	const __m256i remapEnabled = remapStartColor < kCelNoColorLimit ? ones : _mm256_setzero_si256();
+	const __m256i macEnabled = isMacSource ? ones : _mm256_setzero_si256();
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i remapped = _mm256_setzero_si256();
+
+	uint i = 0;
+	for (; i + 32 <= width; i += 32) {
+		const __m256i pixels = _mm256_loadu_si256((const __m256i *)(source + i));
+		const __m256i skip = _mm256_and_si256(_mm256_cmpeq_epi8(pixels, skipValue), skipEnabled);
+		const __m256i belowRemap = _mm256_cmpeq_epi8(_mm256_min_epu8(pixels, remapMax), pixels);
+		const __m256i remap = _mm256_andnot_si256(skip, _mm256_andnot_si256(belowRemap, remapEnabled));
+		const __m256i draw = _mm256_andnot_si256(_mm256_or_si256(skip, remap), ones);
+		remapped = _mm256_or_si256(remapped, remap);
+
+		// 0 and 255 are swapped by inverting all bits
+		const __m256i mac = _mm256_and_si256(_mm256_or_si256(_mm256_cmpeq_epi8(pixels, zero), _mm256_cmpeq_epi8(pixels, ones)), macEnabled);
+		const __m256i color = _mm256_xor_si256(pixels, mac);
+
+		const __m256i old = _mm256_loadu_si256((const __m256i *)(target + i));
+		_mm256_storeu_si256((__m256i *)(target + i), _mm256_or_si256(_mm256_and_si256(draw, color), _mm256_andnot_si256(draw, old)));
+	}
+
+	bool hasRemap = _mm256_movemask_epi8(remapped) != 0;
+	if (i < width) {
+		hasRemap |= drawRowGeneric(target + i, source + i, width - i, skipColor, remapStartColor, isMacSource);
+	}
+	return hasRemap;
+}
+
+} // End of anonymous namespace
+
+void initCelObjDSPAVX2(CelObjDSP &dsp) {
+	dsp.drawRow = drawRowAVX2;
+}
+
+} // End of namespace Sci
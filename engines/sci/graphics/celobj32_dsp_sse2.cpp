@@ -0,0 +1,81 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#include <emmintrin.h>
+
+#include "sci/graphics/celobj32_dsp.h"
+
+namespace Sci {
+
+namespace {
+
+bool drawRowSSE2(byte *target, const byte *source, uint width, uint skipColor, uint remapStartColor, bool isMacSource) {
+	// A remap range starting at 0 cannot be tested with an unsigned minimum
+	// below, but does not occur in practice
+	if (remapStartColor == 0) {
+		return drawRowGeneric(target, source, width, skipColor, remapStartColor, isMacSource);
+	}
+
+	// Tests which are disabled use masks which never match, so that the
+	// loop needs no branches
+	const __m128i ones = _mm_set1_epi8(-1);
+	const __m128i skipValue = _mm_set1_epi8((char)skipColor);
+	const __m128i skipEnabled = skipColor < kCelNoColorLimit ? ones : _mm_setzero_si128();
+	const __m128i remapMax = _mm_set1_epi8((char)(remapStartColor - 1));
+	const __m128i remapEnabled = remapStartColor < kCelNoColorLimit ? ones : _mm_setzero_si128();
+	const __m128i macEnabled = isMacSource ? ones : _mm_setzero_si128();
+	const __m128i zero = _mm_setzero_si128();
+	__m128i remapped = _mm_setzero_si128();
+
+	uint i = 0;
+	for (; i + 16 <= width; i += 16) {
+		const __m128i pixels = _mm_loadu_si128((const __m128i *)(source + i));
+		const __m128i skip = _mm_and_si128(_mm_cmpeq_epi8(pixels, skipValue), skipEnabled);
+		const __m128i belowRemap = _mm_cmpeq_epi8(_mm_min_epu8(pixels, remapMax), pixels);
+		const __m128i remap = _mm_andnot_si128(skip, _mm_andnot_si128(belowRemap, remapEnabled));
+		const __m128i draw = _mm_andnot_si128(_mm_or_si128(skip, remap), ones);
+		remapped = _mm_or_si128(remapped, remap);
+
+		// 0 and 255 are swapped by inverting all bits
+		const __m128i mac = _mm_and_si128(_mm_or_si128(_mm_cmpeq_epi8(pixels, zero), _mm_cmpeq_epi8(pixels, ones)), macEnabled);
+		const __m128i color = _mm_xor_si128(pixels, mac);
+
+		const __m128i old = _mm_loadu_si128((const __m128i *)(target + i));
+		_mm_storeu_si128((__m128i *)(target + i), _mm_or_si128(_mm_and_si128(draw, color), _mm_andnot_si128(draw, old)));
+	}
+
+	bool hasRemap = _mm_movemask_epi8(remapped) != 0;
+	if (i < width) {
+		hasRemap |= drawRowGeneric(target + i, source + i, width - i, skipColor, remapStartColor, isMacSource);
+	}
+	return hasRemap;
+}
+
+} // End of anonymous namespace
+
+void initCelObjDSPSSE2(CelObjDSP &dsp) {
+	dsp.drawRow = drawRowSSE2;
+}
+
+} // End of namespace Sci
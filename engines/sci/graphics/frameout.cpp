@@ -27,6 +27,7 @@
 #include "common/str.h"
 #include "common/system.h"
 #include "common/textconsole.h"
+#include "common/threadpool.h"
 #include "engines/engine.h"
 #include "engines/util.h"
 #include "graphics/palette.h"
@@ -70,7 +71,8 @@ GfxFrameout::GfxFrameout(SegManager *segMan, GfxPalette32 *palette, GfxTransitio
 	_overdrawThreshold(0),
 	_throttleKernelFrameOut(true),
 	_palMorphIsOn(false),
-	_lastScreenUpdateTick(0) {
+	_lastScreenUpdateTick(0),
+	_tilePool(nullptr) {
 
 	if (g_sci->getGameId() == GID_PHANTASMAGORIA) {
 		_currentBuffer.create(630, 450, Graphics::PixelFormat::createFormatCLUT8());
@@ -104,6 +106,10 @@ GfxFrameout::GfxFrameout(SegManager *segMan, GfxPalette32 *palette, GfxTransitio
 		_scriptHeight = 200;
 		break;
 	}
+
+	if (ConfMan.hasKey("sci_tiled_rendering")) {
+		setTiledRendering(ConfMan.getBool("sci_tiled_rendering"));
+	}
 }
 
 GfxFrameout::~GfxFrameout() {
@@ -998,7 +1004,20 @@ void GfxFrameout::drawEraseList(const RectList &eraseList, const Plane &plane) {
 	}
 }
 
+void GfxFrameout::setTiledRendering(const bool enable) {
+	_tilePool = nullptr;
+
+	// Without worker threads, the tiles would only add overhead
+	if (enable && g_system->getThreadPool().getThreadCount() != 0) {
+		_tilePool = &g_system->getThreadPool();
+	}
+}
+
 void GfxFrameout::drawScreenItemList(const DrawList &screenItemList) {
+	if (_tilePool && drawScreenItemListInTiles(screenItemList)) {
+		return;
+	}
+
 	const DrawList::size_type drawListSize = screenItemList.size();
 	for (DrawList::size_type i = 0; i < drawListSize; ++i) {
 		const DrawItem &drawItem = *screenItemList[i];
@@ -1009,6 +1028,61 @@ void GfxFrameout::drawScreenItemList(const DrawList &screenItemList) {
 	}
 }
 
+bool GfxFrameout::drawScreenItemListInTiles(const DrawList &screenItemList) {
+	const DrawList::size_type drawListSize = screenItemList.size();
+	if (drawListSize < 2) {
+		return false;
+	}
+
+	// Black lines alternate relative to the top of each draw rect, which a
+	// tile edge would shift
+	for (DrawList::size_type i = 0; i < drawListSize; ++i) {
+		if (screenItemList[i]->screenItem->_drawBlackLines) {
+			return false;
+		}
+	}
+
+	if (!CelObj::beginThreadedDraw()) {
+		return false;
+	}
+
+	for (DrawList::size_type i = 0; i < drawListSize; ++i) {
+		const DrawItem &drawItem = *screenItemList[i];
+		mergeToShowList(drawItem.rect, _showList, _overdrawThreshold);
+		const ScreenItem &screenItem = *drawItem.screenItem;
+		CelObj &celObj = *screenItem._celObj;
+		celObj.prepareDrawPart(screenItem._mirrorX ^ celObj._mirrorX);
+	}
+
+	// Two tiles per thread, so that a thread which is done early can take
+	// over some of the work of the others
+	const int16 numTiles = _tilePool->getThreadCount() * 2;
+	const int16 tileHeight = (_currentBuffer.h + numTiles - 1) / numTiles;
+	{
+		Common::TaskGroup tasks(*_tilePool);
+		for (int16 top = 0; top < _currentBuffer.h; top += tileHeight) {
+			const Common::Rect tile(0, top, _currentBuffer.w, MIN<int16>(top + tileHeight, _currentBuffer.h));
+			tasks.run([this, &screenItemList, drawListSize, tile]() {
+				for (DrawList::size_type i = 0; i < drawListSize; ++i) {
+					const DrawItem &drawItem = *screenItemList[i];
+					const Common::Rect drawRect = drawItem.rect.findIntersectingRect(tile);
+					if (!drawRect.isEmpty()) {
+						const ScreenItem &screenItem = *drawItem.screenItem;
+						screenItem._celObj->drawPart(_currentBuffer, screenItem, drawRect);
+					}
+				}
+			});
+		}
+	}
+
+	for (DrawList::size_type i = 0; i < drawListSize; ++i) {
+		screenItemList[i]->screenItem->_celObj->finishDrawPart();
+	}
+
+	CelObj::endThreadedDraw();
+	return true;
+}
+
 void GfxFrameout::mergeToShowList(const Common::Rect &drawRect, RectList &showList, const int overdrawThreshold) {
 	RectList mergeList;
 	Common::Rect merged;
@@ -27,6 +27,10 @@
 #include "sci/graphics/plane32.h"
 #include "sci/graphics/screen_item32.h"
 
+namespace Common {
+class ThreadPool;
+}
+
 namespace Sci {
 typedef Common::Array<DrawList> ScreenItemListList;
 typedef Common::Array<RectList> EraseListList;
@@ -230,6 +234,14 @@ public:
 		return _currentBuffer;
 	}
 
+	/**
+	 * Enables or disables drawing screen items in horizontal tiles on worker
+	 * threads. The output is the same either way. This has no effect
+	 * without worker threads. Can be enabled with the `sci_tiled_rendering`
+	 * config key.
+	 */
+	void setTiledRendering(const bool enable);
+
 	void kernelFrameOut(const bool showBits);
 
 	/**
@@ -368,6 +380,22 @@ private:
 	 */
 	void drawScreenItemList(const DrawList &screenItemList);
 
+	/**
+	 * Draws the screen items from the given draw list in horizontal tiles on
+	 * the worker threads of `_tilePool`. Each tile draws the parts of all
+	 * items within it in list order, so that the result is the same as
+	 * drawing the items one after the other.
+	 *
+	 * @returns false if the list cannot be drawn in tiles.
+	 */
+	bool drawScreenItemListInTiles(const DrawList &screenItemList);
+
+	/**
+	 * The shared thread pool when drawing in tiles, or null if screen items
+	 * are drawn on the main thread.
+	 */
+	Common::ThreadPool *_tilePool;
+
 	/**
 	 * Adds a new rectangle to the list of regions to write out to the hardware.
 	 * The provided rect may be merged into an existing rectangle to reduce the
@@ -364,6 +364,13 @@ AVIPlayer::IOStatus AVIPlayer::open(const Common::String &fileName) {
 		return kIOFileNotFound;
 	}
 
+	// Decode a few frames in advance on another core, so that expensive
+	// frames do not stall playback. This only works for AVIs with an index,
+	// and is enabled with the `sci_video_read_ahead` config key.
+	if (ConfMan.hasKey("sci_video_read_ahead") && ConfMan.getBool("sci_video_read_ahead")) {
+		_decoder->setReadAhead(4);
+	}
+
 	_status = kAVIOpen;
 	return kIOSuccess;
 }
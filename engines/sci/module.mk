@@ -92,6 +92,7 @@ MODULE_OBJS += \
 	engine/hoyle5poker.o \
 	engine/kgraphics32.o \
 	graphics/celobj32.o \
+	graphics/celobj32_dsp.o \
 	graphics/controls32.o \
 	graphics/frameout.o \
 	graphics/paint32.o \
@@ -107,6 +108,20 @@ MODULE_OBJS += \
 	sound/audio32.o \
 	sound/decoders/sol.o \
 	video/robot_decoder.o
+
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	graphics/celobj32_dsp_sse2.o
+
+$(MODULE)/graphics/celobj32_dsp_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	graphics/celobj32_dsp_avx2.o
+
+$(MODULE)/graphics/celobj32_dsp_avx2.o: CXXFLAGS += -mavx2
+endif
 endif
 
 # This module can be built as a plugin
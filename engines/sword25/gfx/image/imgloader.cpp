@@ -42,16 +42,13 @@ bool ImgLoader::decodePNGImage(const byte *fileDataPtr, uint fileSize, Graphics:
 	Common::MemoryReadStream *fileStr = new Common::MemoryReadStream(fileDataPtr, fileSize, DisposeAfterUse::NO);
 
 	::Image::PNGDecoder png;
-	if (!png.loadStream(*fileStr)) // the fileStr pointer, and thus pFileData will be deleted after this is done
-		error("Error while reading PNG image");
-
-	const Graphics::Surface *sourceSurface = png.getSurface();
-	Graphics::Surface *pngSurface = sourceSurface->convertTo(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), png.getPalette());
+	png.setOutputPixelFormat(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
 
-	dest->copyFrom(*pngSurface);
+	// Decode straight into dest, converting each row as it comes
+	dest->free();
+	if (!png.loadStreamInto(*fileStr, *dest))
+		error("Error while reading PNG image");
 
-	pngSurface->free();
-	delete pngSurface;
 	delete fileStr;
 
 	// Signal success
@@ -80,8 +80,21 @@ MODULE_OBJS += \
 	tinygl/zline.o \
 	tinygl/zmath.o \
 	tinygl/ztriangle.o \
+	tinygl/ztriangle_dsp.o \
 	tinygl/zblit.o \
 	tinygl/zdirtyrect.o
+
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	tinygl/ztriangle_dsp_sse2.o
+
+$(MODULE)/tinygl/ztriangle_dsp_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	tinygl/ztriangle_dsp_neon.o
+endif
 endif
 
 ifdef USE_ASPECT
@@ -126,5 +139,24 @@ endif
 
 endif
 
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	yuv_to_rgb_sse2.o
+
+$(MODULE)/yuv_to_rgb_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	yuv_to_rgb_avx2.o
+
+$(MODULE)/yuv_to_rgb_avx2.o: CXXFLAGS += -mavx2
+endif
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	yuv_to_rgb_neon.o
+endif
+
 # Include common rules
 include $(srcdir)/rules.mk
@@ -540,6 +540,7 @@ enum {
 	TGL_CLAMP                       = 0x2900,
 	TGL_CLAMP_TO_EDGE               = 0x812F,
 	TGL_MIRRORED_REPEAT             = 0x8370,
+	TGL_GENERATE_MIPMAP             = 0x8191,
 	TGL_S                           = 0x2000,
 	TGL_T                           = 0x2001,
 	TGL_R                           = 0x2002,
@@ -25,6 +25,8 @@
  * It also has modifications by the ResidualVM-team, which are covered under the GPLv2 (or later).
  */
 
+#include "common/config-manager.h"
+
 #include "graphics/tinygl/zgl.h"
 #include "graphics/tinygl/zblit.h"
 #include "graphics/tinygl/zdirtyrect.h"
@@ -150,6 +152,7 @@ void GLContext::init(int screenW, int screenH, Graphics::PixelFormat pixelFormat
 	maxTextureName = 0;
 	texture_mag_filter = TGL_LINEAR;
 	texture_min_filter = TGL_NEAREST_MIPMAP_LINEAR;
+	texture_generate_mipmap = false;
 #if defined(SCUMM_LITTLE_ENDIAN)
 	colorAssociationList.push_back({Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24), TGL_RGBA, TGL_UNSIGNED_BYTE});
 	colorAssociationList.push_back({Graphics::PixelFormat(3, 8, 8, 8, 0, 0, 8, 16, 0),  TGL_RGB,  TGL_UNSIGNED_BYTE});
@@ -269,6 +272,11 @@ void GLContext::init(int screenW, int screenH, Graphics::PixelFormat pixelFormat
 	_debugRectsEnabled = false;
 	_profilingEnabled = false;
 
+	// Executing the draw calls in tiles on worker threads is opt-in for now
+	_tilePool = nullptr;
+	if (ConfMan.hasKey("tinygl_tiled_rendering"))
+		setTiledRendering(ConfMan.getBool("tinygl_tiled_rendering"));
+
 	TinyGL::Internal::tglBlitResetScissorRect();
 }
 
@@ -285,6 +293,7 @@ void destroyContext() {
 }
 
 void GLContext::deinit() {
+	setTiledRendering(false);
 	disposeDrawCallLists();
 	disposeResources();
 
@@ -40,6 +40,7 @@ TexelBuffer::TexelBuffer(uint width, uint height, uint textureSize) {
 	_fracTextureMask = _fracTextureUnit - 1;
 	_widthRatio = (float) width / textureSize;
 	_heightRatio = (float) height / textureSize;
+	_hasMipmaps = false;
 }
 
 static inline uint wrap(uint wrap_mode, int coord, uint _fracTextureUnit, uint _fracTextureMask) {
@@ -63,12 +64,27 @@ static inline uint wrap(uint wrap_mode, int coord, uint _fracTextureUnit, uint _
 
 void TexelBuffer::getARGBAt(
 	uint wrap_s, uint wrap_t,
-	int s, int t,
+	int s, int t, int lod,
 	uint8 &a, uint8 &r, uint8 &g, uint8 &b
 ) const {
 	uint x, y;
 	x = wrap(wrap_s, s, _fracTextureUnit, _fracTextureMask) * _widthRatio;
 	y = wrap(wrap_t, t, _fracTextureUnit, _fracTextureMask) * _heightRatio;
+	if (_hasMipmaps) {
+		getMipmapARGBAt(x, y, lod, a, r, g, b);
+		return;
+	}
+	getARGBAt(
+		(x >> ZB_POINT_ST_FRAC_BITS) + (y >> ZB_POINT_ST_FRAC_BITS) * _width,
+		x & ZB_POINT_ST_FRAC_MASK, y & ZB_POINT_ST_FRAC_MASK,
+		a, r, g, b
+	);
+}
+
+void TexelBuffer::getMipmapARGBAt(
+	uint x, uint y, int,
+	uint8 &a, uint8 &r, uint8 &g, uint8 &b
+) const {
 	getARGBAt(
 		(x >> ZB_POINT_ST_FRAC_BITS) + (y >> ZB_POINT_ST_FRAC_BITS) * _width,
 		x & ZB_POINT_ST_FRAC_MASK, y & ZB_POINT_ST_FRAC_MASK,
@@ -76,6 +92,20 @@ void TexelBuffer::getARGBAt(
 	);
 }
 
+int TexelBuffer::getLevelOfDetail(float dsdx, float dtdx, float dsdy, float dtdy) const {
+	// The squared number of full size texels per pixel, along both axes
+	const float scaleX = _widthRatio / ZB_POINT_ST_UNIT;
+	const float scaleY = _heightRatio / ZB_POINT_ST_UNIT;
+	const float dudx = dsdx * scaleX, dvdx = dtdx * scaleY;
+	const float dudy = dsdy * scaleX, dvdy = dtdy * scaleY;
+	const float rho2 = MAX(dudx * dudx + dvdx * dvdx, dudy * dudy + dvdy * dvdy);
+	if (!(rho2 > 1.0f))
+		return 0;
+
+	// log2(rho) is half of log2(rho2)
+	return (int)MIN(logf(rho2) * (128.0f / 0.6931472f), 32.0f * 256);
+}
+
 // Nearest: store texture in original size.
 NearestTexelBuffer::NearestTexelBuffer(const Graphics::PixelBuffer &buf, uint width, uint height, uint textureSize) : TexelBuffer(width, height, textureSize) {
 	uint pixel_count = _width * _height;
@@ -221,4 +251,139 @@ void BilinearTexelBuffer::getARGBAt(
 	);
 }
 
+static inline uint32 packTexel(uint8 a, uint8 r, uint8 g, uint8 b) {
+	return ((uint32)a << 24) | (r << 16) | (g << 8) | b;
+}
+
+static inline void unpackTexel(uint32 texel, uint8 &a, uint8 &r, uint8 &g, uint8 &b) {
+	a = texel >> 24;
+	r = texel >> 16;
+	g = texel >> 8;
+	b = texel;
+}
+
+// Interpolate all channels at once, two at a time in 16-bit fields
+static inline uint32 lerpTexel(uint32 c0, uint32 c1, uint f) {
+	const uint32 rb = ((((c0 & 0x00FF00FF) * (256 - f) + (c1 & 0x00FF00FF) * f)) >> 8) & 0x00FF00FF;
+	const uint32 ag = (((c0 >> 8) & 0x00FF00FF) * (256 - f) + ((c1 >> 8) & 0x00FF00FF) * f) & 0xFF00FF00;
+	return rb | ag;
+}
+
+static inline uint32 averageTexels(uint32 c00, uint32 c01, uint32 c10, uint32 c11) {
+	const uint32 rb = (((c00 & 0x00FF00FF) + (c01 & 0x00FF00FF) + (c10 & 0x00FF00FF) + (c11 & 0x00FF00FF) + 0x00020002) >> 2) & 0x00FF00FF;
+	const uint32 ag = ((((c00 >> 8) & 0x00FF00FF) + ((c01 >> 8) & 0x00FF00FF) + ((c10 >> 8) & 0x00FF00FF) + ((c11 >> 8) & 0x00FF00FF) + 0x00020002) << 6) & 0xFF00FF00;
+	return rb | ag;
+}
+
+MipmapTexelBuffer::MipmapTexelBuffer(const Graphics::PixelBuffer &buf, uint width, uint height, uint textureSize, uint minFilter, uint magFilter) : TexelBuffer(width, height, textureSize) {
+	_hasMipmaps = true;
+	_magLinear = magFilter == TGL_LINEAR;
+	_minLinear = minFilter == TGL_LINEAR_MIPMAP_NEAREST || minFilter == TGL_LINEAR_MIPMAP_LINEAR;
+	_mipmapLinear = minFilter == TGL_NEAREST_MIPMAP_LINEAR || minFilter == TGL_LINEAR_MIPMAP_LINEAR;
+
+	// Halve the size down to a single texel
+	uint levelSizes[kMaxLevels];
+	uint texelCount = 0;
+	_levelCount = 0;
+	for (uint levelWidth = _width, levelHeight = _height; _levelCount < kMaxLevels; _levelCount++) {
+		Level &level = _levels[_levelCount];
+		level.width = levelWidth;
+		level.height = levelHeight;
+		level.tilesPerRow = (levelWidth + kTileMask) >> kTileShift;
+		levelSizes[_levelCount] = level.tilesPerRow * ((levelHeight + kTileMask) >> kTileShift) << (2 * kTileShift);
+		texelCount += levelSizes[_levelCount];
+		if (levelWidth == 1 && levelHeight == 1) {
+			_levelCount++;
+			break;
+		}
+		levelWidth = MAX<uint>(levelWidth >> 1, 1);
+		levelHeight = MAX<uint>(levelHeight >> 1, 1);
+	}
+
+	_texels = new uint32[texelCount];
+	uint32 *texels = _texels;
+	for (uint i = 0; i < _levelCount; i++) {
+		_levels[i].texels = texels;
+		texels += levelSizes[i];
+	}
+
+	for (uint y = 0; y < _height; y++) {
+		for (uint x = 0; x < _width; x++) {
+			uint8 a, r, g, b;
+			buf.getARGBAt(y * _width + x, a, r, g, b);
+			_levels[0].texels[_levels[0].getIndex(x, y)] = packTexel(a, r, g, b);
+		}
+	}
+
+	// Box filter each level from the one above, repeating the last row or
+	// column of odd sizes
+	for (uint i = 1; i < _levelCount; i++) {
+		const Level &src = _levels[i - 1];
+		Level &dst = _levels[i];
+		for (uint y = 0; y < dst.height; y++) {
+			const uint y0 = MIN(y * 2, src.height - 1), y1 = MIN(y * 2 + 1, src.height - 1);
+			for (uint x = 0; x < dst.width; x++) {
+				const uint x0 = MIN(x * 2, src.width - 1), x1 = MIN(x * 2 + 1, src.width - 1);
+				dst.texels[dst.getIndex(x, y)] = averageTexels(
+					src.texels[src.getIndex(x0, y0)], src.texels[src.getIndex(x1, y0)],
+					src.texels[src.getIndex(x0, y1)], src.texels[src.getIndex(x1, y1)]
+				);
+			}
+		}
+	}
+}
+
+MipmapTexelBuffer::~MipmapTexelBuffer() {
+	delete[] _texels;
+}
+
+void MipmapTexelBuffer::getARGBAt(
+	uint pixel,
+	uint, uint,
+	uint8 &a, uint8 &r, uint8 &g, uint8 &b
+) const {
+	unpackTexel(_levels[0].texels[_levels[0].getIndex(pixel % _width, pixel / _width)], a, r, g, b);
+}
+
+uint32 MipmapTexelBuffer::sampleLevel(uint level, uint x, uint y, bool linear) const {
+	const Level &l = _levels[level];
+	if (!linear) {
+		const uint tx = MIN(x >> (ZB_POINT_ST_FRAC_BITS + level), l.width - 1);
+		const uint ty = MIN(y >> (ZB_POINT_ST_FRAC_BITS + level), l.height - 1);
+		return l.texels[l.getIndex(tx, ty)];
+	}
+
+	// Filter between the centers of the texels, clamping at the edges
+	const uint half = ZB_POINT_ST_UNIT / 2;
+	uint u = x >> level, v = y >> level;
+	u = u > half ? u - half : 0;
+	v = v > half ? v - half : 0;
+	const uint tx0 = MIN(u >> ZB_POINT_ST_FRAC_BITS, l.width - 1), tx1 = MIN(tx0 + 1, l.width - 1);
+	const uint ty0 = MIN(v >> ZB_POINT_ST_FRAC_BITS, l.height - 1), ty1 = MIN(ty0 + 1, l.height - 1);
+	const uint fx = (u >> (ZB_POINT_ST_FRAC_BITS - 8)) & 0xFF;
+	const uint fy = (v >> (ZB_POINT_ST_FRAC_BITS - 8)) & 0xFF;
+	const uint32 top = lerpTexel(l.texels[l.getIndex(tx0, ty0)], l.texels[l.getIndex(tx1, ty0)], fx);
+	const uint32 bottom = lerpTexel(l.texels[l.getIndex(tx0, ty1)], l.texels[l.getIndex(tx1, ty1)], fx);
+	return lerpTexel(top, bottom, fy);
+}
+
+void MipmapTexelBuffer::getMipmapARGBAt(
+	uint x, uint y, int lod,
+	uint8 &a, uint8 &r, uint8 &g, uint8 &b
+) const {
+	uint32 texel;
+	if (lod <= 0) {
+		texel = sampleLevel(0, x, y, _magLinear);
+	} else if (!_mipmapLinear) {
+		texel = sampleLevel(MIN<uint>((lod + 128) >> 8, _levelCount - 1), x, y, _minLinear);
+	} else {
+		const uint level = lod >> 8;
+		if (level + 1 >= _levelCount)
+			texel = sampleLevel(_levelCount - 1, x, y, _minLinear);
+		else
+			texel = lerpTexel(sampleLevel(level, x, y, _minLinear), sampleLevel(level + 1, x, y, _minLinear), lod & 0xFF);
+	}
+	unpackTexel(texel, a, r, g, b);
+}
+
 } // end of namespace TinyGL
@@ -31,20 +31,42 @@ public:
 	TexelBuffer(uint width, uint height, uint textureSize);
 	virtual ~TexelBuffer() {};
 
+	/**
+	 * Sample the texture. The level of detail only matters for textures with
+	 * mipmaps, see getLevelOfDetail().
+	 */
 	void getARGBAt(
 		uint wrap_s, uint wrap_t,
-		int s, int t,
+		int s, int t, int lod,
 		uint8 &a, uint8 &r, uint8 &g, uint8 &b
 	) const;
 
+	bool hasMipmaps() const { return _hasMipmaps; }
+
+	/**
+	 * Return the level of detail for the given changes of the texture
+	 * coordinates from one screen pixel to the next, horizontally and
+	 * vertically. It is the log2 of the texels per pixel, in 1/256 steps.
+	 */
+	int getLevelOfDetail(float dsdx, float dtdx, float dsdy, float dtdy) const;
+
 protected:
 	virtual void getARGBAt(
 		uint pixel,
 		uint ds, uint dt,
 		uint8 &a, uint8 &r, uint8 &g, uint8 &b
 	) const = 0;
+	/**
+	 * Sample a texture with mipmaps. The coordinates are in texels of the
+	 * full size image, with ZB_POINT_ST_FRAC_BITS fractional bits.
+	 */
+	virtual void getMipmapARGBAt(
+		uint x, uint y, int lod,
+		uint8 &a, uint8 &r, uint8 &g, uint8 &b
+	) const;
 	uint _width, _height, _fracTextureUnit, _fracTextureMask;
 	float _widthRatio, _heightRatio;
+	bool _hasMipmaps;
 };
 
 class NearestTexelBuffer : public TexelBuffer {
@@ -79,6 +101,54 @@ private:
 	uint32 *_texels;
 };
 
+/**
+ * Keeps a chain of mipmaps, which gets generated up front. The texels of
+ * each level are stored in 4x4 tiles, so that the texels which get filtered
+ * together share cache lines. Levels get picked and filtered according to
+ * the given GL minification and magnification filters.
+ */
+class MipmapTexelBuffer : public TexelBuffer {
+public:
+	MipmapTexelBuffer(const Graphics::PixelBuffer &buf, uint width, uint height, uint textureSize, uint minFilter, uint magFilter);
+	~MipmapTexelBuffer();
+
+protected:
+	void getARGBAt(
+		uint pixel,
+		uint, uint,
+		uint8 &a, uint8 &r, uint8 &g, uint8 &b
+	) const override;
+	void getMipmapARGBAt(
+		uint x, uint y, int lod,
+		uint8 &a, uint8 &r, uint8 &g, uint8 &b
+	) const override;
+
+private:
+	enum {
+		kMaxLevels = 16,
+		kTileShift = 2,
+		kTileMask = (1 << kTileShift) - 1
+	};
+
+	struct Level {
+		uint width, height;
+		uint tilesPerRow;
+		uint32 *texels;
+
+		uint getIndex(uint x, uint y) const {
+			const uint tile = (y >> kTileShift) * tilesPerRow + (x >> kTileShift);
+			return (tile << (2 * kTileShift)) + ((y & kTileMask) << kTileShift) + (x & kTileMask);
+		}
+	};
+
+	uint32 sampleLevel(uint level, uint x, uint y, bool linear) const;
+
+	Level _levels[kMaxLevels];
+	uint _levelCount;
+	uint32 *_texels;
+	bool _minLinear, _magLinear, _mipmapLinear;
+};
+
 } // end of namespace TinyGL
 
 #endif
@@ -170,6 +170,16 @@ void GLContext::glopTexImage2D(GLParam *p) {
 #endif
 		Graphics::PixelBuffer srcInternal(internalPf, width * height, DisposeAfterUse::YES);
 		srcInternal.copyBuffer(0, width * height, src);
+		if (texture_generate_mipmap && texture_min_filter != TGL_NEAREST && texture_min_filter != TGL_LINEAR) {
+			// Mipmapped textures pick their filter per pixel, from the level of detail
+			im->pixmap = new MipmapTexelBuffer(
+				srcInternal,
+				width, height,
+				_textureSize,
+				texture_min_filter, texture_mag_filter
+			);
+			return;
+		}
 		if (width > _textureSize || height > _textureSize)
 			filter = texture_mag_filter;
 		else
@@ -255,6 +265,9 @@ error:
 			goto error;
 		}
 		break;
+	case TGL_GENERATE_MIPMAP:
+		texture_generate_mipmap = param != TGL_FALSE;
+		break;
 	default:
 		;
 	}
@@ -32,6 +32,7 @@
 
 #include "graphics/tinygl/zbuffer.h"
 #include "graphics/tinygl/zgl.h"
+#include "graphics/tinygl/ztriangle_dsp.h"
 
 namespace TinyGL {
 
@@ -90,6 +91,9 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &for
 	_zbuf = (uint *)gl_zalloc(_pbufWidth * _pbufHeight * sizeof(uint));
 	if (enableStencilBuffer)
 		_sbuf = (byte *)gl_zalloc(_pbufWidth * _pbufHeight * sizeof(byte));
+	else
+		_sbuf = nullptr;
+	_ownsBuffers = true;
 
 	_offscreenBuffer.pbuf = _pbuf.getRawBuffer();
 	_offscreenBuffer.zbuf = _zbuf;
@@ -97,15 +101,33 @@ FrameBuffer::FrameBuffer(int width, int height, const Graphics::PixelFormat &for
 	_currentTexture = nullptr;
 
 	_enableScissor = false;
+
+	_triangleDSP = &getTriangleDSP();
+	enableSpanKernels(true);
 }
 
 FrameBuffer::~FrameBuffer() {
+	if (!_ownsBuffers)
+		return;
+
 	_pbuf.free();
 	gl_free(_zbuf);
 	if (_sbuf)
 		gl_free(_sbuf);
 }
 
+FrameBuffer *FrameBuffer::createView() const {
+	FrameBuffer *view = new FrameBuffer(*this);
+	view->_ownsBuffers = false;
+	return view;
+}
+
+void FrameBuffer::enableSpanKernels(bool enable) {
+	_spanKernels = enable && _pbufBpp == 4 &&
+	               _pbufFormat.rLoss == 0 && _pbufFormat.gLoss == 0 && _pbufFormat.bLoss == 0 &&
+	               (_pbufFormat.aLoss == 0 || _pbufFormat.aLoss == 8);
+}
+
 Buffer *FrameBuffer::genOffscreenBuffer() {
 	Buffer *buf = (Buffer *)gl_malloc(sizeof(Buffer));
 	buf->pbuf = (byte *)gl_zalloc(_pbufHeight * _pbufPitch);
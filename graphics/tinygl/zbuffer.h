@@ -37,6 +37,9 @@
 
 namespace TinyGL {
 
+struct TriangleDSP;
+struct TriangleSpan;
+
 // Z buffer
 
 #define ZB_Z_BITS 16
@@ -107,6 +110,12 @@ struct FrameBuffer {
 	FrameBuffer(int width, int height, const Graphics::PixelFormat &format, bool enableStencilBuffer);
 	~FrameBuffer();
 
+	/**
+	 * Create a frame buffer which draws into the buffers of this one. It starts
+	 * out with a copy of the drawing state, but keeps its own from then on.
+	 */
+	FrameBuffer *createView() const;
+
 	Graphics::PixelFormat getPixelFormat() {
 		return _pbufFormat;
 	}
@@ -137,6 +146,12 @@ struct FrameBuffer {
 		surface.init(_pbufWidth, _pbufHeight, _pbufPitch, _pbuf.getRawBuffer(), _pbufFormat);
 	}
 
+	/**
+	 * Enable or disable the span kernels for triangles. They only get used
+	 * for 32 bits per pixel formats with 8-bit color channels.
+	 */
+	void enableSpanKernels(bool enable);
+
 private:
 
 	FORCEINLINE bool compareDepth(uint &zSrc, uint &zDst) {
@@ -316,7 +331,7 @@ private:
 	template <bool kDepthWrite, bool kLightsMode, bool kSmoothMode, bool kFogMode, bool kEnableAlphaTest, bool kEnableScissor, bool kEnableBlending, bool kStencilEnabled, bool kDepthTestEnabled>
 	void putPixelTexture(int fbOffset, const TexelBuffer *texture,
 	                     uint wrap_s, uint wrap_t, uint *pz, byte *ps, int _a,
-	                     int x, int y, uint &z, int &t, int &s,
+	                     int x, int y, uint &z, int &t, int &s, int lod,
 	                     uint &r, uint &g, uint &b, uint &a,
 	                     int &dzdx, int &dsdx, int &dtdx, int &drdx, int &dgdx, int &dbdx, uint dadx,
 	                     uint &fog, int fog_r, int fog_g, int fog_b, int &dfdx);
@@ -658,6 +673,9 @@ private:
 	template <bool kInterpRGB, bool kInterpZ, bool kInterpST, bool kInterpSTZ, bool kSmoothMode>
 	void fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint *p2);
 
+	template <bool kEnableScissor>
+	void drawSpan(void (*kernel)(const TriangleSpan &), TriangleSpan &span, int x, int count);
+
 public:
 
 	void fillTriangleTextureMappingPerspectiveSmooth(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint *p2);
@@ -702,6 +720,7 @@ private:
 
 	uint *_zbuf;
 	byte *_sbuf;
+	bool _ownsBuffers;
 
 	bool _enableStencil;
 	int _textureSize;
@@ -736,6 +755,9 @@ private:
 	float _fogColorR;
 	float _fogColorG;
 	float _fogColorB;
+
+	const TriangleDSP *_triangleDSP;
+	bool _spanKernels;
 };
 
 // memory.c
@@ -25,6 +25,8 @@
 
 #include "common/debug.h"
 #include "common/math.h"
+#include "common/system.h"
+#include "common/threadpool.h"
 
 namespace TinyGL {
 
@@ -193,12 +195,20 @@ void GLContext::presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas)
 		}
 
 		// Execute draw calls.
-		for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
-			Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+		Common::Array<Common::Rect> clippingRectangles;
+		if (_tilePool) {
 			for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
-				Common::Rect dirtyRegion = (*itRect).rectangle;
-				if (dirtyRegion.intersects(drawCallRegion)) {
-					(*it)->execute(dirtyRegion, true);
+				clippingRectangles.push_back((*itRect).rectangle);
+			}
+		}
+		if (!executeDrawCallsInTiles(clippingRectangles)) {
+			for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
+				Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+				for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
+					Common::Rect dirtyRegion = (*itRect).rectangle;
+					if (dirtyRegion.intersects(drawCallRegion)) {
+						(*it)->execute(dirtyRegion, true);
+					}
 				}
 			}
 		}
@@ -238,10 +248,16 @@ void GLContext::presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas)
 void GLContext::presentBufferSimple(Common::List<Common::Rect> &dirtyAreas) {
 	typedef Common::List<DrawCall *>::const_iterator DrawCallIterator;
 
-	dirtyAreas.push_back(Common::Rect(fb->getPixelBufferWidth(), fb->getPixelBufferHeight()));
+	const Common::Rect frameRect(fb->getPixelBufferWidth(), fb->getPixelBufferHeight());
+	dirtyAreas.push_back(frameRect);
+
+	if (!_tilePool || !executeDrawCallsInTiles(Common::Array<Common::Rect>(1, frameRect))) {
+		for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
+			(*it)->execute(true);
+		}
+	}
 
 	for (DrawCallIterator it = _drawCallsQueue.begin(); it != _drawCallsQueue.end(); ++it) {
-		(*it)->execute(true);
 		delete *it;
 	}
 
@@ -252,6 +268,128 @@ void GLContext::presentBufferSimple(Common::List<Common::Rect> &dirtyAreas) {
 	_drawCallAllocator[_currentAllocatorIndex].reset();
 }
 
+void GLContext::setTiledRendering(bool enable, uint numTiles) {
+	for (uint i = 0; i < _tileContexts.size(); i++) {
+		GLContext *tile = _tileContexts[i];
+		gl_free(tile->vertex);
+		delete tile->fb;
+		delete tile;
+	}
+	_tileContexts.clear();
+	_tileDrawCalls.clear();
+	_tilePool = nullptr;
+
+	if (!enable)
+		return;
+
+	Common::ThreadPool &pool = g_system->getThreadPool();
+	if (numTiles == 0) {
+		if (pool.getThreadCount() == 0) {
+			// Without worker threads, the tiles would only add overhead
+			return;
+		}
+
+		// Two tiles per thread, so that a thread which is done early can take
+		// over some of the work of the others
+		numTiles = pool.getThreadCount() * 2;
+	}
+	_tilePool = &pool;
+
+	for (uint i = 0; i < numTiles; i++) {
+		GLContext *tile = new GLContext();
+		tile->fb = fb->createView();
+		_tileContexts.push_back(tile);
+	}
+	_tileDrawCalls.resize(numTiles);
+}
+
+bool GLContext::executeDrawCallsInTiles(const Common::Array<Common::Rect> &rectangles) {
+	typedef Common::List<DrawCall *>::const_iterator DrawCallIterator;
+
+	// Selection writes to the buffer of the global context
+	if (!_tilePool || render_mode != TGL_RENDER)
+		return false;
+
+	// Apart from these, draw calls only use the part of the context which
+	// they set themselves
+	for (uint i = 0; i < _tileContexts.size(); i++) {
+		GLContext *tile = _tileContexts[i];
+		tile->render_mode = render_mode;
+		tile->current_cull_face = current_cull_face;
+		tile->vertex_n = vertex_n;
+	}
+
+	const bool useDirtyRegions = _enableDirtyRectangles;
+	const int fbWidth = fb->getPixelBufferWidth();
+	const int fbHeight = fb->getPixelBufferHeight();
+	const int tileHeight = (fbHeight + _tileContexts.size() - 1) / _tileContexts.size();
+
+	DrawCallIterator it = _drawCallsQueue.begin();
+	while (it != _drawCallsQueue.end()) {
+		// Blits go through the global context, so they run on this thread in
+		// between the tiled parts of the frame
+		if ((*it)->getType() == DrawCall::DrawCall_Blitting) {
+			if (useDirtyRegions) {
+				Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+				for (uint i = 0; i < rectangles.size(); i++) {
+					if (rectangles[i].intersects(drawCallRegion)) {
+						(*it)->execute(rectangles[i], true);
+					}
+				}
+			} else {
+				(*it)->execute(true);
+			}
+			++it;
+			continue;
+		}
+
+		// Sort the draw calls up to the next blit into the tiles they touch,
+		// so that every tile only goes through its own
+		const int numTiles = (fbHeight + tileHeight - 1) / tileHeight;
+		for (int i = 0; i < numTiles; i++) {
+			_tileDrawCalls[i].resize(0);
+		}
+		for (; it != _drawCallsQueue.end() && (*it)->getType() != DrawCall::DrawCall_Blitting; ++it) {
+			const Common::Rect drawCallRegion = (*it)->getDirtyRegion();
+			if (drawCallRegion.isEmpty()) {
+				continue;
+			}
+			const int lastTile = MIN((drawCallRegion.bottom - 1) / tileHeight, numTiles - 1);
+			for (int i = drawCallRegion.top / tileHeight; i <= lastTile; i++) {
+				_tileDrawCalls[i].push_back(*it);
+			}
+		}
+
+		// The tiles do not overlap, so every pixel still sees the draw calls
+		// in the same order as with serial execution
+		Common::TaskGroup tasks(*_tilePool);
+		for (int i = 0; i < numTiles; i++) {
+			if (_tileDrawCalls[i].empty()) {
+				continue;
+			}
+			GLContext *tile = _tileContexts[i];
+			const Common::Array<DrawCall *> &calls = _tileDrawCalls[i];
+			const Common::Rect tileRect(0, i * tileHeight, fbWidth, MIN((i + 1) * tileHeight, fbHeight));
+			tasks.run([tile, tileRect, &calls, &rectangles, useDirtyRegions]() {
+				for (uint call = 0; call < calls.size(); call++) {
+					Common::Rect drawCallRegion = calls[call]->getDirtyRegion();
+					for (uint j = 0; j < rectangles.size(); j++) {
+						if (useDirtyRegions && !rectangles[j].intersects(drawCallRegion)) {
+							continue;
+						}
+						Common::Rect clippingRectangle = rectangles[j].findIntersectingRect(tileRect);
+						if (!clippingRectangle.isEmpty()) {
+							calls[call]->executeTile(tile, clippingRectangle);
+						}
+					}
+				}
+			});
+		}
+	}
+
+	return true;
+}
+
 void presentBuffer(Common::List<Common::Rect> &dirtyAreas) {
 	GLContext *c = gl_get_context();
 	if (c->_enableDirtyRectangles) {
@@ -295,7 +433,8 @@ RasterizationDrawCall::RasterizationDrawCall() : DrawCall(DrawCall_Rasterization
 	_drawTriangleBack = c->draw_triangle_back;
 	memcpy(_vertex, c->vertex, sizeof(GLVertex) * _vertexCount);
 	_state = captureState();
-	if (c->_enableDirtyRectangles) {
+	// Tiled rendering skips the tiles which a draw call does not touch
+	if (c->_enableDirtyRectangles || c->_tilePool) {
 		computeDirtyRegion();
 	}
 }
@@ -340,13 +479,43 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 	if (restoreState) {
 		backupState = captureState();
 	}
-	applyState(_state);
+	applyState(c, _state);
 
 	GLVertex *prevVertex = c->vertex;
 	int prevVertexCount = c->vertex_cnt;
 
 	c->vertex = _vertex;
 	c->vertex_cnt = _vertexCount;
+	rasterize(c);
+
+	c->vertex = prevVertex;
+	c->vertex_cnt = prevVertexCount;
+
+	if (restoreState) {
+		applyState(c, backupState);
+	}
+}
+
+void RasterizationDrawCall::executeTile(GLContext *c, const Common::Rect &clippingRectangle) const {
+	// Drawing temporarily changes the vertices, so every tile works on a copy
+	if (_vertexCount > c->vertex_max) {
+		gl_free(c->vertex);
+		c->vertex_max = _vertexCount;
+		c->vertex = (GLVertex *)gl_malloc(sizeof(GLVertex) * _vertexCount);
+	}
+	GLVertex *vertexBuffer = c->vertex;
+	memcpy(vertexBuffer, _vertex, sizeof(GLVertex) * _vertexCount);
+	c->vertex_cnt = _vertexCount;
+
+	applyState(c, _state);
+	c->fb->setScissorRectangle(clippingRectangle);
+	rasterize(c);
+	c->fb->resetScissorRectangle();
+
+	c->vertex = vertexBuffer;
+}
+
+void RasterizationDrawCall::rasterize(GLContext *c) const {
 	c->draw_triangle_front = (gl_draw_triangle_func)_drawTriangleFront;
 	c->draw_triangle_back = (gl_draw_triangle_func)_drawTriangleBack;
 
@@ -424,13 +593,6 @@ void RasterizationDrawCall::execute(bool restoreState) const {
 	default:
 		error("glBegin: type %x not handled", c->begin_type);
 	}
-
-	c->vertex = prevVertex;
-	c->vertex_cnt = prevVertexCount;
-
-	if (restoreState) {
-		applyState(backupState);
-	}
 }
 
 RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState() const {
@@ -484,8 +646,7 @@ RasterizationDrawCall::RasterizationState RasterizationDrawCall::captureState()
 	return state;
 }
 
-void RasterizationDrawCall::applyState(const RasterizationDrawCall::RasterizationState &state) const {
-	GLContext *c = gl_get_context();
+void RasterizationDrawCall::applyState(GLContext *c, const RasterizationDrawCall::RasterizationState &state) const {
 	c->fb->enableBlending(state.enableBlending);
 	c->fb->setBlendingFactors(state.sfactor, state.dfactor);
 	c->fb->enableAlphaTest(state.alphaTestEnabled);
@@ -616,6 +777,10 @@ void BlittingDrawCall::execute(const Common::Rect &clippingRectangle, bool resto
 	Internal::tglBlitResetScissorRect();
 }
 
+void BlittingDrawCall::executeTile(GLContext *c, const Common::Rect &clippingRectangle) const {
+	error("BlittingDrawCall::executeTile: Blits can only be executed with the global context");
+}
+
 BlittingDrawCall::BlittingState BlittingDrawCall::captureState() const {
 	BlittingState state;
 	TinyGL::GLContext *c = gl_get_context();
@@ -693,7 +858,7 @@ ClearBufferDrawCall::ClearBufferDrawCall(bool clearZBuffer, int zValue,
 	  _rValue(rValue), _gValue(gValue), _bValue(bValue), _clearStencilBuffer(clearStencilBuffer),
 	  _stencilValue(stencilValue), DrawCall(DrawCall_Clear) {
 	TinyGL::GLContext *c = gl_get_context();
-	if (c->_enableDirtyRectangles) {
+	if (c->_enableDirtyRectangles || c->_tilePool) {
 		_dirtyRegion = c->renderRect;
 	}
 }
@@ -711,6 +876,12 @@ void ClearBufferDrawCall::execute(const Common::Rect &clippingRectangle, bool re
 	                   _clearStencilBuffer, _stencilValue);
 }
 
+void ClearBufferDrawCall::executeTile(GLContext *c, const Common::Rect &clippingRectangle) const {
+	c->fb->clearRegion(clippingRectangle.left, clippingRectangle.top, clippingRectangle.width(), clippingRectangle.height(),
+	                   _clearZBuffer, _zValue, _clearColorBuffer, _rValue, _gValue, _bValue,
+	                   _clearStencilBuffer, _stencilValue);
+}
+
 bool ClearBufferDrawCall::operator==(const ClearBufferDrawCall &other) const {
 	return
 		_clearZBuffer == other._clearZBuffer &&
@@ -43,6 +43,10 @@
 #include "graphics/tinygl/zdirtyrect.h"
 #include "graphics/tinygl/texelbuffer.h"
 
+namespace Common {
+class ThreadPool;
+}
+
 namespace TinyGL {
 
 enum {
@@ -299,6 +303,7 @@ struct GLContext {
 	bool texture_2d_enabled;
 	int texture_mag_filter;
 	int texture_min_filter;
+	bool texture_generate_mipmap;
 	uint texture_wrap_s;
 	uint texture_wrap_t;
 	Common::Array<struct tglColorAssociation> colorAssociationList;
@@ -443,6 +448,13 @@ struct GLContext {
 	bool _debugRectsEnabled;
 	bool _profilingEnabled;
 
+	// Tiled rendering: the frame is split into horizontal tiles, which the
+	// workers of the shared thread pool draw with their own context each
+	Common::ThreadPool *_tilePool;
+	Common::Array<GLContext *> _tileContexts;
+	// The draw calls which touch each tile, reused from frame to frame
+	Common::Array<Common::Array<DrawCall *> > _tileDrawCalls;
+
 	void gl_vertex_transform(GLVertex *v);
 	void gl_calc_fog_factor(GLVertex *v);
 
@@ -493,6 +505,12 @@ public:
 	void presentBufferDirtyRects(Common::List<Common::Rect> &dirtyAreas);
 	void presentBufferSimple(Common::List<Common::Rect> &dirtyAreas);
 
+	// A tile count of 0 picks one based on the number of worker threads, and
+	// keeps tiled rendering off if there are none. Must be called between
+	// frames, since draw calls get the region they touch when they are issued.
+	void setTiledRendering(bool enable, uint numTiles = 0);
+	bool executeDrawCallsInTiles(const Common::Array<Common::Rect> &rectangles);
+
 	void debugDrawRectangle(Common::Rect rect, int r, int g, int b);
 
 	GLSpecBuf *specbuf_get_buffer(const int shininess_i, const float shininess);
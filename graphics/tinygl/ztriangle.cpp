@@ -29,11 +29,50 @@
 #include "graphics/tinygl/texelbuffer.h"
 #include "graphics/tinygl/zbuffer.h"
 #include "graphics/tinygl/zgl.h"
+#include "graphics/tinygl/ztriangle_dsp.h"
 
 namespace TinyGL {
 
 static const int NB_INTERP = 8;
 
+// Sample the texels of the next count pixels of the span, leaving out those
+// which are going to fail the depth test
+static void fetchTexels(const TexelBuffer *texture, uint wrap_s, uint wrap_t, TriangleSpan &span, uint32 *texels, int count, int s, int t, int dsdx, int dtdx, int lod) {
+	uint z = span.z;
+	for (int i = 0; i < count; i++) {
+		const uint zDst = span.depth[i];
+		if (span.depthTest == TriangleSpan::kDepthAlways ||
+		    (span.depthTest == TriangleSpan::kDepthLess ? zDst < z : zDst <= z)) {
+			uint8 c_a, c_r, c_g, c_b;
+			texture->getARGBAt(wrap_s, wrap_t, s, t, lod, c_a, c_r, c_g, c_b);
+			texels[i] = ((uint32)c_a << 24) | (c_r << 16) | (c_g << 8) | c_b;
+		} else {
+			texels[i] = 0;
+		}
+		z += span.dzdx;
+		s += dsdx;
+		t += dtdx;
+	}
+	span.texels = texels;
+}
+
+template <bool kEnableScissor>
+void FrameBuffer::drawSpan(void (*kernel)(const TriangleSpan &), TriangleSpan &span, int x, int count) {
+	if (count <= 0)
+		return;
+
+	TriangleSpan part = span;
+	part.count = count;
+	if (kEnableScissor) {
+		const int skip = CLIP<int>(_clipRectangle.left - x, 0, count);
+		part.skip(skip);
+		part.count = MIN<int>(part.count, _clipRectangle.right - (x + skip));
+	}
+	if (part.count > 0)
+		kernel(part);
+	span.skip(count);
+}
+
 template <bool kDepthWrite, bool kSmoothMode, bool kFogMode, bool kEnableAlphaTest, bool kEnableScissor, bool kEnableBlending, bool kStencilEnabled, bool kDepthTestEnabled>
 void FrameBuffer::putPixelNoTexture(int fbOffset, uint *pz, byte *ps, int _a,
                                     int x, int y, uint &z, uint &r, uint &g, uint &b, uint &a,
@@ -78,7 +117,7 @@ void FrameBuffer::putPixelNoTexture(int fbOffset, uint *pz, byte *ps, int _a,
 template <bool kDepthWrite, bool kLightsMode, bool kSmoothMode, bool kFogMode, bool kEnableAlphaTest, bool kEnableScissor, bool kEnableBlending, bool kStencilEnabled, bool kDepthTestEnabled>
 void FrameBuffer::putPixelTexture(int fbOffset, const TexelBuffer *texture,
                                   uint wrap_s, uint wrap_t, uint *pz, byte *ps, int _a,
-                                  int x, int y, uint &z, int &t, int &s,
+                                  int x, int y, uint &z, int &t, int &s, int lod,
                                   uint &r, uint &g, uint &b, uint &a,
                                   int &dzdx, int &dsdx, int &dtdx, int &drdx, int &dgdx, int &dbdx, uint dadx,
                                   uint &fog, int fog_r, int fog_g, int fog_b, int &dfdx) {
@@ -103,7 +142,7 @@ void FrameBuffer::putPixelTexture(int fbOffset, const TexelBuffer *texture,
 	}
 	if (depthTestResult) {
 		uint8 c_a, c_r, c_g, c_b;
-		texture->getARGBAt(wrap_s, wrap_t, s, t, c_a, c_r, c_g, c_b);
+		texture->getARGBAt(wrap_s, wrap_t, s, t, lod, c_a, c_r, c_g, c_b);
 		if (kLightsMode) {
 			uint l_a = (a >> (ZB_POINT_ALPHA_BITS - 8));
 			uint l_r = (r >> (ZB_POINT_RED_BITS - 8));
@@ -162,7 +201,7 @@ template <bool kInterpRGB, bool kInterpZ, bool kInterpST, bool kInterpSTZ, bool
           bool kBlendingEnabled, bool kStencilEnabled, bool kDepthTestEnabled>
 void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint *p2) {
 	const TexelBuffer *texture;
-	float fdzdx = 0, fndzdx = 0, ndszdx = 0, ndtzdx = 0;
+	float fdzdx = 0, fdzdy = 0, fndzdx = 0, ndszdx = 0, ndtzdx = 0;
 
 	ZBufferPoint *tp, *pr1 = 0, *pr2 = 0, *l1 = 0, *l2 = 0;
 	float fdx1, fdx2, fdy1, fdy2, fz0, d1, d2;
@@ -207,6 +246,9 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		p2 = tp;
 	}
 
+	if (kEnableScissor && (p2->y < _clipRectangle.top || p0->y >= _clipRectangle.bottom))
+		return;
+
 	// we compute dXdx and dXdy for all interpolated values
 
 	fdx1 = (float)(p1->x - p0->x);
@@ -302,6 +344,31 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		polyOffset = -m * _offsetFactor + -_offsetUnits * (1 << 6);
 	}
 
+	// The span kernels cover the common states, when drawing 32-bit pixels
+	const bool useSpanKernels = kInterpRGB && kInterpZ && !kFogMode && !kAlphaTestEnabled && !kStencilEnabled && _spanKernels &&
+	                            (!kDepthTestEnabled || _depthFunc == TGL_LESS || _depthFunc == TGL_LEQUAL || _depthFunc == TGL_ALWAYS) &&
+	                            (!kBlendingEnabled || ((kInterpST || kInterpSTZ) && _sourceBlendingFactor == TGL_SRC_ALPHA && _destinationBlendingFactor == TGL_ONE_MINUS_SRC_ALPHA));
+	TriangleSpan span;
+	if (useSpanKernels) {
+		if (kDepthTestEnabled && _depthFunc == TGL_LESS)
+			span.depthTest = TriangleSpan::kDepthLess;
+		else if (kDepthTestEnabled && _depthFunc == TGL_LEQUAL)
+			span.depthTest = TriangleSpan::kDepthLessEqual;
+		else
+			span.depthTest = TriangleSpan::kDepthAlways;
+		span.depthWrite = kDepthWrite;
+		span.aShift = _pbufFormat.aShift;
+		span.rShift = _pbufFormat.rShift;
+		span.gShift = _pbufFormat.gShift;
+		span.bShift = _pbufFormat.bShift;
+		span.aMask = _pbufFormat.aLoss == 0 ? 0xFF << _pbufFormat.aShift : 0;
+		span.dzdx = dzdx;
+		span.drdx = drdx;
+		span.dgdx = dgdx;
+		span.dbdx = dbdx;
+		span.dadx = dadx;
+	}
+
 	// screen coordinates
 
 	int pp1 = _pbufWidth * p0->y;
@@ -320,6 +387,7 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 	if (kInterpRGB && (kInterpST || kInterpSTZ)) {
 		texture = _currentTexture;
 		fdzdx = (float)dzdx;
+		fdzdy = (float)dzdy;
 		fndzdx = NB_INTERP * fdzdx;
 		ndszdx = NB_INTERP * dszdx;
 		ndtzdx = NB_INTERP * dtzdx;
@@ -424,7 +492,9 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 		// we draw all the scan line of the part
 		while (nb_lines > 0) {
 			int x = x1;
-			if (!kInterpRGB) {
+			if (kEnableScissor && (y < _clipRectangle.top || y >= _clipRectangle.bottom)) {
+				// the scan line is outside of the scissor rectangle, only the edges need updating
+			} else if (!kInterpRGB) {
 				int n;
 				uint *pz;
 				byte *ps = nullptr;
@@ -462,6 +532,16 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 					n -= 1;
 					x += 1;
 				}
+			} else if (useSpanKernels && !(kInterpST || kInterpSTZ)) {
+				span.pixels = (uint32 *)_pbuf.getRawBuffer() + pp1 + x1;
+				span.depth = pz1 + x1;
+				span.texels = nullptr;
+				span.z = z1;
+				span.r = r1;
+				span.g = g1;
+				span.b = b1;
+				span.a = a1;
+				drawSpan<kEnableScissor>(_triangleDSP->shadeSpan, span, x, (x2 >> 16) - x1 + 1);
 			} else if (!(kInterpST || kInterpSTZ)) {
 				uint *pz;
 				byte *ps = nullptr;
@@ -515,6 +595,57 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 					n -= 1;
 					x += 1;
 				}
+			} else if (useSpanKernels) {
+				void (*kernel)(const TriangleSpan &) = kBlendingEnabled ? _triangleDSP->blendTextureSpan : _triangleDSP->textureSpan;
+				uint32 texels[NB_INTERP];
+				int s, t, dsdx, dtdx, lod = 0;
+				int n = (x2 >> 16) - x1;
+				float sz = sz1, tz = tz1;
+				float fz = (float)z1;
+				float zinv = (float)(1.0 / fz);
+
+				span.pixels = (uint32 *)_pbuf.getRawBuffer() + pp1 + x1;
+				span.depth = pz1 + x1;
+				span.z = z1;
+				span.r = r1;
+				span.g = g1;
+				span.b = b1;
+				span.a = a1;
+				while (n >= (NB_INTERP - 1)) {
+					{
+						float ss, tt;
+						ss = sz * zinv;
+						tt = tz * zinv;
+						s = (int)ss;
+						t = (int)tt;
+						dsdx = (int)((dszdx - ss * fdzdx) * zinv);
+						dtdx = (int)((dtzdx - tt * fdzdx) * zinv);
+						if (texture->hasMipmaps())
+							lod = texture->getLevelOfDetail(dsdx, dtdx, (dszdy - ss * fdzdy) * zinv, (dtzdy - tt * fdzdy) * zinv);
+						fz += fndzdx;
+						zinv = (float)(1.0 / fz);
+					}
+					fetchTexels(texture, _wrapS, _wrapT, span, texels, NB_INTERP, s, t, dsdx, dtdx, lod);
+					drawSpan<kEnableScissor>(kernel, span, x, NB_INTERP);
+					sz += ndszdx;
+					tz += ndtzdx;
+					n -= NB_INTERP;
+					x += NB_INTERP;
+				}
+
+				{
+					float ss, tt;
+					ss = sz * zinv;
+					tt = tz * zinv;
+					s = (int)ss;
+					t = (int)tt;
+					dsdx = (int)((dszdx - ss * fdzdx) * zinv);
+					dtdx = (int)((dtzdx - tt * fdzdx) * zinv);
+					if (texture->hasMipmaps())
+						lod = texture->getLevelOfDetail(dsdx, dtdx, (dszdy - ss * fdzdy) * zinv, (dtzdy - tt * fdzdy) * zinv);
+				}
+				fetchTexels(texture, _wrapS, _wrapT, span, texels, n + 1, s, t, dsdx, dtdx, lod);
+				drawSpan<kEnableScissor>(kernel, span, x, n + 1);
 			} else if (kInterpST || kInterpSTZ) {
 				uint *pz;
 				byte *ps = nullptr;
@@ -522,7 +653,7 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 				uint z, r, g, b, a, fog;
 				int n, pp;
 				float sz, tz, fz, zinv;
-				int dsdx, dtdx;
+				int dsdx, dtdx, lod = 0;
 
 				n = (x2 >> 16) - x1;
 				fz = (float)z1;
@@ -554,12 +685,14 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 						t = (int)tt;
 						dsdx = (int)((dszdx - ss * fdzdx) * zinv);
 						dtdx = (int)((dtzdx - tt * fdzdx) * zinv);
+						if (texture->hasMipmaps())
+							lod = texture->getLevelOfDetail(dsdx, dtdx, (dszdy - ss * fdzdy) * zinv, (dtzdy - tt * fdzdy) * zinv);
 						fz += fndzdx;
 						zinv = (float)(1.0 / fz);
 					}
 					for (int _a = 0; _a < NB_INTERP; _a++) {
 						putPixelTexture<kDepthWrite, kInterpRGB, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
-						               (pp, texture, _wrapS, _wrapT, pz, ps, _a, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
+						               (pp, texture, _wrapS, _wrapT, pz, ps, _a, x, y, z, t, s, lod, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
 					}
 					pp += NB_INTERP;
 					if (kInterpZ) {
@@ -582,11 +715,13 @@ void FrameBuffer::fillTriangle(ZBufferPoint *p0, ZBufferPoint *p1, ZBufferPoint
 					t = (int)tt;
 					dsdx = (int)((dszdx - ss * fdzdx) * zinv);
 					dtdx = (int)((dtzdx - tt * fdzdx) * zinv);
+					if (texture->hasMipmaps())
+						lod = texture->getLevelOfDetail(dsdx, dtdx, (dszdy - ss * fdzdy) * zinv, (dtzdy - tt * fdzdy) * zinv);
 				}
 
 				while (n >= 0) {
 					putPixelTexture<kDepthWrite, kInterpRGB, kSmoothMode, kFogMode, kAlphaTestEnabled, kEnableScissor, kBlendingEnabled, kStencilEnabled, kDepthTestEnabled>
-					               (pp, texture, _wrapS, _wrapT, pz, ps, 0, x, y, z, t, s, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
+					               (pp, texture, _wrapS, _wrapT, pz, ps, 0, x, y, z, t, s, lod, r, g, b, a, dzdx, dsdx, dtdx, drdx, dgdx, dbdx, dadx, fog, fog_r, fog_g, fog_b, dfdx);
 					pp += 1;
 					if (kInterpZ) {
 						pz += 1;
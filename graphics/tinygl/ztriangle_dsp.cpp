@@ -0,0 +1,126 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/system.h"
+
+#include "graphics/tinygl/ztriangle_dsp.h"
+
+namespace TinyGL {
+
+static inline bool testDepth(const TriangleSpan &span, uint z, uint zDst) {
+	switch (span.depthTest) {
+	case TriangleSpan::kDepthLess:
+		return zDst < z;
+	case TriangleSpan::kDepthLessEqual:
+		return zDst <= z;
+	default:
+		return true;
+	}
+}
+
+static inline void writeDepth(const TriangleSpan &span, uint *depth, uint z) {
+	// The generic code passes the depth on as a float
+	if (span.depthWrite)
+		*depth = (uint)(float)z;
+}
+
+static inline uint32 packPixel(const TriangleSpan &span, byte a, byte r, byte g, byte b) {
+	return (((uint32)a << span.aShift) & span.aMask) | ((uint32)r << span.rShift) | ((uint32)g << span.gShift) | ((uint32)b << span.bShift);
+}
+
+static void shadeSpan(const TriangleSpan &span) {
+	uint z = span.z, r = span.r, g = span.g, b = span.b, a = span.a;
+	for (int i = 0; i < span.count; i++) {
+		if (testDepth(span, z, span.depth[i])) {
+			writeDepth(span, span.depth + i, z);
+			span.pixels[i] = packPixel(span, a >> 8, r >> 8, g >> 8, b >> 8);
+		}
+		z += span.dzdx;
+		r += span.drdx;
+		g += span.dgdx;
+		b += span.dbdx;
+		a += span.dadx;
+	}
+}
+
+template <bool kBlending>
+static void textureSpan(const TriangleSpan &span) {
+	uint z = span.z, r = span.r, g = span.g, b = span.b, a = span.a;
+	for (int i = 0; i < span.count; i++) {
+		if (testDepth(span, z, span.depth[i])) {
+			const uint32 texel = span.texels[i];
+			byte aSrc = (byte)(((texel >> 24) * (a >> 8)) >> 8);
+			byte rSrc = (byte)((((texel >> 16) & 0xFF) * (r >> 8)) >> 8);
+			byte gSrc = (byte)((((texel >> 8) & 0xFF) * (g >> 8)) >> 8);
+			byte bSrc = (byte)(((texel & 0xFF) * (b >> 8)) >> 8);
+			writeDepth(span, span.depth + i, z);
+
+			if (!kBlending) {
+				span.pixels[i] = packPixel(span, aSrc, rSrc, gSrc, bSrc);
+			} else {
+				const uint32 dst = span.pixels[i];
+				const int rDst = (((dst >> span.rShift) & 0xFF) * (255 - aSrc)) >> 8;
+				const int gDst = (((dst >> span.gShift) & 0xFF) * (255 - aSrc)) >> 8;
+				const int bDst = (((dst >> span.bShift) & 0xFF) * (255 - aSrc)) >> 8;
+				const int finalR = MIN(((rSrc * aSrc) >> 8) + rDst, 255);
+				const int finalG = MIN(((gSrc * aSrc) >> 8) + gDst, 255);
+				const int finalB = MIN(((bSrc * aSrc) >> 8) + bDst, 255);
+				span.pixels[i] = packPixel(span, 255, finalR, finalG, finalB);
+			}
+		}
+		z += span.dzdx;
+		r += span.drdx;
+		g += span.dgdx;
+		b += span.dbdx;
+		a += span.dadx;
+	}
+}
+
+void initTriangleDSP(TriangleDSP &dsp) {
+	dsp.shadeSpan = shadeSpan;
+	dsp.textureSpan = textureSpan<false>;
+	dsp.blendTextureSpan = textureSpan<true>;
+}
+
+static TriangleDSP selectTriangleDSP() {
+	TriangleDSP dsp;
+	initTriangleDSP(dsp);
+
+	if (!g_system)
+		return dsp;
+
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasCpuFeature(OSystem::kCpuFeatureSSE2))
+		initTriangleDSPSSE2(dsp);
+#endif
+#ifdef SCUMMVM_NEON
+	if (g_system->hasCpuFeature(OSystem::kCpuFeatureNEON))
+		initTriangleDSPNEON(dsp);
+#endif
+	return dsp;
+}
+
+const TriangleDSP &getTriangleDSP() {
+	static const TriangleDSP dsp = selectTriangleDSP();
+	return dsp;
+}
+
+} // end of namespace TinyGL
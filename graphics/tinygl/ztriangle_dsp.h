@@ -0,0 +1,101 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_TINYGL_ZTRIANGLE_DSP_H
+#define GRAPHICS_TINYGL_ZTRIANGLE_DSP_H
+
+#include "common/scummsys.h"
+
+namespace TinyGL {
+
+/**
+ * One horizontal run of triangle pixels in a 32 bits per pixel frame buffer
+ * with 8-bit color channels. The depth and colors are stepped by their deltas
+ * for each pixel, wrapping around like the unsigned values of the generic
+ * fillTriangle() code; the colors have ZB_POINT_*_BITS bits.
+ */
+struct TriangleSpan {
+	enum DepthTest {
+		kDepthAlways,
+		kDepthLess,
+		kDepthLessEqual
+	};
+
+	uint32 *pixels;
+	uint *depth;
+	/** The A8R8G8B8 texel of each pixel, for the textured spans. */
+	const uint32 *texels;
+	int count;
+
+	uint z, r, g, b, a;
+	int dzdx, drdx, dgdx, dbdx, dadx;
+
+	DepthTest depthTest;
+	bool depthWrite;
+	byte aShift, rShift, gShift, bShift;
+	/** Keeps the alpha bits of a pixel, zero if the format has no alpha. */
+	uint32 aMask;
+
+	/** Step past the first n pixels. */
+	void skip(int n) {
+		pixels += n;
+		depth += n;
+		if (texels)
+			texels += n;
+		count -= n;
+		z += (uint)dzdx * n;
+		r += (uint)drdx * n;
+		g += (uint)dgdx * n;
+		b += (uint)dbdx * n;
+		a += (uint)dadx * n;
+	}
+};
+
+/**
+ * The span kernels of the triangle rasterizer, for the common cases without
+ * stencil, fog or alpha test. They give the same pixels as the generic code.
+ */
+struct TriangleDSP {
+	/** Draw a flat or Gouraud shaded span. */
+	void (*shadeSpan)(const TriangleSpan &span);
+	/** Draw a textured span, with the texels modulated by the color. */
+	void (*textureSpan)(const TriangleSpan &span);
+	/** Like textureSpan, blended with TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA. */
+	void (*blendTextureSpan)(const TriangleSpan &span);
+};
+
+/** Set up the plain C++ kernels. */
+void initTriangleDSP(TriangleDSP &dsp);
+
+#ifdef SCUMMVM_SSE2
+void initTriangleDSPSSE2(TriangleDSP &dsp);
+#endif
+
+#ifdef SCUMMVM_NEON
+void initTriangleDSPNEON(TriangleDSP &dsp);
+#endif
+
+/** Return the fastest kernels the host CPU supports. */
+const TriangleDSP &getTriangleDSP();
+
+} // end of namespace TinyGL
+
+#endif
@@ -0,0 +1,163 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <arm_neon.h>
+
+#include "graphics/tinygl/ztriangle_dsp.h"
+
+namespace TinyGL {
+
+enum SpanMode {
+	kModeShade,
+	kModeTexture,
+	kModeBlendTexture
+};
+
+static inline uint32x4_t lanes(uint value, int delta) {
+	const uint32 values[4] = { value, value + (uint)delta, value + 2 * (uint)delta, value + 3 * (uint)delta };
+	return vld1q_u32(values);
+}
+
+static inline uint32x4_t testDepth(TriangleSpan::DepthTest depthTest, uint32x4_t z, uint32x4_t zDst) {
+	switch (depthTest) {
+	case TriangleSpan::kDepthLess:
+		return vcltq_u32(zDst, z);
+	case TriangleSpan::kDepthLessEqual:
+		return vcleq_u32(zDst, z);
+	default:
+		return vdupq_n_u32(0xFFFFFFFF);
+	}
+}
+
+static inline uint32x4_t roundDepth(uint32x4_t z) {
+	// The generic code passes the depth on as a float; both conversions
+	// round the same way as the scalar ones
+	return vcvtq_u32_f32(vcvtq_f32_u32(z));
+}
+
+static inline uint32x4_t colorByte(uint32x4_t color) {
+	return vandq_u32(vshrq_n_u32(color, 8), vdupq_n_u32(0xFF));
+}
+
+static inline uint32x4_t modulate(uint32x4_t texel, uint32x4_t color) {
+	return vandq_u32(vshrq_n_u32(vmulq_u32(texel, vshrq_n_u32(color, 8)), 8), vdupq_n_u32(0xFF));
+}
+
+template <int kMode>
+static void drawSpan(const TriangleSpan &span) {
+	const uint32x4_t ff = vdupq_n_u32(0xFF);
+	const int32x4_t aShift = vdupq_n_s32(span.aShift);
+	const int32x4_t rShift = vdupq_n_s32(span.rShift);
+	const int32x4_t gShift = vdupq_n_s32(span.gShift);
+	const int32x4_t bShift = vdupq_n_s32(span.bShift);
+	const uint32x4_t aMask = vdupq_n_u32(span.aMask);
+
+	uint32x4_t z = lanes(span.z, span.dzdx);
+	uint32x4_t r = lanes(span.r, span.drdx);
+	uint32x4_t g = lanes(span.g, span.dgdx);
+	uint32x4_t b = lanes(span.b, span.dbdx);
+	uint32x4_t a = lanes(span.a, span.dadx);
+	const uint32x4_t dz = vdupq_n_u32(4 * (uint)span.dzdx);
+	const uint32x4_t dr = vdupq_n_u32(4 * (uint)span.drdx);
+	const uint32x4_t dg = vdupq_n_u32(4 * (uint)span.dgdx);
+	const uint32x4_t db = vdupq_n_u32(4 * (uint)span.dbdx);
+	const uint32x4_t da = vdupq_n_u32(4 * (uint)span.dadx);
+
+	auto drawPixels = [&](uint32 *pixels, uint *depth, const uint32 *texels) {
+		const uint32x4_t zDst = vld1q_u32(depth);
+		const uint32x4_t pass = testDepth(span.depthTest, z, zDst);
+		const uint32x2_t anyPass = vorr_u32(vget_low_u32(pass), vget_high_u32(pass));
+		if ((vget_lane_u32(anyPass, 0) | vget_lane_u32(anyPass, 1)) == 0)
+			return;
+
+		if (span.depthWrite)
+			vst1q_u32(depth, vbslq_u32(pass, roundDepth(z), zDst));
+
+		uint32x4_t aSrc, rSrc, gSrc, bSrc;
+		if (kMode == kModeShade) {
+			aSrc = colorByte(a);
+			rSrc = colorByte(r);
+			gSrc = colorByte(g);
+			bSrc = colorByte(b);
+		} else {
+			const uint32x4_t texel = vld1q_u32(texels);
+			aSrc = modulate(vshrq_n_u32(texel, 24), a);
+			rSrc = modulate(vandq_u32(vshrq_n_u32(texel, 16), ff), r);
+			gSrc = modulate(vandq_u32(vshrq_n_u32(texel, 8), ff), g);
+			bSrc = modulate(vandq_u32(texel, ff), b);
+		}
+
+		const uint32x4_t dst = vld1q_u32(pixels);
+		if (kMode == kModeBlendTexture) {
+			const uint32x4_t aInv = vsubq_u32(ff, aSrc);
+			const uint32x4_t rDst = vandq_u32(vshlq_u32(dst, vnegq_s32(rShift)), ff);
+			const uint32x4_t gDst = vandq_u32(vshlq_u32(dst, vnegq_s32(gShift)), ff);
+			const uint32x4_t bDst = vandq_u32(vshlq_u32(dst, vnegq_s32(bShift)), ff);
+			rSrc = vminq_u32(vaddq_u32(vshrq_n_u32(vmulq_u32(rSrc, aSrc), 8), vshrq_n_u32(vmulq_u32(rDst, aInv), 8)), ff);
+			gSrc = vminq_u32(vaddq_u32(vshrq_n_u32(vmulq_u32(gSrc, aSrc), 8), vshrq_n_u32(vmulq_u32(gDst, aInv), 8)), ff);
+			bSrc = vminq_u32(vaddq_u32(vshrq_n_u32(vmulq_u32(bSrc, aSrc), 8), vshrq_n_u32(vmulq_u32(bDst, aInv), 8)), ff);
+			aSrc = ff;
+		}
+
+		uint32x4_t color = vandq_u32(vshlq_u32(aSrc, aShift), aMask);
+		color = vorrq_u32(color, vshlq_u32(rSrc, rShift));
+		color = vorrq_u32(color, vshlq_u32(gSrc, gShift));
+		color = vorrq_u32(color, vshlq_u32(bSrc, bShift));
+		vst1q_u32(pixels, vbslq_u32(pass, color, dst));
+	};
+
+	int i = 0;
+	for (; i + 4 <= span.count; i += 4) {
+		drawPixels(span.pixels + i, span.depth + i, kMode == kModeShade ? nullptr : span.texels + i);
+		z = vaddq_u32(z, dz);
+		r = vaddq_u32(r, dr);
+		g = vaddq_u32(g, dg);
+		b = vaddq_u32(b, db);
+		a = vaddq_u32(a, da);
+	}
+
+	const int left = span.count - i;
+	if (left > 0) {
+		// Go through a copy, so that nothing beyond the span gets touched
+		uint32 pixels[4] = { 0, 0, 0, 0 };
+		uint depth[4] = { 0, 0, 0, 0 };
+		uint32 texels[4] = { 0, 0, 0, 0 };
+		for (int j = 0; j < left; j++) {
+			pixels[j] = span.pixels[i + j];
+			depth[j] = span.depth[i + j];
+			if (kMode != kModeShade)
+				texels[j] = span.texels[i + j];
+		}
+		drawPixels(pixels, depth, texels);
+		for (int j = 0; j < left; j++) {
+			span.pixels[i + j] = pixels[j];
+			span.depth[i + j] = depth[j];
+		}
+	}
+}
+
+void initTriangleDSPNEON(TriangleDSP &dsp) {
+	dsp.shadeSpan = drawSpan<kModeShade>;
+	dsp.textureSpan = drawSpan<kModeTexture>;
+	dsp.blendTextureSpan = drawSpan<kModeBlendTexture>;
+}
+
+} // end of namespace TinyGL
@@ -0,0 +1,173 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <emmintrin.h>
+
+#include "graphics/tinygl/ztriangle_dsp.h"
+
+namespace TinyGL {
+
+enum SpanMode {
+	kModeShade,
+	kModeTexture,
+	kModeBlendTexture
+};
+
+static inline __m128i lanes(uint value, int delta) {
+	return _mm_set_epi32((int)(value + 3 * (uint)delta), (int)(value + 2 * (uint)delta), (int)(value + (uint)delta), (int)value);
+}
+
+static inline __m128i testDepth(TriangleSpan::DepthTest depthTest, __m128i z, __m128i zDst) {
+	// Unsigned compares, done on signed values with the sign bit flipped
+	const __m128i sign = _mm_set1_epi32((int)0x80000000);
+	switch (depthTest) {
+	case TriangleSpan::kDepthLess:
+		return _mm_cmpgt_epi32(_mm_xor_si128(z, sign), _mm_xor_si128(zDst, sign));
+	case TriangleSpan::kDepthLessEqual:
+		return _mm_xor_si128(_mm_cmpgt_epi32(_mm_xor_si128(zDst, sign), _mm_xor_si128(z, sign)), _mm_set1_epi32(-1));
+	default:
+		return _mm_set1_epi32(-1);
+	}
+}
+
+static inline __m128i roundDepth(__m128i z) {
+	// The generic code passes the depth on as a float. The halves convert
+	// exactly, so that their sum gets rounded only once.
+	const __m128 high = _mm_cvtepi32_ps(_mm_srli_epi32(z, 16));
+	const __m128 low = _mm_cvtepi32_ps(_mm_and_si128(z, _mm_set1_epi32(0xFFFF)));
+	const __m128 f = _mm_add_ps(_mm_mul_ps(high, _mm_set1_ps(65536.0f)), low);
+
+	// Values from 2^31 on do not fit the signed conversion
+	const __m128 big = _mm_cmpge_ps(f, _mm_set1_ps(2147483648.0f));
+	const __m128i result = _mm_cvttps_epi32(_mm_sub_ps(f, _mm_and_ps(big, _mm_set1_ps(2147483648.0f))));
+	return _mm_xor_si128(result, _mm_slli_epi32(_mm_castps_si128(big), 31));
+}
+
+static inline __m128i colorByte(__m128i color) {
+	return _mm_and_si128(_mm_srli_epi32(color, 8), _mm_set1_epi32(0xFF));
+}
+
+static inline __m128i modulate(__m128i texel, __m128i color) {
+	// Only the low 16 bits of the products matter for the result byte
+	const __m128i light = _mm_and_si128(_mm_srli_epi32(color, 8), _mm_set1_epi32(0xFFFF));
+	return _mm_and_si128(_mm_srli_epi32(_mm_mullo_epi16(texel, light), 8), _mm_set1_epi32(0xFF));
+}
+
+template <int kMode>
+static void drawSpan(const TriangleSpan &span) {
+	const __m128i ff = _mm_set1_epi32(0xFF);
+	const __m128i aShift = _mm_cvtsi32_si128(span.aShift);
+	const __m128i rShift = _mm_cvtsi32_si128(span.rShift);
+	const __m128i gShift = _mm_cvtsi32_si128(span.gShift);
+	const __m128i bShift = _mm_cvtsi32_si128(span.bShift);
+	const __m128i aMask = _mm_set1_epi32((int)span.aMask);
+
+	__m128i z = lanes(span.z, span.dzdx);
+	__m128i r = lanes(span.r, span.drdx);
+	__m128i g = lanes(span.g, span.dgdx);
+	__m128i b = lanes(span.b, span.dbdx);
+	__m128i a = lanes(span.a, span.dadx);
+	const __m128i dz = _mm_set1_epi32((int)(4 * (uint)span.dzdx));
+	const __m128i dr = _mm_set1_epi32((int)(4 * (uint)span.drdx));
+	const __m128i dg = _mm_set1_epi32((int)(4 * (uint)span.dgdx));
+	const __m128i db = _mm_set1_epi32((int)(4 * (uint)span.dbdx));
+	const __m128i da = _mm_set1_epi32((int)(4 * (uint)span.dadx));
+
+	auto drawPixels = [&](uint32 *pixels, uint *depth, const uint32 *texels) {
+		const __m128i zDst = _mm_loadu_si128((const __m128i *)depth);
+		const __m128i pass = testDepth(span.depthTest, z, zDst);
+		if (_mm_movemask_epi8(pass) == 0)
+			return;
+
+		if (span.depthWrite)
+			_mm_storeu_si128((__m128i *)depth, _mm_or_si128(_mm_and_si128(pass, roundDepth(z)), _mm_andnot_si128(pass, zDst)));
+
+		__m128i aSrc, rSrc, gSrc, bSrc;
+		if (kMode == kModeShade) {
+			aSrc = colorByte(a);
+			rSrc = colorByte(r);
+			gSrc = colorByte(g);
+			bSrc = colorByte(b);
+		} else {
+			const __m128i texel = _mm_loadu_si128((const __m128i *)texels);
+			aSrc = modulate(_mm_srli_epi32(texel, 24), a);
+			rSrc = modulate(_mm_and_si128(_mm_srli_epi32(texel, 16), ff), r);
+			gSrc = modulate(_mm_and_si128(_mm_srli_epi32(texel, 8), ff), g);
+			bSrc = modulate(_mm_and_si128(texel, ff), b);
+		}
+
+		const __m128i dst = _mm_loadu_si128((const __m128i *)pixels);
+		if (kMode == kModeBlendTexture) {
+			// The products fit into 16 bits, and the sums into the signed 16-bit minimum
+			const __m128i aInv = _mm_sub_epi32(ff, aSrc);
+			const __m128i rDst = _mm_and_si128(_mm_srl_epi32(dst, rShift), ff);
+			const __m128i gDst = _mm_and_si128(_mm_srl_epi32(dst, gShift), ff);
+			const __m128i bDst = _mm_and_si128(_mm_srl_epi32(dst, bShift), ff);
+			rSrc = _mm_min_epi16(_mm_add_epi32(_mm_srli_epi32(_mm_mullo_epi16(rSrc, aSrc), 8), _mm_srli_epi32(_mm_mullo_epi16(rDst, aInv), 8)), ff);
+			gSrc = _mm_min_epi16(_mm_add_epi32(_mm_srli_epi32(_mm_mullo_epi16(gSrc, aSrc), 8), _mm_srli_epi32(_mm_mullo_epi16(gDst, aInv), 8)), ff);
+			bSrc = _mm_min_epi16(_mm_add_epi32(_mm_srli_epi32(_mm_mullo_epi16(bSrc, aSrc), 8), _mm_srli_epi32(_mm_mullo_epi16(bDst, aInv), 8)), ff);
+			aSrc = ff;
+		}
+
+		__m128i color = _mm_and_si128(_mm_sll_epi32(aSrc, aShift), aMask);
+		color = _mm_or_si128(color, _mm_sll_epi32(rSrc, rShift));
+		color = _mm_or_si128(color, _mm_sll_epi32(gSrc, gShift));
+		color = _mm_or_si128(color, _mm_sll_epi32(bSrc, bShift));
+		_mm_storeu_si128((__m128i *)pixels, _mm_or_si128(_mm_and_si128(pass, color), _mm_andnot_si128(pass, dst)));
+	};
+
+	int i = 0;
+	for (; i + 4 <= span.count; i += 4) {
+		drawPixels(span.pixels + i, span.depth + i, kMode == kModeShade ? nullptr : span.texels + i);
+		z = _mm_add_epi32(z, dz);
+		r = _mm_add_epi32(r, dr);
+		g = _mm_add_epi32(g, dg);
+		b = _mm_add_epi32(b, db);
+		a = _mm_add_epi32(a, da);
+	}
+
+	const int left = span.count - i;
+	if (left > 0) {
+		// Go through a copy, so that nothing beyond the span gets touched
+		uint32 pixels[4] = { 0, 0, 0, 0 };
+		uint depth[4] = { 0, 0, 0, 0 };
+		uint32 texels[4] = { 0, 0, 0, 0 };
+		for (int j = 0; j < left; j++) {
+			pixels[j] = span.pixels[i + j];
+			depth[j] = span.depth[i + j];
+			if (kMode != kModeShade)
+				texels[j] = span.texels[i + j];
+		}
+		drawPixels(pixels, depth, texels);
+		for (int j = 0; j < left; j++) {
+			span.pixels[i + j] = pixels[j];
+			span.depth[i + j] = depth[j];
+		}
+	}
+}
+
+void initTriangleDSPSSE2(TriangleDSP &dsp) {
+	dsp.shadeSpan = drawSpan<kModeShade>;
+	dsp.textureSpan = drawSpan<kModeTexture>;
+	dsp.blendTextureSpan = drawSpan<kModeBlendTexture>;
+}
+
+} // end of namespace TinyGL
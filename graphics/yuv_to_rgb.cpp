@@ -82,8 +82,10 @@
 // BASIS, AND BROWN UNIVERSITY HAS NO OBLIGATION TO PROVIDE MAINTENANCE,
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
+#include "common/system.h"
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_intern.h"
 
 namespace Common {
 DECLARE_SINGLETON(Graphics::YUVToRGBManager);
@@ -168,6 +170,7 @@ YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::Lu
 YUVToRGBManager::YUVToRGBManager() {
 	_lookup = 0;
 	_alphaMode = false;
+	_simdEnabled = true;
 
 	int16 *Cr_r_tab = &_colorTab[0 * 256];
 	int16 *Cr_g_tab = &_colorTab[1 * 256];
@@ -202,6 +205,117 @@ const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, Y
 	return _lookup;
 }
 
+// Defined here rather than in the header, so that no copy compiled for a
+// SIMD instruction set can end up being used on CPUs without it
+bool YUVToRGBRowFormat::hasWholeByteChannels() const {
+	if (bytesPerPixel != 4 || rLoss != 0 || gLoss != 0 || bLoss != 0 || ((rShift | gShift | bShift | aShift) & 7) != 0)
+		return false;
+	if (aLoss != 0 && aLoss != 8)
+		return false;
+
+	int r, g, b, a;
+	getBytePositions(r, g, b, a);
+	if (r > 3 || g > 3 || b > 3 || a < 0 || a > 3)
+		return false;
+	return ((1 << r) | (1 << g) | (1 << b) | (1 << a)) == 0xF;
+}
+
+void YUVToRGBRowFormat::getBytePositions(int &r, int &g, int &b, int &a) const {
+	r = rShift / 8;
+	g = gShift / 8;
+	b = bShift / 8;
+	a = (aLoss == 0) ? aShift / 8 : 6 - r - g - b;
+}
+
+static YUVToRGBRowProc selectRowProc() {
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasCpuFeature(OSystem::kCpuFeatureAVX2))
+		return convertYUVToRGBRowAVX2;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasCpuFeature(OSystem::kCpuFeatureSSE2))
+		return convertYUVToRGBRowSSE2;
+#endif
+#ifdef SCUMMVM_NEON
+	if (g_system->hasCpuFeature(OSystem::kCpuFeatureNEON))
+		return convertYUVToRGBRowNEON;
+#endif
+	return nullptr;
+}
+
+static YUVToRGBRowProc getRowProc(bool simdEnabled) {
+	if (!simdEnabled || !g_system)
+		return nullptr;
+
+	// Pick the implementation once the backend is available to ask
+	static YUVToRGBRowProc rowProc = selectRowProc();
+	return rowProc;
+}
+
+static YUVToRGBRowFormat makeRowFormat(const Graphics::PixelFormat &format, YUVToRGBManager::LuminanceScale scale, bool subsampled, bool alphaMode) {
+	YUVToRGBRowFormat rowFormat;
+	rowFormat.bytesPerPixel = format.bytesPerPixel;
+	rowFormat.scaleITU = (scale == YUVToRGBManager::kScaleITU);
+	rowFormat.subsampled = subsampled;
+	rowFormat.rLoss = format.rLoss;
+	rowFormat.gLoss = format.gLoss;
+	rowFormat.bLoss = format.bLoss;
+	rowFormat.aLoss = format.aLoss;
+	rowFormat.rShift = format.rShift;
+	rowFormat.gShift = format.gShift;
+	rowFormat.bShift = format.bShift;
+	rowFormat.aShift = format.aShift;
+	// Matches the alpha value the lookup tables are built with
+	rowFormat.opaqueAlpha = format.ARGBToColor(alphaMode ? 0 : 255, 0, 0, 0);
+	return rowFormat;
+}
+
+/**
+ * Convert a YUV444 or YUV420 image with a SIMD row kernel. Whatever the
+ * kernel leaves at the end of a row goes through the lookup tables, which
+ * the kernels match exactly.
+ */
+template<typename PixelInt>
+void convertYUVToRGBSIMD(YUVToRGBRowProc rowProc, const YUVToRGBRowFormat &rowFormat, byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, const int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	const int shift = rowFormat.subsampled ? 1 : 0;
+
+	// Keep the tables in pointers here to avoid a dereference on each pixel
+	const int16 *Cr_r_tab = colorTab;
+	const int16 *Cr_g_tab = Cr_r_tab + 256;
+	const int16 *Cb_g_tab = Cr_g_tab + 256;
+	const int16 *Cb_b_tab = Cb_g_tab + 256;
+	const uint32 *rgbToPix = lookup->getRGBToPix();
+	const uint32 *aToPix = lookup->getAlphaToPix();
+
+	for (int h = 0; h < yHeight; h += 1 << shift) {
+		const int done = rowProc(dstPtr, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, yWidth, rowFormat);
+
+		for (int row = 0; row < (1 << shift); row++) {
+			byte *dst = dstPtr + row * dstPitch;
+			const byte *y = ySrc + row * yPitch;
+			const byte *a = aSrc ? aSrc + row * yPitch : nullptr;
+
+			for (int w = done; w < yWidth; w++) {
+				const byte u = uSrc[w >> shift];
+				const byte v = vSrc[w >> shift];
+				const uint32 *L = &rgbToPix[y[w]];
+
+				uint32 pixel = L[Cr_r_tab[v]] | L[Cr_g_tab[v] + Cb_g_tab[u]] | L[Cb_b_tab[u]];
+				if (a)
+					pixel |= aToPix[a[w]];
+				*((PixelInt *)dst + w) = pixel;
+			}
+		}
+
+		dstPtr += dstPitch << shift;
+		ySrc += yPitch << shift;
+		if (aSrc)
+			aSrc += yPitch << shift;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
+	}
+}
+
 #define PUT_PIXEL(s, d) \
 	L = &rgbToPix[(s)]; \
 	*((PixelInt *)(d)) = (L[cr_r] | L[crb_g] | L[cb_b])
@@ -245,6 +359,16 @@ void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+	YUVToRGBRowProc rowProc = getRowProc(_simdEnabled);
+	if (rowProc) {
+		const YUVToRGBRowFormat rowFormat = makeRowFormat(dst->format, scale, false, false);
+		if (dst->format.bytesPerPixel == 2)
+			convertYUVToRGBSIMD<uint16>(rowProc, rowFormat, (byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, nullptr, yWidth, yHeight, yPitch, uvPitch);
+		else
+			convertYUVToRGBSIMD<uint32>(rowProc, rowFormat, (byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, nullptr, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV444ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
@@ -301,6 +425,16 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+	YUVToRGBRowProc rowProc = getRowProc(_simdEnabled);
+	if (rowProc) {
+		const YUVToRGBRowFormat rowFormat = makeRowFormat(dst->format, scale, true, false);
+		if (dst->format.bytesPerPixel == 2)
+			convertYUVToRGBSIMD<uint16>(rowProc, rowFormat, (byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, nullptr, yWidth, yHeight, yPitch, uvPitch);
+		else
+			convertYUVToRGBSIMD<uint32>(rowProc, rowFormat, (byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, nullptr, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV420ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
@@ -365,6 +499,16 @@ void YUVToRGBManager::convert420Alpha(Graphics::Surface *dst, YUVToRGBManager::L
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale, true);
 
+	YUVToRGBRowProc rowProc = getRowProc(_simdEnabled);
+	if (rowProc) {
+		const YUVToRGBRowFormat rowFormat = makeRowFormat(dst->format, scale, true, true);
+		if (dst->format.bytesPerPixel == 2)
+			convertYUVToRGBSIMD<uint16>(rowProc, rowFormat, (byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+		else
+			convertYUVToRGBSIMD<uint32>(rowProc, rowFormat, (byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUVA420ToRGBA<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch);
@@ -120,6 +120,14 @@ public:
 	 */
 	void convert410(Graphics::Surface *dst, LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
 
+	/**
+	 * Enable or disable the SIMD versions of convert444(), convert420() and
+	 * convert420Alpha(). They are used by default if the host CPU supports
+	 * them and give the same results as the lookup tables; this only exists
+	 * for comparing the two.
+	 */
+	void setSIMDEnabled(bool enable) { _simdEnabled = enable; }
+
 private:
 	friend class Common::Singleton<SingletonBaseType>;
 	YUVToRGBManager();
@@ -130,6 +138,7 @@ private:
 	YUVToRGBLookup *_lookup;
 	int16 _colorTab[4 * 256]; // 2048 bytes
 	bool _alphaMode;
+	bool _simdEnabled;
 };
  /** @} */
 } // End of namespace Graphics
@@ -0,0 +1,250 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <immintrin.h>
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+namespace Graphics {
+
+namespace {
+
+struct ConstantsAVX2 {
+	__m256i zero, max;
+	__m128i rLoss, gLoss, bLoss, aLoss;
+	__m128i rShift, gShift, bShift, aShift;
+	__m256i opaqueAlpha16, opaqueAlpha32;
+	/** The byte of a pixel each channel goes to, for whole byte channels */
+	int rByte, gByte, bByte, aByte;
+	/** 0xFF in every byte if the format has an 8-bit alpha channel */
+	__m256i alphaBytes;
+
+	explicit ConstantsAVX2(const YUVToRGBRowFormat &format) {
+		zero = _mm256_setzero_si256();
+		max = _mm256_set1_epi16(format.scaleITU ? 235 - 16 : 255);
+		rLoss = _mm_cvtsi32_si128(format.rLoss);
+		gLoss = _mm_cvtsi32_si128(format.gLoss);
+		bLoss = _mm_cvtsi32_si128(format.bLoss);
+		aLoss = _mm_cvtsi32_si128(format.aLoss);
+		rShift = _mm_cvtsi32_si128(format.rShift);
+		gShift = _mm_cvtsi32_si128(format.gShift);
+		bShift = _mm_cvtsi32_si128(format.bShift);
+		aShift = _mm_cvtsi32_si128(format.aShift);
+		opaqueAlpha16 = _mm256_set1_epi16((int16)format.opaqueAlpha);
+		opaqueAlpha32 = _mm256_set1_epi32((int32)format.opaqueAlpha);
+		format.getBytePositions(rByte, gByte, bByte, aByte);
+		alphaBytes = _mm256_set1_epi8(format.aLoss == 0 ? (char)0xFF : 0);
+	}
+};
+
+/** The chroma offsets of thirty-two pixels, as two halves. */
+struct OffsetsAVX2 {
+	__m256i r[2], g[2], b[2];
+};
+
+/** Compute the offsets of sixteen 16-bit chroma samples. */
+inline void chromaOffsetsAVX2(__m256i u, __m256i v, __m256i &r, __m256i &g, __m256i &b) {
+	const __m256i bias = _mm256_set1_epi16(128);
+	const __m256i cr = _mm256_sub_epi16(v, bias);
+	const __m256i cb = _mm256_sub_epi16(u, bias);
+	const __m256i crSign = _mm256_srai_epi16(cr, 15);
+	const __m256i cbSign = _mm256_srai_epi16(cb, 15);
+	const __m256i crAbs = _mm256_slli_epi16(_mm256_abs_epi16(cr), 1);
+	const __m256i cbAbs = _mm256_slli_epi16(_mm256_abs_epi16(cb), 1);
+
+	// The sign goes back in with (x ^ s) - s, or with s - (x ^ s) for the negative factors
+	r = _mm256_sub_epi16(_mm256_xor_si256(_mm256_mulhi_epu16(crAbs, _mm256_set1_epi16((int16)kYUVToRGBCrToR)), crSign), crSign);
+	b = _mm256_sub_epi16(_mm256_xor_si256(_mm256_mulhi_epu16(cbAbs, _mm256_set1_epi16((int16)kYUVToRGBCbToB)), cbSign), cbSign);
+	g = _mm256_add_epi16(
+		_mm256_sub_epi16(crSign, _mm256_xor_si256(_mm256_mulhi_epu16(crAbs, _mm256_set1_epi16((int16)kYUVToRGBCrToG)), crSign)),
+		_mm256_sub_epi16(cbSign, _mm256_xor_si256(_mm256_mulhi_epu16(cbAbs, _mm256_set1_epi16((int16)kYUVToRGBCbToG)), cbSign)));
+}
+
+/**
+ * Add the offsets to sixteen luminance values and clamp and scale the result
+ * to [0, 255]. For the ITU scale, the luminance values come in as y - 16.
+ */
+template<bool kScaleITU>
+inline __m256i channelAVX2(__m256i y, __m256i offsets, const ConstantsAVX2 &c) {
+	__m256i v = _mm256_min_epi16(_mm256_max_epi16(_mm256_add_epi16(y, offsets), c.zero), c.max);
+	if (kScaleITU)
+		v = _mm256_mulhi_epu16(_mm256_slli_epi16(v, 1), _mm256_set1_epi16((int16)kYUVToRGBScaleITU));
+	return v;
+}
+
+/** As above, for channels which go through a saturating pack, which does the clamping for the full scale. */
+template<bool kScaleITU>
+inline __m256i channelBytesAVX2(__m256i y, __m256i offsets, const ConstantsAVX2 &c) {
+	if (kScaleITU)
+		return channelAVX2<kScaleITU>(y, offsets, c);
+	return _mm256_add_epi16(y, offsets);
+}
+
+/** Widen eight channel values and move them into place. */
+inline __m256i placeAVX2(__m128i channel, __m128i shift) {
+	return _mm256_sll_epi32(_mm256_cvtepu16_epi32(channel), shift);
+}
+
+/** Convert sixteen pixels of any format. */
+template<int kBytesPerPixel, bool kScaleITU, bool kAlpha>
+inline void pixelsAVX2(byte *dst, __m256i y, const byte *aSrc, __m256i rOffsets, __m256i gOffsets, __m256i bOffsets, const ConstantsAVX2 &c) {
+	const __m256i r = _mm256_srl_epi16(channelAVX2<kScaleITU>(y, rOffsets, c), c.rLoss);
+	const __m256i g = _mm256_srl_epi16(channelAVX2<kScaleITU>(y, gOffsets, c), c.gLoss);
+	const __m256i b = _mm256_srl_epi16(channelAVX2<kScaleITU>(y, bOffsets, c), c.bLoss);
+	const __m256i a = kAlpha ? _mm256_srl_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)aSrc)), c.aLoss) : _mm256_setzero_si256();
+
+	if (kBytesPerPixel == 2) {
+		__m256i pixels = _mm256_or_si256(_mm256_or_si256(_mm256_sll_epi16(r, c.rShift), _mm256_sll_epi16(g, c.gShift)), _mm256_sll_epi16(b, c.bShift));
+		pixels = _mm256_or_si256(pixels, kAlpha ? _mm256_sll_epi16(a, c.aShift) : c.opaqueAlpha16);
+		_mm256_storeu_si256((__m256i *)dst, pixels);
+	} else {
+		__m256i lo = _mm256_or_si256(_mm256_or_si256(
+			placeAVX2(_mm256_castsi256_si128(r), c.rShift),
+			placeAVX2(_mm256_castsi256_si128(g), c.gShift)),
+			placeAVX2(_mm256_castsi256_si128(b), c.bShift));
+		__m256i hi = _mm256_or_si256(_mm256_or_si256(
+			placeAVX2(_mm256_extracti128_si256(r, 1), c.rShift),
+			placeAVX2(_mm256_extracti128_si256(g, 1), c.gShift)),
+			placeAVX2(_mm256_extracti128_si256(b, 1), c.bShift));
+		lo = _mm256_or_si256(lo, kAlpha ? placeAVX2(_mm256_castsi256_si128(a), c.aShift) : c.opaqueAlpha32);
+		hi = _mm256_or_si256(hi, kAlpha ? placeAVX2(_mm256_extracti128_si256(a, 1), c.aShift) : c.opaqueAlpha32);
+		_mm256_storeu_si256((__m256i *)dst, lo);
+		_mm256_storeu_si256((__m256i *)(dst + 32), hi);
+	}
+}
+
+/**
+ * Convert thirty-two pixels. Formats with 8-bit channels in whole bytes go
+ * through saturating packs and byte interleaving instead of shifts.
+ */
+template<int kBytesPerPixel, bool kScaleITU, bool kAlpha, bool kWholeBytes>
+inline void pixelsAVX2(byte *dst, const byte *ySrc, const byte *aSrc, const OffsetsAVX2 &offsets, const ConstantsAVX2 &c) {
+	const __m256i bias = _mm256_set1_epi16(kScaleITU ? 16 : 0);
+	const __m256i y0 = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)ySrc)), bias);
+	const __m256i y1 = _mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(ySrc + 16))), bias);
+
+	if (!kWholeBytes) {
+		pixelsAVX2<kBytesPerPixel, kScaleITU, kAlpha>(dst, y0, aSrc, offsets.r[0], offsets.g[0], offsets.b[0], c);
+		pixelsAVX2<kBytesPerPixel, kScaleITU, kAlpha>(dst + 16 * kBytesPerPixel, y1, kAlpha ? aSrc + 16 : nullptr, offsets.r[1], offsets.g[1], offsets.b[1], c);
+		return;
+	}
+
+	// Packing works within 128-bit lanes, so the first lane ends up with
+	// pixels 0-7 and 16-23, and the second one with the rest
+	__m256i bytes[4];
+	bytes[c.rByte] = _mm256_packus_epi16(channelBytesAVX2<kScaleITU>(y0, offsets.r[0], c), channelBytesAVX2<kScaleITU>(y1, offsets.r[1], c));
+	bytes[c.gByte] = _mm256_packus_epi16(channelBytesAVX2<kScaleITU>(y0, offsets.g[0], c), channelBytesAVX2<kScaleITU>(y1, offsets.g[1], c));
+	bytes[c.bByte] = _mm256_packus_epi16(channelBytesAVX2<kScaleITU>(y0, offsets.b[0], c), channelBytesAVX2<kScaleITU>(y1, offsets.b[1], c));
+	if (kAlpha)
+		bytes[c.aByte] = _mm256_and_si256(_mm256_permute4x64_epi64(_mm256_loadu_si256((const __m256i *)aSrc), 0xD8), c.alphaBytes);
+	else
+		bytes[c.aByte] = c.alphaBytes;
+
+	const __m256i lo01 = _mm256_unpacklo_epi8(bytes[0], bytes[1]);
+	const __m256i hi01 = _mm256_unpackhi_epi8(bytes[0], bytes[1]);
+	const __m256i lo23 = _mm256_unpacklo_epi8(bytes[2], bytes[3]);
+	const __m256i hi23 = _mm256_unpackhi_epi8(bytes[2], bytes[3]);
+	const __m256i p0 = _mm256_unpacklo_epi16(lo01, lo23); // Pixels 0-3 and 8-11
+	const __m256i p1 = _mm256_unpackhi_epi16(lo01, lo23); // Pixels 4-7 and 12-15
+	const __m256i p2 = _mm256_unpacklo_epi16(hi01, hi23); // Pixels 16-19 and 24-27
+	const __m256i p3 = _mm256_unpackhi_epi16(hi01, hi23); // Pixels 20-23 and 28-31
+	_mm256_storeu_si256((__m256i *)dst, _mm256_permute2x128_si256(p0, p1, 0x20));
+	_mm256_storeu_si256((__m256i *)(dst + 32), _mm256_permute2x128_si256(p0, p1, 0x31));
+	_mm256_storeu_si256((__m256i *)(dst + 64), _mm256_permute2x128_si256(p2, p3, 0x20));
+	_mm256_storeu_si256((__m256i *)(dst + 96), _mm256_permute2x128_si256(p2, p3, 0x31));
+}
+
+/** Convert thirty-two pixels at a time. */
+template<int kBytesPerPixel, bool kScaleITU, bool kSubsampled, bool kAlpha, bool kWholeBytes>
+int convertBlocksAVX2(byte *dst, int dstPitch, const byte *ySrc, const byte *aSrc, int yPitch, const byte *uSrc, const byte *vSrc, int width, const ConstantsAVX2 &c) {
+	const int blocks = width / 32;
+	OffsetsAVX2 offsets;
+
+	for (int i = 0; i < blocks; ++i) {
+		if (kSubsampled) {
+			// Every chroma sample covers two pixels of each row. Duplicating them works
+			// within 128-bit lanes, so the halves need to be put back in order.
+			__m256i r, g, b;
+			chromaOffsetsAVX2(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)uSrc)), _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)vSrc)), r, g, b);
+			const __m256i rLo = _mm256_unpacklo_epi16(r, r), rHi = _mm256_unpackhi_epi16(r, r);
+			const __m256i gLo = _mm256_unpacklo_epi16(g, g), gHi = _mm256_unpackhi_epi16(g, g);
+			const __m256i bLo = _mm256_unpacklo_epi16(b, b), bHi = _mm256_unpackhi_epi16(b, b);
+			offsets.r[0] = _mm256_permute2x128_si256(rLo, rHi, 0x20);
+			offsets.r[1] = _mm256_permute2x128_si256(rLo, rHi, 0x31);
+			offsets.g[0] = _mm256_permute2x128_si256(gLo, gHi, 0x20);
+			offsets.g[1] = _mm256_permute2x128_si256(gLo, gHi, 0x31);
+			offsets.b[0] = _mm256_permute2x128_si256(bLo, bHi, 0x20);
+			offsets.b[1] = _mm256_permute2x128_si256(bLo, bHi, 0x31);
+			uSrc += 16;
+			vSrc += 16;
+		} else {
+			chromaOffsetsAVX2(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)uSrc)), _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)vSrc)), offsets.r[0], offsets.g[0], offsets.b[0]);
+			chromaOffsetsAVX2(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(uSrc + 16))), _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(vSrc + 16))), offsets.r[1], offsets.g[1], offsets.b[1]);
+			uSrc += 32;
+			vSrc += 32;
+		}
+
+		pixelsAVX2<kBytesPerPixel, kScaleITU, kAlpha, kWholeBytes>(dst, ySrc, aSrc, offsets, c);
+		if (kSubsampled)
+			pixelsAVX2<kBytesPerPixel, kScaleITU, kAlpha, kWholeBytes>(dst + dstPitch, ySrc + yPitch, kAlpha ? aSrc + yPitch : nullptr, offsets, c);
+
+		dst += 32 * kBytesPerPixel;
+		ySrc += 32;
+		if (kAlpha)
+			aSrc += 32;
+	}
+
+	return blocks * 32;
+}
+
+template<int kBytesPerPixel, bool kScaleITU, bool kWholeBytes>
+int convertRowAVX2(byte *dst, int dstPitch, const byte *ySrc, const byte *aSrc, int yPitch, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBRowFormat &format) {
+	const ConstantsAVX2 c(format);
+	if (format.subsampled) {
+		if (aSrc)
+			return convertBlocksAVX2<kBytesPerPixel, kScaleITU, true, true, kWholeBytes>(dst, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, width, c);
+		return convertBlocksAVX2<kBytesPerPixel, kScaleITU, true, false, kWholeBytes>(dst, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, width, c);
+	}
+	if (aSrc)
+		return convertBlocksAVX2<kBytesPerPixel, kScaleITU, false, true, kWholeBytes>(dst, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, width, c);
+	return convertBlocksAVX2<kBytesPerPixel, kScaleITU, false, false, kWholeBytes>(dst, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, width, c);
+}
+
+} // End of anonymous namespace
+
+int convertYUVToRGBRowAVX2(byte *dst, int dstPitch, const byte *ySrc, const byte *aSrc, int yPitch, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBRowFormat &format) {
+	if (format.bytesPerPixel == 2) {
+		if (format.scaleITU)
+			return convertRowAVX2<2, true, false>(dst, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, width, format);
+		return convertRowAVX2<2, false, false>(dst, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, width, format);
+	}
+	if (format.hasWholeByteChannels()) {
+		if (format.scaleITU)
+			return convertRowAVX2<4, true, true>(dst, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, width, format);
+		return convertRowAVX2<4, false, true>(dst, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, width, format);
+	}
+	if (format.scaleITU)
+		return convertRowAVX2<4, true, false>(dst, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, width, format);
+	return convertRowAVX2<4, false, false>(dst, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, width, format);
+}
+
+} // End of namespace Graphics
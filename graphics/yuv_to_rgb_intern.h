@@ -0,0 +1,105 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef GRAPHICS_YUV_TO_RGB_INTERN_H
+#define GRAPHICS_YUV_TO_RGB_INTERN_H
+
+#include "common/scummsys.h"
+
+namespace Graphics {
+
+/**
+ * The pixel format and luminance scale a row kernel converts to, in the
+ * form the kernels need it.
+ */
+struct YUVToRGBRowFormat {
+	int bytesPerPixel;
+	/** Clamp the channels to [16, 235] and scale them to [0, 255] */
+	bool scaleITU;
+	/**
+	 * The chroma planes have half the resolution in both directions. The
+	 * kernels then convert two rows at once, which share their chroma.
+	 */
+	bool subsampled;
+	uint8 rLoss, gLoss, bLoss, aLoss;
+	uint8 rShift, gShift, bShift, aShift;
+	/** The alpha bits of every pixel if there is no alpha source */
+	uint32 opaqueAlpha;
+
+	/**
+	 * Return true for 32-bit formats whose color channels are whole bytes
+	 * and whose alpha channel is either a whole byte as well or missing.
+	 * The kernels can put these together byte by byte.
+	 */
+	bool hasWholeByteChannels() const;
+
+	/**
+	 * Get the byte of a little endian pixel each channel of such a format
+	 * goes to. A missing alpha channel gets the byte left over.
+	 */
+	void getBytePositions(int &r, int &g, int &b, int &a) const;
+};
+
+/**
+ * The kernels compute the chroma offsets of the YUVToRGBManager color tables
+ * instead of looking them up. Each table holds trunc(f * c) for the chroma
+ * values c in [-128, 127], which is ((|c| << 1) * m) >> 16 with the factors
+ * below and the sign of f * c put back afterwards. This is exact for every
+ * value, as the test suite checks.
+ */
+enum {
+	kYUVToRGBCrToR = 45888,
+	kYUVToRGBCrToG = 23392, // negative factor
+	kYUVToRGBCbToG = 11284, // negative factor
+	kYUVToRGBCbToB = 58110,
+	/** ((t - 16) << 1) * m >> 16 is (t - 16) * 255 / 219 for t in [16, 235] */
+	kYUVToRGBScaleITU = 38155
+};
+
+/**
+ * The SIMD row kernels of YUVToRGBManager. They are only exposed so that the
+ * test suite can compare them against the lookup tables; everyone else
+ * should go through YUVToRGBManager, which picks the best one supported by
+ * the host CPU.
+ *
+ * A kernel converts the start of a row, or of two rows for subsampled
+ * chroma. It handles as many pixels as fit into whole vectors and returns
+ * their number; the caller converts the rest. The alpha source may be null,
+ * otherwise it has the same pitch as the luminance.
+ */
+typedef int (*YUVToRGBRowProc)(byte *dst, int dstPitch, const byte *ySrc, const byte *aSrc, int yPitch, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBRowFormat &format);
+
+#ifdef SCUMMVM_SSE2
+int convertYUVToRGBRowSSE2(byte *dst, int dstPitch, const byte *ySrc, const byte *aSrc, int yPitch, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBRowFormat &format);
+#endif
+
+#ifdef SCUMMVM_AVX2
+int convertYUVToRGBRowAVX2(byte *dst, int dstPitch, const byte *ySrc, const byte *aSrc, int yPitch, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBRowFormat &format);
+#endif
+
+#ifdef SCUMMVM_NEON
+int convertYUVToRGBRowNEON(byte *dst, int dstPitch, const byte *ySrc, const byte *aSrc, int yPitch, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBRowFormat &format);
+#endif
+
+} // End of namespace Graphics
+
+#endif
@@ -0,0 +1,240 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <arm_neon.h>
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+namespace Graphics {
+
+namespace {
+
+struct ConstantsNEON {
+	int16x8_t max;
+	// Negative shift counts shift to the right
+	int16x8_t rLoss, gLoss, bLoss, aLoss;
+	int16x8_t rShift16, gShift16, bShift16, aShift16;
+	int32x4_t rShift32, gShift32, bShift32, aShift32;
+	uint16x8_t opaqueAlpha16;
+	uint32x4_t opaqueAlpha32;
+	/** The byte of a pixel each channel goes to, for whole byte channels */
+	int rByte, gByte, bByte, aByte;
+	/** 0xFF in every byte if the format has an 8-bit alpha channel */
+	uint8x16_t alphaBytes;
+
+	explicit ConstantsNEON(const YUVToRGBRowFormat &format) {
+		max = vdupq_n_s16(format.scaleITU ? 235 - 16 : 255);
+		rLoss = vdupq_n_s16(-format.rLoss);
+		gLoss = vdupq_n_s16(-format.gLoss);
+		bLoss = vdupq_n_s16(-format.bLoss);
+		aLoss = vdupq_n_s16(-format.aLoss);
+		rShift16 = vdupq_n_s16(format.rShift);
+		gShift16 = vdupq_n_s16(format.gShift);
+		bShift16 = vdupq_n_s16(format.bShift);
+		aShift16 = vdupq_n_s16(format.aShift);
+		rShift32 = vdupq_n_s32(format.rShift);
+		gShift32 = vdupq_n_s32(format.gShift);
+		bShift32 = vdupq_n_s32(format.bShift);
+		aShift32 = vdupq_n_s32(format.aShift);
+		opaqueAlpha16 = vdupq_n_u16((uint16)format.opaqueAlpha);
+		opaqueAlpha32 = vdupq_n_u32(format.opaqueAlpha);
+		format.getBytePositions(rByte, gByte, bByte, aByte);
+		alphaBytes = vdupq_n_u8(format.aLoss == 0 ? 0xFF : 0);
+	}
+};
+
+/** The chroma offsets of sixteen pixels, as two halves. */
+struct OffsetsNEON {
+	int16x8_t r[2], g[2], b[2];
+};
+
+/** Compute ((x << 1) * m) >> 16 for eight unsigned values. */
+inline uint16x8_t mulhiNEON(uint16x8_t x, uint16 m) {
+	const uint16x4_t factor = vdup_n_u16(m);
+	x = vshlq_n_u16(x, 1);
+	return vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(x), factor), 16), vshrn_n_u32(vmull_u16(vget_high_u16(x), factor), 16));
+}
+
+/** Compute the offsets of eight chroma samples. */
+inline void chromaOffsetsNEON(uint8x8_t u, uint8x8_t v, int16x8_t &r, int16x8_t &g, int16x8_t &b) {
+	const int16x8_t cr = vreinterpretq_s16_u16(vsubl_u8(v, vdup_n_u8(128)));
+	const int16x8_t cb = vreinterpretq_s16_u16(vsubl_u8(u, vdup_n_u8(128)));
+	const int16x8_t crSign = vshrq_n_s16(cr, 15);
+	const int16x8_t cbSign = vshrq_n_s16(cb, 15);
+	const uint16x8_t crAbs = vreinterpretq_u16_s16(vabsq_s16(cr));
+	const uint16x8_t cbAbs = vreinterpretq_u16_s16(vabsq_s16(cb));
+
+	// The sign goes back in with (x ^ s) - s, or with s - (x ^ s) for the negative factors
+	r = vsubq_s16(veorq_s16(vreinterpretq_s16_u16(mulhiNEON(crAbs, kYUVToRGBCrToR)), crSign), crSign);
+	b = vsubq_s16(veorq_s16(vreinterpretq_s16_u16(mulhiNEON(cbAbs, kYUVToRGBCbToB)), cbSign), cbSign);
+	g = vaddq_s16(
+		vsubq_s16(crSign, veorq_s16(vreinterpretq_s16_u16(mulhiNEON(crAbs, kYUVToRGBCrToG)), crSign)),
+		vsubq_s16(cbSign, veorq_s16(vreinterpretq_s16_u16(mulhiNEON(cbAbs, kYUVToRGBCbToG)), cbSign)));
+}
+
+/**
+ * Add the offsets to eight luminance values and clamp and scale the result
+ * to [0, 255]. For the ITU scale, the luminance values come in as y - 16.
+ */
+template<bool kScaleITU>
+inline uint16x8_t channelNEON(int16x8_t y, int16x8_t offsets, const ConstantsNEON &c) {
+	uint16x8_t v = vreinterpretq_u16_s16(vminq_s16(vmaxq_s16(vaddq_s16(y, offsets), vdupq_n_s16(0)), c.max));
+	if (kScaleITU)
+		v = mulhiNEON(v, kYUVToRGBScaleITU);
+	return v;
+}
+
+/** As above, narrowed to bytes. The saturating narrowing does the clamping for the full scale. */
+template<bool kScaleITU>
+inline uint8x8_t channelBytesNEON(int16x8_t y, int16x8_t offsets, const ConstantsNEON &c) {
+	if (kScaleITU)
+		return vmovn_u16(channelNEON<kScaleITU>(y, offsets, c));
+	return vqmovun_s16(vaddq_s16(y, offsets));
+}
+
+inline uint32x4_t placeNEON(uint16x4_t channel, int32x4_t shift) {
+	return vshlq_u32(vmovl_u16(channel), shift);
+}
+
+/** Convert eight pixels of any format. */
+template<int kBytesPerPixel, bool kScaleITU, bool kAlpha>
+inline void pixelsNEON(byte *dst, int16x8_t y, const byte *aSrc, int16x8_t rOffsets, int16x8_t gOffsets, int16x8_t bOffsets, const ConstantsNEON &c) {
+	const uint16x8_t r = vshlq_u16(channelNEON<kScaleITU>(y, rOffsets, c), c.rLoss);
+	const uint16x8_t g = vshlq_u16(channelNEON<kScaleITU>(y, gOffsets, c), c.gLoss);
+	const uint16x8_t b = vshlq_u16(channelNEON<kScaleITU>(y, bOffsets, c), c.bLoss);
+	const uint16x8_t a = kAlpha ? vshlq_u16(vmovl_u8(vld1_u8(aSrc)), c.aLoss) : vdupq_n_u16(0);
+
+	if (kBytesPerPixel == 2) {
+		uint16x8_t pixels = vorrq_u16(vorrq_u16(vshlq_u16(r, c.rShift16), vshlq_u16(g, c.gShift16)), vshlq_u16(b, c.bShift16));
+		pixels = vorrq_u16(pixels, kAlpha ? vshlq_u16(a, c.aShift16) : c.opaqueAlpha16);
+		vst1q_u16((uint16 *)dst, pixels);
+	} else {
+		uint32x4_t lo = vorrq_u32(vorrq_u32(placeNEON(vget_low_u16(r), c.rShift32), placeNEON(vget_low_u16(g), c.gShift32)), placeNEON(vget_low_u16(b), c.bShift32));
+		uint32x4_t hi = vorrq_u32(vorrq_u32(placeNEON(vget_high_u16(r), c.rShift32), placeNEON(vget_high_u16(g), c.gShift32)), placeNEON(vget_high_u16(b), c.bShift32));
+		lo = vorrq_u32(lo, kAlpha ? placeNEON(vget_low_u16(a), c.aShift32) : c.opaqueAlpha32);
+		hi = vorrq_u32(hi, kAlpha ? placeNEON(vget_high_u16(a), c.aShift32) : c.opaqueAlpha32);
+		vst1q_u32((uint32 *)dst, lo);
+		vst1q_u32((uint32 *)(dst + 16), hi);
+	}
+}
+
+/**
+ * Convert sixteen pixels. Formats with 8-bit channels in whole bytes go
+ * through saturating narrowing and an interleaving store instead of shifts.
+ */
+template<int kBytesPerPixel, bool kScaleITU, bool kAlpha, bool kWholeBytes>
+inline void pixelsNEON(byte *dst, const byte *ySrc, const byte *aSrc, const OffsetsNEON &offsets, const ConstantsNEON &c) {
+	const uint8x16_t y = vld1q_u8(ySrc);
+	const int16x8_t bias = vdupq_n_s16(kScaleITU ? 16 : 0);
+	const int16x8_t y0 = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(y))), bias);
+	const int16x8_t y1 = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(y))), bias);
+
+	if (!kWholeBytes) {
+		pixelsNEON<kBytesPerPixel, kScaleITU, kAlpha>(dst, y0, aSrc, offsets.r[0], offsets.g[0], offsets.b[0], c);
+		pixelsNEON<kBytesPerPixel, kScaleITU, kAlpha>(dst + 8 * kBytesPerPixel, y1, kAlpha ? aSrc + 8 : nullptr, offsets.r[1], offsets.g[1], offsets.b[1], c);
+		return;
+	}
+
+	uint8x16x4_t bytes;
+	bytes.val[c.rByte] = vcombine_u8(channelBytesNEON<kScaleITU>(y0, offsets.r[0], c), channelBytesNEON<kScaleITU>(y1, offsets.r[1], c));
+	bytes.val[c.gByte] = vcombine_u8(channelBytesNEON<kScaleITU>(y0, offsets.g[0], c), channelBytesNEON<kScaleITU>(y1, offsets.g[1], c));
+	bytes.val[c.bByte] = vcombine_u8(channelBytesNEON<kScaleITU>(y0, offsets.b[0], c), channelBytesNEON<kScaleITU>(y1, offsets.b[1], c));
+	bytes.val[c.aByte] = kAlpha ? vandq_u8(vld1q_u8(aSrc), c.alphaBytes) : c.alphaBytes;
+	vst4q_u8(dst, bytes);
+}
+
+/** Convert sixteen pixels at a time. */
+template<int kBytesPerPixel, bool kScaleITU, bool kSubsampled, bool kAlpha, bool kWholeBytes>
+int convertBlocksNEON(byte *dst, int dstPitch, const byte *ySrc, const byte *aSrc, int yPitch, const byte *uSrc, const byte *vSrc, int width, const ConstantsNEON &c) {
+	const int blocks = width / 16;
+	OffsetsNEON offsets;
+
+	for (int i = 0; i < blocks; ++i) {
+		if (kSubsampled) {
+			// Every chroma sample covers two pixels of each row
+			int16x8_t r, g, b;
+			chromaOffsetsNEON(vld1_u8(uSrc), vld1_u8(vSrc), r, g, b);
+			const int16x8x2_t rPairs = vzipq_s16(r, r);
+			const int16x8x2_t gPairs = vzipq_s16(g, g);
+			const int16x8x2_t bPairs = vzipq_s16(b, b);
+			offsets.r[0] = rPairs.val[0];
+			offsets.r[1] = rPairs.val[1];
+			offsets.g[0] = gPairs.val[0];
+			offsets.g[1] = gPairs.val[1];
+			offsets.b[0] = bPairs.val[0];
+			offsets.b[1] = bPairs.val[1];
+			uSrc += 8;
+			vSrc += 8;
+		} else {
+			chromaOffsetsNEON(vld1_u8(uSrc), vld1_u8(vSrc), offsets.r[0], offsets.g[0], offsets.b[0]);
+			chromaOffsetsNEON(vld1_u8(uSrc + 8), vld1_u8(vSrc + 8), offsets.r[1], offsets.g[1], offsets.b[1]);
+			uSrc += 16;
+			vSrc += 16;
+		}
+
+		pixelsNEON<kBytesPerPixel, kScaleITU, kAlpha, kWholeBytes>(dst, ySrc, aSrc, offsets, c);
+		if (kSubsampled)
+			pixelsNEON<kBytesPerPixel, kScaleITU, kAlpha, kWholeBytes>(dst + dstPitch, ySrc + yPitch, kAlpha ? aSrc + yPitch : nullptr, offsets, c);
+
+		dst += 16 * kBytesPerPixel;
+		ySrc += 16;
+		if (kAlpha)
+			aSrc += 16;
+	}
+
+	return blocks * 16;
+}
+
+template<int kBytesPerPixel, bool kScaleITU, bool kWholeBytes>
+int convertRowNEON(byte *dst, int dstPitch, const byte *ySrc, const byte *aSrc, int yPitch, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBRowFormat &format) {
+	const ConstantsNEON c(format);
+	if (format.subsampled) {
+		if (aSrc)
+			return convertBlocksNEON<kBytesPerPixel, kScaleITU, true, true, kWholeBytes>(dst, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, width, c);
+		return convertBlocksNEON<kBytesPerPixel, kScaleITU, true, false, kWholeBytes>(dst, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, width, c);
+	}
+	if (aSrc)
+		return convertBlocksNEON<kBytesPerPixel, kScaleITU, false, true, kWholeBytes>(dst, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, width, c);
+	return convertBlocksNEON<kBytesPerPixel, kScaleITU, false, false, kWholeBytes>(dst, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, width, c);
+}
+
+} // End of anonymous namespace
+
+int convertYUVToRGBRowNEON(byte *dst, int dstPitch, const byte *ySrc, const byte *aSrc, int yPitch, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBRowFormat &format) {
+	if (format.bytesPerPixel == 2) {
+		if (format.scaleITU)
+			return convertRowNEON<2, true, false>(dst, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, width, format);
+		return convertRowNEON<2, false, false>(dst, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, width, format);
+	}
+#ifdef SCUMM_LITTLE_ENDIAN
+	if (format.hasWholeByteChannels()) {
+		if (format.scaleITU)
+			return convertRowNEON<4, true, true>(dst, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, width, format);
+		return convertRowNEON<4, false, true>(dst, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, width, format);
+	}
+#endif
+	if (format.scaleITU)
+		return convertRowNEON<4, true, false>(dst, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, width, format);
+	return convertRowNEON<4, false, false>(dst, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, width, format);
+}
+
+} // End of namespace Graphics
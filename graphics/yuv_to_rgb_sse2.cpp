@@ -0,0 +1,238 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <emmintrin.h>
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+namespace Graphics {
+
+namespace {
+
+struct ConstantsSSE2 {
+	__m128i zero, max;
+	__m128i rLoss, gLoss, bLoss, aLoss;
+	__m128i rShift, gShift, bShift, aShift;
+	__m128i opaqueAlpha16, opaqueAlpha32;
+	/** The byte of a pixel each channel goes to, for whole byte channels */
+	int rByte, gByte, bByte, aByte;
+	/** 0xFF in every byte if the format has an 8-bit alpha channel */
+	__m128i alphaBytes;
+
+	explicit ConstantsSSE2(const YUVToRGBRowFormat &format) {
+		zero = _mm_setzero_si128();
+		max = _mm_set1_epi16(format.scaleITU ? 235 - 16 : 255);
+		rLoss = _mm_cvtsi32_si128(format.rLoss);
+		gLoss = _mm_cvtsi32_si128(format.gLoss);
+		bLoss = _mm_cvtsi32_si128(format.bLoss);
+		aLoss = _mm_cvtsi32_si128(format.aLoss);
+		rShift = _mm_cvtsi32_si128(format.rShift);
+		gShift = _mm_cvtsi32_si128(format.gShift);
+		bShift = _mm_cvtsi32_si128(format.bShift);
+		aShift = _mm_cvtsi32_si128(format.aShift);
+		opaqueAlpha16 = _mm_set1_epi16((int16)format.opaqueAlpha);
+		opaqueAlpha32 = _mm_set1_epi32((int32)format.opaqueAlpha);
+		format.getBytePositions(rByte, gByte, bByte, aByte);
+		alphaBytes = _mm_set1_epi8(format.aLoss == 0 ? (char)0xFF : 0);
+	}
+};
+
+/** The chroma offsets of sixteen pixels, as two halves. */
+struct OffsetsSSE2 {
+	__m128i r[2], g[2], b[2];
+};
+
+/** Compute the offsets of eight 16-bit chroma samples. */
+inline void chromaOffsetsSSE2(__m128i u, __m128i v, __m128i &r, __m128i &g, __m128i &b) {
+	const __m128i bias = _mm_set1_epi16(128);
+	const __m128i cr = _mm_sub_epi16(v, bias);
+	const __m128i cb = _mm_sub_epi16(u, bias);
+	const __m128i crSign = _mm_srai_epi16(cr, 15);
+	const __m128i cbSign = _mm_srai_epi16(cb, 15);
+	const __m128i crAbs = _mm_slli_epi16(_mm_sub_epi16(_mm_xor_si128(cr, crSign), crSign), 1);
+	const __m128i cbAbs = _mm_slli_epi16(_mm_sub_epi16(_mm_xor_si128(cb, cbSign), cbSign), 1);
+
+	// The sign goes back in with (x ^ s) - s, or with s - (x ^ s) for the negative factors
+	r = _mm_sub_epi16(_mm_xor_si128(_mm_mulhi_epu16(crAbs, _mm_set1_epi16((int16)kYUVToRGBCrToR)), crSign), crSign);
+	b = _mm_sub_epi16(_mm_xor_si128(_mm_mulhi_epu16(cbAbs, _mm_set1_epi16((int16)kYUVToRGBCbToB)), cbSign), cbSign);
+	g = _mm_add_epi16(
+		_mm_sub_epi16(crSign, _mm_xor_si128(_mm_mulhi_epu16(crAbs, _mm_set1_epi16((int16)kYUVToRGBCrToG)), crSign)),
+		_mm_sub_epi16(cbSign, _mm_xor_si128(_mm_mulhi_epu16(cbAbs, _mm_set1_epi16((int16)kYUVToRGBCbToG)), cbSign)));
+}
+
+/**
+ * Add the offsets to eight luminance values and clamp and scale the result
+ * to [0, 255]. For the ITU scale, the luminance values come in as y - 16.
+ */
+template<bool kScaleITU>
+inline __m128i channelSSE2(__m128i y, __m128i offsets, const ConstantsSSE2 &c) {
+	__m128i v = _mm_min_epi16(_mm_max_epi16(_mm_add_epi16(y, offsets), c.zero), c.max);
+	if (kScaleITU)
+		v = _mm_mulhi_epu16(_mm_slli_epi16(v, 1), _mm_set1_epi16((int16)kYUVToRGBScaleITU));
+	return v;
+}
+
+/** As above, for channels which go through a saturating pack, which does the clamping for the full scale. */
+template<bool kScaleITU>
+inline __m128i channelBytesSSE2(__m128i y, __m128i offsets, const ConstantsSSE2 &c) {
+	if (kScaleITU)
+		return channelSSE2<kScaleITU>(y, offsets, c);
+	return _mm_add_epi16(y, offsets);
+}
+
+/** Convert eight pixels of any format. */
+template<int kBytesPerPixel, bool kScaleITU, bool kAlpha>
+inline void pixelsSSE2(byte *dst, __m128i y, const byte *aSrc, __m128i rOffsets, __m128i gOffsets, __m128i bOffsets, const ConstantsSSE2 &c) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i r = _mm_srl_epi16(channelSSE2<kScaleITU>(y, rOffsets, c), c.rLoss);
+	const __m128i g = _mm_srl_epi16(channelSSE2<kScaleITU>(y, gOffsets, c), c.gLoss);
+	const __m128i b = _mm_srl_epi16(channelSSE2<kScaleITU>(y, bOffsets, c), c.bLoss);
+	const __m128i a = kAlpha ? _mm_srl_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)aSrc), zero), c.aLoss) : zero;
+
+	if (kBytesPerPixel == 2) {
+		__m128i pixels = _mm_or_si128(_mm_or_si128(_mm_sll_epi16(r, c.rShift), _mm_sll_epi16(g, c.gShift)), _mm_sll_epi16(b, c.bShift));
+		pixels = _mm_or_si128(pixels, kAlpha ? _mm_sll_epi16(a, c.aShift) : c.opaqueAlpha16);
+		_mm_storeu_si128((__m128i *)dst, pixels);
+	} else {
+		__m128i lo = _mm_or_si128(_mm_or_si128(
+			_mm_sll_epi32(_mm_unpacklo_epi16(r, zero), c.rShift),
+			_mm_sll_epi32(_mm_unpacklo_epi16(g, zero), c.gShift)),
+			_mm_sll_epi32(_mm_unpacklo_epi16(b, zero), c.bShift));
+		__m128i hi = _mm_or_si128(_mm_or_si128(
+			_mm_sll_epi32(_mm_unpackhi_epi16(r, zero), c.rShift),
+			_mm_sll_epi32(_mm_unpackhi_epi16(g, zero), c.gShift)),
+			_mm_sll_epi32(_mm_unpackhi_epi16(b, zero), c.bShift));
+		lo = _mm_or_si128(lo, kAlpha ? _mm_sll_epi32(_mm_unpacklo_epi16(a, zero), c.aShift) : c.opaqueAlpha32);
+		hi = _mm_or_si128(hi, kAlpha ? _mm_sll_epi32(_mm_unpackhi_epi16(a, zero), c.aShift) : c.opaqueAlpha32);
+		_mm_storeu_si128((__m128i *)dst, lo);
+		_mm_storeu_si128((__m128i *)(dst + 16), hi);
+	}
+}
+
+/**
+ * Convert sixteen pixels. Formats with 8-bit channels in whole bytes go
+ * through saturating packs and byte interleaving instead of shifts.
+ */
+template<int kBytesPerPixel, bool kScaleITU, bool kAlpha, bool kWholeBytes>
+inline void pixelsSSE2(byte *dst, const byte *ySrc, const byte *aSrc, const OffsetsSSE2 &offsets, const ConstantsSSE2 &c) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i y = _mm_loadu_si128((const __m128i *)ySrc);
+	const __m128i bias = _mm_set1_epi16(kScaleITU ? 16 : 0);
+	const __m128i y0 = _mm_sub_epi16(_mm_unpacklo_epi8(y, zero), bias);
+	const __m128i y1 = _mm_sub_epi16(_mm_unpackhi_epi8(y, zero), bias);
+
+	if (!kWholeBytes) {
+		pixelsSSE2<kBytesPerPixel, kScaleITU, kAlpha>(dst, y0, aSrc, offsets.r[0], offsets.g[0], offsets.b[0], c);
+		pixelsSSE2<kBytesPerPixel, kScaleITU, kAlpha>(dst + 8 * kBytesPerPixel, y1, kAlpha ? aSrc + 8 : nullptr, offsets.r[1], offsets.g[1], offsets.b[1], c);
+		return;
+	}
+
+	__m128i bytes[4];
+	bytes[c.rByte] = _mm_packus_epi16(channelBytesSSE2<kScaleITU>(y0, offsets.r[0], c), channelBytesSSE2<kScaleITU>(y1, offsets.r[1], c));
+	bytes[c.gByte] = _mm_packus_epi16(channelBytesSSE2<kScaleITU>(y0, offsets.g[0], c), channelBytesSSE2<kScaleITU>(y1, offsets.g[1], c));
+	bytes[c.bByte] = _mm_packus_epi16(channelBytesSSE2<kScaleITU>(y0, offsets.b[0], c), channelBytesSSE2<kScaleITU>(y1, offsets.b[1], c));
+	bytes[c.aByte] = kAlpha ? _mm_and_si128(_mm_loadu_si128((const __m128i *)aSrc), c.alphaBytes) : c.alphaBytes;
+
+	const __m128i lo01 = _mm_unpacklo_epi8(bytes[0], bytes[1]);
+	const __m128i hi01 = _mm_unpackhi_epi8(bytes[0], bytes[1]);
+	const __m128i lo23 = _mm_unpacklo_epi8(bytes[2], bytes[3]);
+	const __m128i hi23 = _mm_unpackhi_epi8(bytes[2], bytes[3]);
+	_mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi16(lo01, lo23));
+	_mm_storeu_si128((__m128i *)(dst + 16), _mm_unpackhi_epi16(lo01, lo23));
+	_mm_storeu_si128((__m128i *)(dst + 32), _mm_unpacklo_epi16(hi01, hi23));
+	_mm_storeu_si128((__m128i *)(dst + 48), _mm_unpackhi_epi16(hi01, hi23));
+}
+
+/** Convert sixteen pixels at a time. */
+template<int kBytesPerPixel, bool kScaleITU, bool kSubsampled, bool kAlpha, bool kWholeBytes>
+int convertBlocksSSE2(byte *dst, int dstPitch, const byte *ySrc, const byte *aSrc, int yPitch, const byte *uSrc, const byte *vSrc, int width, const ConstantsSSE2 &c) {
+	const __m128i zero = _mm_setzero_si128();
+	const int blocks = width / 16;
+	OffsetsSSE2 offsets;
+
+	for (int i = 0; i < blocks; ++i) {
+		if (kSubsampled) {
+			// Every chroma sample covers two pixels of each row
+			__m128i r, g, b;
+			chromaOffsetsSSE2(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)uSrc), zero), _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)vSrc), zero), r, g, b);
+			offsets.r[0] = _mm_unpacklo_epi16(r, r);
+			offsets.r[1] = _mm_unpackhi_epi16(r, r);
+			offsets.g[0] = _mm_unpacklo_epi16(g, g);
+			offsets.g[1] = _mm_unpackhi_epi16(g, g);
+			offsets.b[0] = _mm_unpacklo_epi16(b, b);
+			offsets.b[1] = _mm_unpackhi_epi16(b, b);
+			uSrc += 8;
+			vSrc += 8;
+		} else {
+			const __m128i u = _mm_loadu_si128((const __m128i *)uSrc);
+			const __m128i v = _mm_loadu_si128((const __m128i *)vSrc);
+			chromaOffsetsSSE2(_mm_unpacklo_epi8(u, zero), _mm_unpacklo_epi8(v, zero), offsets.r[0], offsets.g[0], offsets.b[0]);
+			chromaOffsetsSSE2(_mm_unpackhi_epi8(u, zero), _mm_unpackhi_epi8(v, zero), offsets.r[1], offsets.g[1], offsets.b[1]);
+			uSrc += 16;
+			vSrc += 16;
+		}
+
+		pixelsSSE2<kBytesPerPixel, kScaleITU, kAlpha, kWholeBytes>(dst, ySrc, aSrc, offsets, c);
+		if (kSubsampled)
+			pixelsSSE2<kBytesPerPixel, kScaleITU, kAlpha, kWholeBytes>(dst + dstPitch, ySrc + yPitch, kAlpha ? aSrc + yPitch : nullptr, offsets, c);
+
+		dst += 16 * kBytesPerPixel;
+		ySrc += 16;
+		if (kAlpha)
+			aSrc += 16;
+	}
+
+	return blocks * 16;
+}
+
+template<int kBytesPerPixel, bool kScaleITU, bool kWholeBytes>
+int convertRowSSE2(byte *dst, int dstPitch, const byte *ySrc, const byte *aSrc, int yPitch, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBRowFormat &format) {
+	const ConstantsSSE2 c(format);
+	if (format.subsampled) {
+		if (aSrc)
+			return convertBlocksSSE2<kBytesPerPixel, kScaleITU, true, true, kWholeBytes>(dst, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, width, c);
+		return convertBlocksSSE2<kBytesPerPixel, kScaleITU, true, false, kWholeBytes>(dst, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, width, c);
+	}
+	if (aSrc)
+		return convertBlocksSSE2<kBytesPerPixel, kScaleITU, false, true, kWholeBytes>(dst, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, width, c);
+	return convertBlocksSSE2<kBytesPerPixel, kScaleITU, false, false, kWholeBytes>(dst, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, width, c);
+}
+
+} // End of anonymous namespace
+
+int convertYUVToRGBRowSSE2(byte *dst, int dstPitch, const byte *ySrc, const byte *aSrc, int yPitch, const byte *uSrc, const byte *vSrc, int width, const YUVToRGBRowFormat &format) {
+	if (format.bytesPerPixel == 2) {
+		if (format.scaleITU)
+			return convertRowSSE2<2, true, false>(dst, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, width, format);
+		return convertRowSSE2<2, false, false>(dst, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, width, format);
+	}
+	if (format.hasWholeByteChannels()) {
+		if (format.scaleITU)
+			return convertRowSSE2<4, true, true>(dst, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, width, format);
+		return convertRowSSE2<4, false, true>(dst, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, width, format);
+	}
+	if (format.scaleITU)
+		return convertRowSSE2<4, true, false>(dst, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, width, format);
+	return convertRowSSE2<4, false, false>(dst, dstPitch, ySrc, aSrc, yPitch, uSrc, vSrc, width, format);
+}
+
+} // End of namespace Graphics
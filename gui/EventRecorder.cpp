@@ -24,12 +24,15 @@
 
 #ifdef ENABLE_EVENTRECORDER
 
+#ifdef POSIX
+#include <sys/resource.h>
+#endif
+
 namespace Common {
 DECLARE_SINGLETON(GUI::EventRecorder);
 }
 
 #include "common/debug-channels.h"
-#include "backends/timer/sdl/sdl-timer.h"
 #include "backends/mixer/mixer.h"
 #include "common/config-manager.h"
 #include "common/md5.h"
@@ -78,6 +81,13 @@ EventRecorder::EventRecorder() {
 	_screenshotPeriod = 0;
 	_playbackFile = nullptr;
 	_recordFile = nullptr;
+	_benchmarkClock = nullptr;
+	_benchmarkFrameStart = 0;
+	_benchmarkScreenStart = 0;
+	_benchmarkEngineTime = 0;
+	_benchmarkMixerTime = 0;
+	_benchmarkTimerTime = 0;
+	_benchmarkReported = false;
 }
 
 EventRecorder::~EventRecorder() {
@@ -88,6 +98,7 @@ void EventRecorder::deinit() {
 	if (!_initialized) {
 		return;
 	}
+	writeBenchmarkReport();
 	setFileHeader();
 	_needRedraw = false;
 	_initialized = false;
@@ -219,7 +230,7 @@ void EventRecorder::processMillis(uint32 &millis, bool skipRecord) {
 		}
 		updateSubsystems();
 		_nextEvent = _playbackFile->getNextEvent();
-		_timerManager->handler();
+		runTimers();
 		_controlPanel->setReplayedTime(_fakeTimer);
 		_processingMillis = false;
 		break;
@@ -256,6 +267,12 @@ void EventRecorder::processScreenUpdate() {
 		break;
 	case kRecorderUpdate: // fallthrough
 	case kRecorderPlayback:
+		if (_benchmarkClock) {
+			// Everything since the previous frame, except for audio mixing
+			// and timer callbacks, has been done by the engine
+			const uint64 now = _benchmarkClock();
+			_benchmarkEngineTime = (uint32)(now - _benchmarkFrameStart) - _benchmarkMixerTime - _benchmarkTimerTime;
+		}
 		// if the next event isn't a screen update, fast forward until we find one.
 		if (_nextEvent.recordedtype != Common::kRecorderEventTypeScreenUpdate) {
 			int numSkipped = 0;
@@ -279,15 +296,104 @@ void EventRecorder::processScreenUpdate() {
 			_recordFile->writeEvent(screenUpdateEvent);
 			takeScreenshot();
 		}
-		_timerManager->handler();
+		runTimers();
 		_controlPanel->setReplayedTime(_fakeTimer);
 		_processingMillis = false;
+		if (_benchmarkClock)
+			_benchmarkScreenStart = _benchmarkClock();
 		break;
 	default:
 		break;
 	}
 }
 
+void EventRecorder::setBenchmarkClock(uint64 (*getMicros)()) {
+	_benchmarkClock = getMicros;
+	_fastPlayback = true;
+	_benchmarkFrames.clear();
+	_benchmarkFrameStart = getMicros();
+	_benchmarkScreenStart = 0;
+	_benchmarkEngineTime = 0;
+	_benchmarkMixerTime = 0;
+	_benchmarkTimerTime = 0;
+	_benchmarkReported = false;
+}
+
+void EventRecorder::runTimers() {
+	const uint64 timerStart = _benchmarkClock ? _benchmarkClock() : 0;
+	_timerManager->handler();
+	if (_benchmarkClock)
+		_benchmarkTimerTime += (uint32)(_benchmarkClock() - timerStart);
+}
+
+static void appendBenchmarkSummary(Common::String &json, const char *name, uint64 total, uint32 max, uint count) {
+	json += Common::String::format("\"%s\": { \"total\": %llu, \"average\": %.1f, \"max\": %u },\n",
+		name, (unsigned long long)total, count ? (double)total / count : 0.0, max);
+}
+
+void EventRecorder::writeBenchmarkReport() {
+	if (!_benchmarkClock || _benchmarkReported)
+		return;
+	_benchmarkReported = true;
+
+	uint64 engineTotal = 0, screenTotal = 0, mixerTotal = 0, timerTotal = 0;
+	uint32 engineMax = 0, screenMax = 0, mixerMax = 0, timerMax = 0;
+	Common::String engineTimes, screenTimes, mixerTimes, timerTimes;
+	for (uint i = 0; i < _benchmarkFrames.size(); ++i) {
+		const BenchmarkFrame &frame = _benchmarkFrames[i];
+		engineTotal += frame.engineTime;
+		screenTotal += frame.screenTime;
+		mixerTotal += frame.mixerTime;
+		timerTotal += frame.timerTime;
+		engineMax = MAX(engineMax, frame.engineTime);
+		screenMax = MAX(screenMax, frame.screenTime);
+		mixerMax = MAX(mixerMax, frame.mixerTime);
+		timerMax = MAX(timerMax, frame.timerTime);
+
+		const char *separator = i ? ", " : "";
+		engineTimes += Common::String::format("%s%u", separator, frame.engineTime);
+		screenTimes += Common::String::format("%s%u", separator, frame.screenTime);
+		mixerTimes += Common::String::format("%s%u", separator, frame.mixerTime);
+		timerTimes += Common::String::format("%s%u", separator, frame.timerTime);
+	}
+
+	// Peak resident set size in KiB, or -1 if the platform cannot tell
+	long peakRSS = -1;
+#ifdef POSIX
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef MACOSX
+		peakRSS = usage.ru_maxrss / 1024;
+#else
+		peakRSS = usage.ru_maxrss;
+#endif
+	}
+#endif
+
+	Common::String recordFileName;
+	for (uint i = 0; i < _recordFileName.size(); ++i) {
+		if (_recordFileName[i] == '"' || _recordFileName[i] == '\\')
+			recordFileName += '\\';
+		recordFileName += _recordFileName[i];
+	}
+
+	Common::String json = "{\n";
+	json += Common::String::format("\"recording\": \"%s\",\n", recordFileName.c_str());
+	json += Common::String::format("\"frames\": %u,\n", _benchmarkFrames.size());
+	appendBenchmarkSummary(json, "engine_us", engineTotal, engineMax, _benchmarkFrames.size());
+	appendBenchmarkSummary(json, "screen_us", screenTotal, screenMax, _benchmarkFrames.size());
+	appendBenchmarkSummary(json, "mixer_us", mixerTotal, mixerMax, _benchmarkFrames.size());
+	appendBenchmarkSummary(json, "timer_us", timerTotal, timerMax, _benchmarkFrames.size());
+	json += Common::String::format("\"peak_rss_kb\": %ld,\n", peakRSS);
+	json += "\"per_frame\": {\n";
+	json += "\"engine_us\": [" + engineTimes + "],\n";
+	json += "\"screen_us\": [" + screenTimes + "],\n";
+	json += "\"mixer_us\": [" + mixerTimes + "],\n";
+	json += "\"timer_us\": [" + timerTimes + "]\n";
+	json += "}\n}\n";
+	g_system->logMessage(LogMessageType::kInfo, json.c_str());
+}
+
 void EventRecorder::checkForKeyCode(const Common::Event &event) {
 	if ((event.type == Common::EVENT_KEYDOWN) && (event.kbd.flags & Common::KBD_CTRL) && (event.kbd.keycode == Common::KEYCODE_p) && (!event.kbdRepeat)) {
 		togglePause();
@@ -388,6 +494,7 @@ void EventRecorder::init(const Common::String &recordFileName, RecordMode mode)
 	_lastMillis = g_system->getMillis();
 	_lastScreenshotTime = 0;
 	_recordMode = mode;
+	_recordFileName = recordFileName;
 	_needcontinueGame = false;
 	if (ConfMan.hasKey("disable_display")) {
 		DebugMan.enableDebugChannel("EventRec");
@@ -557,7 +664,11 @@ void EventRecorder::registerTimerManager(DefaultTimerManager *timerManager) {
 void EventRecorder::switchTimerManagers() {
 	delete _timerManager;
 	if (_recordMode == kPassthrough) {
+#ifdef SDL_BACKEND
 		_timerManager = new SdlTimerManager();
+#else
+		_timerManager = new DefaultTimerManager();
+#endif
 	} else {
 		_timerManager = new DefaultTimerManager();
 	}
@@ -569,7 +680,10 @@ void EventRecorder::updateSubsystems() {
 	}
 	RecordMode oldRecordMode = _recordMode;
 	_recordMode = kPassthrough;
+	const uint64 mixerStart = _benchmarkClock ? _benchmarkClock() : 0;
 	_fakeMixerManager->update();
+	if (_benchmarkClock)
+		_benchmarkMixerTime += (uint32)(_benchmarkClock() - mixerStart);
 	_recordMode = oldRecordMode;
 }
 
@@ -697,6 +811,10 @@ Common::SaveFileManager *EventRecorder::getSaveManager(Common::SaveFileManager *
 }
 
 void EventRecorder::preDrawOverlayGui() {
+	if (_benchmarkClock) {
+		// The playback controls are not drawn while benchmarking
+		return;
+	}
 	if ((_initialized) || (_needRedraw)) {
 		RecordMode oldMode = _recordMode;
 		_recordMode = kPassthrough;
@@ -714,6 +832,22 @@ void EventRecorder::preDrawOverlayGui() {
 }
 
 void EventRecorder::postDrawOverlayGui() {
+	if (_benchmarkClock) {
+		if (_benchmarkScreenStart) {
+			const uint64 now = _benchmarkClock();
+			BenchmarkFrame frame;
+			frame.engineTime = _benchmarkEngineTime;
+			frame.screenTime = (uint32)(now - _benchmarkScreenStart);
+			frame.mixerTime = _benchmarkMixerTime;
+			frame.timerTime = _benchmarkTimerTime;
+			_benchmarkFrames.push_back(frame);
+			_benchmarkFrameStart = now;
+			_benchmarkScreenStart = 0;
+			_benchmarkMixerTime = 0;
+			_benchmarkTimerTime = 0;
+		}
+		return;
+	}
 	if ((_initialized) || (_needRedraw)) {
 		RecordMode oldMode = _recordMode;
 		_recordMode = kPassthrough;
@@ -754,10 +888,12 @@ void EventRecorder::setFileHeader() {
 	_recordFile->getHeader().name = _name;
 }
 
+#ifdef SDL_BACKEND
 SDL_Surface *EventRecorder::getSurface(int width, int height) {
 	// Create a RGB565 surface of the requested dimensions.
 	return SDL_CreateRGBSurface(SDL_SWSURFACE, width, height, 16, 0xF800, 0x07E0, 0x001F, 0x0000);
 }
+#endif
 
 bool EventRecorder::switchMode() {
 	const Plugin *plugin = EngineMan.findPlugin(ConfMan.get("engineid"));
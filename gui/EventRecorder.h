@@ -38,7 +38,11 @@
 #include "backends/mixer/mixer.h"
 #include "common/hashmap.h"
 #include "common/hash-str.h"
+#ifdef SDL_BACKEND
 #include "backends/timer/sdl/sdl-timer.h"
+#else
+#include "backends/timer/default/default-timer.h"
+#endif
 #include "common/config-manager.h"
 #include "common/recorderfile.h"
 #include "backends/saves/recorder/recorder-saves.h"
@@ -177,7 +181,9 @@ public:
 	Common::String generateRecordFileName(const Common::String &target);
 
 	Common::SaveFileManager *getSaveManager(Common::SaveFileManager *realSaveManager);
+#ifdef SDL_BACKEND
 	SDL_Surface *getSurface(int width, int height);
+#endif
 	void RegisterEventSource();
 
 	/** Retrieve game screenshot and compute its checksum for comparison */
@@ -187,9 +193,23 @@ public:
 	bool switchMode();
 	void switchFastMode();
 
+	/**
+	 * Benchmark the playback. The recording is replayed as fast as possible,
+	 * without drawing the playback controls, and the time taken by every
+	 * frame is reported as JSON once the playback ends.
+	 *
+	 * @param getMicros	function returning the real time in microseconds
+	 */
+	void setBenchmarkClock(uint64 (*getMicros)());
+
+	/** Print the benchmark report, unless it has been printed already */
+	void writeBenchmarkReport();
+
 private:
 	bool pollEvent(Common::Event &ev) override;
 	bool notifyEvent(const Common::Event &event) override;
+	/** Run the timer callbacks, timing them when benchmarking */
+	void runTimers();
 	bool _initialized;
 	volatile uint32 _fakeTimer;
 	TimeDate _lastTimeDate;
@@ -249,6 +269,23 @@ private:
 	bool _fastPlayback;
 	bool _needRedraw;
 	bool _processingMillis;
+
+	/** Timings of one benchmarked frame, in microseconds */
+	struct BenchmarkFrame {
+		uint32 engineTime; /**< Time spent by the engine since the previous frame */
+		uint32 screenTime; /**< Time spent updating the screen */
+		uint32 mixerTime;  /**< Time spent mixing audio */
+		uint32 timerTime;  /**< Time spent in timer callbacks */
+	};
+
+	uint64 (*_benchmarkClock)();
+	Common::Array<BenchmarkFrame> _benchmarkFrames;
+	uint64 _benchmarkFrameStart;
+	uint64 _benchmarkScreenStart;
+	uint32 _benchmarkEngineTime;
+	uint32 _benchmarkMixerTime;
+	uint32 _benchmarkTimerTime;
+	bool _benchmarkReported;
 };
 
 } // End of namespace GUI
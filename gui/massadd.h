@@ -24,10 +24,11 @@
 
 #include "gui/dialog.h"
 #include "gui/widgets/list.h"
+#include "common/dir-scanner.h"
 #include "common/fs.h"
 #include "common/hashmap.h"
-#include "common/stack.h"
 #include "common/str.h"
+#include "common/threadpool.h"
 
 namespace GUI {
 
@@ -48,7 +49,12 @@ public:
 	}
 
 private:
-	Common::Stack<Common::FSNode>  _scanStack;
+	/** Add the games found in a directory, unless they are already configured. */
+	void addGames(const Common::FSNode &dir, const DetectionResults &detectionResults);
+
+	/** The shared thread pool, which lists the directories next in line */
+	Common::ThreadPool &_pool;
+	Common::DirectoryScanner _scanner;
 	DetectedGames _games;
 
 	/**
@@ -58,9 +64,7 @@ private:
 	 */
 	Common::HashMap<Common::String, Common::StringArray>	_pathToTargets;
 
-	int _dirsScanned;
 	int _oldGamesCount;
-	int _dirTotal;
 
 	Widget *_okButton;
 	StaticTextWidget *_dirProgressText;
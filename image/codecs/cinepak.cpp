@@ -21,6 +21,7 @@
 
 #include "image/codecs/cinepak.h"
 #include "image/codecs/cinepak_tables.h"
+#include "image/codecs/surface_pool.h"
 
 #include "common/debug.h"
 #include "common/stream.h"
@@ -384,10 +385,7 @@ CinepakDecoder::CinepakDecoder(int bitsPerPixel) : Codec(), _bitsPerPixel(bitsPe
 }
 
 CinepakDecoder::~CinepakDecoder() {
-	if (_curFrame.surface) {
-		_curFrame.surface->free();
-		delete _curFrame.surface;
-	}
+	SurfacePoolMan.release(_curFrame.surface);
 
 	delete[] _curFrame.strips;
 	delete[] _clipTableBuf;
@@ -424,8 +422,7 @@ const Graphics::Surface *CinepakDecoder::decodeFrame(Common::SeekableReadStream
 	}
 
 	if (!_curFrame.surface) {
-		_curFrame.surface = new Graphics::Surface();
-		_curFrame.surface->create(_curFrame.width, _curFrame.height, _pixelFormat);
+		_curFrame.surface = SurfacePoolMan.acquire(_curFrame.width, _curFrame.height, _pixelFormat);
 	}
 
 	_y = 0;
@@ -624,6 +621,19 @@ void CinepakDecoder::decodeVectors(Common::SeekableReadStream &stream, uint16 st
 	}
 }
 
+bool CinepakDecoder::canOutputPixelFormat(const Graphics::PixelFormat &format) const {
+	// Dithered and 8bpp videos always stay in 8bpp
+	if (_curFrame.surface || _pixelFormat.bytesPerPixel == 1 || (format.bytesPerPixel != 2 && format.bytesPerPixel != 4))
+		return format == _pixelFormat;
+
+	return true;
+}
+
+void CinepakDecoder::setOutputPixelFormat(const Graphics::PixelFormat &format) {
+	assert(canOutputPixelFormat(format));
+	_pixelFormat = format;
+}
+
 bool CinepakDecoder::canDither(DitherType type) const {
 	return (type == kDitherTypeVFW || type == kDitherTypeQT) && _bitsPerPixel == 24;
 }
@@ -74,6 +74,8 @@ public:
 
 	const Graphics::Surface *decodeFrame(Common::SeekableReadStream &stream);
 	Graphics::PixelFormat getPixelFormat() const { return _pixelFormat; }
+	bool canOutputPixelFormat(const Graphics::PixelFormat &format) const;
+	void setOutputPixelFormat(const Graphics::PixelFormat &format);
 
 	bool containsPalette() const { return _ditherPalette != 0; }
 	const byte *getPalette() { _dirtyPalette = false; return _ditherPalette; }
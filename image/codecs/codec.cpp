@@ -24,6 +24,8 @@
 
 #include "image/codecs/codec.h"
 
+#include "graphics/conversion.h"
+
 #include "image/jpeg.h"
 #include "image/codecs/bmp_raw.h"
 #include "image/codecs/cdtoons.h"
@@ -73,6 +75,23 @@ inline uint16 makeQuickTimeDitherColor(byte r, byte g, byte b) {
 
 } // End of anonymous namespace
 
+bool Codec::decodeFrameInto(Common::SeekableReadStream &stream, Graphics::Surface &dst) {
+	const Graphics::Surface *frame = decodeFrame(stream);
+	return frame && copyFrame(*frame, dst);
+}
+
+bool Codec::copyFrame(const Graphics::Surface &frame, Graphics::Surface &dst) {
+	if (frame.w != dst.w || frame.h != dst.h)
+		return false;
+
+	if (frame.format == dst.format) {
+		Graphics::copyBlit((byte *)dst.getPixels(), (const byte *)frame.getPixels(), dst.pitch, frame.pitch, frame.w, frame.h, frame.format.bytesPerPixel);
+		return true;
+	}
+
+	return Graphics::crossBlit((byte *)dst.getPixels(), (const byte *)frame.getPixels(), dst.pitch, frame.pitch, frame.w, frame.h, dst.format, frame.format);
+}
+
 byte *Codec::createQuickTimeDitherTable(const byte *palette, uint colorCount) {
 	byte *buf = new byte[0x10000]();
 
@@ -79,12 +79,43 @@ public:
 	 */
 	virtual const Graphics::Surface *decodeFrame(Common::SeekableReadStream &stream) = 0;
 
+	/**
+	 * Decode the frame for the given data into a surface provided by the
+	 * caller, e.g. a buffer of the screen or of a frame queue.
+	 *
+	 * The surface must have the size of the frame. It may be in any format
+	 * the frame can be converted to, which includes the one returned by
+	 * getPixelFormat(). Codecs which convert their frames from YUV planes
+	 * write straight into the surface. Others decode the frame as with
+	 * decodeFrame() and copy it over.
+	 *
+	 * @return true on success, false if the frame could not be decoded or
+	 *         converted
+	 */
+	virtual bool decodeFrameInto(Common::SeekableReadStream &stream, Graphics::Surface &dst);
+
 	/**
 	 * Get the format that the surface returned from decodeImage() will
 	 * be in.
 	 */
 	virtual Graphics::PixelFormat getPixelFormat() const = 0;
 
+	/**
+	 * Can the codec output its frames in the given format?
+	 *
+	 * Only codecs which output true color frames support other formats
+	 * than their own, and only before the first frame is decoded.
+	 */
+	virtual bool canOutputPixelFormat(const Graphics::PixelFormat &format) const { return format == getPixelFormat(); }
+
+	/**
+	 * Output the frames in the given format, so that they do not need to
+	 * be converted afterwards.
+	 *
+	 * Only call this if canOutputPixelFormat() returned true for the format.
+	 */
+	virtual void setOutputPixelFormat(const Graphics::PixelFormat &format) {}
+
 	/**
 	 * Can this codec's frames contain a palette?
 	 */
@@ -114,6 +145,16 @@ public:
 	 * Create a dither table, as used by QuickTime codecs.
 	 */
 	static byte *createQuickTimeDitherTable(const byte *palette, uint colorCount);
+
+protected:
+	/**
+	 * Copy a decoded frame into a surface of the same size, converting it
+	 * to the surface's format if needed.
+	 *
+	 * @return true on success, false if the sizes differ or the frame cannot
+	 *         be converted
+	 */
+	static bool copyFrame(const Graphics::Surface &frame, Graphics::Surface &dst);
 };
 
 /**
@@ -25,6 +25,8 @@
 #include "common/textconsole.h"
 #include "graphics/surface.h"
 
+#include "image/codecs/surface_pool.h"
+
 namespace Image {
 
 HLZDecoder::HLZDecoder(int width, int height) : Codec(),
@@ -32,18 +34,15 @@ HLZDecoder::HLZDecoder(int width, int height) : Codec(),
 }
 
 HLZDecoder::~HLZDecoder() {
-	if (_surface) {
-		_surface->free();
-		delete _surface;
-	}
+	SurfacePoolMan.release(_surface);
 }
 
 const Graphics::Surface *HLZDecoder::decodeFrame(Common::SeekableReadStream &stream) {
-	if (!_surface) {
-		_surface = new Graphics::Surface();
-	}
-
-	_surface->create(_width, _height, Graphics::PixelFormat::createFormatCLUT8());
+	// The surface is kept for the next frame, but each frame starts out blank
+	if (!_surface)
+		_surface = SurfacePoolMan.acquire(_width, _height, Graphics::PixelFormat::createFormatCLUT8());
+	else
+		memset(_surface->getPixels(), 0, _surface->pitch * _surface->h);
 
 	byte *dst = (byte *)_surface->getPixels();
 	decodeFrameInPlace(stream, uint32(-1), dst);
@@ -51,6 +50,17 @@ const Graphics::Surface *HLZDecoder::decodeFrame(Common::SeekableReadStream &str
 	return _surface;
 }
 
+bool HLZDecoder::decodeFrameInto(Common::SeekableReadStream &stream, Graphics::Surface &dst) {
+	// Frames are decoded as one run of bytes, so they can only go straight
+	// to a surface without padding
+	if (dst.w != _width || dst.h != _height || dst.format.bytesPerPixel != 1 || dst.pitch != dst.w)
+		return Codec::decodeFrameInto(stream, dst);
+
+	memset(dst.getPixels(), 0, dst.pitch * dst.h);
+	decodeFrameInPlace(stream, uint32(-1), (byte *)dst.getPixels());
+	return true;
+}
+
 Graphics::PixelFormat HLZDecoder::getPixelFormat() const {
 	return Graphics::PixelFormat::createFormatCLUT8();
 }
@@ -37,6 +37,7 @@ public:
 	~HLZDecoder() override;
 
 	const Graphics::Surface *decodeFrame(Common::SeekableReadStream &stream) override;
+	bool decodeFrameInto(Common::SeekableReadStream &stream, Graphics::Surface &dst) override;
 	Graphics::PixelFormat getPixelFormat() const override;
 
 	static void decodeFrameInPlace(Common::SeekableReadStream &stream, uint32 size, byte *dst);
@@ -491,6 +491,19 @@ IndeoDecoderBase::IndeoDecoderBase(uint16 width, uint16 height, uint bitsPerPixe
 	_ctx._bRefBuf = 3; // buffer 2 is used for scalability mode
 }
 
+bool IndeoDecoderBase::canOutputPixelFormat(const Graphics::PixelFormat &format) const {
+	return format.bytesPerPixel == 2 || format.bytesPerPixel == 4;
+}
+
+void IndeoDecoderBase::setOutputPixelFormat(const Graphics::PixelFormat &format) {
+	assert(canOutputPixelFormat(format));
+
+	if (format != _pixelFormat) {
+		_pixelFormat = format;
+		_surface.convertToInPlace(_pixelFormat);
+	}
+}
+
 IndeoDecoderBase::~IndeoDecoderBase() {
 	_surface.free();
 	IVIPlaneDesc::freeBuffers(_ctx._planes);
@@ -582,6 +582,13 @@ protected:
 public:
 	IndeoDecoderBase(uint16 width, uint16 height, uint bitsPerPixel);
 	virtual ~IndeoDecoderBase();
+
+	/**
+	 * Output frames in the given true color format, which is possible
+	 * at any time.
+	 */
+	virtual bool canOutputPixelFormat(const Graphics::PixelFormat &format) const;
+	virtual void setOutputPixelFormat(const Graphics::PixelFormat &format);
 };
 
 } // End of namespace Indeo
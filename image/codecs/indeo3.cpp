@@ -36,12 +36,17 @@
 #include "graphics/yuv_to_rgb.h"
 
 #include "image/codecs/indeo3.h"
+#include "image/codecs/surface_pool.h"
 
 namespace Image {
 
 Indeo3Decoder::Indeo3Decoder(uint16 width, uint16 height, uint bitsPerPixel) : _ModPred(0), _corrector_type(0) {
 	_iv_frame[0].the_buf = 0;
 	_iv_frame[1].the_buf = 0;
+	_shown_frame = 0;
+	_shown_w = _shown_h = 0;
+	_chroma_buf = 0;
+	_chroma_buf_size = 0;
 
 	_pixelFormat = g_system->getScreenFormat();
 
@@ -65,18 +70,17 @@ Indeo3Decoder::Indeo3Decoder(uint16 width, uint16 height, uint bitsPerPixel) : _
 		}
 	}
 
-	_surface = new Graphics::Surface;
-	_surface->create(width, height, _pixelFormat);
+	_surface = SurfacePoolMan.acquire(width, height, _pixelFormat);
 
 	buildModPred();
 	allocFrames();
 }
 
 Indeo3Decoder::~Indeo3Decoder() {
-	_surface->free();
-	delete _surface;
+	SurfacePoolMan.release(_surface);
 
 	delete[] _iv_frame[0].the_buf;
+	delete[] _chroma_buf;
 	delete[] _ModPred;
 	delete[] _corrector_type;
 }
@@ -85,6 +89,19 @@ Graphics::PixelFormat Indeo3Decoder::getPixelFormat() const {
 	return _pixelFormat;
 }
 
+bool Indeo3Decoder::canOutputPixelFormat(const Graphics::PixelFormat &format) const {
+	return format.bytesPerPixel == 2 || format.bytesPerPixel == 4;
+}
+
+void Indeo3Decoder::setOutputPixelFormat(const Graphics::PixelFormat &format) {
+	assert(canOutputPixelFormat(format));
+
+	if (format != _pixelFormat) {
+		_pixelFormat = format;
+		_surface->convertToInPlace(_pixelFormat);
+	}
+}
+
 bool Indeo3Decoder::isIndeo3(Common::SeekableReadStream &stream) {
 	// Less than 16 bytes? This can't be right
 	if (stream.size() < 16)
@@ -183,17 +200,17 @@ void Indeo3Decoder::allocFrames() {
 	}
 }
 
-const Graphics::Surface *Indeo3Decoder::decodeFrame(Common::SeekableReadStream &stream) {
+bool Indeo3Decoder::decodePlanes(Common::SeekableReadStream &stream) {
 	// Not Indeo 3? Fail
 	if (!isIndeo3(stream))
-		return 0;
+		return false;
 
 	stream.seek(12);
 	uint32 frameDataLen = stream.readUint32LE();
 
 	// Less data than the frame should have? Fail
 	if (stream.size() < (int)(frameDataLen - 16))
-		return 0;
+		return false;
 
 	stream.seek(16); // Behind header
 	stream.skip(2);  // Unknown
@@ -211,8 +228,9 @@ const Graphics::Surface *Indeo3Decoder::decodeFrame(Common::SeekableReadStream &
 		_ref_frame = _iv_frame + 1;
 	}
 
+	// Repeat the last frame
 	if (flags3 == 0x80)
-		return _surface;
+		return true;
 
 	stream.skip(3);
 
@@ -233,15 +251,15 @@ const Graphics::Surface *Indeo3Decoder::decodeFrame(Common::SeekableReadStream &
 
 	if (offsY < hPos) {
 		warning("Indeo3Decoder::decodeImage: offsY < hPos");
-		return 0;
+		return false;
 	}
 	if (offsU < hPos) {
 		warning("Indeo3Decoder::decodeImage: offsY < hPos");
-		return 0;
+		return false;
 	}
 	if (offsV < hPos) {
 		warning("Indeo3Decoder::decodeImage: offsY < hPos");
-		return 0;
+		return false;
 	}
 
 	uint32 dataSize = stream.size() - hPos;
@@ -250,7 +268,7 @@ const Graphics::Surface *Indeo3Decoder::decodeFrame(Common::SeekableReadStream &
 
 	if (stream.read(inData, dataSize) != dataSize) {
 		delete[] inData;
-		return 0;
+		return false;
 	}
 
 	byte *hdr_pos = inData;
@@ -279,14 +297,37 @@ const Graphics::Surface *Indeo3Decoder::decodeFrame(Common::SeekableReadStream &
 
 	delete[] inData;
 
-	const byte *srcY = _cur_frame->Ybuf;
-	const byte *srcU = _cur_frame->Ubuf;
-	const byte *srcV = _cur_frame->Vbuf;
+	_shown_frame = _cur_frame;
+	_shown_w = fWidth;
+	_shown_h = fHeight;
+
+	return true;
+}
+
+void Indeo3Decoder::convertPlanes(Graphics::Surface &dst) {
+	if (!_shown_frame)
+		return;
+
+	uint16 fWidth = _shown_w;
+	uint16 fHeight = _shown_h;
+	uint32 chromaHeight = ((fHeight >> 2) + 3) & 0x7FFC;
+	uint32 chromaWidth  = ((fWidth  >> 2) + 3) & 0x7FFC;
+
+	const byte *srcY = _shown_frame->Ybuf;
+	const byte *srcU = _shown_frame->Ubuf;
+	const byte *srcV = _shown_frame->Vbuf;
 
 	// Create buffers for U/V with an extra row/column copied from the second-to-last
 	// row/column.
-	byte *tempU = new byte[(chromaWidth + 1) * (chromaHeight + 1)];
-	byte *tempV = new byte[(chromaWidth + 1) * (chromaHeight + 1)];
+	const uint32 chromaSize = (chromaWidth + 1) * (chromaHeight + 1);
+	if (_chroma_buf_size < chromaSize * 2) {
+		delete[] _chroma_buf;
+		_chroma_buf_size = chromaSize * 2;
+		_chroma_buf = new byte[_chroma_buf_size];
+	}
+
+	byte *tempU = _chroma_buf;
+	byte *tempV = _chroma_buf + chromaSize;
 
 	for (uint i = 0; i < chromaHeight; i++) {
 		memcpy(tempU + (chromaWidth + 1) * i, srcU + chromaWidth * i, chromaWidth);
@@ -301,42 +342,55 @@ const Graphics::Surface *Indeo3Decoder::decodeFrame(Common::SeekableReadStream &
 			chromaWidth + 1);
 
 	// Blit the frame onto the surface
-	uint32 scaleWidth  = _surface->w / fWidth;
-	uint32 scaleHeight = _surface->h / fHeight;
+	uint32 scaleWidth  = dst.w / fWidth;
+	uint32 scaleHeight = dst.h / fHeight;
 
 	if (scaleWidth == 1 && scaleHeight == 1) {
 		// Shortcut: Don't need to scale so we can decode straight to the surface
-		YUVToRGBMan.convert410(_surface, Graphics::YUVToRGBManager::kScaleITU, srcY, tempU, tempV,
+		YUVToRGBMan.convert410(&dst, Graphics::YUVToRGBManager::kScaleITU, srcY, tempU, tempV,
 				fWidth, fHeight, fWidth, chromaWidth + 1);
 	} else {
 		// Need to upscale, so decode to a temp surface first
-		Graphics::Surface tempSurface;
-		tempSurface.create(fWidth, fHeight, _surface->format);
+		Graphics::Surface *tempSurface = SurfacePoolMan.acquire(fWidth, fHeight, dst.format);
 
-		YUVToRGBMan.convert410(&tempSurface, Graphics::YUVToRGBManager::kScaleITU, srcY, tempU, tempV,
+		YUVToRGBMan.convert410(tempSurface, Graphics::YUVToRGBManager::kScaleITU, srcY, tempU, tempV,
 				fWidth, fHeight, fWidth, chromaWidth + 1);
 
 		// Upscale
-		for (int y = 0; y < _surface->h; y++) {
-			for (int x = 0; x < _surface->w; x++) {
-				if (_surface->format.bytesPerPixel == 1)
-					*((byte *)_surface->getBasePtr(x, y)) = *((byte *)tempSurface.getBasePtr(x / scaleWidth, y / scaleHeight));
-				else if (_surface->format.bytesPerPixel == 2)
-					*((uint16 *)_surface->getBasePtr(x, y)) = *((uint16 *)tempSurface.getBasePtr(x / scaleWidth, y / scaleHeight));
-				else if (_surface->format.bytesPerPixel == 4)
-					*((uint32 *)_surface->getBasePtr(x, y)) = *((uint32 *)tempSurface.getBasePtr(x / scaleWidth, y / scaleHeight));
+		for (int y = 0; y < dst.h; y++) {
+			for (int x = 0; x < dst.w; x++) {
+				if (dst.format.bytesPerPixel == 1)
+					*((byte *)dst.getBasePtr(x, y)) = *((byte *)tempSurface->getBasePtr(x / scaleWidth, y / scaleHeight));
+				else if (dst.format.bytesPerPixel == 2)
+					*((uint16 *)dst.getBasePtr(x, y)) = *((uint16 *)tempSurface->getBasePtr(x / scaleWidth, y / scaleHeight));
+				else if (dst.format.bytesPerPixel == 4)
+					*((uint32 *)dst.getBasePtr(x, y)) = *((uint32 *)tempSurface->getBasePtr(x / scaleWidth, y / scaleHeight));
  			}
 		}
 
-		tempSurface.free();
+		SurfacePoolMan.release(tempSurface);
 	}
+}
 
-	delete[] tempU;
-	delete[] tempV;
+const Graphics::Surface *Indeo3Decoder::decodeFrame(Common::SeekableReadStream &stream) {
+	if (!decodePlanes(stream))
+		return 0;
 
+	convertPlanes(*_surface);
 	return _surface;
 }
 
+bool Indeo3Decoder::decodeFrameInto(Common::SeekableReadStream &stream, Graphics::Surface &dst) {
+	if (dst.w != _surface->w || dst.h != _surface->h || (dst.format.bytesPerPixel != 2 && dst.format.bytesPerPixel != 4))
+		return Codec::decodeFrameInto(stream, dst);
+
+	if (!decodePlanes(stream))
+		return false;
+
+	convertPlanes(dst);
+	return true;
+}
+
 typedef struct {
 	int32 xpos;
 	int32 ypos;
@@ -49,7 +49,10 @@ public:
 	~Indeo3Decoder();
 
 	const Graphics::Surface *decodeFrame(Common::SeekableReadStream &stream);
+	bool decodeFrameInto(Common::SeekableReadStream &stream, Graphics::Surface &dst);
 	Graphics::PixelFormat getPixelFormat() const;
+	bool canOutputPixelFormat(const Graphics::PixelFormat &format) const;
+	void setOutputPixelFormat(const Graphics::PixelFormat &format);
 
 	static bool isIndeo3(Common::SeekableReadStream &stream);
 
@@ -78,12 +81,23 @@ private:
 	YUVBufs *_cur_frame;
 	YUVBufs *_ref_frame;
 
+	/** Planes of the frame last decoded, which is the one to display */
+	YUVBufs *_shown_frame;
+	uint16 _shown_w, _shown_h;
+
+	/** Chroma planes with the extra row and column the conversion needs */
+	byte *_chroma_buf;
+	uint32 _chroma_buf_size;
+
 	byte *_ModPred;
 	uint16 *_corrector_type;
 
 	void buildModPred();
 	void allocFrames();
 
+	bool decodePlanes(Common::SeekableReadStream &stream);
+	void convertPlanes(Graphics::Surface &dst);
+
 	void decodeChunk(byte *cur, byte *ref, int width, int height,
 			const byte *buf1, uint32 fflags2, const byte *hdr,
 			const byte *buf2, int min_width_160);
@@ -91,6 +91,14 @@ const Graphics::Surface *Indeo4Decoder::decodeFrame(Common::SeekableReadStream &
 	return (err < 0) ? nullptr : &_surface;
 }
 
+bool Indeo4Decoder::canOutputPixelFormat(const Graphics::PixelFormat &format) const {
+	// Transparent frames need a 32bpp format with alpha, see decodePictureHeader()
+	if (format.bytesPerPixel != 4 || format.aBits() == 0)
+		return format == _pixelFormat;
+
+	return IndeoDecoderBase::canOutputPixelFormat(format);
+}
+
 int Indeo4Decoder::decodePictureHeader() {
 	int pic_size_indx, i, p;
 	IVIPicConfig picConf;
@@ -55,6 +55,7 @@ public:
 	virtual ~Indeo4Decoder() {}
 
 	virtual const Graphics::Surface *decodeFrame(Common::SeekableReadStream &stream);
+	virtual bool canOutputPixelFormat(const Graphics::PixelFormat &format) const;
 
 	static bool isIndeo4(Common::SeekableReadStream &stream);
 protected:
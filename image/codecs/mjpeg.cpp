@@ -31,6 +31,7 @@
 #include "image/jpeg.h"
 
 #include "image/codecs/mjpeg.h"
+#include "image/codecs/surface_pool.h"
 
 namespace Common {
 class SeekableReadStream;
@@ -44,10 +45,7 @@ MJPEGDecoder::MJPEGDecoder() : Codec() {
 }
 
 MJPEGDecoder::~MJPEGDecoder() {
-	if (_surface) {
-		_surface->free();
-		delete _surface;
-	}
+	SurfacePoolMan.release(_surface);
 }
 
 // Header to be inserted
@@ -148,7 +146,7 @@ static const byte s_mjpegValACChrominance[] = {
 	0xf9, 0xfa
 };
 
-const Graphics::Surface *MJPEGDecoder::decodeFrame(Common::SeekableReadStream &stream) {
+bool MJPEGDecoder::decodeJPEG(Common::SeekableReadStream &stream, JPEGDecoder &jpeg, const Graphics::PixelFormat &format, Graphics::Surface *dst) {
 	// We need to reconstruct an actual JPEG stream here, then feed it to the JPEG decoder
 	// Yes, this is a pain.
 
@@ -158,7 +156,7 @@ const Graphics::Surface *MJPEGDecoder::decodeFrame(Common::SeekableReadStream &s
 
 	if (tag != MKTAG('A', 'V', 'I', '1')) {
 		warning("Invalid MJPEG tag found");
-		return 0;
+		return false;
 	}
 
 	uint32 outputSize = stream.size() - inputSkip + sizeof(s_jpegHeader) + DHT_SEGMENT_SIZE;
@@ -166,7 +164,7 @@ const Graphics::Surface *MJPEGDecoder::decodeFrame(Common::SeekableReadStream &s
 
 	if (!data) {
 		warning("Failed to allocate data for MJPEG conversion");
-		return 0;
+		return false;
 	}
 
 	// Copy the header
@@ -198,25 +196,53 @@ const Graphics::Surface *MJPEGDecoder::decodeFrame(Common::SeekableReadStream &s
 	stream.read(data + dataOffset, stream.size() - inputSkip);
 
 	Common::MemoryReadStream convertedStream(data, outputSize, DisposeAfterUse::YES);
-	JPEGDecoder jpeg;
-	jpeg.setOutputPixelFormat(_pixelFormat);
+	jpeg.setOutputPixelFormat(format);
 
-	if (!jpeg.loadStream(convertedStream)) {
+	if (!(dst ? jpeg.loadStreamInto(convertedStream, *dst) : jpeg.loadStream(convertedStream))) {
 		warning("Failed to decode MJPEG frame");
-		return 0;
+		return false;
 	}
 
-	if (_surface) {
-		_surface->free();
-		delete _surface;
-	}
+	assert(dst || jpeg.getSurface()->format == format);
+	return true;
+}
 
-	_surface = new Graphics::Surface();
-	_surface->copyFrom(*jpeg.getSurface());
+const Graphics::Surface *MJPEGDecoder::decodeFrame(Common::SeekableReadStream &stream) {
+	JPEGDecoder jpeg;
+	if (!decodeJPEG(stream, jpeg, _pixelFormat))
+		return 0;
 
-	assert(_surface->format == _pixelFormat);
+	// Keep the surface from frame to frame, instead of allocating a new one
+	const Graphics::Surface *frame = jpeg.getSurface();
+	if (!_surface || _surface->w != frame->w || _surface->h != frame->h) {
+		SurfacePoolMan.release(_surface);
+		_surface = SurfacePoolMan.acquire(frame->w, frame->h, _pixelFormat);
+	}
 
+	copyFrame(*frame, *_surface);
 	return _surface;
 }
 
+bool MJPEGDecoder::decodeFrameInto(Common::SeekableReadStream &stream, Graphics::Surface &dst) {
+	JPEGDecoder jpeg;
+
+	// Let the JPEG decoder write to the caller's surface directly
+	if (dst.format.bytesPerPixel == 2 || dst.format.bytesPerPixel == 4)
+		return decodeJPEG(stream, jpeg, dst.format, &dst);
+
+	return decodeJPEG(stream, jpeg, _pixelFormat) && copyFrame(*jpeg.getSurface(), dst);
+}
+
+bool MJPEGDecoder::canOutputPixelFormat(const Graphics::PixelFormat &format) const {
+	if (_surface || (format.bytesPerPixel != 2 && format.bytesPerPixel != 4))
+		return format == _pixelFormat;
+
+	return true;
+}
+
+void MJPEGDecoder::setOutputPixelFormat(const Graphics::PixelFormat &format) {
+	assert(canOutputPixelFormat(format));
+	_pixelFormat = format;
+}
+
 } // End of namespace Image
@@ -35,6 +35,8 @@ struct Surface;
 
 namespace Image {
 
+class JPEGDecoder;
+
 /**
  * Motion JPEG decoder.
  *
@@ -46,9 +48,14 @@ public:
 	~MJPEGDecoder();
 
 	const Graphics::Surface *decodeFrame(Common::SeekableReadStream &stream);
+	bool decodeFrameInto(Common::SeekableReadStream &stream, Graphics::Surface &dst);
 	Graphics::PixelFormat getPixelFormat() const { return _pixelFormat; }
+	bool canOutputPixelFormat(const Graphics::PixelFormat &format) const;
+	void setOutputPixelFormat(const Graphics::PixelFormat &format);
 
 private:
+	bool decodeJPEG(Common::SeekableReadStream &stream, JPEGDecoder &jpeg, const Graphics::PixelFormat &format, Graphics::Surface *dst = nullptr);
+
 	Graphics::PixelFormat _pixelFormat;
 	Graphics::Surface *_surface;
 };
@@ -23,6 +23,7 @@
 // Based off ffmpeg's QuickTime RLE decoder (written by Mike Melanson)
 
 #include "image/codecs/qtrle.h"
+#include "image/codecs/surface_pool.h"
 
 #include "common/debug.h"
 #include "common/scummsys.h"
@@ -51,8 +52,8 @@ QTRLEDecoder::QTRLEDecoder(uint16 width, uint16 height, byte bitsPerPixel) : Cod
 
 QTRLEDecoder::~QTRLEDecoder() {
 	if (_surface) {
-		_surface->free();
-		delete _surface;
+		_surface->w = _paddedWidth;
+		SurfacePoolMan.release(_surface);
 	}
 
 	delete[] _colorMap;
@@ -531,12 +532,11 @@ void QTRLEDecoder::setDither(DitherType type, const byte *palette) {
 
 void QTRLEDecoder::createSurface() {
 	if (_surface) {
-		_surface->free();
-		delete _surface;
+		_surface->w = _paddedWidth;
+		SurfacePoolMan.release(_surface);
 	}
 
-	_surface = new Graphics::Surface();
-	_surface->create(_paddedWidth, _height, getPixelFormat());
+	_surface = SurfacePoolMan.acquire(_paddedWidth, _height, getPixelFormat());
 	_surface->w = _width;
 }
 
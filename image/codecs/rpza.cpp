@@ -22,6 +22,7 @@
  // Based off ffmpeg's RPZA decoder
 
 #include "image/codecs/rpza.h"
+#include "image/codecs/surface_pool.h"
 
 #include "common/debug.h"
 #include "common/system.h"
@@ -44,8 +45,10 @@ RPZADecoder::RPZADecoder(uint16 width, uint16 height) : Codec() {
 
 RPZADecoder::~RPZADecoder() {
 	if (_surface) {
-		_surface->free();
-		delete _surface;
+		// Give the whole blocks back to the pool
+		_surface->w = _blockWidth * 4;
+		_surface->h = _blockHeight * 4;
+		SurfacePoolMan.release(_surface);
 	}
 
 	delete[] _ditherPalette;
@@ -328,10 +331,8 @@ static inline void decodeFrameTmpl(Common::SeekableReadStream &stream, PixelInt
 
 const Graphics::Surface *RPZADecoder::decodeFrame(Common::SeekableReadStream &stream) {
 	if (!_surface) {
-		_surface = new Graphics::Surface();
-
 		// Allocate enough space in the surface for the blocks
-		_surface->create(_blockWidth * 4, _blockHeight * 4, getPixelFormat());
+		_surface = SurfacePoolMan.acquire(_blockWidth * 4, _blockHeight * 4, getPixelFormat());
 
 		// Adjust width/height to be the right ones
 		_surface->w = _width;
@@ -0,0 +1,116 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "graphics/surface.h"
+
+#include "image/codecs/surface_pool.h"
+
+namespace Common {
+DECLARE_SINGLETON(Image::SurfacePool);
+}
+
+namespace Image {
+
+SurfacePool::SurfacePool() {
+}
+
+SurfacePool::~SurfacePool() {
+	clear();
+}
+
+Graphics::Surface *SurfacePool::acquire(int16 width, int16 height, const Graphics::PixelFormat &format) {
+	Graphics::Surface *surface = nullptr;
+
+	{
+		Common::StackLock lock(_mutex);
+
+		// Prefer the most recently released surface
+		for (uint i = _free.size(); i-- > 0; ) {
+			if (_free[i]->w == width && _free[i]->h == height && _free[i]->format == format) {
+				surface = _free[i];
+				_free.remove_at(i);
+				break;
+			}
+		}
+	}
+
+	if (surface) {
+		memset(surface->getPixels(), 0, surface->pitch * surface->h);
+	} else {
+		surface = new Graphics::Surface();
+		surface->create(width, height, format);
+	}
+
+	return surface;
+}
+
+void SurfacePool::release(Graphics::Surface *surface) {
+	if (!surface)
+		return;
+
+	// Codecs may have changed the visible size, only whole buffers are reused
+	if (!surface->getPixels() || surface->pitch != surface->w * surface->format.bytesPerPixel) {
+		surface->free();
+		delete surface;
+		return;
+	}
+
+	Graphics::Surface *oldest = nullptr;
+
+	{
+		Common::StackLock lock(_mutex);
+
+		if (_free.size() >= kMaxFreeSurfaces) {
+			oldest = _free.front();
+			_free.remove_at(0);
+		}
+
+		_free.push_back(surface);
+	}
+
+	if (oldest) {
+		oldest->free();
+		delete oldest;
+	}
+}
+
+void SurfacePool::clear() {
+	Common::Array<Graphics::Surface *> surfaces;
+
+	{
+		Common::StackLock lock(_mutex);
+		surfaces = _free;
+		_free.clear();
+	}
+
+	for (uint i = 0; i < surfaces.size(); i++) {
+		surfaces[i]->free();
+		delete surfaces[i];
+	}
+}
+
+uint SurfacePool::getFreeCount() {
+	Common::StackLock lock(_mutex);
+	return _free.size();
+}
+
+} // End of namespace Image
@@ -0,0 +1,88 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef IMAGE_CODECS_SURFACE_POOL_H
+#define IMAGE_CODECS_SURFACE_POOL_H
+
+#include "common/array.h"
+#include "common/mutex.h"
+#include "common/singleton.h"
+#include "graphics/pixelformat.h"
+
+namespace Graphics {
+struct Surface;
+}
+
+namespace Image {
+
+/**
+ * A pool of frame surfaces shared by all codecs.
+ *
+ * Video playback tends to create a codec per video and a surface per codec,
+ * all with the same few sizes and formats. Codecs take their surfaces from
+ * this pool and give them back on destruction, so that the pixel buffers
+ * are recycled from one video to the next instead of being freed and
+ * allocated again.
+ *
+ * The pool may be used from several threads, e.g. by the read ahead of a
+ * video decoder.
+ */
+class SurfacePool : public Common::Singleton<SurfacePool> {
+public:
+	/** Number of unused surfaces the pool holds on to at most. */
+	static const uint kMaxFreeSurfaces = 8;
+
+	/**
+	 * Get a surface with the given size and format, cleared to zero, just
+	 * like Graphics::Surface::create() would create it.
+	 *
+	 * The surface must be handed back with release(), or be freed and
+	 * deleted by the caller.
+	 */
+	Graphics::Surface *acquire(int16 width, int16 height, const Graphics::PixelFormat &format);
+
+	/**
+	 * Hand a surface back to the pool. If the pool is full, the surface
+	 * which has been unused for the longest time is freed. Null is ignored.
+	 */
+	void release(Graphics::Surface *surface);
+
+	/** Free all unused surfaces. */
+	void clear();
+
+	/** Return the number of unused surfaces held by the pool. */
+	uint getFreeCount();
+
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+	SurfacePool();
+	~SurfacePool();
+
+	Common::Mutex _mutex;
+	Common::Array<Graphics::Surface *> _free;
+};
+
+} // End of namespace Image
+
+#define SurfacePoolMan (::Image::SurfacePool::instance())
+
+#endif
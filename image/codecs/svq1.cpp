@@ -36,6 +36,8 @@
 
 #include "graphics/yuv_to_rgb.h"
 
+#include "image/codecs/surface_pool.h"
+
 namespace Image {
 
 #define SVQ1_BLOCK_SKIP     0
@@ -48,11 +50,15 @@ SVQ1Decoder::SVQ1Decoder(uint16 width, uint16 height) {
 	_width = width;
 	_height = height;
 	_frameWidth = _frameHeight = 0;
+	_pixelFormat = g_system->getScreenFormat();
 	_surface = 0;
 
-	_last[0] = 0;
-	_last[1] = 0;
-	_last[2] = 0;
+	for (int i = 0; i < 3; i++) {
+		_last[i] = 0;
+		_current[i] = 0;
+	}
+
+	_planeWidth = _planeHeight = 0;
 
 	// Setup Variable Length Code Tables
 	_blockType = new HuffmanDecoder(0, 4, s_svq1BlockTypeCodes, s_svq1BlockTypeLengths);
@@ -68,14 +74,12 @@ SVQ1Decoder::SVQ1Decoder(uint16 width, uint16 height) {
 }
 
 SVQ1Decoder::~SVQ1Decoder() {
-	if (_surface) {
-		_surface->free();
-		delete _surface;
-	}
+	SurfacePoolMan.release(_surface);
 
-	delete[] _last[0];
-	delete[] _last[1];
-	delete[] _last[2];
+	for (int i = 0; i < 3; i++) {
+		delete[] _last[i];
+		delete[] _current[i];
+	}
 
 	delete _blockType;
 	delete _intraMean;
@@ -90,7 +94,7 @@ SVQ1Decoder::~SVQ1Decoder() {
 
 #define ALIGN(x, a) (((x)+(a)-1)&~((a)-1))
 
-const Graphics::Surface *SVQ1Decoder::decodeFrame(Common::SeekableReadStream &stream) {
+bool SVQ1Decoder::decodePlanes(Common::SeekableReadStream &stream) {
 	debug(1, "SVQ1Decoder::decodeImage()");
 
 	Common::BitStream32BEMSB frameData(stream);
@@ -100,7 +104,7 @@ const Graphics::Surface *SVQ1Decoder::decodeFrame(Common::SeekableReadStream &st
 
 	if ((frameCode & ~0x70) || !(frameCode & 0x60)) { // Invalid
 		warning("Invalid Image at frameCode");
-		return _surface;
+		return false;
 	}
 
 	byte temporalReference = frameData.getBits<8>();
@@ -151,10 +155,10 @@ const Graphics::Surface *SVQ1Decoder::decodeFrame(Common::SeekableReadStream &st
 		debug(1, " frameHeight: %d", _frameHeight);
 	} else if (frameType == 2) { // B Frame
 		warning("B Frames not supported by SVQ1 decoder (yet)");
-		return _surface;
+		return false;
 	} else if (frameType == 3) { // Invalid
 		warning("Invalid Frame Type");
-		return _surface;
+		return false;
 	}
 
 	bool checksumPresent = frameData.getBit() != 0;
@@ -185,7 +189,20 @@ const Graphics::Surface *SVQ1Decoder::decodeFrame(Common::SeekableReadStream &st
 	uint uvHeight = ALIGN(yHeight / 4, 16);
 	uint uvPitch = uvWidth + 4; // we need at least one extra column and pitch must be divisible by 4
 
-	byte *current[3];
+	// The planes are kept from frame to frame, only a change of the frame
+	// size requires new ones
+	if (_frameWidth != _planeWidth || _frameHeight != _planeHeight) {
+		for (int i = 0; i < 3; i++) {
+			delete[] _last[i];
+			delete[] _current[i];
+			_last[i] = _current[i] = 0;
+		}
+
+		_planeWidth = _frameWidth;
+		_planeHeight = _frameHeight;
+	}
+
+	byte **current = _current;
 
 	// Decode Y, U and V component planes
 	for (int i = 0; i < 3; i++) {
@@ -194,14 +211,16 @@ const Graphics::Surface *SVQ1Decoder::decodeFrame(Common::SeekableReadStream &st
 			width = yWidth;
 			height = yHeight;
 			pitch = width;
-			current[i] = new byte[width * height];
+			if (!current[i])
+				current[i] = new byte[width * height];
 		} else {
 			width = uvWidth;
 			height = uvHeight;
 			pitch = uvPitch;
 
 			// Add an extra row here. See below for more information.
-			current[i] = new byte[pitch * (height + 1)];
+			if (!current[i])
+				current[i] = new byte[pitch * (height + 1)];
 		}
 
 		if (frameType == 0) { // I Frame
@@ -211,7 +230,7 @@ const Graphics::Surface *SVQ1Decoder::decodeFrame(Common::SeekableReadStream &st
 				for (uint16 x = 0; x < width; x += 16) {
 					if (!svq1DecodeBlockIntra(&frameData, &currentP[x], pitch)) {
 						warning("svq1DecodeBlockIntra decode failure");
-						return _surface;
+						return false;
 					}
 				}
 				currentP += 16 * pitch;
@@ -235,7 +254,7 @@ const Graphics::Surface *SVQ1Decoder::decodeFrame(Common::SeekableReadStream &st
 				for (uint16 x = 0; x < width; x += 16) {
 					if (!svq1DecodeDeltaBlock(&frameData, &currentP[x], previous, pitch, pmv, x, y)) {
 						warning("svq1DecodeDeltaBlock decode failure");
-						return _surface;
+						return false;
 					}
 				}
 
@@ -248,14 +267,6 @@ const Graphics::Surface *SVQ1Decoder::decodeFrame(Common::SeekableReadStream &st
 		}
 	}
 
-	// Now we'll create the surface
-	if (!_surface) {
-		_surface = new Graphics::Surface();
-		_surface->create(yWidth, yHeight, g_system->getScreenFormat());
-		_surface->w = _width;
-		_surface->h = _height;
-	}
-
 	// We need to massage the chrominance data a bit to be able to be used by the converter
 	// Since the thing peeks at values one column and one row beyond the data, we need to fill it in
 
@@ -269,16 +280,63 @@ const Graphics::Surface *SVQ1Decoder::decodeFrame(Common::SeekableReadStream &st
 	memcpy(current[1] + uvHeight * uvPitch, current[1] + (uvHeight - 1) * uvPitch, uvWidth + 1);
 	memcpy(current[2] + uvHeight * uvPitch, current[2] + (uvHeight - 1) * uvPitch, uvWidth + 1);
 
-	// Finally, actually do the conversion ;)
-	YUVToRGBMan.convert410(_surface, Graphics::YUVToRGBManager::kScaleFull, current[0], current[1], current[2], yWidth, yHeight, yWidth, uvPitch);
+	// Keep the current planes for the next frame and reuse the old ones
+	for (int i = 0; i < 3; i++)
+		SWAP(_last[i], _current[i]);
 
-	// Store the current surfaces for later and free the old ones
-	for (int i = 0; i < 3; i++) {
-		delete[] _last[i];
-		_last[i] = current[i];
+	return true;
+}
+
+void SVQ1Decoder::convertPlanes(Graphics::Surface &dst) {
+	uint yWidth = ALIGN(_frameWidth, 16);
+	uint yHeight = ALIGN(_frameHeight, 16);
+	uint uvPitch = ALIGN(yWidth / 4, 16) + 4;
+
+	YUVToRGBMan.convert410(&dst, Graphics::YUVToRGBManager::kScaleFull, _last[0], _last[1], _last[2], yWidth, yHeight, yWidth, uvPitch);
+}
+
+const Graphics::Surface *SVQ1Decoder::convertFrame() {
+	if (!_surface) {
+		_surface = SurfacePoolMan.acquire(ALIGN(_frameWidth, 16), ALIGN(_frameHeight, 16), _pixelFormat);
+		_frame = _surface->getSubArea(Common::Rect(_width, _height));
 	}
 
-	return _surface;
+	convertPlanes(*_surface);
+	return &_frame;
+}
+
+const Graphics::Surface *SVQ1Decoder::decodeFrame(Common::SeekableReadStream &stream) {
+	if (!decodePlanes(stream))
+		return _surface ? &_frame : 0;
+
+	return convertFrame();
+}
+
+bool SVQ1Decoder::decodeFrameInto(Common::SeekableReadStream &stream, Graphics::Surface &dst) {
+	if (!decodePlanes(stream))
+		return false;
+
+	// The conversion writes whole blocks, so only a frame without padding
+	// can go straight to the caller's surface
+	if (dst.w == _width && dst.h == _height && dst.w == ALIGN(_frameWidth, 16) && dst.h == ALIGN(_frameHeight, 16) &&
+			(dst.format.bytesPerPixel == 2 || dst.format.bytesPerPixel == 4)) {
+		convertPlanes(dst);
+		return true;
+	}
+
+	return copyFrame(*convertFrame(), dst);
+}
+
+bool SVQ1Decoder::canOutputPixelFormat(const Graphics::PixelFormat &format) const {
+	if (_surface || (format.bytesPerPixel != 2 && format.bytesPerPixel != 4))
+		return format == _pixelFormat;
+
+	return true;
+}
+
+void SVQ1Decoder::setOutputPixelFormat(const Graphics::PixelFormat &format) {
+	assert(canOutputPixelFormat(format));
+	_pixelFormat = format;
 }
 
 bool SVQ1Decoder::svq1DecodeBlockIntra(Common::BitStream32BEMSB *s, byte *pixels, int pitch) {
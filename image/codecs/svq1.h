@@ -44,14 +44,25 @@ public:
 	~SVQ1Decoder();
 
 	const Graphics::Surface *decodeFrame(Common::SeekableReadStream &stream);
-	Graphics::PixelFormat getPixelFormat() const { return _surface->format; }
+	bool decodeFrameInto(Common::SeekableReadStream &stream, Graphics::Surface &dst);
+	Graphics::PixelFormat getPixelFormat() const { return _pixelFormat; }
+	bool canOutputPixelFormat(const Graphics::PixelFormat &format) const;
+	void setOutputPixelFormat(const Graphics::PixelFormat &format);
 
 private:
-	Graphics::Surface *_surface;
+	Graphics::PixelFormat _pixelFormat;
+	Graphics::Surface *_surface; ///< Whole planes, padded to a multiple of 16
+	Graphics::Surface _frame;    ///< Visible area of _surface
 	uint16 _width, _height;
 	uint16 _frameWidth, _frameHeight;
 
 	byte *_last[3];
+	byte *_current[3];
+	uint16 _planeWidth, _planeHeight;
+
+	bool decodePlanes(Common::SeekableReadStream &stream);
+	void convertPlanes(Graphics::Surface &dst);
+	const Graphics::Surface *convertFrame();
 
 	typedef Common::Huffman<Common::BitStream32BEMSB> HuffmanDecoder;
 
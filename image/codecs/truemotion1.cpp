@@ -26,6 +26,7 @@
 
 #ifdef IMAGE_CODECS_TRUEMOTION1_H
 
+#include "image/codecs/surface_pool.h"
 #include "image/codecs/truemotion1data.h"
 #include "common/stream.h"
 #include "common/textconsole.h"
@@ -97,10 +98,7 @@ TrueMotion1Decoder::TrueMotion1Decoder() {
 }
 
 TrueMotion1Decoder::~TrueMotion1Decoder() {
-	if (_surface) {
-		_surface->free();
-		delete _surface;
-	}
+	SurfacePoolMan.release(_surface);
 
 	delete[] _vertPred;
 }
@@ -194,8 +192,7 @@ void TrueMotion1Decoder::decodeHeader(Common::SeekableReadStream &stream) {
 	}
 
 	if (!_surface) {
-		_surface = new Graphics::Surface();
-		_surface->create(_header.xsize, _header.ysize, getPixelFormat());
+		_surface = SurfacePoolMan.acquire(_header.xsize, _header.ysize, getPixelFormat());
 	}
 
 	// There is 1 change bit per 4 pixels, so each change byte represents
@@ -24,6 +24,7 @@
 #define FORBIDDEN_SYMBOL_ALLOW_ALL
 
 #include "image/jpeg.h"
+#include "image/row_writer.h"
 
 #include "common/debug.h"
 #include "common/endian.h"
@@ -47,7 +48,8 @@ namespace Image {
 JPEGDecoder::JPEGDecoder() :
 		_surface(),
 		_colorSpace(kColorSpaceRGB),
-		_requestedPixelFormat(getByteOrderRgbPixelFormat()) {
+		_requestedPixelFormat(getByteOrderRgbPixelFormat()),
+		_scaleFactor(1) {
 }
 
 JPEGDecoder::~JPEGDecoder() {
@@ -228,6 +230,19 @@ J_COLOR_SPACE fromScummvmPixelFormat(const Graphics::PixelFormat &format) {
 #endif
 
 bool JPEGDecoder::loadStream(Common::SeekableReadStream &stream) {
+	return decode(stream, nullptr);
+}
+
+bool JPEGDecoder::loadStreamInto(Common::SeekableReadStream &stream, Graphics::Surface &dst) {
+	return decode(stream, &dst);
+}
+
+void JPEGDecoder::setScaleFactor(uint factor) {
+	assert(factor == 1 || factor == 2 || factor == 4 || factor == 8);
+	_scaleFactor = factor;
+}
+
+bool JPEGDecoder::decode(Common::SeekableReadStream &stream, Graphics::Surface *dst) {
 #ifdef USE_JPEG
 	// Reset member variables from previous decodings
 	destroy();
@@ -249,10 +264,15 @@ bool JPEGDecoder::loadStream(Common::SeekableReadStream &stream) {
 	// Read the file header
 	jpeg_read_header(&cinfo, TRUE);
 
+	// A destination with pixels decides the format
+	Graphics::PixelFormat targetFormat = _requestedPixelFormat;
+	if (dst && dst->getPixels())
+		targetFormat = dst->format;
+
 	// We can request YUV output because Groovie requires it
 	switch (_colorSpace) {
 	case kColorSpaceRGB: {
-		J_COLOR_SPACE colorSpace = fromScummvmPixelFormat(_requestedPixelFormat);
+		J_COLOR_SPACE colorSpace = fromScummvmPixelFormat(targetFormat);
 
 		if (colorSpace == JCS_UNKNOWN) {
 			// When libjpeg-turbo is not available or an unhandled pixel
@@ -266,57 +286,66 @@ bool JPEGDecoder::loadStream(Common::SeekableReadStream &stream) {
 	}
 	case kColorSpaceYUV:
 		cinfo.out_color_space = JCS_YCbCr;
+		// We use YUV with 3 bytes per pixel otherwise.
+		// This is pretty ugly since our PixelFormat cannot express YUV...
+		targetFormat = Graphics::PixelFormat(3, 0, 0, 0, 0, 0, 0, 0, 0);
 		break;
 	default:
 		break;
 	}
 
+	// libjpeg scales down while decoding, which is cheaper than decoding
+	// the whole image
+	cinfo.scale_num = 1;
+	cinfo.scale_denom = _scaleFactor;
+
 	// Actually start decompressing the image
 	jpeg_start_decompress(&cinfo);
 
+	Graphics::PixelFormat decodedFormat = targetFormat;
+	if (_colorSpace == kColorSpaceRGB && cinfo.out_color_space == JCS_RGB)
+		decodedFormat = getByteOrderRgbPixelFormat();
+
 	// Allocate buffers for the output data
-	switch (_colorSpace) {
-	case kColorSpaceRGB: {
-		Graphics::PixelFormat outputPixelFormat;
-		if (cinfo.out_color_space == JCS_RGB) {
-			outputPixelFormat = getByteOrderRgbPixelFormat();
-		} else {
-			outputPixelFormat = _requestedPixelFormat;
-		}
-		_surface.create(cinfo.output_width, cinfo.output_height, outputPixelFormat);
-		break;
-	}
-	case kColorSpaceYUV:
-		// We use YUV with 3 bytes per pixel otherwise.
-		// This is pretty ugly since our PixelFormat cannot express YUV...
-		_surface.create(cinfo.output_width, cinfo.output_height, Graphics::PixelFormat(3, 0, 0, 0, 0, 0, 0, 0, 0));
-		break;
-	default:
-		break;
+	Graphics::Surface *surface = dst ? dst : &_surface;
+	const bool convertible = decodedFormat == targetFormat || targetFormat.bytesPerPixel == 2 || targetFormat.bytesPerPixel == 4;
+	const bool fits = !surface->getPixels() || (surface->format == targetFormat &&
+			(uint)surface->w >= cinfo.output_width && (uint)surface->h >= cinfo.output_height);
+
+	if (!convertible || !fits) {
+		warning("JPEGDecoder: Cannot decode the image into the requested format or surface");
+		jpeg_abort_decompress(&cinfo);
+		jpeg_destroy_decompress(&cinfo);
+		return false;
 	}
 
-	// Allocate buffer for one scanline
-	JDIMENSION pitch = cinfo.output_width * _surface.format.bytesPerPixel;
-	assert(_surface.pitch >= (int)pitch);
-	JSAMPARRAY buffer = (*cinfo.mem->alloc_sarray)((j_common_ptr)&cinfo, JPOOL_IMAGE, pitch, 1);
+	if (!surface->getPixels())
+		surface->create(cinfo.output_width, cinfo.output_height, targetFormat);
 
-	// Go through the image data scanline by scanline
-	while (cinfo.output_scanline < cinfo.output_height) {
-		byte *dst = (byte *)_surface.getBasePtr(0, cinfo.output_scanline);
+	RowWriter writer(*surface, decodedFormat, cinfo.output_width);
 
-		jpeg_read_scanlines(&cinfo, buffer, 1);
+	// Buffer for one scanline, if it cannot be decoded in place
+	JSAMPARRAY buffer = nullptr;
+	if (!writer.getDirectRow())
+		buffer = (*cinfo.mem->alloc_sarray)((j_common_ptr)&cinfo, JPOOL_IMAGE, cinfo.output_width * decodedFormat.bytesPerPixel, 1);
 
-		memcpy(dst, buffer[0], pitch);
+	// Go through the image data scanline by scanline, converting each of
+	// them if needed
+	while (cinfo.output_scanline < cinfo.output_height) {
+		if (buffer) {
+			jpeg_read_scanlines(&cinfo, buffer, 1);
+			writer.writeRow(buffer[0]);
+		} else {
+			JSAMPROW row = writer.getDirectRow();
+			jpeg_read_scanlines(&cinfo, &row, 1);
+			writer.skipRow();
+		}
 	}
 
 	// We are done with decompressing, thus free all the data
 	jpeg_finish_decompress(&cinfo);
 	jpeg_destroy_decompress(&cinfo);
 
-	if (_colorSpace == kColorSpaceRGB && _surface.format != _requestedPixelFormat) {
-		_surface.convertToInPlace(_requestedPixelFormat); // Slow path
-	}
-
 	return true;
 #else
 	return false;
@@ -55,9 +55,24 @@ public:
 	virtual bool loadStream(Common::SeekableReadStream &str);
 	virtual const Graphics::Surface *getSurface() const;
 
+	/**
+	 * Decode the image straight into a surface of the caller, instead of
+	 * the decoder's own surface, which stays empty.
+	 *
+	 * Each scanline is converted as soon as it is decoded, so that the
+	 * whole image never exists in another format.
+	 *
+	 * If @p dst already has pixels, the image is written to its top left
+	 * corner, in the format of @p dst, and must fit. Otherwise @p dst is
+	 * created with the size of the image, in the format set by
+	 * setOutputPixelFormat().
+	 */
+	bool loadStreamInto(Common::SeekableReadStream &stream, Graphics::Surface &dst);
+
 	// Codec API
 	const Graphics::Surface *decodeFrame(Common::SeekableReadStream &stream);
 	Graphics::PixelFormat getPixelFormat() const;
+	bool canOutputPixelFormat(const Graphics::PixelFormat &format) const { return format.bytesPerPixel == 2 || format.bytesPerPixel == 4; }
 
 	// Special API for JPEG
 	enum ColorSpace {
@@ -99,14 +114,22 @@ public:
 	 * color conversion routines for some pixel formats. This setting allows to use
 	 * them and avoid costly subsequent color conversion.
 	 */
-	void setOutputPixelFormat(const Graphics::PixelFormat &format) { _requestedPixelFormat = format; }
+	void setOutputPixelFormat(const Graphics::PixelFormat &format) override { _requestedPixelFormat = format; }
+
+	/**
+	 * Scale the image down by 2, 4 or 8 while decoding it. libjpeg does
+	 * this as part of the inverse DCT, which makes decoding faster as well.
+	 */
+	void setScaleFactor(uint factor);
 
 private:
 	Graphics::Surface _surface;
 	ColorSpace _colorSpace;
 	Graphics::PixelFormat _requestedPixelFormat;
+	uint _scaleFactor;
 
 	Graphics::PixelFormat getByteOrderRgbPixelFormat() const;
+	bool decode(Common::SeekableReadStream &stream, Graphics::Surface *dst);
 };
 /** @} */
 } // End of namespace Image
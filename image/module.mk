@@ -9,6 +9,7 @@ MODULE_OBJS := \
 	pcx.o \
 	pict.o \
 	png.o \
+	row_writer.o \
 	tga.o \
 	codecs/bmp_raw.o \
 	codecs/cdtoons.o \
@@ -27,6 +28,7 @@ MODULE_OBJS := \
 	codecs/qtrle.o \
 	codecs/rpza.o \
 	codecs/smc.o \
+	codecs/surface_pool.o \
 	codecs/svq1.o \
 	codecs/truemotion1.o \
 	codecs/xan.o \
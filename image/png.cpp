@@ -29,6 +29,7 @@
 #endif
 
 #include "image/png.h"
+#include "image/row_writer.h"
 
 #include "graphics/pixelformat.h"
 #include "graphics/surface.h"
@@ -45,7 +46,8 @@ PNGDecoder::PNGDecoder() :
 		_paletteColorCount(0),
 		_skipSignature(false),
 		_keepTransparencyPaletted(false),
-		_transparentColor(-1) {
+		_transparentColor(-1),
+		_scaleFactor(1) {
 }
 
 PNGDecoder::~PNGDecoder() {
@@ -110,6 +112,19 @@ void pngFlushStream(png_structp pngPtr) {
  */
 
 bool PNGDecoder::loadStream(Common::SeekableReadStream &stream) {
+	return decode(stream, nullptr);
+}
+
+bool PNGDecoder::loadStreamInto(Common::SeekableReadStream &stream, Graphics::Surface &dst) {
+	return decode(stream, &dst);
+}
+
+void PNGDecoder::setScaleFactor(uint factor) {
+	assert(factor >= 1);
+	_scaleFactor = factor;
+}
+
+bool PNGDecoder::decode(Common::SeekableReadStream &stream, Graphics::Surface *dst) {
 #ifdef USE_PNG
 	destroy();
 
@@ -158,13 +173,18 @@ bool PNGDecoder::loadStream(Common::SeekableReadStream &stream) {
 	width = w;
 	height = h;
 
-	// Allocate memory for the final image data.
-	// To keep memory framentation low this happens before allocating memory for temporary image data.
-	_outputSurface = new Graphics::Surface();
+	// The format the caller asked for, if any. Only true color formats can
+	// be asked for, paletted images are then converted as well.
+	Graphics::PixelFormat targetFormat;
+	if (dst && dst->getPixels())
+		targetFormat = dst->format;
+	else if (_outputPixelFormat.bytesPerPixel > 1)
+		targetFormat = _outputPixelFormat;
 
 	// Images of all color formats except PNG_COLOR_TYPE_PALETTE
 	// will be transformed into ARGB images
-	if (colorType == PNG_COLOR_TYPE_PALETTE && (_keepTransparencyPaletted || !png_get_valid(pngPtr, infoPtr, PNG_INFO_tRNS))) {
+	Graphics::PixelFormat decodedFormat;
+	if (colorType == PNG_COLOR_TYPE_PALETTE && targetFormat.bytesPerPixel <= 1 && (_keepTransparencyPaletted || !png_get_valid(pngPtr, infoPtr, PNG_INFO_tRNS))) {
 		int numPalette = 0;
 		png_colorp palette = NULL;
 		png_bytep trans = nullptr;
@@ -199,8 +219,7 @@ bool PNGDecoder::loadStream(Common::SeekableReadStream &stream) {
 			}
 		}
 
-		_outputSurface->create(width, height,
-			hasRgbaPalette ? getByteOrderRgbaPixelFormat(true) : Graphics::PixelFormat::createFormatCLUT8());
+		decodedFormat = hasRgbaPalette ? getByteOrderRgbaPixelFormat(true) : Graphics::PixelFormat::createFormatCLUT8();
 		png_set_packing(pngPtr);
 
 		if (hasRgbaPalette) {
@@ -208,7 +227,7 @@ bool PNGDecoder::loadStream(Common::SeekableReadStream &stream) {
 			Common::fill(&rgbaPalette[0], &rgbaPalette[256], 0);
 			for (int i = 0; i < _paletteColorCount; ++i) {
 				byte a = (i < numTrans) ? trans[i] : 0xff;
-				rgbaPalette[i] = _outputSurface->format.ARGBToColor(
+				rgbaPalette[i] = decodedFormat.ARGBToColor(
 					a, palette[i].red, palette[i].green, palette[i].blue);
 			}
 
@@ -224,13 +243,10 @@ bool PNGDecoder::loadStream(Common::SeekableReadStream &stream) {
 			png_set_expand(pngPtr);
 		}
 
-		_outputSurface->create(width, height, getByteOrderRgbaPixelFormat(isAlpha));
-		if (!_outputSurface->getPixels()) {
-			error("Could not allocate memory for output image.");
-		}
+		decodedFormat = getByteOrderRgbaPixelFormat(isAlpha);
 		if (bitDepth == 16)
 			png_set_strip_16(pngPtr);
-		if (bitDepth < 8)
+		if (bitDepth < 8 || colorType == PNG_COLOR_TYPE_PALETTE)
 			png_set_expand(pngPtr);
 		if (colorType == PNG_COLOR_TYPE_GRAY ||
 			colorType == PNG_COLOR_TYPE_GRAY_ALPHA)
@@ -240,6 +256,37 @@ bool PNGDecoder::loadStream(Common::SeekableReadStream &stream) {
 			png_set_filler(pngPtr, 0xff, PNG_FILLER_AFTER);
 	}
 
+	if (targetFormat.bytesPerPixel == 0)
+		targetFormat = decodedFormat;
+
+	if (targetFormat != decodedFormat && (targetFormat.bytesPerPixel == 1 || targetFormat.bytesPerPixel == 3)) {
+		warning("PNGDecoder: Cannot convert the image to the requested format");
+		png_destroy_read_struct(&pngPtr, &infoPtr, NULL);
+		return false;
+	}
+
+	const int outputWidth = RowWriter::getScaledSize(width, _scaleFactor);
+	const int outputHeight = RowWriter::getScaledSize(height, _scaleFactor);
+
+	// Allocate memory for the final image data.
+	// To keep memory framentation low this happens before allocating memory for temporary image data.
+	Graphics::Surface *surface = dst;
+	if (!surface) {
+		_outputSurface = new Graphics::Surface();
+		surface = _outputSurface;
+	}
+
+	if (!surface->getPixels()) {
+		surface->create(outputWidth, outputHeight, targetFormat);
+		if (!surface->getPixels()) {
+			error("Could not allocate memory for output image.");
+		}
+	} else if (surface->w < outputWidth || surface->h < outputHeight) {
+		warning("PNGDecoder: The image does not fit into the destination surface");
+		png_destroy_read_struct(&pngPtr, &infoPtr, NULL);
+		return false;
+	}
+
 	// After the transformations have been registered, the image data is read again.
 	png_set_interlace_handling(pngPtr);
 	png_read_update_info(pngPtr, infoPtr);
@@ -247,29 +294,54 @@ bool PNGDecoder::loadStream(Common::SeekableReadStream &stream) {
 	width = w;
 	height = h;
 
+	RowWriter writer(*surface, decodedFormat, width, _scaleFactor);
+
 	if (hasRgbaPalette) {
-		// Build up the RGBA surface from paletted rows
+		// Build up the RGBA rows from paletted rows
 		png_bytep rowPtr = new byte[width];
-		if (!rowPtr)
+		uint32 *rgbaRow = new uint32[width];
+		if (!rowPtr || !rgbaRow)
 			error("Could not allocate memory for row.");
 
 		for (int yp = 0; yp < height; ++yp) {
 			png_read_row(pngPtr, rowPtr, nullptr);
-			uint32 *destRowP = (uint32 *)_outputSurface->getBasePtr(0, yp);
+			uint32 *destRowP = writer.getDirectRow() ? (uint32 *)writer.getDirectRow() : rgbaRow;
 
 			for (int xp = 0; xp < width; ++xp)
 				destRowP[xp] = rgbaPalette[rowPtr[xp]];
+
+			if (destRowP == rgbaRow)
+				writer.writeRow((const byte *)rgbaRow);
+			else
+				writer.skipRow();
 		}
 
 		delete[] rowPtr;
+		delete[] rgbaRow;
 	} else  if (interlaceType == PNG_INTERLACE_NONE) {
-		// PNGs without interlacing can simply be read row by row.
+		// PNGs without interlacing can simply be read row by row, straight
+		// into the surface if no conversion is needed
+		png_bytep rowPtr = writer.getDirectRow() ? nullptr : new byte[width * decodedFormat.bytesPerPixel];
+
 		for (int i = 0; i < height; i++) {
-			png_read_row(pngPtr, (png_bytep)_outputSurface->getBasePtr(0, i), NULL);
+			if (rowPtr) {
+				png_read_row(pngPtr, rowPtr, NULL);
+				writer.writeRow(rowPtr);
+			} else {
+				png_read_row(pngPtr, writer.getDirectRow(), NULL);
+				writer.skipRow();
+			}
 		}
+
+		delete[] rowPtr;
 	} else {
 		// PNGs with interlacing require us to allocate an auxillary
-		// buffer with pointers to all row starts.
+		// buffer with pointers to all row starts. If the image needs to be
+		// converted, the whole image has to be decoded first.
+		Graphics::Surface decodedSurface;
+		bool direct = writer.getDirectRow() != nullptr;
+		if (!direct)
+			decodedSurface.create(width, height, decodedFormat);
 
 		// Allocate row pointer buffer
 		png_bytep *rowPtr = new png_bytep[height];
@@ -279,15 +351,24 @@ bool PNGDecoder::loadStream(Common::SeekableReadStream &stream) {
 
 		// Initialize row pointers
 		for (int i = 0; i < height; i++)
-			rowPtr[i] = (png_bytep)_outputSurface->getBasePtr(0, i);
+			rowPtr[i] = (png_bytep)(direct ? surface->getBasePtr(0, i) : decodedSurface.getBasePtr(0, i));
 
 		// Read image data
 		png_read_image(pngPtr, rowPtr);
 
 		// Free row pointer buffer
 		delete[] rowPtr;
+
+		if (!direct) {
+			for (int i = 0; i < height; i++)
+				writer.writeRow((const byte *)decodedSurface.getBasePtr(0, i));
+
+			decodedSurface.free();
+		}
 	}
 
+	writer.finish();
+
 	// Read additional data at the end.
 	png_read_end(pngPtr, NULL);
 
@@ -65,8 +65,39 @@ public:
 	int getTransparentColor() const { return _transparentColor; }
 	void setSkipSignature(bool skip) { _skipSignature = skip; }
 	void setKeepTransparencyPaletted(bool keep) { _keepTransparencyPaletted = keep; }
+
+	/**
+	 * Decode the image straight into a surface of the caller, instead of
+	 * the decoder's own surface, which stays empty.
+	 *
+	 * Each row is converted and scaled down as soon as it is decoded, so
+	 * that the whole image never exists in its original format and size.
+	 * Only interlaced images which need converting still go through a
+	 * temporary surface.
+	 *
+	 * If @p dst already has pixels, the image is written to its top left
+	 * corner, in the format of @p dst, and must fit. Otherwise @p dst is
+	 * created with the size of the image, in the format set by
+	 * setOutputPixelFormat().
+	 */
+	bool loadStreamInto(Common::SeekableReadStream &stream, Graphics::Surface &dst);
+
+	/**
+	 * Request a true color format for the decoded image, to which paletted
+	 * images are converted as well. By default, images keep their palette
+	 * or are decoded to byte order RGBA.
+	 */
+	void setOutputPixelFormat(const Graphics::PixelFormat &format) { _outputPixelFormat = format; }
+
+	/**
+	 * Scale the image down by the given factor while decoding it, by
+	 * averaging blocks of factor x factor pixels. Paletted images keep the
+	 * top left pixel of each block.
+	 */
+	void setScaleFactor(uint factor);
 private:
 	Graphics::PixelFormat getByteOrderRgbaPixelFormat(bool isAlpha) const;
+	bool decode(Common::SeekableReadStream &stream, Graphics::Surface *dst);
 
 	byte *_palette;
 	uint16 _paletteColorCount;
@@ -79,6 +110,8 @@ private:
 	int _transparentColor;
 
 	Graphics::Surface *_outputSurface;
+	Graphics::PixelFormat _outputPixelFormat;
+	uint _scaleFactor;
 };
 
 /**
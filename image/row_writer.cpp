@@ -0,0 +1,135 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/endian.h"
+#include "graphics/conversion.h"
+#include "graphics/surface.h"
+
+#include "image/row_writer.h"
+
+namespace Image {
+
+namespace {
+
+inline uint32 readPixel(const byte *src, uint bytesPerPixel) {
+	switch (bytesPerPixel) {
+	case 2:
+		return READ_UINT16(src);
+	case 3:
+		return READ_UINT24(src);
+	default:
+		return READ_UINT32(src);
+	}
+}
+
+} // End of anonymous namespace
+
+RowWriter::RowWriter(Graphics::Surface &dst, const Graphics::PixelFormat &srcFormat, uint srcWidth, uint scaleFactor) :
+		_dst(dst), _srcFormat(srcFormat), _srcWidth(srcWidth), _scaleFactor(scaleFactor), _srcY(0), _sums(nullptr), _sumRows(0) {
+	assert(_scaleFactor >= 1);
+	assert(_srcFormat == _dst.format || (_srcFormat.bytesPerPixel > 1 && _dst.format.bytesPerPixel > 1 && _dst.format.bytesPerPixel != 3));
+	assert(getScaledSize(_srcWidth, _scaleFactor) <= (uint)_dst.w);
+
+	if (_scaleFactor > 1 && _dst.format.bytesPerPixel > 1)
+		_sums = new uint32[getScaledSize(_srcWidth, _scaleFactor) * 4]();
+}
+
+RowWriter::~RowWriter() {
+	delete[] _sums;
+}
+
+byte *RowWriter::getDirectRow() const {
+	if (_scaleFactor != 1 || _srcFormat != _dst.format)
+		return nullptr;
+
+	return (byte *)_dst.getBasePtr(0, _srcY);
+}
+
+void RowWriter::writeRow(const byte *src) {
+	const uint srcY = _srcY++;
+
+	if (_scaleFactor == 1) {
+		byte *dst = (byte *)_dst.getBasePtr(0, srcY);
+		if (_srcFormat == _dst.format)
+			memcpy(dst, src, _srcWidth * _srcFormat.bytesPerPixel);
+		else
+			Graphics::crossBlit(dst, src, _dst.pitch, _srcWidth * _srcFormat.bytesPerPixel, _srcWidth, 1, _dst.format, _srcFormat);
+		return;
+	}
+
+	if (!_sums) {
+		// Paletted, keep the top left pixel of each block
+		if (srcY % _scaleFactor == 0) {
+			byte *dst = (byte *)_dst.getBasePtr(0, srcY / _scaleFactor);
+			for (uint x = 0; x < _srcWidth; x += _scaleFactor)
+				*dst++ = src[x];
+		}
+		return;
+	}
+
+	const uint bpp = _srcFormat.bytesPerPixel;
+	uint32 *sums = _sums;
+	for (uint x = 0; x < _srcWidth; x += _scaleFactor, sums += 4) {
+		const uint blockEnd = MIN(x + _scaleFactor, _srcWidth);
+		for (uint i = x; i < blockEnd; i++) {
+			byte a, r, g, b;
+			_srcFormat.colorToARGB(readPixel(src + i * bpp, bpp), a, r, g, b);
+			sums[0] += a;
+			sums[1] += r;
+			sums[2] += g;
+			sums[3] += b;
+		}
+	}
+
+	if (++_sumRows == _scaleFactor)
+		flushSums();
+}
+
+void RowWriter::finish() {
+	if (_sums && _sumRows)
+		flushSums();
+}
+
+void RowWriter::flushSums() {
+	const uint dstY = (_srcY - 1) / _scaleFactor;
+	byte *dst = (byte *)_dst.getBasePtr(0, dstY);
+	uint32 *sums = _sums;
+
+	for (uint x = 0; x < _srcWidth; x += _scaleFactor, sums += 4) {
+		const uint count = MIN(_scaleFactor, _srcWidth - x) * _sumRows;
+		const uint32 color = _dst.format.ARGBToColor(sums[0] / count, sums[1] / count, sums[2] / count, sums[3] / count);
+
+		if (_dst.format.bytesPerPixel == 2) {
+			WRITE_UINT16(dst, color);
+			dst += 2;
+		} else {
+			WRITE_UINT32(dst, color);
+			dst += 4;
+		}
+
+		sums[0] = sums[1] = sums[2] = sums[3] = 0;
+	}
+
+	_sumRows = 0;
+}
+
+} // End of namespace Image
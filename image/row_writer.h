@@ -0,0 +1,92 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef IMAGE_ROW_WRITER_H
+#define IMAGE_ROW_WRITER_H
+
+#include "common/noncopyable.h"
+#include "graphics/pixelformat.h"
+
+namespace Graphics {
+struct Surface;
+}
+
+namespace Image {
+
+/**
+ * Writes the rows of an image into a surface as they are decoded,
+ * converting them to the format of the surface and scaling the image down
+ * on the way. Image decoders use it so that they never need a surface with
+ * the whole image in its original format and size.
+ *
+ * Scaling down averages blocks of scaleFactor x scaleFactor pixels. Paletted
+ * images are scaled down by picking the top left pixel of each block.
+ */
+class RowWriter : Common::NonCopyable {
+public:
+	/**
+	 * @param dst          Surface to write to. It must be large enough for
+	 *                     the scaled down image, which goes to its top left.
+	 * @param srcFormat    Format of the rows passed to writeRow(). It must be
+	 *                     the format of @p dst, or both must be true color.
+	 * @param srcWidth     Number of pixels in the rows passed to writeRow().
+	 * @param scaleFactor  Factor to scale the image down by.
+	 */
+	RowWriter(Graphics::Surface &dst, const Graphics::PixelFormat &srcFormat, uint srcWidth, uint scaleFactor = 1);
+	~RowWriter();
+
+	/** Return the size of an image side after scaling it down. */
+	static uint getScaledSize(uint size, uint scaleFactor) { return (size + scaleFactor - 1) / scaleFactor; }
+
+	/**
+	 * Return the row of the surface the next source row can be decoded to
+	 * directly, or null if it has to go through writeRow(). The caller
+	 * must then call skipRow() instead of writeRow().
+	 */
+	byte *getDirectRow() const;
+
+	/** Move on to the next row after decoding it to getDirectRow(). */
+	void skipRow() { _srcY++; }
+
+	/** Write the next row of the image. The rows must be written in order. */
+	void writeRow(const byte *src);
+
+	/** Write the last row, if the image height is not a multiple of the scale factor. */
+	void finish();
+
+private:
+	void flushSums();
+
+	Graphics::Surface &_dst;
+	const Graphics::PixelFormat _srcFormat;
+	const uint _srcWidth;
+	const uint _scaleFactor;
+	uint _srcY;
+
+	/** Sums of the A, R, G and B values of each block of the current row */
+	uint32 *_sums;
+	uint _sumRows;
+};
+
+} // End of namespace Image
+
+#endif
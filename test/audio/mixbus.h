@@ -0,0 +1,99 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mixbus.h"
+#include "audio/mixer.h"
+#include "audio/rate.h"
+
+class MixBusTestSuite : public CxxTest::TestSuite
+{
+public:
+	void test_full_volume_is_bit_exact() {
+		const int16 in[8] = { 0, 1, -1, 12345, -32768, 32767, 100, -100 };
+		int16 out[8];
+
+		Audio::MixBus bus;
+		int32 *buf = bus.clear(4);
+		Audio::mixStereoSamplesWide(buf, in, 4, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+		bus.render(out, 4);
+
+		TS_ASSERT_EQUALS(memcmp(in, out, sizeof(in)), 0);
+	}
+
+	void test_no_clipping_between_channels() {
+		// With per channel clamping, the first two channels would clip and
+		// the third one would then pull the result down to 32767 - 30000
+		const int16 loud[2] = { 30000, -30000 };
+		const int16 inverted[2] = { -30000, 30000 };
+		int16 out[2];
+
+		Audio::MixBus bus;
+		int32 *buf = bus.clear(1);
+		Audio::mixStereoSamplesWide(buf, loud, 1, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+		Audio::mixStereoSamplesWide(buf, loud, 1, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+		Audio::mixStereoSamplesWide(buf, inverted, 1, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+		bus.render(out, 1);
+
+		TS_ASSERT_EQUALS(out[0], 30000);
+		TS_ASSERT_EQUALS(out[1], -30000);
+	}
+
+	void test_limiter() {
+		enum { kFrames = 8192 };
+
+		int16 *in = new int16[kFrames * 2];
+		int16 *out = new int16[kFrames * 2];
+		for (int i = 0; i < kFrames * 2; ++i)
+			in[i] = (i & 2) ? 32767 : -32768;
+
+		Audio::MixBus bus;
+
+		// Twice as loud as the output can represent
+		int32 *buf = bus.clear(kFrames);
+		Audio::mixStereoSamplesWide(buf, in, kFrames, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+		Audio::mixStereoSamplesWide(buf, in, kFrames, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+		bus.render(out, kFrames);
+
+		// The limiter halves the gain, so the result only just fits and
+		// nothing is clipped
+		for (int i = 0; i < kFrames * 2; ++i) {
+			TS_ASSERT_LESS_THAN_EQUALS(ABS((int)out[i]), 32768);
+			TS_ASSERT_LESS_THAN_EQUALS(32760, ABS((int)out[i]));
+		}
+
+		// Once the input gets quiet, the gain recovers to unity
+		for (int i = 0; i < kFrames * 2; ++i)
+			in[i] = (i & 2) ? 1000 : -1000;
+		for (int block = 0; block < 4; ++block) {
+			buf = bus.clear(kFrames);
+			Audio::mixStereoSamplesWide(buf, in, kFrames, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+			bus.render(out, kFrames);
+		}
+		TS_ASSERT_EQUALS(memcmp(in, out, sizeof(int16) * kFrames * 2), 0);
+
+		delete[] in;
+		delete[] out;
+	}
+
+	void test_dither_is_unbiased() {
+		enum { kFrames = 4096 };
+
+		// Half volume turns 1 into half a sample step, which rounds up or
+		// down depending on the dither, but averages out to about 0.5
+		int16 in[kFrames * 2];
+		int16 out[kFrames * 2];
+		for (int i = 0; i < kFrames * 2; ++i)
+			in[i] = 1;
+
+		Audio::MixBus bus;
+		int32 *buf = bus.clear(kFrames);
+		Audio::mixStereoSamplesWide(buf, in, kFrames, Audio::Mixer::kMaxMixerVolume / 2, Audio::Mixer::kMaxMixerVolume / 2);
+		bus.render(out, kFrames);
+
+		int sum = 0;
+		for (int i = 0; i < kFrames * 2; ++i) {
+			TS_ASSERT(out[i] == 0 || out[i] == 1);
+			sum += out[i];
+		}
+		TS_ASSERT_DELTA(sum, kFrames, kFrames / 10);
+	}
+};
@@ -0,0 +1,178 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/decoders/raw.h"
+#include "audio/mixer_intern.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+class MixerTestSuite : public CxxTest::TestSuite
+{
+public:
+	void setUp() {
+		if (!g_system)
+			Common::install_null_g_system();
+	}
+
+	void test_channel_volume() {
+		Audio::MixerImpl mixer(kRate);
+		mixer.setReady(true);
+
+		Audio::SoundHandle handle;
+		playSound(mixer, &handle, Audio::Mixer::kSFXSoundType);
+		TS_ASSERT(!isSilent(mixer));
+
+		mixer.setChannelVolume(handle, 0);
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), 0);
+		TS_ASSERT(isSilent(mixer));
+
+		mixer.setChannelVolume(handle, Audio::Mixer::kMaxChannelVolume);
+		TS_ASSERT(!isSilent(mixer));
+
+		mixer.setVolumeForSoundType(Audio::Mixer::kSFXSoundType, 0);
+		TS_ASSERT(isSilent(mixer));
+		mixer.setVolumeForSoundType(Audio::Mixer::kSFXSoundType, Audio::Mixer::kMaxMixerVolume);
+
+		mixer.muteSoundType(Audio::Mixer::kSFXSoundType, true);
+		TS_ASSERT(isSilent(mixer));
+		mixer.muteSoundType(Audio::Mixer::kSFXSoundType, false);
+		TS_ASSERT(!isSilent(mixer));
+	}
+
+	void test_settings_before_mix() {
+		// The channel is picked up by the audio thread only after the change
+		Audio::MixerImpl mixer(kRate);
+		mixer.setReady(true);
+
+		Audio::SoundHandle handle;
+		playSound(mixer, &handle, Audio::Mixer::kSFXSoundType);
+		mixer.setChannelVolume(handle, 0);
+		TS_ASSERT(isSilent(mixer));
+	}
+
+	void test_loop_channel() {
+		Audio::MixerImpl mixer(kRate);
+		mixer.setReady(true);
+
+		// A sound which ends with the first mix
+		byte *data = (byte *)malloc(kMixSamples * 2);
+		memset(data, 0x20, kMixSamples * 2);
+		Audio::SeekableAudioStream *stream = Audio::makeRawStream(data, kMixSamples * 2, kRate, Audio::FLAG_16BITS);
+		Audio::SoundHandle handle;
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &handle, stream, -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::YES, false, false);
+
+		mixer.loopChannel(handle);
+		TS_ASSERT(!isSilent(mixer));
+		TS_ASSERT(!isSilent(mixer));
+		TS_ASSERT(mixer.isSoundHandleActive(handle));
+	}
+
+	void test_pause_handle() {
+		Audio::MixerImpl mixer(kRate);
+		mixer.setReady(true);
+
+		Audio::SoundHandle handle;
+		playSound(mixer, &handle, Audio::Mixer::kSFXSoundType);
+		mix(mixer);
+
+		// The elapsed time has to stop right away, without waiting for the
+		// audio thread to mix again
+		mixer.pauseHandle(handle, true);
+		const uint32 paused = mixer.getSoundElapsedTime(handle);
+		g_system->delayMillis(30);
+		TS_ASSERT_EQUALS(mixer.getSoundElapsedTime(handle), paused);
+		TS_ASSERT(isSilent(mixer));
+
+		mixer.pauseHandle(handle, false);
+		TS_ASSERT(!isSilent(mixer));
+	}
+
+	void test_pause_all() {
+		Audio::MixerImpl mixer(kRate);
+		mixer.setReady(true);
+
+		Audio::SoundHandle first, second;
+		playSound(mixer, &first, Audio::Mixer::kSFXSoundType);
+		playSound(mixer, &second, Audio::Mixer::kMusicSoundType);
+		mix(mixer);
+
+		mixer.pauseAll(true);
+		const uint32 pausedFirst = mixer.getSoundElapsedTime(first);
+		const uint32 pausedSecond = mixer.getSoundElapsedTime(second);
+		g_system->delayMillis(30);
+		TS_ASSERT_EQUALS(mixer.getSoundElapsedTime(first), pausedFirst);
+		TS_ASSERT_EQUALS(mixer.getSoundElapsedTime(second), pausedSecond);
+		TS_ASSERT(isSilent(mixer));
+
+		mixer.pauseAll(false);
+		TS_ASSERT(!isSilent(mixer));
+	}
+
+	void test_stop_handle() {
+		Audio::MixerImpl mixer(kRate);
+		mixer.setReady(true);
+
+		// The stream is not disposed by the mixer, so it has to be gone from
+		// the mixer once stopHandle() returns
+		byte *data = createSamples();
+		Audio::SeekableAudioStream *stream = Audio::makeRawStream(data, kSamples * 2, kRate, Audio::FLAG_16BITS, DisposeAfterUse::NO);
+		Audio::SoundHandle handle;
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &handle, stream, -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::NO, false, false);
+		TS_ASSERT(mixer.isSoundHandleActive(handle));
+
+		mixer.stopHandle(handle);
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+		delete stream;
+		free(data);
+		TS_ASSERT(isSilent(mixer));
+	}
+
+	void test_many_calls_without_mixing() {
+		// Nothing mixes here, as if the audio thread was not running
+		Audio::MixerImpl mixer(kRate);
+		mixer.setReady(true);
+
+		Audio::SoundHandle handle;
+		playSound(mixer, &handle, Audio::Mixer::kSFXSoundType);
+		for (int i = 0; i < 1000; i++) {
+			mixer.setChannelVolume(handle, i & 0xFF);
+			mixer.setChannelBalance(handle, (int8)(i & 0x7F));
+		}
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), 999 & 0xFF);
+		TS_ASSERT_EQUALS(mixer.getChannelBalance(handle), 999 & 0x7F);
+	}
+
+private:
+	enum {
+		kRate = 22050,
+		kSamples = kRate * 2,
+		kMixSamples = 256
+	};
+
+	/** Constant samples, whose bytes are all the same so that endianness does not matter */
+	static byte *createSamples() {
+		byte *data = (byte *)malloc(kSamples * 2);
+		memset(data, 0x20, kSamples * 2);
+		return data;
+	}
+
+	static void playSound(Audio::MixerImpl &mixer, Audio::SoundHandle *handle, Audio::Mixer::SoundType type) {
+		Audio::SeekableAudioStream *stream = Audio::makeRawStream(createSamples(), kSamples * 2, kRate, Audio::FLAG_16BITS);
+		mixer.playStream(type, handle, stream, -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::YES, false, false);
+	}
+
+	static void mix(Audio::MixerImpl &mixer) {
+		int16 samples[kMixSamples * 2];
+		mixer.mixCallback((byte *)samples, sizeof(samples));
+	}
+
+	static bool isSilent(Audio::MixerImpl &mixer) {
+		int16 samples[kMixSamples * 2];
+		mixer.mixCallback((byte *)samples, sizeof(samples));
+		for (int i = 0; i < kMixSamples * 2; i++) {
+			if (samples[i] != 0)
+				return false;
+		}
+		return true;
+	}
+};
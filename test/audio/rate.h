@@ -0,0 +1,280 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/mixer.h"
+#include "audio/rate.h"
+#include "audio/rate_intern.h"
+
+#include "common/endian.h"
+#include "common/stream.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+#include "helper.h"
+
+class RateConverterTestSuite : public CxxTest::TestSuite
+{
+private:
+	uint32 _seed;
+
+	int16 nextSample() {
+		// Simple LCG, so that the test data is the same on every run
+		_seed = _seed * 1103515245 + 12345;
+		return (int16)(_seed >> 16);
+	}
+
+	void fillSamples(int16 *buf, uint len) {
+		for (uint i = 0; i < len; ++i)
+			buf[i] = nextSample();
+
+		// Make sure the extremes are always covered
+		if (len >= 4) {
+			buf[0] = -32768;
+			buf[1] = 32767;
+			buf[2] = -1;
+			buf[3] = 1;
+		}
+	}
+
+	void compareMixProcs(Audio::MixStereoProc proc) {
+		static const Audio::st_volume_t volumes[] = { 0, 1, 127, 128, 200, 255, 256 };
+		// Frame counts not divisible by the SIMD block size exercise the tail handling
+		static const uint frameCounts[] = { 0, 1, 3, 4, 7, 64, 333 };
+
+		_seed = 1;
+		for (int f = 0; f < ARRAYSIZE(frameCounts); ++f) {
+			const uint len = frameCounts[f] * 2;
+			int16 *in = new int16[len + 1];
+			int16 *expected = new int16[len + 1];
+			int16 *actual = new int16[len + 1];
+
+			for (int l = 0; l < ARRAYSIZE(volumes); ++l) {
+				for (int r = 0; r < ARRAYSIZE(volumes); ++r) {
+					fillSamples(in, len);
+					fillSamples(expected, len);
+					memcpy(actual, expected, len * sizeof(int16));
+
+					Audio::mixStereoSamplesGeneric(expected, in, frameCounts[f], volumes[l], volumes[r]);
+					proc(actual, in, frameCounts[f], volumes[l], volumes[r]);
+
+					TS_ASSERT_EQUALS(memcmp(expected, actual, len * sizeof(int16)), 0);
+				}
+			}
+
+			delete[] in;
+			delete[] expected;
+			delete[] actual;
+		}
+	}
+
+	Audio::AudioStream *createConstantStream(int rate, int samples, int16 value) {
+		byte *data = (byte *)malloc(samples * 2);
+		for (int i = 0; i < samples; ++i)
+			WRITE_LE_INT16(data + i * 2, value);
+
+		Common::SeekableReadStream *stream = new Common::MemoryReadStream(data, samples * 2, DisposeAfterUse::YES);
+		return Audio::makeRawStream(stream, rate, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN);
+	}
+
+	double toneAmplitude(const int16 *buf, int frames, int offset) {
+		// Root mean square of one channel, scaled to the peak of a sine
+		double sum = 0.0;
+		for (int i = 0; i < frames; ++i)
+			sum += (double)buf[i * 2 + offset] * buf[i * 2 + offset];
+		return sqrt(2.0 * sum / frames);
+	}
+
+	bool hasCpuFeature(OSystem::CpuFeature feature) {
+		if (!g_system)
+			Common::install_null_g_system();
+		return g_system->hasCpuFeature(feature);
+	}
+
+public:
+	void test_mix_generic_clamps() {
+		int16 out[4] = { 32000, -32000, 100, -100 };
+		const int16 in[4] = { 32767, -32768, -201, 201 };
+
+		Audio::mixStereoSamplesGeneric(out, in, 2, 256, 128);
+
+		TS_ASSERT_EQUALS(out[0], 32767);
+		TS_ASSERT_EQUALS(out[1], -32768);
+		TS_ASSERT_EQUALS(out[2], -101);
+		// Division rounds towards zero: 201 * 128 / 256 = 100
+		TS_ASSERT_EQUALS(out[3], 0);
+	}
+
+	void test_mix_sse2_matches_generic() {
+#ifdef SCUMMVM_SSE2
+		if (hasCpuFeature(OSystem::kCpuFeatureSSE2))
+			compareMixProcs(Audio::mixStereoSamplesSSE2);
+#endif
+	}
+
+	void test_mix_neon_matches_generic() {
+#ifdef SCUMMVM_NEON
+		if (hasCpuFeature(OSystem::kCpuFeatureNEON))
+			compareMixProcs(Audio::mixStereoSamplesNEON);
+#endif
+	}
+
+	void test_mix_dispatch_matches_generic() {
+		compareMixProcs(Audio::mixStereoSamples);
+	}
+
+	void test_copy_converter_stereo() {
+		int16 *sine;
+		Audio::SeekableAudioStream *s = createSineStream<int16>(11025, 1, &sine, true, true);
+		Audio::RateConverter *conv = Audio::makeRateConverter(11025, 11025, true, false);
+
+		int16 *buffer = new int16[11025 * 2];
+		memset(buffer, 0, sizeof(int16) * 11025 * 2);
+		TS_ASSERT_EQUALS(conv->flow(*s, buffer, 11025, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), 11025);
+		TS_ASSERT_EQUALS(memcmp(sine, buffer, sizeof(int16) * 11025 * 2), 0);
+
+		delete[] sine;
+		delete[] buffer;
+		delete conv;
+		delete s;
+	}
+
+	void test_copy_converter_mono() {
+		int16 *sine;
+		Audio::SeekableAudioStream *s = createSineStream<int16>(11025, 1, &sine, true, false);
+		Audio::RateConverter *conv = Audio::makeRateConverter(11025, 11025, false, false);
+
+		int16 *buffer = new int16[11025 * 2];
+		memset(buffer, 0, sizeof(int16) * 11025 * 2);
+		TS_ASSERT_EQUALS(conv->flow(*s, buffer, 11025, Audio::Mixer::kMaxMixerVolume, 0), 11025);
+
+		for (int i = 0; i < 11025; ++i) {
+			TS_ASSERT_EQUALS(buffer[i * 2], sine[i]);
+			TS_ASSERT_EQUALS(buffer[i * 2 + 1], 0);
+		}
+
+		delete[] sine;
+		delete[] buffer;
+		delete conv;
+		delete s;
+	}
+
+	void test_simple_converter_reverse_stereo() {
+		int16 *sine;
+		Audio::SeekableAudioStream *s = createSineStream<int16>(22050, 1, &sine, true, true);
+		Audio::RateConverter *conv = Audio::makeRateConverter(22050, 11025, true, true);
+
+		int16 *buffer = new int16[11025 * 2];
+		memset(buffer, 0, sizeof(int16) * 11025 * 2);
+		TS_ASSERT_EQUALS(conv->flow(*s, buffer, 11025, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume / 2), 11025);
+
+		// Every second input sample pair is used, with the channels swapped
+		for (int i = 0; i < 11025; ++i) {
+			TS_ASSERT_EQUALS(buffer[i * 2], sine[i * 4 + 3] / 2);
+			TS_ASSERT_EQUALS(buffer[i * 2 + 1], sine[i * 4 + 2]);
+		}
+
+		delete[] sine;
+		delete[] buffer;
+		delete conv;
+		delete s;
+	}
+
+	void test_linear_converter_mono() {
+		int16 *sine;
+		Audio::SeekableAudioStream *s = createSineStream<int16>(11025, 1, &sine, true, false);
+		Audio::RateConverter *conv = Audio::makeRateConverter(11025, 22050, false, false);
+
+		int16 *buffer = new int16[22048 * 2];
+		memset(buffer, 0, sizeof(int16) * 22048 * 2);
+		TS_ASSERT_EQUALS(conv->flow(*s, buffer, 22048, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), 22048);
+
+		// Upsampling by two interpolates one sample between each input pair,
+		// rounded to the nearest value
+		TS_ASSERT_EQUALS(buffer[0], 0);
+		for (int i = 1; i < 11024; ++i) {
+			const int16 interpolated = (int16)(sine[i - 1] + (((sine[i] - sine[i - 1]) * (1 << 14) + (1 << 14)) >> 15));
+			TS_ASSERT_EQUALS(buffer[i * 4], sine[i - 1]);
+			TS_ASSERT_EQUALS(buffer[i * 4 + 1], sine[i - 1]);
+			TS_ASSERT_EQUALS(buffer[i * 4 + 2], interpolated);
+			TS_ASSERT_EQUALS(buffer[i * 4 + 3], interpolated);
+		}
+
+		delete[] sine;
+		delete[] buffer;
+		delete conv;
+		delete s;
+	}
+
+	void test_polyphase_converter_constant() {
+		static const int rates[][2] = { { 11025, 48000 }, { 22050, 44100 }, { 44100, 22050 }, { 48000, 11025 }, { 32000, 44100 } };
+
+		for (int r = 0; r < ARRAYSIZE(rates); ++r) {
+			Audio::AudioStream *s = createConstantStream(rates[r][0], rates[r][0], -12345);
+			Audio::RateConverter *conv = Audio::makeRateConverter(rates[r][0], rates[r][1], false, false, Audio::kRateConverterPolyphase);
+
+			const int frames = rates[r][1] / 2;
+			int16 *buffer = new int16[frames * 2];
+			memset(buffer, 0, sizeof(int16) * frames * 2);
+			TS_ASSERT_EQUALS(conv->flow(*s, buffer, frames, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), frames);
+
+			// Every filter phase has unity gain, so once the filter has
+			// settled, a constant signal passes through unchanged
+			for (int i = frames / 4; i < frames * 2; ++i)
+				TS_ASSERT_EQUALS(buffer[i], -12345);
+
+			delete[] buffer;
+			delete conv;
+			delete s;
+		}
+	}
+
+	void test_polyphase_converter_sine() {
+		// A 1 kHz tone should survive upsampling with little distortion
+		int16 *sine = new int16[11025];
+		for (int i = 0; i < 11025; ++i)
+			sine[i] = (int16)(sin(2.0 * M_PI * 1000.0 * i / 11025) * 16384);
+
+		byte *data = (byte *)malloc(11025 * 2);
+		for (int i = 0; i < 11025; ++i)
+			WRITE_LE_INT16(data + i * 2, sine[i]);
+		Audio::AudioStream *s = Audio::makeRawStream(new Common::MemoryReadStream(data, 11025 * 2, DisposeAfterUse::YES), 11025, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN);
+		Audio::RateConverter *conv = Audio::makeRateConverter(11025, 48000, false, false, Audio::kRateConverterPolyphase);
+
+		int16 *buffer = new int16[24000 * 2];
+		memset(buffer, 0, sizeof(int16) * 24000 * 2);
+		TS_ASSERT_EQUALS(conv->flow(*s, buffer, 24000, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), 24000);
+
+		for (int i = 100; i < 24000; ++i) {
+			const double expected = sin(2.0 * M_PI * 1000.0 * i / 48000) * 16384;
+			TS_ASSERT_DELTA(buffer[i * 2], expected, 64);
+		}
+
+		delete[] sine;
+		delete[] buffer;
+		delete conv;
+		delete s;
+	}
+
+	void test_polyphase_converter_antialiasing() {
+		// A 10 kHz tone is above the Nyquist frequency of 11025 Hz output, so
+		// it must be filtered out instead of aliasing down to 1025 Hz
+		byte *data = (byte *)malloc(48000 * 2);
+		for (int i = 0; i < 48000; ++i)
+			WRITE_LE_INT16(data + i * 2, (int16)(sin(2.0 * M_PI * 10000.0 * i / 48000) * 16384));
+		Audio::AudioStream *s = Audio::makeRawStream(new Common::MemoryReadStream(data, 48000 * 2, DisposeAfterUse::YES), 48000, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN);
+
+		Audio::RateConverter *conv = Audio::makeRateConverter(48000, 11025, false, false, Audio::kRateConverterPolyphase);
+
+		int16 *buffer = new int16[5000 * 2];
+		memset(buffer, 0, sizeof(int16) * 5000 * 2);
+		TS_ASSERT_EQUALS(conv->flow(*s, buffer, 5000, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), 5000);
+
+		// The linear converter lets through most of the amplitude, the
+		// filter attenuates it by more than 40 dB
+		TS_ASSERT_LESS_THAN(toneAmplitude(buffer + 200, 4800, 0), 164.0);
+
+		delete[] buffer;
+		delete conv;
+		delete s;
+	}
+};
@@ -0,0 +1,157 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/fs.h"
+#include "common/stream.h"
+#include "common/system.h"
+
+#include "backends/fs/posix/posix-iostream.h"
+
+#include "../../null_osystem.h"
+
+#ifdef HAS_MMAP
+#include <sys/types.h>
+
+// Not from <sys/stat.h>, which declares functions forbidden in ScummVM code
+extern "C" int chmod(const char *path, mode_t mode);
+#endif
+
+// Files only get mapped when configured with --enable-mmap
+class PosixMmapStreamTestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+		if (!g_system)
+			Common::install_null_g_system();
+	}
+
+	void test_small_files_are_not_mapped() {
+#ifdef HAS_MMAP
+		TS_ASSERT(writeFile("mmap_small.bin", PosixMmapStream::kMinMappedSize - 1));
+		TS_ASSERT(!PosixMmapStream::makeFromPath("mmap_small.bin"));
+		TS_ASSERT(!PosixMmapStream::makeFromPath("mmap_missing.bin"));
+#endif
+	}
+
+	void test_size_and_read() {
+#ifdef HAS_MMAP
+		const uint32 size = PosixMmapStream::kMinMappedSize + 3;
+		TS_ASSERT(writeFile("mmap_read.bin", size));
+		Common::ScopedPtr<PosixMmapStream> stream(PosixMmapStream::makeFromPath("mmap_read.bin"));
+		TS_ASSERT(stream);
+		if (!stream)
+			return;
+
+		TS_ASSERT_EQUALS(stream->size(), (int64)size);
+		TS_ASSERT_EQUALS(stream->pos(), 0);
+		TS_ASSERT(stream->getBuffer());
+		TS_ASSERT_EQUALS(stream->getBuffer()[size - 1], valueAt(size - 1));
+
+		byte data[16];
+		TS_ASSERT_EQUALS(stream->read(data, sizeof(data)), sizeof(data));
+		for (uint i = 0; i < sizeof(data); ++i)
+			TS_ASSERT_EQUALS(data[i], valueAt(i));
+		TS_ASSERT_EQUALS(stream->pos(), (int64)sizeof(data));
+		TS_ASSERT(!stream->eos());
+#endif
+	}
+
+	void test_read_past_end() {
+#ifdef HAS_MMAP
+		const uint32 size = PosixMmapStream::kMinMappedSize;
+		TS_ASSERT(writeFile("mmap_end.bin", size));
+		Common::ScopedPtr<PosixMmapStream> stream(PosixMmapStream::makeFromPath("mmap_end.bin"));
+		TS_ASSERT(stream);
+		if (!stream)
+			return;
+
+		byte data[8];
+		TS_ASSERT(stream->seek(-3, SEEK_END));
+		TS_ASSERT(!stream->eos());
+		TS_ASSERT_EQUALS(stream->read(data, sizeof(data)), 3u);
+		TS_ASSERT_EQUALS(data[2], valueAt(size - 1));
+		TS_ASSERT(stream->eos());
+		TS_ASSERT_EQUALS(stream->pos(), (int64)size);
+
+		// Reading at the end gives nothing, and the position stays
+		TS_ASSERT_EQUALS(stream->read(data, sizeof(data)), 0u);
+		TS_ASSERT_EQUALS(stream->pos(), (int64)size);
+
+		stream->clearErr();
+		TS_ASSERT(!stream->eos());
+#endif
+	}
+
+	void test_seek() {
+#ifdef HAS_MMAP
+		const uint32 size = PosixMmapStream::kMinMappedSize + 100;
+		TS_ASSERT(writeFile("mmap_seek.bin", size));
+		Common::ScopedPtr<PosixMmapStream> stream(PosixMmapStream::makeFromPath("mmap_seek.bin"));
+		TS_ASSERT(stream);
+		if (!stream)
+			return;
+
+		TS_ASSERT(stream->seek(1000));
+		TS_ASSERT_EQUALS(stream->readByte(), valueAt(1000));
+		TS_ASSERT(stream->seek(-11, SEEK_CUR));
+		TS_ASSERT_EQUALS(stream->pos(), 990);
+		TS_ASSERT_EQUALS(stream->readByte(), valueAt(990));
+		TS_ASSERT(stream->seek(-1, SEEK_END));
+		TS_ASSERT_EQUALS(stream->readByte(), valueAt(size - 1));
+
+		// Seeking to the very end is allowed, but not beyond either end
+		TS_ASSERT(stream->seek(0, SEEK_END));
+		TS_ASSERT_EQUALS(stream->pos(), (int64)size);
+		TS_ASSERT(!stream->seek(1, SEEK_END));
+		TS_ASSERT(!stream->seek(-1));
+		TS_ASSERT_EQUALS(stream->pos(), (int64)size);
+
+		// Seeking clears the end of stream flag
+		stream->readByte();
+		TS_ASSERT(stream->eos());
+		TS_ASSERT(stream->seek(0));
+		TS_ASSERT(!stream->eos());
+#endif
+	}
+
+	void test_writable_files_are_not_mapped() {
+#ifdef HAS_MMAP
+		TS_ASSERT(writeFile("mmap_writable.bin", PosixMmapStream::kMinMappedSize, false));
+		TS_ASSERT(!PosixMmapStream::makeFromPath("mmap_writable.bin"));
+
+		// Files get mapped through the file system node as well
+		TS_ASSERT(writeFile("mmap_data.bin", PosixMmapStream::kMinMappedSize));
+		Common::ScopedPtr<Common::SeekableReadStream> writable(Common::FSNode("mmap_writable.bin").createReadStream());
+		Common::ScopedPtr<Common::SeekableReadStream> data(Common::FSNode("mmap_data.bin").createReadStream());
+		TS_ASSERT(writable && !writable->getBuffer());
+		TS_ASSERT(data && data->getBuffer());
+#endif
+	}
+
+private:
+	static byte valueAt(uint32 offset) {
+		return (byte)(offset * 7 + offset / 256);
+	}
+
+	/** Write a test file, which is read-only afterwards unless asked otherwise, so that it can be mapped. */
+	static bool writeFile(const char *name, uint32 size, bool readOnly = true) {
+#ifdef HAS_MMAP
+		// The file may be left read-only by an earlier run
+		chmod(name, 0644);
+#endif
+		Common::ScopedPtr<Common::WriteStream> stream(Common::FSNode(name).createWriteStream());
+		if (!stream)
+			return false;
+
+		for (uint32 i = 0; i < size; ++i)
+			stream->writeByte(valueAt(i));
+		stream->finalize();
+		if (stream->err())
+			return false;
+		stream.reset();
+
+#ifdef HAS_MMAP
+		if (readOnly)
+			return chmod(name, 0444) == 0;
+#endif
+		return true;
+	}
+};
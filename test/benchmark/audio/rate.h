@@ -0,0 +1,91 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/mixer.h"
+#include "audio/rate.h"
+
+#include "../helper.h"
+
+/**
+ * An endless stream of pseudo random samples, so that the benchmark only
+ * measures the converters and not some decoder.
+ */
+class NoiseAudioStream : public Audio::AudioStream {
+public:
+	NoiseAudioStream(int rate, bool stereo) : _rate(rate), _stereo(stereo), _seed(1) {}
+
+	int readBuffer(int16 *buffer, const int numSamples) override {
+		for (int i = 0; i < numSamples; ++i) {
+			_seed = _seed * 1103515245 + 12345;
+			buffer[i] = (int16)(_seed >> 16);
+		}
+		return numSamples;
+	}
+
+	bool isStereo() const override { return _stereo; }
+	int getRate() const override { return _rate; }
+	bool endOfData() const override { return false; }
+
+private:
+	int _rate;
+	bool _stereo;
+	uint32 _seed;
+};
+
+class RateConverterBenchmark {
+public:
+	enum {
+		kFrames = 4096
+	};
+
+	RateConverterBenchmark(int inRate, int outRate, bool stereo, Audio::RateConverterType type)
+		: _stream(inRate, stereo) {
+		_converter = Audio::makeRateConverter(inRate, outRate, stereo, false, type);
+	}
+
+	~RateConverterBenchmark() {
+		delete _converter;
+	}
+
+	void operator()() {
+		memset(_buffer, 0, sizeof(_buffer));
+		_converter->flow(_stream, _buffer, kFrames, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume / 2);
+	}
+
+private:
+	NoiseAudioStream _stream;
+	Audio::RateConverter *_converter;
+	int16 _buffer[kFrames * 2];
+};
+
+class RateConverterBenchmarkSuite : public CxxTest::TestSuite
+{
+private:
+	void run(const char *name, int inRate, int outRate, bool stereo, Audio::RateConverterType type) {
+		RateConverterBenchmark benchmark(inRate, outRate, stereo, type);
+		const double nanos = benchmarkNanosPerCall(benchmark);
+		reportBenchmark("rate", name, nanos / RateConverterBenchmark::kFrames, "ns/sample");
+	}
+
+public:
+	void test_copy() {
+		run("copy_44100_mono", 44100, 44100, false, Audio::kRateConverterDefault);
+		run("copy_44100_stereo", 44100, 44100, true, Audio::kRateConverterDefault);
+	}
+
+	void test_simple() {
+		run("simple_44100_22050_mono", 44100, 22050, false, Audio::kRateConverterDefault);
+		run("simple_44100_22050_stereo", 44100, 22050, true, Audio::kRateConverterDefault);
+	}
+
+	void test_linear() {
+		run("linear_11025_48000_mono", 11025, 48000, false, Audio::kRateConverterDefault);
+		run("linear_22050_48000_stereo", 22050, 48000, true, Audio::kRateConverterDefault);
+	}
+
+	void test_polyphase() {
+		run("polyphase_11025_48000_mono", 11025, 48000, false, Audio::kRateConverterPolyphase);
+		run("polyphase_22050_48000_stereo", 22050, 48000, true, Audio::kRateConverterPolyphase);
+		run("polyphase_44100_22050_stereo", 44100, 22050, true, Audio::kRateConverterPolyphase);
+	}
+};
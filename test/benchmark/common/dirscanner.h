@@ -0,0 +1,152 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/dir-scanner.h"
+#include "common/stream.h"
+#include "common/threadpool.h"
+#include "engines/advancedDetector.h"
+
+#include "../helper.h"
+
+static const PlainGameDescriptor benchmarkGames[] = {
+	{ "benchmark", "Benchmark Game" },
+	{ nullptr, nullptr }
+};
+
+#define BENCHMARK_ENTRY(f) \
+	{ "benchmark", "", AD_ENTRY2s(f, "00000000000000000000000000000000", 8192, "resource.000", "11111111111111111111111111111111", 8192), \
+	  Common::EN_ANY, Common::kPlatformDOS, ADGF_NO_FLAGS, GUIO0() }
+
+/**
+ * Game descriptions for the files of the benchmark tree. Their MD5s never
+ * match, so the detector checks every file they name in every directory.
+ */
+static const ADGameDescription benchmarkGameDescriptions[] = {
+	BENCHMARK_ENTRY("resource.001"),
+	BENCHMARK_ENTRY("resource.002"),
+	BENCHMARK_ENTRY("resource.003"),
+	BENCHMARK_ENTRY("resource.004"),
+	BENCHMARK_ENTRY("resource.005"),
+	BENCHMARK_ENTRY("resource.006"),
+	BENCHMARK_ENTRY("resource.007"),
+	AD_TABLE_END_MARKER
+};
+
+#undef BENCHMARK_ENTRY
+
+class BenchmarkMetaEngineDetection : public AdvancedMetaEngineDetection {
+public:
+	BenchmarkMetaEngineDetection() : AdvancedMetaEngineDetection(benchmarkGameDescriptions, sizeof(ADGameDescription), benchmarkGames) {}
+
+	const char *getName() const override { return "benchmark"; }
+	const char *getEngineName() const override { return "Benchmark"; }
+	const char *getOriginalCopyright() const override { return ""; }
+};
+
+/**
+ * Times a mass add style scan over a synthetic directory tree. Every
+ * directory goes through the advanced detector, which hashes the start of
+ * the files its game descriptions know about. With a thread pool, the
+ * directories next in line are listed on the pool while the detector runs
+ * on the calling thread, the way the mass add dialog does.
+ *
+ * The MD5s of the first scan are kept in the persistent MD5 cache, so the
+ * timed scans look them up there, as a scan of a known collection would.
+ * The tree is created in the build directory on first use and kept for
+ * later runs.
+ */
+class DirectoryScannerBenchmark {
+public:
+	enum {
+		kFanOut = 6,
+		kDepth = 3,
+		kFilesPerDirectory = 8,
+		kFileSize = 8192
+	};
+
+	explicit DirectoryScannerBenchmark(Common::ThreadPool *pool) : _root("benchmark_dirtree"), _pool(pool), _directories(0) {
+		if (!_root.exists()) {
+			_root.createDirectory();
+			_root = Common::FSNode(_root.getPath());
+			populate(_root, kDepth);
+		}
+	}
+
+	void operator()() {
+		Common::DirectoryScanner scanner(_root, -1, _pool);
+		MD5Man.clear();
+		_directories = 0;
+
+		Common::FSNode dir;
+		Common::FSList files;
+		while (scanner.nextDirectory(dir, files)) {
+			_detection.detectGames(files, ADGF_WARNING | ADGF_UNSUPPORTED, true);
+			++_directories;
+		}
+	}
+
+	uint getDirectoryCount() const { return _directories; }
+
+	static uint expectedDirectoryCount() {
+		uint count = 1, level = 1;
+		for (int i = 0; i < kDepth; ++i) {
+			level *= kFanOut;
+			count += level;
+		}
+		return count;
+	}
+
+private:
+	void populate(const Common::FSNode &dir, int depth) {
+		byte data[kFileSize];
+		for (int i = 0; i < kFilesPerDirectory; ++i) {
+			for (int j = 0; j < kFileSize; ++j)
+				data[j] = (byte)(i * 31 + j * 7 + depth);
+
+			Common::ScopedPtr<Common::WriteStream> stream(dir.getChild(Common::String::format("resource.%03d", i)).createWriteStream());
+			stream->write(data, sizeof(data));
+			stream->finalize();
+		}
+
+		if (depth == 0)
+			return;
+
+		for (int i = 0; i < kFanOut; ++i) {
+			Common::FSNode child = dir.getChild(Common::String::format("game%d", i));
+			child.createDirectory();
+			populate(Common::FSNode(child.getPath()), depth - 1);
+		}
+	}
+
+	BenchmarkMetaEngineDetection _detection;
+	Common::FSNode _root;
+	Common::ThreadPool *_pool;
+	uint _directories;
+};
+
+class DirectoryScannerBenchmarkSuite : public CxxTest::TestSuite
+{
+private:
+	void run(const char *name, Common::ThreadPool *pool) {
+		DirectoryScannerBenchmark benchmark(pool);
+		const double nanos = benchmarkNanosPerCall(benchmark);
+
+		TS_ASSERT_EQUALS(benchmark.getDirectoryCount(), DirectoryScannerBenchmark::expectedDirectoryCount());
+
+		reportBenchmark("dirscanner", name, nanos / benchmark.getDirectoryCount(), "ns/directory");
+	}
+
+public:
+	void setUp() {
+		if (!g_system)
+			Common::install_null_g_system();
+	}
+
+	void test_mass_add_detect() {
+		run("mass_add_detect", nullptr);
+	}
+
+	void test_mass_add_detect_pool() {
+		Common::ThreadPool pool;
+		run("mass_add_detect_pool", &pool);
+	}
+};
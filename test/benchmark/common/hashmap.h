@@ -0,0 +1,124 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/flat-hashmap.h"
+#include "common/hash-str.h"
+#include "common/hashmap.h"
+
+#include "../helper.h"
+
+/**
+ * Compares the node based HashMap to the open addressing FlatHashMap, for
+ * an integer key (like engine resource tables) and a case insensitive string
+ * key (like archive member lookups).
+ */
+template<class Map, class Key>
+class HashMapBenchmark {
+public:
+	enum {
+		kElements = 10000
+	};
+
+	HashMapBenchmark(const Common::Array<Key> &keys, const Common::Array<Key> &missingKeys) : _keys(keys), _missingKeys(missingKeys), _result(0) {
+		for (uint i = 0; i < _keys.size(); ++i)
+			_map[_keys[i]] = i;
+	}
+
+	struct Insert {
+		HashMapBenchmark *_bench;
+		void operator()() {
+			Map map;
+			for (uint i = 0; i < _bench->_keys.size(); ++i)
+				map[_bench->_keys[i]] = i;
+			_bench->_result += map.size();
+		}
+	};
+
+	struct Lookup {
+		HashMapBenchmark *_bench;
+		void operator()() {
+			for (uint i = 0; i < _bench->_keys.size(); ++i)
+				_bench->_result += _bench->_map.getValOrDefault(_bench->_keys[i]);
+		}
+	};
+
+	struct LookupMissing {
+		HashMapBenchmark *_bench;
+		void operator()() {
+			for (uint i = 0; i < _bench->_missingKeys.size(); ++i)
+				_bench->_result += _bench->_map.contains(_bench->_missingKeys[i]);
+		}
+	};
+
+	struct Iterate {
+		HashMapBenchmark *_bench;
+		void operator()() {
+			for (typename Map::const_iterator i = _bench->_map.begin(); i != _bench->_map.end(); ++i)
+				_bench->_result += i->_value;
+		}
+	};
+
+	void run(const char *name) {
+		Insert insert = { this };
+		Lookup lookup = { this };
+		LookupMissing lookupMissing = { this };
+		Iterate iterate = { this };
+
+		report(name, "insert", benchmarkNanosPerCall(insert));
+		report(name, "lookup", benchmarkNanosPerCall(lookup));
+		report(name, "lookup_missing", benchmarkNanosPerCall(lookupMissing));
+		report(name, "iterate", benchmarkNanosPerCall(iterate));
+	}
+
+private:
+	void report(const char *name, const char *operation, double nanos) {
+		reportBenchmark("hashmap", Common::String::format("%s_%s", name, operation).c_str(), nanos / _keys.size(), "ns/element");
+	}
+
+	const Common::Array<Key> &_keys;
+	const Common::Array<Key> &_missingKeys;
+	Map _map;
+
+	/** Keeps the compiler from optimizing the lookups away */
+	uint _result;
+};
+
+class HashMapBenchmarkSuite : public CxxTest::TestSuite
+{
+private:
+	Common::Array<int> _intKeys, _missingIntKeys;
+	Common::Array<Common::String> _stringKeys, _missingStringKeys;
+
+public:
+	HashMapBenchmarkSuite() {
+		// Spread out integer keys, with some structure like resource ids
+		for (uint i = 0; i < HashMapBenchmark<Common::HashMap<int, uint>, int>::kElements; ++i) {
+			_intKeys.push_back((i % 100) | ((i / 100) << 16));
+			_missingIntKeys.push_back((i % 100) | ((i / 100) << 16) | 0x8000);
+		}
+
+		for (uint i = 0; i < HashMapBenchmark<Common::HashMap<int, uint>, int>::kElements; ++i) {
+			_stringKeys.push_back(Common::String::format("data/room%03u/resource.%u", i % 100, i / 100));
+			_missingStringKeys.push_back(Common::String::format("data/room%03u/missing.%u", i % 100, i / 100));
+		}
+	}
+
+	void test_int_keys() {
+		HashMapBenchmark<Common::HashMap<int, uint>, int> hashMap(_intKeys, _missingIntKeys);
+		hashMap.run("int_hashmap");
+
+		HashMapBenchmark<Common::FlatHashMap<int, uint>, int> flatHashMap(_intKeys, _missingIntKeys);
+		flatHashMap.run("int_flat_hashmap");
+	}
+
+	void test_string_keys() {
+		typedef Common::HashMap<Common::String, uint, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> StringMap;
+		typedef Common::FlatHashMap<Common::String, uint, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> FlatStringMap;
+
+		HashMapBenchmark<StringMap, Common::String> hashMap(_stringKeys, _missingStringKeys);
+		hashMap.run("string_hashmap");
+
+		HashMapBenchmark<FlatStringMap, Common::String> flatHashMap(_stringKeys, _missingStringKeys);
+		flatHashMap.run("string_flat_hashmap");
+	}
+};
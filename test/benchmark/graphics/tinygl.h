@@ -0,0 +1,174 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/system.h"
+
+#ifdef USE_TINYGL
+#include "graphics/tinygl/tinygl.h"
+#include "graphics/tinygl/zgl.h"
+#endif
+
+#include "../helper.h"
+
+#ifdef USE_TINYGL
+
+/**
+ * Renders a fixed soup of depth tested triangles into a 640x480 frame, in
+ * screen coordinates, so that the covered pixels are known up front.
+ */
+class TinyGLTriangleBenchmark {
+public:
+	enum Mode {
+		kModeGouraud,
+		kModeTextured,
+		kModeBlendedTextured
+	};
+
+	enum {
+		kWidth = 640,
+		kHeight = 480,
+		kTriangleCount = 3000,
+		kTextureSize = 64
+	};
+
+	TinyGLTriangleBenchmark(Mode mode, bool spanKernels) : _mode(mode), _pixelCount(0) {
+		TinyGL::createContext(kWidth, kHeight, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), 256, false, false);
+		TinyGL::gl_get_context()->fb->enableSpanKernels(spanKernels);
+
+		uint32 seed = 1;
+		byte *texels = new byte[kTextureSize * kTextureSize * 4];
+		for (int i = 0; i < kTextureSize * kTextureSize * 4; i++) {
+			seed = seed * 1103515245 + 12345;
+			texels[i] = (byte)(seed >> 16);
+		}
+		tglGenTextures(1, &_texture);
+		tglBindTexture(TGL_TEXTURE_2D, _texture);
+		tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_MIN_FILTER, TGL_LINEAR);
+		tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_MAG_FILTER, TGL_LINEAR);
+		tglTexImage2D(TGL_TEXTURE_2D, 0, TGL_RGBA, kTextureSize, kTextureSize, 0, TGL_RGBA, TGL_UNSIGNED_BYTE, texels);
+		delete[] texels;
+
+		for (int i = 0; i < kTriangleCount * 3; i++) {
+			Vertex &v = _vertices[i];
+			seed = seed * 1103515245 + 12345;
+			const int centerX = (seed >> 8) % (kWidth - 40) + 20;
+			seed = seed * 1103515245 + 12345;
+			const int centerY = (seed >> 8) % (kHeight - 40) + 20;
+			if (i % 3) {
+				// Stay close to the first vertex of the triangle
+				v.x = _vertices[i - i % 3].x + (float)((int)((seed >> 4) % 81) - 40);
+				v.y = _vertices[i - i % 3].y + (float)((int)((seed >> 12) % 81) - 40);
+			} else {
+				v.x = (float)centerX;
+				v.y = (float)centerY;
+			}
+			v.z = -(float)((seed >> 20) % 1000) / 1000.0f;
+			v.s = (float)((seed >> 3) % 300) / 100.0f;
+			v.t = (float)((seed >> 13) % 300) / 100.0f;
+			for (int c = 0; c < 4; c++)
+				v.color[c] = 0.3f + (float)((seed >> (c * 5 + 2)) % 70) / 100.0f;
+		}
+
+		for (int i = 0; i < kTriangleCount * 3; i += 3) {
+			const Vertex &v0 = _vertices[i], &v1 = _vertices[i + 1], &v2 = _vertices[i + 2];
+			const float area = ((v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y)) / 2.0f;
+			_pixelCount += area < 0 ? -area : area;
+		}
+	}
+
+	~TinyGLTriangleBenchmark() {
+		tglDeleteTextures(1, &_texture);
+		TinyGL::destroyContext();
+	}
+
+	void operator()() {
+		tglViewport(0, 0, kWidth, kHeight);
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglOrtho(0.0, kWidth, kHeight, 0.0, -1.0, 1.0);
+		tglMatrixMode(TGL_MODELVIEW);
+		tglLoadIdentity();
+
+		tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+		tglEnable(TGL_DEPTH_TEST);
+		tglShadeModel(TGL_SMOOTH);
+		if (_mode != kModeGouraud) {
+			tglEnable(TGL_TEXTURE_2D);
+			tglBindTexture(TGL_TEXTURE_2D, _texture);
+		}
+		if (_mode == kModeBlendedTextured) {
+			tglEnable(TGL_BLEND);
+			tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+		}
+
+		tglBegin(TGL_TRIANGLES);
+		for (int i = 0; i < kTriangleCount * 3; i++) {
+			const Vertex &v = _vertices[i];
+			tglColor4f(v.color[0], v.color[1], v.color[2], v.color[3]);
+			tglTexCoord2f(v.s, v.t);
+			tglVertex3f(v.x, v.y, v.z);
+		}
+		tglEnd();
+
+		tglDisable(TGL_BLEND);
+		tglDisable(TGL_TEXTURE_2D);
+		TinyGL::presentBuffer();
+	}
+
+	double getPixelCount() const { return _pixelCount; }
+
+private:
+	struct Vertex {
+		float x, y, z;
+		float s, t;
+		float color[4];
+	};
+
+	Mode _mode;
+	double _pixelCount;
+	TGLuint _texture;
+	Vertex _vertices[kTriangleCount * 3];
+};
+
+#endif
+
+class TinyGLBenchmarkSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+		if (!g_system)
+			Common::install_null_g_system();
+	}
+
+	void test_gouraud() {
+#ifdef USE_TINYGL
+		run("gouraud", TinyGLTriangleBenchmark::kModeGouraud);
+#endif
+	}
+
+	void test_textured() {
+#ifdef USE_TINYGL
+		run("textured", TinyGLTriangleBenchmark::kModeTextured);
+#endif
+	}
+
+	void test_blended_textured() {
+#ifdef USE_TINYGL
+		run("blended_textured", TinyGLTriangleBenchmark::kModeBlendedTextured);
+#endif
+	}
+
+private:
+#ifdef USE_TINYGL
+	void run(const char *name, TinyGLTriangleBenchmark::Mode mode) {
+		for (int spanKernels = 0; spanKernels < 2; spanKernels++) {
+			TinyGLTriangleBenchmark *benchmark = new TinyGLTriangleBenchmark(mode, spanKernels);
+			const double nanos = benchmarkNanosPerCall(*benchmark, 500);
+			reportBenchmark("tinygl", Common::String::format("%s_%s", name, spanKernels ? "span" : "generic").c_str(), benchmark->getPixelCount() * 1000.0 / nanos, "Mpixels/s");
+			delete benchmark;
+		}
+	}
+#endif
+};
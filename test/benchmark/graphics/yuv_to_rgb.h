@@ -0,0 +1,100 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/system.h"
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+
+#include "../helper.h"
+
+/**
+ * Converts one frame of pseudo random YUV420 data, the layout used by most
+ * video decoders, into a surface of the given format.
+ */
+class YUVToRGBBenchmark {
+public:
+	YUVToRGBBenchmark(int width, int height, const Graphics::PixelFormat &format, bool alpha) :
+			_width(width), _height(height), _alpha(alpha) {
+		const int size = width * height;
+		_y = new byte[size];
+		_a = new byte[size];
+		_u = new byte[size / 4];
+		_v = new byte[size / 4];
+
+		uint32 seed = 1;
+		for (int i = 0; i < size; ++i) {
+			seed = seed * 1103515245 + 12345;
+			_y[i] = (byte)(seed >> 16);
+			_a[i] = (byte)(seed >> 24);
+		}
+		for (int i = 0; i < size / 4; ++i) {
+			seed = seed * 1103515245 + 12345;
+			_u[i] = (byte)(seed >> 16);
+			_v[i] = (byte)(seed >> 24);
+		}
+
+		_surface.create(width, height, format);
+	}
+
+	~YUVToRGBBenchmark() {
+		_surface.free();
+		delete[] _y;
+		delete[] _u;
+		delete[] _v;
+		delete[] _a;
+	}
+
+	void operator()() {
+		if (_alpha)
+			YUVToRGBMan.convert420Alpha(&_surface, Graphics::YUVToRGBManager::kScaleITU, _y, _u, _v, _a, _width, _height, _width, _width / 2);
+		else
+			YUVToRGBMan.convert420(&_surface, Graphics::YUVToRGBManager::kScaleITU, _y, _u, _v, _width, _height, _width, _width / 2);
+	}
+
+	int getPixelCount() const { return _width * _height; }
+
+private:
+	int _width, _height;
+	bool _alpha;
+	byte *_y, *_u, *_v, *_a;
+	Graphics::Surface _surface;
+};
+
+class YUVToRGBBenchmarkSuite : public CxxTest::TestSuite
+{
+private:
+	void run(const char *name, int width, int height, const Graphics::PixelFormat &format, bool alpha = false) {
+		YUVToRGBBenchmark benchmark(width, height, format, alpha);
+
+		YUVToRGBMan.setSIMDEnabled(false);
+		const double tableNanos = benchmarkNanosPerCall(benchmark);
+		YUVToRGBMan.setSIMDEnabled(true);
+		const double simdNanos = benchmarkNanosPerCall(benchmark);
+
+		reportBenchmark("yuv_to_rgb", Common::String::format("%s_table", name).c_str(), tableNanos / benchmark.getPixelCount(), "ns/pixel");
+		reportBenchmark("yuv_to_rgb", Common::String::format("%s_simd", name).c_str(), simdNanos / benchmark.getPixelCount(), "ns/pixel");
+	}
+
+public:
+	void setUp() {
+		if (!g_system)
+			Common::install_null_g_system();
+	}
+
+	void test_420_32bpp() {
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		run("420_640x480_32bpp", 640, 480, format);
+		run("420_1280x720_32bpp", 1280, 720, format);
+	}
+
+	void test_420_16bpp() {
+		const Graphics::PixelFormat format(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		run("420_640x480_16bpp", 640, 480, format);
+		run("420_1280x720_16bpp", 1280, 720, format);
+	}
+
+	void test_420_alpha_32bpp() {
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		run("420a_640x480_32bpp", 640, 480, format, true);
+		run("420a_1280x720_32bpp", 1280, 720, format, true);
+	}
+};
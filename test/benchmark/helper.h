@@ -0,0 +1,64 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef TEST_BENCHMARK_HELPER_H
+#define TEST_BENCHMARK_HELPER_H
+
+#include "common/debug.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+/**
+ * Run a benchmark function repeatedly until at least minMillis milliseconds
+ * have passed, and return the average time per call in nanoseconds.
+ *
+ * The function gets called once up front, so that one-time setup costs
+ * (like filling caches) do not show up in the result.
+ */
+template<class Func>
+static double benchmarkNanosPerCall(Func &func, uint32 minMillis = 250) {
+	if (!g_system)
+		Common::install_null_g_system();
+
+	func();
+
+	uint32 calls = 0;
+	const uint32 start = g_system->getMillis();
+	uint32 elapsed;
+	do {
+		func();
+		++calls;
+		elapsed = g_system->getMillis() - start;
+	} while (elapsed < minMillis);
+
+	return elapsed * 1000000.0 / calls;
+}
+
+/**
+ * Print one line of benchmark results, in a format which is easy to pick
+ * out of the test runner output and compare between runs.
+ */
+static void reportBenchmark(const char *suite, const char *name, double value, const char *unit) {
+	debug("BENCHMARK %s/%s: %.2f %s", suite, name, value, unit);
+}
+
+#endif
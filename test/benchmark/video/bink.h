@@ -0,0 +1,428 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memstream.h"
+#include "video/bink_decoder.h"
+#include "video/bink_dsp.h"
+
+#include "../helper.h"
+
+#ifdef USE_BINK
+
+/**
+ * Writes bits the way the Bink decoder reads them: little endian 32-bit
+ * words, starting with the lowest bit.
+ */
+class BinkBitWriter {
+public:
+	BinkBitWriter() : _stream(DisposeAfterUse::YES), _word(0), _bitCount(0) {}
+
+	void putBit(uint32 bit) {
+		_word |= (bit & 1) << _bitCount;
+		if (++_bitCount == 32)
+			flush();
+	}
+
+	void putBits(uint32 value, int count) {
+		for (int i = 0; i < count; i++)
+			putBit(value >> i);
+	}
+
+	/** Fill up the current word with zeroes. */
+	void align() {
+		if (_bitCount)
+			flush();
+	}
+
+	Common::MemoryWriteStreamDynamic &getStream() { return _stream; }
+
+private:
+	void flush() {
+		_stream.writeUint32LE(_word);
+		_word = 0;
+		_bitCount = 0;
+	}
+
+	Common::MemoryWriteStreamDynamic _stream;
+	uint32 _word;
+	int _bitCount;
+};
+
+/**
+ * Builds a BIKi file whose frames consist of DCT blocks only: intra blocks
+ * in the key frames and inter blocks in between, each with a random set of
+ * coefficients. This is the worst case for the decoder, and needs no
+ * Huffman coding to write.
+ */
+class BinkStreamBuilder {
+public:
+	BinkStreamBuilder(uint32 width, uint32 height, uint32 frameCount, uint32 keyFrameInterval) : _seed(1), _data(DisposeAfterUse::YES) {
+		Common::Array<Common::MemoryWriteStreamDynamic *> frames;
+		for (uint32 i = 0; i < frameCount; i++) {
+			BinkBitWriter bits;
+			writeFrame(bits, width, height, (i % keyFrameInterval) == 0);
+			frames.push_back(new Common::MemoryWriteStreamDynamic(DisposeAfterUse::YES));
+			frames.back()->write(bits.getStream().getData(), bits.getStream().size());
+		}
+
+		uint32 offset = 44 + 4 * frameCount;
+		uint32 largest = 0;
+		for (uint32 i = 0; i < frameCount; i++)
+			largest = MAX<uint32>(largest, frames[i]->size());
+
+		uint32 fileSize = offset;
+		for (uint32 i = 0; i < frameCount; i++)
+			fileSize += frames[i]->size();
+
+		_data.writeUint32BE(MKTAG('B', 'I', 'K', 'i'));
+		_data.writeUint32LE(fileSize - 8);
+		_data.writeUint32LE(frameCount);
+		_data.writeUint32LE(largest);
+		_data.writeUint32LE(0);
+		_data.writeUint32LE(width);
+		_data.writeUint32LE(height);
+		_data.writeUint32LE(30); // frame rate
+		_data.writeUint32LE(1);
+		_data.writeUint32LE(0);  // video flags
+		_data.writeUint32LE(0);  // audio tracks
+
+		for (uint32 i = 0; i < frameCount; i++) {
+			_data.writeUint32LE(offset | ((i % keyFrameInterval) == 0 ? 1 : 0));
+			offset += frames[i]->size();
+		}
+
+		for (uint32 i = 0; i < frameCount; i++) {
+			_data.write(frames[i]->getData(), frames[i]->size());
+			delete frames[i];
+		}
+	}
+
+	Common::SeekableReadStream *createReadStream() {
+		return new Common::MemoryReadStream(_data.getData(), _data.size());
+	}
+
+private:
+	enum Source {
+		kBlockTypes,
+		kSubBlockTypes,
+		kColors,
+		kPattern,
+		kXOff,
+		kYOff,
+		kIntraDC,
+		kInterDC,
+		kRun,
+
+		kSourceCount
+	};
+
+	uint32 nextRandom(uint32 range) {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 8) % range;
+	}
+
+	/** The number of bits of the element counts, see BinkVideoTrack::initBundles(). */
+	static int countLength(uint32 maxCount) {
+		int bits = 1;
+		for (maxCount += 511; maxCount > 1; maxCount >>= 1)
+			bits++;
+		return bits;
+	}
+
+	static int countLength(int source, uint32 width, uint32 blockWidth) {
+		switch (source) {
+		case kSubBlockTypes:
+			return countLength((width + 7) >> 4);
+		case kColors:
+			return countLength(blockWidth * 64);
+		case kPattern:
+			return countLength(blockWidth << 3);
+		case kRun:
+			return countLength(blockWidth * 48);
+		default:
+			return countLength(width >> 3);
+		}
+	}
+
+	void writeFrame(BinkBitWriter &bits, uint32 width, uint32 height, bool keyFrame) {
+		bits.putBits(0, 32);
+		writePlane(bits, width, (width + 7) >> 3, (height + 7) >> 3, keyFrame);
+		writePlane(bits, width >> 1, (width + 15) >> 4, (height + 15) >> 4, keyFrame);
+		writePlane(bits, width >> 1, (width + 15) >> 4, (height + 15) >> 4, keyFrame);
+	}
+
+	void writePlane(BinkBitWriter &bits, uint32 width, uint32 blockWidth, uint32 blockHeight, bool keyFrame) {
+		// Every bundle uses the plain nibble code
+		for (int i = 0; i < kSourceCount; i++) {
+			if (i == kColors)
+				bits.putBits(0, 4 * 16);
+			if (i != kIntraDC && i != kInterDC)
+				bits.putBits(0, 4);
+		}
+
+		for (uint32 y = 0; y < blockHeight; y++) {
+			for (int i = 0; i < kSourceCount; i++) {
+				const int length = countLength(i, width, blockWidth);
+				const bool used = (i == kBlockTypes) || (keyFrame ? i == kIntraDC : (i == kXOff || i == kYOff || i == kInterDC));
+				if (!used) {
+					// A count of 0 ends the bundle for the whole plane
+					if (y == 0)
+						bits.putBits(0, length);
+					continue;
+				}
+
+				bits.putBits(blockWidth, length);
+				switch (i) {
+				case kBlockTypes:
+					bits.putBit(1);
+					bits.putBits(keyFrame ? 5 : 7, 4);
+					break;
+				case kXOff:
+				case kYOff:
+					bits.putBit(1);
+					bits.putBits(0, 4);
+					break;
+				default:
+					writeDCs(bits, blockWidth, i == kInterDC);
+					break;
+				}
+			}
+
+			for (uint32 x = 0; x < blockWidth; x++)
+				writeDCTCoeffs(bits);
+		}
+
+		bits.align();
+	}
+
+	void writeDCs(BinkBitWriter &bits, uint32 count, bool hasSign) {
+		int v = 256 + nextRandom(512);
+		bits.putBits(v, hasSign ? 10 : 11);
+		if (hasSign)
+			bits.putBit(0);
+
+		for (uint32 i = 1; i < count; i += 8) {
+			bits.putBits(3, 4);
+			for (uint32 j = i; j < MIN<uint32>(i + 8, count); j++) {
+				const uint32 delta = nextRandom(8);
+				bits.putBits(delta, 3);
+				if (delta) {
+					// Stay clear of overflows
+					const bool negative = v > 512;
+					bits.putBit(negative);
+					v += negative ? -(int)delta : delta;
+				}
+			}
+		}
+	}
+
+	void writeCoeff(BinkBitWriter &bits, int valueBits) {
+		bits.putBits(nextRandom(1 << valueBits), valueBits);
+		bits.putBit(nextRandom(2));
+	}
+
+	/** Mirrors BinkVideoTrack::readDCTCoeffs(), picking the coefficients at random. */
+	void writeDCTCoeffs(BinkBitWriter &bits) {
+		int listStart = 64;
+		int listEnd   = 64;
+
+		int coefList[128];      int modeList[128];
+		coefList[listEnd] = 4;  modeList[listEnd++] = 0;
+		coefList[listEnd] = 24; modeList[listEnd++] = 0;
+		coefList[listEnd] = 44; modeList[listEnd++] = 0;
+		coefList[listEnd] = 1;  modeList[listEnd++] = 3;
+		coefList[listEnd] = 2;  modeList[listEnd++] = 3;
+		coefList[listEnd] = 3;  modeList[listEnd++] = 3;
+
+		const int maxBits = 2;
+		bits.putBits(maxBits + 1, 4);
+		for (int valueBits = maxBits; valueBits >= 0; valueBits--) {
+			int listPos = listStart;
+
+			while (listPos < listEnd) {
+				if (!(modeList[listPos] | coefList[listPos])) {
+					listPos++;
+					continue;
+				}
+
+				const bool take = nextRandom(2);
+				bits.putBit(take);
+				if (!take) {
+					listPos++;
+					continue;
+				}
+
+				int ccoef = coefList[listPos];
+				int mode  = modeList[listPos];
+
+				switch (mode) {
+				case 0:
+					coefList[listPos] = ccoef + 4;
+					modeList[listPos] = 1;
+					// fall through
+				case 2:
+					if (mode == 2) {
+						coefList[listPos]   = 0;
+						modeList[listPos++] = 0;
+					}
+					for (int i = 0; i < 4; i++) {
+						bits.putBit(0);
+						writeCoeff(bits, valueBits);
+					}
+					break;
+
+				case 1:
+					modeList[listPos] = 2;
+					for (int i = 0; i < 3; i++) {
+						ccoef += 4;
+						coefList[listEnd]   = ccoef;
+						modeList[listEnd++] = 2;
+					}
+					break;
+
+				case 3:
+					writeCoeff(bits, valueBits);
+					coefList[listPos]   = 0;
+					modeList[listPos++] = 0;
+					break;
+
+				default:
+					break;
+				}
+			}
+		}
+
+		bits.putBits(nextRandom(4), 4); // quantizer
+	}
+
+	uint32 _seed;
+	Common::MemoryWriteStreamDynamic _data;
+};
+
+/**
+ * Decodes all frames of a synthetic Bink video, with or without the slice
+ * tasks.
+ */
+class BinkBenchmark {
+public:
+	BinkBenchmark(BinkStreamBuilder &builder, uint32 frameCount, bool sliceThreading) : _frameCount(frameCount) {
+		_decoder.setDefaultHighColorFormat(Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24));
+		_decoder.loadStream(builder.createReadStream());
+		_decoder.setSliceThreading(sliceThreading);
+	}
+
+	void operator()() {
+		_decoder.rewind();
+		for (uint32 i = 0; i < _frameCount; i++)
+			_decoder.decodeNextFrame();
+	}
+
+	Video::BinkDecoder &getDecoder() { return _decoder; }
+
+private:
+	Video::BinkDecoder _decoder;
+	uint32 _frameCount;
+};
+
+/**
+ * Transforms a row of DCT blocks into a plane, like an intra or inter
+ * frame does.
+ */
+class BinkIDCTBenchmark {
+public:
+	enum {
+		kBlockCount = 160
+	};
+
+	BinkIDCTBenchmark(const Video::BinkDSP &dsp, bool add) : _dsp(dsp), _add(add) {
+		uint32 seed = 1;
+		for (int i = 0; i < kBlockCount * 64; i++) {
+			seed = seed * 1103515245 + 12345;
+			// Mostly low frequencies, like real video
+			_coeffs[i] = ((i & 63) < 16) ? (int)((seed >> 8) & 255) - 128 : 0;
+		}
+		memset(_plane, 0, sizeof(_plane));
+	}
+
+	void operator()() {
+		for (int i = 0; i < kBlockCount; i++) {
+			if (_add)
+				_dsp.idctAdd(_plane + i * 8, kBlockCount * 8, _coeffs + i * 64);
+			else
+				_dsp.idctPut(_plane + i * 8, kBlockCount * 8, _coeffs + i * 64);
+		}
+	}
+
+private:
+	const Video::BinkDSP &_dsp;
+	bool _add;
+	int32 _coeffs[kBlockCount * 64];
+	byte _plane[kBlockCount * 64];
+};
+
+#endif
+
+class BinkBenchmarkSuite : public CxxTest::TestSuite {
+public:
+	enum {
+		kWidth = 1280,
+		kHeight = 720,
+		kFrameCount = 12,
+		kKeyFrameInterval = 6
+	};
+
+	void setUp() {
+		if (!g_system)
+			Common::install_null_g_system();
+	}
+
+	void test_decode_720p() {
+#ifdef USE_BINK
+		BinkStreamBuilder builder(kWidth, kHeight, kFrameCount, kKeyFrameInterval);
+
+		checkSliceThreading(builder);
+
+		BinkBenchmark serial(builder, kFrameCount, false);
+		reportBenchmark("bink", "decode_720p", benchmarkNanosPerCall(serial) / kFrameCount / 1000, "us/frame");
+
+		BinkBenchmark threaded(builder, kFrameCount, true);
+		reportBenchmark("bink", "decode_720p_slices", benchmarkNanosPerCall(threaded) / kFrameCount / 1000, "us/frame");
+#endif
+	}
+
+	void test_idct() {
+#ifdef USE_BINK
+		Video::BinkDSP reference;
+		Video::initBinkDSP(reference);
+
+		runIDCT("idct_put", reference, false);
+		runIDCT("idct_add", reference, true);
+		runIDCT("idct_put_simd", Video::getBinkDSP(), false);
+		runIDCT("idct_add_simd", Video::getBinkDSP(), true);
+#endif
+	}
+
+#ifdef USE_BINK
+private:
+	void runIDCT(const char *name, const Video::BinkDSP &dsp, bool add) {
+		BinkIDCTBenchmark benchmark(dsp, add);
+		reportBenchmark("bink", name, benchmarkNanosPerCall(benchmark) / BinkIDCTBenchmark::kBlockCount, "ns/block");
+	}
+
+	/** The slice tasks must not change the decoded frames. */
+	void checkSliceThreading(BinkStreamBuilder &builder) {
+		BinkBenchmark serial(builder, kFrameCount, false);
+		BinkBenchmark threaded(builder, kFrameCount, true);
+
+		for (uint32 i = 0; i < kFrameCount; i++) {
+			const Graphics::Surface *serialFrame = serial.getDecoder().decodeNextFrame();
+			const Graphics::Surface *threadedFrame = threaded.getDecoder().decodeNextFrame();
+			TS_ASSERT(serialFrame && threadedFrame);
+			if (!serialFrame || !threadedFrame)
+				return;
+
+			for (int y = 0; y < serialFrame->h; y++)
+				TS_ASSERT_EQUALS(memcmp(serialFrame->getBasePtr(0, y), threadedFrame->getBasePtr(0, y), serialFrame->w * serialFrame->format.bytesPerPixel), 0);
+		}
+	}
+#endif
+};
@@ -0,0 +1,154 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/memstream.h"
+#include "common/str-array.h"
+
+/**
+ * Archive which contains a fixed set of empty files, and counts how often
+ * it is asked for them.
+ */
+class CountingArchive : public Common::Archive {
+public:
+	CountingArchive(const char *file1, const char *file2 = nullptr) : _lookups(0) {
+		_files.push_back(file1);
+		if (file2)
+			_files.push_back(file2);
+	}
+
+	bool hasFile(const Common::Path &path) const override {
+		_lookups++;
+		for (uint i = 0; i < _files.size(); ++i)
+			if (path.toString().equalsIgnoreCase(_files[i]))
+				return true;
+		return false;
+	}
+
+	int listMembers(Common::ArchiveMemberList &list) const override {
+		for (uint i = 0; i < _files.size(); ++i)
+			list.push_back(Common::ArchiveMemberPtr(new Common::GenericArchiveMember(_files[i], this)));
+		return _files.size();
+	}
+
+	const Common::ArchiveMemberPtr getMember(const Common::Path &path) const override {
+		if (!hasFile(path))
+			return Common::ArchiveMemberPtr();
+		return Common::ArchiveMemberPtr(new Common::GenericArchiveMember(path.toString(), this));
+	}
+
+	Common::SeekableReadStream *createReadStreamForMember(const Common::Path &path) const override {
+		if (!hasFile(path))
+			return nullptr;
+		return new Common::MemoryReadStream(nullptr, 0);
+	}
+
+	mutable int _lookups;
+
+private:
+	Common::StringArray _files;
+};
+
+class SearchSetTestSuite : public CxxTest::TestSuite
+{
+	public:
+	void test_lookup_cache() {
+		Common::SearchSet set;
+		CountingArchive *high = new CountingArchive("a.dat");
+		CountingArchive *low = new CountingArchive("a.dat", "b.dat");
+		set.add("high", high, 1);
+		set.add("low", low, 0);
+
+		TS_ASSERT(set.hasFile("b.dat"));
+		TS_ASSERT(!set.hasFile("c.dat"));
+		const int highLookups = high->_lookups;
+		const int lowLookups = low->_lookups;
+
+		// Repeated lookups are answered from the cache, both positive and
+		// negative ones
+		for (int i = 0; i < 10; ++i) {
+			TS_ASSERT(set.hasFile("b.dat"));
+			TS_ASSERT(!set.hasFile("c.dat"));
+		}
+		TS_ASSERT_EQUALS(high->_lookups, highLookups);
+		TS_ASSERT_EQUALS(low->_lookups, lowLookups);
+
+		// The cached archive is asked directly when opening the file
+		Common::SeekableReadStream *stream = set.createReadStreamForMember("b.dat");
+		TS_ASSERT(stream);
+		delete stream;
+		TS_ASSERT_EQUALS(high->_lookups, highLookups);
+		TS_ASSERT_EQUALS(low->_lookups, lowLookups + 1);
+	}
+
+	void test_lookup_cache_invalidation() {
+		Common::SearchSet set;
+		set.add("first", new CountingArchive("a.dat"));
+		TS_ASSERT(!set.hasFile("b.dat"));
+
+		// Adding an archive has to drop the negative result
+		set.add("second", new CountingArchive("b.dat"));
+		TS_ASSERT(set.hasFile("b.dat"));
+
+		// Removing it has to drop the positive one
+		set.remove("second");
+		TS_ASSERT(!set.hasFile("b.dat"));
+		TS_ASSERT(set.hasFile("a.dat"));
+
+		set.clear();
+		TS_ASSERT(!set.hasFile("a.dat"));
+	}
+
+	void test_lookup_cache_priority() {
+		Common::SearchSet set;
+		CountingArchive *first = new CountingArchive("a.dat");
+		CountingArchive *second = new CountingArchive("a.dat");
+		set.add("first", first, 1);
+		set.add("second", second, 0);
+
+		TS_ASSERT(set.hasFile("a.dat"));
+		TS_ASSERT_EQUALS(first->_lookups, 1);
+		TS_ASSERT_EQUALS(second->_lookups, 0);
+
+		// After reordering, the file has to come from the other archive
+		set.setPriority("second", 2);
+		Common::SeekableReadStream *stream = set.createReadStreamForMember("a.dat");
+		delete stream;
+		TS_ASSERT_EQUALS(first->_lookups, 1);
+		TS_ASSERT_EQUALS(second->_lookups, 1);
+	}
+
+	void test_lookup_cache_nested() {
+		// Like the Kyra resource manager, which keeps the archives it loads
+		// in sets nested in the one it searches
+		Common::SearchSet files;
+		Common::SearchSet *archives = new Common::SearchSet();
+		Common::SearchSet *inner = new Common::SearchSet();
+		archives->add("inner", inner);
+		files.add("archives", archives);
+		files.add("base", new CountingArchive("a.dat"), -1);
+
+		TS_ASSERT(!files.hasFile("b.dat"));
+		TS_ASSERT(files.hasFile("a.dat"));
+
+		// Loading an archive into the nested sets has to drop the negative result
+		CountingArchive *pak = new CountingArchive("a.dat", "b.dat");
+		inner->add("pak", pak);
+		TS_ASSERT(files.hasFile("b.dat"));
+
+		// and the file has to come from the archive now searched first
+		Common::SeekableReadStream *stream = files.createReadStreamForMember("a.dat");
+		delete stream;
+		TS_ASSERT_EQUALS(pak->_lookups, 2);
+
+		// Unloading it has to drop the positive results
+		inner->remove("pak");
+		TS_ASSERT(!files.hasFile("b.dat"));
+		TS_ASSERT(files.hasFile("a.dat"));
+
+		// The same goes for whole nested sets
+		inner->add("pak", new CountingArchive("b.dat"));
+		TS_ASSERT(files.hasFile("b.dat"));
+		archives->remove("inner");
+		TS_ASSERT(!files.hasFile("b.dat"));
+	}
+};
@@ -0,0 +1,86 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/dir-scanner.h"
+#include "common/str-array.h"
+#include "common/system.h"
+#include "common/threadpool.h"
+
+#include "../null_osystem.h"
+
+class DirectoryScannerTestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+		if (!g_system)
+			Common::install_null_g_system();
+	}
+
+	void test_depth_first_order() {
+		const Common::FSNode root = createTree();
+		if (!root.isDirectory())
+			return;
+
+		Common::StringArray plain = scan(root, nullptr);
+		TS_ASSERT_EQUALS(plain.size(), 7u);
+		if (plain.size() != 7)
+			return;
+
+		// Each directory comes before its subdirectories, and those are
+		// visited by name, no matter in which order they were created
+		TS_ASSERT_EQUALS(plain[0], "dirscanner_tree");
+		TS_ASSERT_EQUALS(plain[1], "a");
+		TS_ASSERT_EQUALS(plain[2], "a1");
+		TS_ASSERT_EQUALS(plain[3], "a2");
+		TS_ASSERT_EQUALS(plain[4], "b");
+		TS_ASSERT_EQUALS(plain[5], "b1");
+		TS_ASSERT_EQUALS(plain[6], "c");
+
+		// Listing directories ahead of time does not change the order
+		Common::ThreadPool pool;
+		Common::StringArray prefetched = scan(root, &pool);
+		TS_ASSERT_EQUALS(prefetched.size(), plain.size());
+		for (uint i = 0; i < prefetched.size() && i < plain.size(); ++i)
+			TS_ASSERT_EQUALS(prefetched[i], plain[i]);
+	}
+
+	void test_max_depth() {
+		const Common::FSNode root = createTree();
+		if (!root.isDirectory())
+			return;
+
+		Common::StringArray names = scan(root, nullptr, 0);
+		TS_ASSERT_EQUALS(names.size(), 1u);
+
+		names = scan(root, nullptr, 1);
+		TS_ASSERT_EQUALS(names.size(), 4u);
+	}
+
+private:
+	/**
+	 * Create a small directory tree in the build directory, with the
+	 * directories created out of order.
+	 */
+	static Common::FSNode createTree() {
+		Common::FSNode root("dirscanner_tree");
+		if (!root.exists())
+			root.createDirectory();
+		root = Common::FSNode(root.getPath());
+
+		static const char *const paths[] = { "c", "b", "b/b1", "a", "a/a2", "a/a1" };
+		for (uint i = 0; i < ARRAYSIZE(paths); ++i) {
+			Common::FSNode dir(root.getPath() + "/" + paths[i]);
+			if (!dir.exists())
+				dir.createDirectory();
+		}
+		return root;
+	}
+
+	static Common::StringArray scan(const Common::FSNode &root, Common::ThreadPool *pool, int maxDepth = -1) {
+		Common::DirectoryScanner scanner(root, maxDepth, pool);
+		Common::StringArray names;
+		Common::FSNode dir;
+		Common::FSList contents;
+		while (scanner.nextDirectory(dir, contents))
+			names.push_back(dir.getName());
+		return names;
+	}
+};
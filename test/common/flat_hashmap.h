@@ -0,0 +1,167 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/flat-hashmap.h"
+#include "common/hash-str.h"
+
+/** Hash function which maps every key to the same value */
+struct ConstantHash {
+	uint operator()(int) const { return 42; }
+};
+
+class FlatHashMapTestSuite : public CxxTest::TestSuite
+{
+	public:
+	void test_empty_clear() {
+		Common::FlatHashMap<int, int> container;
+		TS_ASSERT(container.empty());
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(!container.empty());
+		container.clear();
+		TS_ASSERT(container.empty());
+
+		Common::FlatHashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> container2;
+		TS_ASSERT(container2.empty());
+		container2["foo"] = "bar";
+		container2["quux"] = "blub";
+		TS_ASSERT(!container2.empty());
+		TS_ASSERT_EQUALS(container2["FOO"], "bar");
+		container2.clear(true);
+		TS_ASSERT(container2.empty());
+	}
+
+	void test_add_remove() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+		TS_ASSERT(container.contains(1));
+		container.erase(1);
+		TS_ASSERT(!container.contains(1));
+		container[1] = 42;
+		TS_ASSERT(container.contains(1));
+		TS_ASSERT_EQUALS(container[1], 42);
+		container.erase(container.find(1));
+		TS_ASSERT(!container.contains(1));
+		TS_ASSERT_EQUALS(container.size(), 4u);
+
+		// Erasing a missing key is fine
+		container.erase(1);
+		TS_ASSERT_EQUALS(container.size(), 4u);
+	}
+
+	void test_lookup_with_default() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = -1;
+
+		const Common::FlatHashMap<int, int> &containerRef = container;
+
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(0), 17);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(17), 0);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(0, -10), 17);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(17, -10), -10);
+
+		int val = 0;
+		TS_ASSERT(containerRef.tryGetVal(1, val));
+		TS_ASSERT_EQUALS(val, -1);
+		TS_ASSERT(!containerRef.tryGetVal(2, val));
+		TS_ASSERT(containerRef.find(2) == containerRef.end());
+	}
+
+	void test_copy() {
+		Common::FlatHashMap<int, Common::String> map1, map2;
+		for (int i = 0; i < 100; ++i)
+			map1[i * 7] = Common::String::format("%d", i);
+
+		map2 = map1;
+		Common::FlatHashMap<int, Common::String> map3(map1);
+		map1.clear();
+
+		for (int i = 0; i < 100; ++i) {
+			TS_ASSERT_EQUALS(map2[i * 7], Common::String::format("%d", i));
+			TS_ASSERT_EQUALS(map3[i * 7], Common::String::format("%d", i));
+		}
+		TS_ASSERT_EQUALS(map2.size(), 100u);
+	}
+
+	void test_collision() {
+		// Keys which only differ in the upper bits, and keys which all have
+		// the very same hash
+		Common::FlatHashMap<int, int> h;
+		for (int i = 0; i < 64; ++i)
+			h[i << 16] = i;
+
+		Common::FlatHashMap<int, int, ConstantHash> c;
+		for (int i = 0; i < 64; ++i)
+			c[i] = i;
+
+		for (int i = 0; i < 64; i += 2) {
+			h.erase(i << 16);
+			c.erase(i);
+		}
+
+		for (int i = 0; i < 64; ++i) {
+			TS_ASSERT_EQUALS(h.contains(i << 16), (i & 1) != 0);
+			TS_ASSERT_EQUALS(c.contains(i), (i & 1) != 0);
+			if (i & 1) {
+				TS_ASSERT_EQUALS(h[i << 16], i);
+				TS_ASSERT_EQUALS(c[i], i);
+			}
+		}
+	}
+
+	void test_erase_while_iterating() {
+		Common::FlatHashMap<int, int> container;
+		for (int i = 0; i < 1000; ++i)
+			container[i] = i;
+
+		// Erasing the current element must neither skip nor repeat others
+		int visited = 0;
+		for (Common::FlatHashMap<int, int>::iterator i = container.begin(); i != container.end(); ++i) {
+			visited++;
+			if (i->_key % 3)
+				container.erase(i);
+		}
+		TS_ASSERT_EQUALS(visited, 1000);
+		TS_ASSERT_EQUALS(container.size(), 334u);
+
+		visited = 0;
+		for (Common::FlatHashMap<int, int>::const_iterator i = container.begin(); i != container.end(); ++i) {
+			TS_ASSERT_EQUALS(i->_key % 3, 0);
+			TS_ASSERT_EQUALS(i->_value, i->_key);
+			visited++;
+		}
+		TS_ASSERT_EQUALS(visited, 334);
+	}
+
+	void test_against_hashmap() {
+		// Random inserts and erases, compared to the regular HashMap
+		uint32 seed = 1;
+		Common::FlatHashMap<Common::String, int> flat;
+		Common::HashMap<Common::String, int> reference;
+
+		for (int i = 0; i < 20000; ++i) {
+			seed = seed * 1103515245 + 12345;
+			const Common::String key = Common::String::format("key%u", (seed >> 16) % 2000);
+			if (seed & 0x80000000) {
+				flat[key] = i;
+				reference[key] = i;
+			} else {
+				flat.erase(key);
+				reference.erase(key);
+			}
+		}
+
+		TS_ASSERT_EQUALS(flat.size(), reference.size());
+		for (Common::HashMap<Common::String, int>::const_iterator i = reference.begin(); i != reference.end(); ++i)
+			TS_ASSERT_EQUALS(flat.getValOrDefault(i->_key, -1), i->_value);
+
+		uint count = 0;
+		for (Common::FlatHashMap<Common::String, int>::const_iterator i = flat.begin(); i != flat.end(); ++i, ++count)
+			TS_ASSERT(reference.contains(i->_key));
+		TS_ASSERT_EQUALS(count, reference.size());
+	}
+};
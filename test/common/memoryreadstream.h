@@ -104,4 +104,13 @@ class MemoryReadStreamTestSuite : public CxxTest::TestSuite {
 		ms.seek(0, SEEK_SET);
 		TS_ASSERT(!ms.eos());
 	}
+
+	void test_get_buffer() {
+		byte contents[] = { 1, 2, 3, 4, 5, 6, 7 };
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+
+		// The buffer always starts at the beginning of the stream
+		ms.seek(3);
+		TS_ASSERT_EQUALS(ms.getBuffer(), contents);
+	}
 };
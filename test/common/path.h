@@ -0,0 +1,57 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/path.h"
+
+class PathTestSuite : public CxxTest::TestSuite
+{
+	public:
+	void test_hash_ignore_case() {
+		Common::Path p1("Data/File.DAT");
+		Common::Path p2("data/file.dat");
+		Common::Path p3("data/file.dat", '\\');
+		TS_ASSERT_EQUALS(p1.hashIgnoreCase(), p2.hashIgnoreCase());
+		TS_ASSERT(p1.equalsIgnoreCase(p2));
+		TS_ASSERT(p1 != p2);
+
+		// Different separators give different paths
+		TS_ASSERT(!p2.equalsIgnoreCase(p3));
+	}
+
+	void test_hash_follows_changes() {
+		Common::Path path("data");
+		const uint dataHash = path.hashIgnoreCase();
+
+		path.joinInPlace("file.dat");
+		TS_ASSERT_EQUALS(path.hashIgnoreCase(), Common::Path("DATA/FILE.DAT").hashIgnoreCase());
+		TS_ASSERT_DIFFERS(path.hashIgnoreCase(), dataHash);
+
+		path.appendInPlace(".bak");
+		TS_ASSERT_EQUALS(path.hashIgnoreCase(), Common::Path("data/file.dat.bak").hashIgnoreCase());
+
+		path = "data";
+		TS_ASSERT_EQUALS(path.hashIgnoreCase(), dataHash);
+
+		// Copies keep the hash
+		Common::Path copy(path);
+		TS_ASSERT_EQUALS(copy.hashIgnoreCase(), dataHash);
+		copy.set("other");
+		TS_ASSERT_EQUALS(copy.hashIgnoreCase(), Common::Path("OTHER").hashIgnoreCase());
+	}
+
+	void test_interner() {
+		Common::PathInterner interner;
+
+		const Common::Path &p1 = interner.intern(Common::Path("data/file.dat"));
+		const Common::Path &p2 = interner.intern(Common::Path("data/file.dat"));
+		const Common::Path &p3 = interner.intern(Common::Path("DATA/FILE.DAT"));
+
+		// Equal paths are only stored once, different cases are kept apart
+		TS_ASSERT_EQUALS(&p1, &p2);
+		TS_ASSERT_DIFFERS(&p1, &p3);
+		TS_ASSERT_EQUALS(p3, Common::Path("DATA/FILE.DAT"));
+		TS_ASSERT_EQUALS(interner.size(), 2u);
+
+		interner.clear();
+		TS_ASSERT_EQUALS(interner.size(), 0u);
+	}
+};
@@ -70,4 +70,17 @@ class SeekableSubReadStreamTestSuite : public CxxTest::TestSuite {
 		b = ssrs.readByte();
 		TS_ASSERT_EQUALS(b, 1);
 	}
+
+	void test_get_buffer() {
+		byte contents[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+		Common::MemoryReadStream ms(contents, 10);
+
+		Common::SeekableSubReadStream ssrs(&ms, 2, 8);
+		TS_ASSERT_EQUALS(ssrs.getBuffer(), contents + 2);
+
+		// A substream reaching past the end of its parent must not expose
+		// memory beyond it
+		Common::SeekableSubReadStream tooLong(&ms, 2, 12);
+		TS_ASSERT(tooLong.getBuffer() == nullptr);
+	}
 };
@@ -0,0 +1,61 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/spsc-queue.h"
+
+class SPSCQueueTestSuite : public CxxTest::TestSuite {
+public:
+	void test_push_pop() {
+		Common::SPSCQueue<int, 4> queue;
+		int x = -1;
+
+		TS_ASSERT(queue.empty());
+		TS_ASSERT(!queue.pop(x));
+		TS_ASSERT_EQUALS(x, -1);
+
+		TS_ASSERT(queue.push(1));
+		TS_ASSERT(queue.push(2));
+		TS_ASSERT(!queue.empty());
+
+		TS_ASSERT(queue.pop(x));
+		TS_ASSERT_EQUALS(x, 1);
+		TS_ASSERT(queue.pop(x));
+		TS_ASSERT_EQUALS(x, 2);
+		TS_ASSERT(queue.empty());
+	}
+
+	void test_full() {
+		Common::SPSCQueue<int, 4> queue;
+		int x;
+
+		for (int i = 0; i < 4; ++i)
+			TS_ASSERT(queue.push(i));
+		TS_ASSERT(queue.full());
+		TS_ASSERT(!queue.push(4));
+
+		TS_ASSERT(queue.pop(x));
+		TS_ASSERT_EQUALS(x, 0);
+		TS_ASSERT(!queue.full());
+		TS_ASSERT(queue.push(4));
+
+		for (int i = 1; i <= 4; ++i) {
+			TS_ASSERT(queue.pop(x));
+			TS_ASSERT_EQUALS(x, i);
+		}
+		TS_ASSERT(queue.empty());
+	}
+
+	void test_wrap_around() {
+		Common::SPSCQueue<int, 8> queue;
+		int x;
+
+		// Go round the ring several times with varying fill levels
+		int next = 0, expected = 0;
+		for (int round = 0; round < 100; ++round) {
+			for (int i = 0; i < round % 8 + 1; ++i)
+				TS_ASSERT(queue.push(next++));
+			while (queue.pop(x))
+				TS_ASSERT_EQUALS(x, expected++);
+		}
+		TS_ASSERT_EQUALS(next, expected);
+	}
+};
@@ -0,0 +1,121 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/atomic.h"
+#include "common/system.h"
+#include "common/threadpool.h"
+#include "../null_osystem.h"
+
+class ThreadPoolTestSuite : public CxxTest::TestSuite
+{
+public:
+	void setUp() {
+		if (!g_system)
+			Common::install_null_g_system();
+	}
+
+	void test_future() {
+		Common::ThreadPool pool(4);
+
+		Common::Future<int> futures[16];
+		for (int i = 0; i < 16; ++i) {
+			futures[i] = pool.async([i]() {
+				int sum = 0;
+				for (int j = 0; j <= i * 1000; ++j)
+					sum += j & 0xFF;
+				return sum;
+			});
+		}
+
+		for (int i = 0; i < 16; ++i) {
+			int sum = 0;
+			for (int j = 0; j <= i * 1000; ++j)
+				sum += j & 0xFF;
+			TS_ASSERT_EQUALS(futures[i].get(), sum);
+			TS_ASSERT(futures[i].isReady());
+		}
+
+		Common::Future<int> invalid;
+		TS_ASSERT(!invalid.isValid());
+		TS_ASSERT(invalid.isReady());
+	}
+
+	void test_task_group() {
+		Common::ThreadPool pool(4);
+		Common::Atomic<int> counter(0);
+		int results[100];
+
+		{
+			Common::TaskGroup group(pool);
+			for (int i = 0; i < 100; ++i) {
+				int *result = &results[i];
+				group.run([&counter, result, i]() {
+					*result = i * i;
+					counter.fetchAdd(1);
+				});
+			}
+			TS_ASSERT_EQUALS(group.size(), 100u);
+			group.wait();
+			TS_ASSERT_EQUALS(group.size(), 0u);
+			TS_ASSERT_EQUALS(counter.load(), 100);
+		}
+
+		for (int i = 0; i < 100; ++i)
+			TS_ASSERT_EQUALS(results[i], i * i);
+	}
+
+	void test_nested_wait() {
+		// Every worker waits for tasks queued behind it, which only works
+		// because waiting threads run queued tasks themselves
+		Common::ThreadPool pool(2);
+		Common::Atomic<int> counter(0);
+
+		{
+			Common::TaskGroup outer(pool);
+			for (int i = 0; i < 8; ++i) {
+				outer.run([&pool, &counter]() {
+					Common::TaskGroup inner(pool);
+					for (int j = 0; j < 8; ++j)
+						inner.run([&counter]() { counter.fetchAdd(1); });
+				});
+			}
+		}
+
+		TS_ASSERT_EQUALS(counter.load(), 64);
+	}
+
+	void test_task_resubmit() {
+		class CountTask : public Common::ThreadPoolTask {
+		public:
+			CountTask() : _count(0) {}
+			void run() override { ++_count; }
+			int _count;
+		};
+
+		Common::ThreadPool pool(2);
+		CountTask task;
+		TS_ASSERT(task.isDone());
+		for (int i = 0; i < 10; ++i) {
+			pool.submit(&task);
+			pool.wait(&task);
+			TS_ASSERT(task.isDone());
+		}
+		TS_ASSERT_EQUALS(task._count, 10);
+	}
+
+	void test_shared_pool() {
+		Common::ThreadPool &pool = g_system->getThreadPool();
+		TS_ASSERT_EQUALS(&pool, &g_system->getThreadPool());
+
+		// Users of the shared pool nest, e.g. a video decoded ahead on a
+		// worker splits its frames into slices on the same pool
+		Common::Atomic<int> counter(0);
+		Common::Future<int> outer = pool.async([&pool, &counter]() {
+			Common::TaskGroup inner(pool);
+			for (int i = 0; i < 8; ++i)
+				inner.run([&counter]() { counter.fetchAdd(1); });
+			inner.wait();
+			return counter.load();
+		});
+		TS_ASSERT_EQUALS(outer.get(), 8);
+	}
+};
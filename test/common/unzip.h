@@ -0,0 +1,217 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/memstream.h"
+#include "common/unzip.h"
+
+/**
+ * Builds ZIP files in memory. Deflated members are written as uncompressed
+ * deflate blocks, which exercises the inflate code without needing a
+ * compressor.
+ */
+class ZipBuilder {
+public:
+	ZipBuilder() : _data(DisposeAfterUse::NO), _centralDir(DisposeAfterUse::YES), _count(0) {}
+
+	/**
+	 * Add a member. Members which are not deflated can be labelled with any
+	 * compression method, to check that unsupported ones are turned down.
+	 */
+	void add(const char *name, const byte *contents, uint32 size, bool deflate, uint16 method = 0) {
+		if (deflate)
+			method = 8;
+
+		Common::MemoryWriteStreamDynamic compressed(DisposeAfterUse::YES);
+		if (deflate) {
+			uint32 done = 0;
+			do {
+				const uint32 block = MIN<uint32>(size - done, 0xFFFF);
+				compressed.writeByte(done + block == size ? 1 : 0);
+				compressed.writeUint16LE(block);
+				compressed.writeUint16LE(~block);
+				compressed.write(contents + done, block);
+				done += block;
+			} while (done < size);
+		} else {
+			compressed.write(contents, size);
+		}
+
+		const uint32 checksum = crc32(contents, size);
+		const uint32 offset = _data.pos();
+		const uint16 nameLength = strlen(name);
+
+		_data.writeUint32LE(0x04034b50);
+		writeCommonHeader(_data, method, checksum, compressed.size(), size, nameLength);
+		_data.write(name, nameLength);
+		_data.write(compressed.getData(), compressed.size());
+
+		_centralDir.writeUint32LE(0x02014b50);
+		_centralDir.writeUint16LE(20);
+		writeCommonHeader(_centralDir, method, checksum, compressed.size(), size, nameLength);
+		_centralDir.writeUint16LE(0); // comment length
+		_centralDir.writeUint16LE(0); // disk number
+		_centralDir.writeUint16LE(0); // internal attributes
+		_centralDir.writeUint32LE(0); // external attributes
+		_centralDir.writeUint32LE(offset);
+		_centralDir.write(name, nameLength);
+
+		++_count;
+	}
+
+	/** Finish the archive and open it. */
+	Common::Archive *open() {
+		const uint32 centralDirOffset = _data.pos();
+		_data.write(_centralDir.getData(), _centralDir.size());
+
+		_data.writeUint32LE(0x06054b50);
+		_data.writeUint16LE(0);
+		_data.writeUint16LE(0);
+		_data.writeUint16LE(_count);
+		_data.writeUint16LE(_count);
+		_data.writeUint32LE(_centralDir.size());
+		_data.writeUint32LE(centralDirOffset);
+		_data.writeUint16LE(0);
+
+		return Common::makeZipArchive(new Common::MemoryReadStream(_data.getData(), _data.size(), DisposeAfterUse::YES));
+	}
+
+private:
+	static uint32 crc32(const byte *data, uint32 size) {
+		uint32 crc = 0xFFFFFFFF;
+		for (uint32 i = 0; i < size; ++i) {
+			crc ^= data[i];
+			for (int bit = 0; bit < 8; ++bit)
+				crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+		}
+		return ~crc;
+	}
+
+	static void writeCommonHeader(Common::WriteStream &stream, uint16 method, uint32 crc, uint32 compressedSize, uint32 size, uint16 nameLength) {
+		stream.writeUint16LE(20); // version needed
+		stream.writeUint16LE(0); // flags
+		stream.writeUint16LE(method);
+		stream.writeUint32LE(0); // date and time
+		stream.writeUint32LE(crc);
+		stream.writeUint32LE(compressedSize);
+		stream.writeUint32LE(size);
+		stream.writeUint16LE(nameLength);
+		stream.writeUint16LE(0); // extra field length
+	}
+
+	Common::MemoryWriteStreamDynamic _data;
+	Common::MemoryWriteStreamDynamic _centralDir;
+	uint16 _count;
+};
+
+class UnzipTestSuite : public CxxTest::TestSuite {
+public:
+	UnzipTestSuite() {
+		for (uint32 i = 0; i < kBigSize; ++i)
+			_big[i] = (byte)(i * 7 + (i >> 9));
+	}
+
+	void test_index() {
+		ZipBuilder builder;
+		builder.add("small.txt", (const byte *)"hello", 5, false);
+		builder.add("dir/Other.txt", (const byte *)"world", 5, false);
+		Common::Archive *archive = builder.open();
+		TS_ASSERT(archive);
+
+		TS_ASSERT(archive->hasFile("small.txt"));
+		TS_ASSERT(archive->hasFile("DIR/OTHER.TXT"));
+		TS_ASSERT(!archive->hasFile("missing.txt"));
+
+		Common::ArchiveMemberList list;
+		TS_ASSERT_EQUALS(archive->listMembers(list), 2);
+
+		Common::SeekableReadStream *stream = archive->createReadStreamForMember("dir/other.txt");
+		TS_ASSERT(stream);
+		if (stream) {
+			TS_ASSERT_EQUALS(stream->size(), 5);
+			TS_ASSERT_EQUALS(stream->readUint32BE(), MKTAG('w', 'o', 'r', 'l'));
+			delete stream;
+		}
+
+		delete archive;
+	}
+
+#ifdef USE_ZLIB
+	void test_streamed_deflated_member() {
+		ZipBuilder builder;
+		builder.add("big.bin", _big, kBigSize, true);
+		Common::Archive *archive = builder.open();
+		Common::SeekableReadStream *stream = archive->createReadStreamForMember("big.bin");
+		TS_ASSERT(stream);
+		TS_ASSERT_EQUALS(stream->size(), kBigSize);
+
+		// The stream must stay usable once the archive is gone
+		delete archive;
+
+		byte buffer[1000];
+		TS_ASSERT_EQUALS(stream->read(buffer, sizeof(buffer)), sizeof(buffer));
+		TS_ASSERT_EQUALS(memcmp(buffer, _big, sizeof(buffer)), 0);
+
+		TS_ASSERT(stream->seek(kBigSize - 500));
+		TS_ASSERT_EQUALS(stream->read(buffer, sizeof(buffer)), 500u);
+		TS_ASSERT(stream->eos());
+		TS_ASSERT_EQUALS(memcmp(buffer, _big + kBigSize - 500, 500), 0);
+
+		TS_ASSERT(stream->seek(100000));
+		TS_ASSERT_EQUALS(stream->read(buffer, sizeof(buffer)), sizeof(buffer));
+		TS_ASSERT_EQUALS(memcmp(buffer, _big + 100000, sizeof(buffer)), 0);
+
+		TS_ASSERT(!stream->err());
+		TS_ASSERT(stream->getBuffer());
+		TS_ASSERT_EQUALS(memcmp(stream->getBuffer(), _big, kBigSize), 0);
+
+		delete stream;
+	}
+#endif
+
+	void test_streamed_stored_member() {
+		ZipBuilder builder;
+		builder.add("small.txt", (const byte *)"hello", 5, false);
+		builder.add("big.bin", _big, kBigSize, false);
+		Common::Archive *archive = builder.open();
+
+		Common::SeekableReadStream *first = archive->createReadStreamForMember("big.bin");
+		Common::SeekableReadStream *second = archive->createReadStreamForMember("big.bin");
+		TS_ASSERT(first && second);
+
+		// Streams of the same archive read independently of each other
+		first->seek(200000);
+		TS_ASSERT_EQUALS(first->readByte(), _big[200000]);
+		TS_ASSERT_EQUALS(second->readByte(), _big[0]);
+		TS_ASSERT_EQUALS(first->readByte(), _big[200001]);
+
+		first->seek(0, SEEK_END);
+		first->readByte();
+		TS_ASSERT(first->eos());
+		first->clearErr();
+		TS_ASSERT(!first->eos() && !first->err());
+
+		delete first;
+		delete second;
+		delete archive;
+	}
+
+	void test_unsupported_method() {
+		// bzip2 and LZMA, for small and streamed members
+		ZipBuilder builder;
+		builder.add("small.bz2", (const byte *)"hello", 5, false, 12);
+		builder.add("big.lzma", _big, kBigSize, false, 14);
+		Common::Archive *archive = builder.open();
+		TS_ASSERT(archive->hasFile("small.bz2"));
+		TS_ASSERT(archive->hasFile("big.lzma"));
+		TS_ASSERT(!archive->createReadStreamForMember("small.bz2"));
+		TS_ASSERT(!archive->createReadStreamForMember("big.lzma"));
+		delete archive;
+	}
+
+private:
+	enum {
+		kBigSize = 300 * 1024
+	};
+
+	byte _big[kBigSize];
+};
@@ -0,0 +1,180 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/system.h"
+#include "common/threadpool.h"
+#include "engines/sci/graphics/celobj32.h"
+#include "engines/sci/graphics/celobj32_dsp.h"
+
+#include "../../null_osystem.h"
+
+/**
+ * A cel whose pixels are already decompressed, like the ones from the cel
+ * cache, so that it can be drawn without any resources.
+ */
+class TestCelObj : public Sci::CelObj {
+public:
+	TestCelObj(int16 width, int16 height, uint8 skipColor, bool transparent, uint32 seed) {
+		_info.type = Sci::kCelTypeMem;
+		_celHeaderOffset = 0;
+		_hunkPaletteOffset = 0;
+		_width = width;
+		_height = height;
+		_xResolution = 320;
+		_yResolution = 200;
+		_skipColor = skipColor;
+		_transparent = transparent;
+		_compressionType = Sci::kCelCompressionNone;
+		_remap = false;
+		_mirrorX = false;
+		_isMacSource = false;
+
+		Sci::Buffer *pixels = new Sci::Buffer();
+		pixels->create(width, height, Graphics::PixelFormat::createFormatCLUT8());
+		byte *pixel = (byte *)pixels->getPixels();
+		for (int i = 0; i < width * height; ++i) {
+			seed = seed * 1103515245 + 12345;
+			pixel[i] = (seed >> 16) % 5 == 0 ? skipColor : (byte)(seed >> 8);
+		}
+		_decompressedPixels = Common::SharedPtr<Sci::Buffer>(pixels, Graphics::SurfaceDeleter());
+	}
+
+	CelObj *duplicate() const override { return new TestCelObj(*this); }
+	const Sci::SciSpan<const byte> getResPointer() const override { return Sci::SciSpan<const byte>(); }
+};
+
+/**
+ * Compares the SIMD row kernels of the SCI32 cel renderer against the C++
+ * one, and cels drawn in tiles against cels drawn in one piece, which have
+ * to give exactly the same pixels.
+ */
+class CelObj32TestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+		if (!g_system)
+			Common::install_null_g_system();
+		Sci::CelObj::init();
+	}
+
+	void tearDown() {
+		Sci::CelObj::deinit();
+	}
+
+	void test_row_kernels() {
+		Sci::CelObjDSP dsp;
+		Sci::initCelObjDSP(dsp);
+		checkKernels(dsp);
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasCpuFeature(OSystem::kCpuFeatureSSE2)) {
+			Sci::initCelObjDSP(dsp);
+			Sci::initCelObjDSPSSE2(dsp);
+			checkKernels(dsp);
+		}
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasCpuFeature(OSystem::kCpuFeatureAVX2)) {
+			Sci::initCelObjDSP(dsp);
+			Sci::initCelObjDSPAVX2(dsp);
+			checkKernels(dsp);
+		}
+#endif
+	}
+
+	void test_tiled_draw() {
+		// Overlapping cels, some clipped by the edges of the target, and
+		// tiles whose height does not divide the target height
+		TestCelObj cels[] = {
+			TestCelObj(53, 37, 0, true, 1),
+			TestCelObj(29, 61, 255, true, 2),
+			TestCelObj(41, 23, 7, false, 3),
+			TestCelObj(70, 15, 0, true, 4)
+		};
+		const Common::Point positions[] = {
+			Common::Point(-5, 3), Common::Point(30, -9), Common::Point(12, 20), Common::Point(-2, 50)
+		};
+		const bool mirrored[] = { false, true, false, true };
+
+		Sci::Buffer serial, tiled;
+		serial.create(kWidth, kHeight, Graphics::PixelFormat::createFormatCLUT8());
+		tiled.create(kWidth, kHeight, Graphics::PixelFormat::createFormatCLUT8());
+		fillTarget(serial);
+		fillTarget(tiled);
+
+		// Drawn like GfxFrameout draws screen items when it is not tiling
+		for (uint i = 0; i < ARRAYSIZE(cels); ++i) {
+			cels[i].prepareDrawPart(mirrored[i]);
+			cels[i].drawPart(serial, getDrawRect(cels[i], positions[i]), positions[i], Sci::Ratio(), Sci::Ratio());
+			cels[i].finishDrawPart();
+		}
+
+		for (uint i = 0; i < ARRAYSIZE(cels); ++i)
+			cels[i].prepareDrawPart(mirrored[i]);
+		{
+			Common::ThreadPool pool;
+			Common::TaskGroup tasks(pool);
+			for (int16 top = 0; top < kHeight; top += kTileHeight) {
+				const Common::Rect tile(0, top, kWidth, MIN<int16>(top + kTileHeight, kHeight));
+				tasks.run([&cels, &positions, &tiled, tile]() {
+					for (uint i = 0; i < ARRAYSIZE(cels); ++i) {
+						const Common::Rect drawRect = getDrawRect(cels[i], positions[i]).findIntersectingRect(tile);
+						if (!drawRect.isEmpty())
+							cels[i].drawPart(tiled, drawRect, positions[i], Sci::Ratio(), Sci::Ratio());
+					}
+				});
+			}
+		}
+		for (uint i = 0; i < ARRAYSIZE(cels); ++i)
+			cels[i].finishDrawPart();
+
+		for (int y = 0; y < kHeight; ++y)
+			TS_ASSERT_SAME_DATA(tiled.getBasePtr(0, y), serial.getBasePtr(0, y), kWidth);
+
+		serial.free();
+		tiled.free();
+	}
+
+private:
+	enum {
+		kWidth = 83,
+		kHeight = 67,
+		kTileHeight = 9
+	};
+
+	static Common::Rect getDrawRect(const TestCelObj &cel, const Common::Point &position) {
+		return Common::Rect(position.x, position.y, position.x + cel._width, position.y + cel._height).findIntersectingRect(Common::Rect(kWidth, kHeight));
+	}
+
+	static void fillTarget(Sci::Buffer &target) {
+		for (int y = 0; y < target.h; ++y)
+			for (int x = 0; x < target.w; ++x)
+				*(byte *)target.getBasePtr(x, y) = (byte)(x * 3 + y * 5);
+	}
+
+	void checkKernels(const Sci::CelObjDSP &dsp) {
+		const uint skipColors[] = { Sci::kCelNoColorLimit, 0, 255, 93 };
+		const uint remapStartColors[] = { Sci::kCelNoColorLimit, 236, 0, 255 };
+
+		uint32 seed = 1;
+		for (uint width = 0; width < 80; ++width) {
+			for (uint i = 0; i < ARRAYSIZE(skipColors); ++i) {
+				for (uint j = 0; j < ARRAYSIZE(remapStartColors); ++j) {
+					for (int mac = 0; mac < 2; ++mac) {
+						// Rows start at odd offsets, so that loads are unaligned
+						byte source[81], target[81], expected[81];
+						for (uint k = 0; k < ARRAYSIZE(source); ++k) {
+							seed = seed * 1103515245 + 12345;
+							const byte value = (byte)(seed >> 16);
+							// Make the special colors common enough to matter
+							source[k] = (seed >> 8) % 4 == 0 ? (byte)skipColors[i] : (seed >> 8) % 4 == 1 ? (byte)(value | 0xF0) : value;
+							target[k] = expected[k] = (byte)(seed >> 24);
+						}
+
+						const bool remapped = dsp.drawRow(target + 1, source + 1, width, skipColors[i], remapStartColors[j], mac);
+						const bool expectedRemapped = Sci::drawRowGeneric(expected + 1, source + 1, width, skipColors[i], remapStartColors[j], mac);
+						TS_ASSERT_EQUALS(remapped, expectedRemapped);
+						TS_ASSERT_SAME_DATA(target, expected, sizeof(target));
+					}
+				}
+			}
+		}
+	}
+};
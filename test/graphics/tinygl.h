@@ -0,0 +1,282 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/system.h"
+#include "graphics/surface.h"
+
+#ifdef USE_TINYGL
+#include "graphics/tinygl/tinygl.h"
+#include "graphics/tinygl/zgl.h"
+#endif
+
+#include "../null_osystem.h"
+
+/**
+ * Renders the same frames serially and in tiles, which have to give
+ * exactly the same pixels. The tile count does not divide the frame
+ * height, and the blit in the middle splits the draw calls into two
+ * tiled parts. The same goes for rendering with and without the span
+ * kernels. Mipmapped textures must not alias when minified.
+ */
+class TinyGLTestSuite : public CxxTest::TestSuite {
+#ifdef USE_TINYGL
+private:
+	enum {
+		kWidth = 97,
+		kHeight = 61,
+		kTextureSize = 16,
+		kNumTiles = 7
+	};
+
+	TinyGL::BlitImage *_blitImage;
+	TGLuint _texture;
+
+	void createContext(bool dirtyRects, uint numTiles, bool spanKernels) {
+		TinyGL::createContext(kWidth, kHeight, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), 256, true, dirtyRects);
+		TinyGL::gl_get_context()->fb->enableSpanKernels(spanKernels);
+		if (numTiles)
+			TinyGL::gl_get_context()->setTiledRendering(true, numTiles);
+
+		byte texels[kTextureSize * kTextureSize * 4];
+		for (int i = 0; i < kTextureSize * kTextureSize * 4; i++)
+			texels[i] = (byte)(i * 37 + (i >> 6) * 11);
+		tglGenTextures(1, &_texture);
+		tglBindTexture(TGL_TEXTURE_2D, _texture);
+		tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_MIN_FILTER, TGL_LINEAR);
+		tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_MAG_FILTER, TGL_LINEAR);
+		tglTexImage2D(TGL_TEXTURE_2D, 0, TGL_RGBA, kTextureSize, kTextureSize, 0, TGL_RGBA, TGL_UNSIGNED_BYTE, texels);
+
+		Graphics::Surface image;
+		image.create(13, 9, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+		for (int y = 0; y < image.h; y++) {
+			for (int x = 0; x < image.w; x++)
+				image.setPixel(x, y, image.format.ARGBToColor(128 + x * 9, x * 19, y * 27, 200));
+		}
+		_blitImage = tglGenBlitImage();
+		tglUploadBlitImage(_blitImage, image, 0, false);
+		image.free();
+	}
+
+	void destroyContext() {
+		tglDeleteBlitImage(_blitImage);
+		tglDeleteTextures(1, &_texture);
+		TinyGL::destroyContext();
+	}
+
+	void drawFrame(int frame) {
+		tglViewport(0, 0, kWidth, kHeight);
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglFrustum(-1.0, 1.0, -0.7, 0.7, 1.0, 10.0);
+		tglMatrixMode(TGL_MODELVIEW);
+		tglLoadIdentity();
+		tglTranslatef(0.0f, 0.0f, -3.0f);
+		tglRotatef(frame * 17.0f, 0.3f, 1.0f, 0.1f);
+
+		tglClearColor(0.1f, 0.2f, 0.3f, 1.0f);
+		tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+		tglEnable(TGL_DEPTH_TEST);
+		tglShadeModel(TGL_SMOOTH);
+
+		// Crosses the near plane, so that it gets clipped
+		tglBegin(TGL_TRIANGLES);
+		tglColor4f(1.0f, 0.0f, 0.0f, 1.0f);
+		tglVertex3f(-1.5f, -1.0f, 2.8f);
+		tglColor4f(0.0f, 1.0f, 0.0f, 1.0f);
+		tglVertex3f(1.2f, -0.8f, -0.5f);
+		tglColor4f(0.0f, 0.0f, 1.0f, 1.0f);
+		tglVertex3f(0.1f, 1.3f, 0.2f);
+		tglEnd();
+
+		tglEnable(TGL_TEXTURE_2D);
+		tglBindTexture(TGL_TEXTURE_2D, _texture);
+		tglBegin(TGL_QUADS);
+		tglColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+		tglTexCoord2f(0.0f, 0.0f);
+		tglVertex3f(-0.9f, -0.9f, 0.3f);
+		tglTexCoord2f(1.0f, 0.0f);
+		tglVertex3f(0.9f, -0.7f, -0.3f);
+		tglTexCoord2f(1.0f, 1.0f);
+		tglVertex3f(0.8f, 0.9f, 0.0f);
+		tglTexCoord2f(0.0f, 1.0f);
+		tglVertex3f(-0.7f, 0.8f, 0.1f);
+		tglEnd();
+		tglDisable(TGL_TEXTURE_2D);
+
+		tglBlit(_blitImage, 5 + frame * 7, 40 - frame * 5);
+
+		tglEnable(TGL_BLEND);
+		tglBlendFunc(TGL_SRC_ALPHA, TGL_ONE_MINUS_SRC_ALPHA);
+		tglBegin(TGL_TRIANGLE_STRIP);
+		for (int i = 0; i < 8; i++) {
+			tglColor4f(0.1f * i, 1.0f - 0.1f * i, 0.5f, 0.5f);
+			tglVertex3f(-1.0f + i * 0.3f, (i & 1) ? 0.6f : -0.4f, 0.5f - i * 0.1f);
+		}
+		tglEnd();
+
+		tglEnable(TGL_TEXTURE_2D);
+		tglDepthFunc(TGL_LEQUAL);
+		tglBegin(TGL_TRIANGLES);
+		tglColor4f(1.0f, 0.8f, 0.6f, 0.7f);
+		tglTexCoord2f(0.0f, 0.0f);
+		tglVertex3f(-0.6f, -0.2f, 0.4f);
+		tglColor4f(0.3f, 1.0f, 0.9f, 0.4f);
+		tglTexCoord2f(2.0f, 0.5f);
+		tglVertex3f(1.0f, 0.1f, 0.2f);
+		tglColor4f(0.8f, 0.5f, 1.0f, 1.0f);
+		tglTexCoord2f(0.5f, 1.5f);
+		tglVertex3f(0.0f, 1.0f, 0.3f);
+		tglEnd();
+		tglDepthFunc(TGL_LESS);
+		tglDisable(TGL_TEXTURE_2D);
+		tglDisable(TGL_BLEND);
+
+		tglBegin(TGL_LINES);
+		tglColor4f(1.0f, 1.0f, 0.0f, 1.0f);
+		tglVertex3f(-1.2f, 1.0f, 0.0f);
+		tglVertex3f(1.1f, -1.1f, 0.4f);
+		tglEnd();
+
+		tglBegin(TGL_POINTS);
+		for (int i = 0; i < 10; i++)
+			tglVertex3f(-0.9f + i * 0.2f, 0.35f, 0.6f);
+		tglEnd();
+	}
+
+	Graphics::Surface *render(bool dirtyRects, uint numTiles, bool spanKernels = true) {
+		createContext(dirtyRects, numTiles, spanKernels);
+		for (int frame = 0; frame < 3; frame++) {
+			drawFrame(frame);
+			TinyGL::presentBuffer();
+		}
+		Graphics::Surface *result = TinyGL::copyToBuffer(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+		destroyContext();
+		return result;
+	}
+
+	// Draws a one texel checkerboard onto a quad eight times smaller
+	Graphics::Surface *renderMinified(uint minFilter, bool generateMipmap, bool spanKernels) {
+		TinyGL::createContext(kWidth, kHeight, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0), 256, true, false);
+		TinyGL::gl_get_context()->fb->enableSpanKernels(spanKernels);
+
+		byte texels[64 * 64 * 4];
+		for (int i = 0; i < 64 * 64; i++) {
+			const byte value = ((i ^ (i >> 6)) & 1) ? 255 : 0;
+			texels[i * 4] = texels[i * 4 + 1] = texels[i * 4 + 2] = value;
+			texels[i * 4 + 3] = 255;
+		}
+		TGLuint texture;
+		tglGenTextures(1, &texture);
+		tglBindTexture(TGL_TEXTURE_2D, texture);
+		tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_MIN_FILTER, minFilter);
+		tglTexParameteri(TGL_TEXTURE_2D, TGL_TEXTURE_MAG_FILTER, TGL_LINEAR);
+		tglTexParameteri(TGL_TEXTURE_2D, TGL_GENERATE_MIPMAP, generateMipmap ? TGL_TRUE : TGL_FALSE);
+		tglTexImage2D(TGL_TEXTURE_2D, 0, TGL_RGBA, 64, 64, 0, TGL_RGBA, TGL_UNSIGNED_BYTE, texels);
+
+		tglViewport(0, 0, kWidth, kHeight);
+		tglMatrixMode(TGL_PROJECTION);
+		tglLoadIdentity();
+		tglOrtho(0.0, kWidth, kHeight, 0.0, -1.0, 1.0);
+		tglMatrixMode(TGL_MODELVIEW);
+		tglLoadIdentity();
+		tglClearColor(1.0f, 0.0f, 0.0f, 1.0f);
+		tglClear(TGL_COLOR_BUFFER_BIT | TGL_DEPTH_BUFFER_BIT);
+		tglEnable(TGL_TEXTURE_2D);
+		tglBegin(TGL_QUADS);
+		tglColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+		tglTexCoord2f(0.0f, 0.0f);
+		tglVertex3f(10.0f, 10.0f, 0.0f);
+		tglTexCoord2f(0.0f, 1.0f);
+		tglVertex3f(10.0f, 18.0f, 0.0f);
+		tglTexCoord2f(1.0f, 1.0f);
+		tglVertex3f(18.0f, 18.0f, 0.0f);
+		tglTexCoord2f(1.0f, 0.0f);
+		tglVertex3f(18.0f, 10.0f, 0.0f);
+		tglEnd();
+		tglDisable(TGL_TEXTURE_2D);
+		TinyGL::presentBuffer();
+
+		Graphics::Surface *result = TinyGL::copyToBuffer(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+		tglDeleteTextures(1, &texture);
+		TinyGL::destroyContext();
+		return result;
+	}
+
+	// Counts the pixels of the quad, and those which are not mid grey
+	void countMinifiedPixels(Graphics::Surface *surface, int &covered, int &aliased) {
+		covered = aliased = 0;
+		for (int y = 0; y < kHeight; y++) {
+			for (int x = 0; x < kWidth; x++) {
+				byte a, r, g, b;
+				surface->format.colorToARGB(surface->getPixel(x, y), a, r, g, b);
+				if (r == 255 && g == 0 && b == 0)
+					continue;
+				covered++;
+				if (r < 96 || r > 160)
+					aliased++;
+			}
+		}
+		surface->free();
+		delete surface;
+	}
+
+	void checkSameFrames(Graphics::Surface *expected, Graphics::Surface *actual) {
+		for (int y = 0; y < kHeight; y++)
+			TS_ASSERT_SAME_DATA(expected->getBasePtr(0, y), actual->getBasePtr(0, y), kWidth * 4);
+		expected->free();
+		delete expected;
+		actual->free();
+		delete actual;
+	}
+#endif
+
+public:
+	void setUp() {
+		if (!g_system)
+			Common::install_null_g_system();
+	}
+
+	void test_tiled_rendering() {
+#ifdef USE_TINYGL
+		checkSameFrames(render(false, 0), render(false, kNumTiles));
+#endif
+	}
+
+	void test_tiled_rendering_dirty_rects() {
+#ifdef USE_TINYGL
+		checkSameFrames(render(true, 0), render(true, kNumTiles));
+#endif
+	}
+
+	void test_span_kernels() {
+#ifdef USE_TINYGL
+		checkSameFrames(render(false, 0, false), render(false, 0));
+#endif
+	}
+
+	void test_span_kernels_dirty_rects() {
+#ifdef USE_TINYGL
+		checkSameFrames(render(true, 0, false), render(true, 0));
+#endif
+	}
+
+	void test_mipmaps() {
+#ifdef USE_TINYGL
+		int covered, aliased;
+		countMinifiedPixels(renderMinified(TGL_NEAREST_MIPMAP_NEAREST, false, false), covered, aliased);
+		TS_ASSERT(covered > 0);
+		TS_ASSERT(aliased > 0);
+
+		const uint filters[] = { TGL_NEAREST_MIPMAP_NEAREST, TGL_LINEAR_MIPMAP_NEAREST, TGL_NEAREST_MIPMAP_LINEAR, TGL_LINEAR_MIPMAP_LINEAR };
+		for (int i = 0; i < ARRAYSIZE(filters); i++) {
+			countMinifiedPixels(renderMinified(filters[i], true, false), covered, aliased);
+			TS_ASSERT(covered > 0);
+			TS_ASSERT_EQUALS(aliased, 0);
+			checkSameFrames(renderMinified(filters[i], true, false), renderMinified(filters[i], true, true));
+		}
+#endif
+	}
+};
@@ -0,0 +1,131 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/system.h"
+
+#ifdef USE_TINYGL
+#include "graphics/tinygl/ztriangle_dsp.h"
+#endif
+
+#include "../null_osystem.h"
+
+/**
+ * Compares the SIMD span kernels of TinyGL against the C++ ones, which they
+ * have to match exactly, wrap around of the depth and colors included.
+ */
+class TinyGLDSPTestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+		if (!g_system)
+			Common::install_null_g_system();
+	}
+
+	void test_kernels() {
+#ifdef USE_TINYGL
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasCpuFeature(OSystem::kCpuFeatureSSE2)) {
+			TinyGL::TriangleDSP dsp;
+			TinyGL::initTriangleDSP(dsp);
+			TinyGL::initTriangleDSPSSE2(dsp);
+			checkKernels(dsp);
+		}
+#endif
+#ifdef SCUMMVM_NEON
+		if (g_system->hasCpuFeature(OSystem::kCpuFeatureNEON)) {
+			TinyGL::TriangleDSP dsp;
+			TinyGL::initTriangleDSP(dsp);
+			TinyGL::initTriangleDSPNEON(dsp);
+			checkKernels(dsp);
+		}
+#endif
+#endif
+	}
+
+private:
+	enum {
+		kMaxCount = 23
+	};
+
+	uint32 _seed;
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 16) | (_seed << 16);
+	}
+
+#ifdef USE_TINYGL
+	void checkKernels(const TinyGL::TriangleDSP &dsp) {
+		TinyGL::TriangleDSP reference;
+		TinyGL::initTriangleDSP(reference);
+
+		_seed = 1;
+		for (int pass = 0; pass < 300; pass++) {
+			TinyGL::TriangleSpan span;
+			span.count = nextRandom() % (kMaxCount + 1);
+			span.depthTest = (TinyGL::TriangleSpan::DepthTest)(pass % 3);
+			span.depthWrite = (pass / 3) & 1;
+
+			// Depths all over the range, and near the stored ones
+			span.z = (pass & 8) ? nextRandom() : 0x1000000 + nextRandom() % 0x400;
+			span.dzdx = (int)nextRandom() >> ((pass & 8) ? 4 : 24);
+
+			// Colors which stay in range, and some which wrap around
+			const int colorShift = (pass & 16) ? 0 : 12;
+			span.r = nextRandom() >> colorShift;
+			span.g = nextRandom() >> colorShift;
+			span.b = nextRandom() >> colorShift;
+			span.a = nextRandom() >> colorShift;
+			span.drdx = (int)nextRandom() >> (colorShift + 8);
+			span.dgdx = (int)nextRandom() >> (colorShift + 8);
+			span.dbdx = (int)nextRandom() >> (colorShift + 8);
+			span.dadx = (int)nextRandom() >> (colorShift + 8);
+
+			if (pass & 32) {
+				span.aShift = 0;
+				span.rShift = 24;
+				span.gShift = 16;
+				span.bShift = 8;
+			} else {
+				span.aShift = 24;
+				span.rShift = 16;
+				span.gShift = 8;
+				span.bShift = 0;
+			}
+			span.aMask = (pass & 64) ? 0 : 0xFF << span.aShift;
+
+			checkKernel(dsp.shadeSpan, reference.shadeSpan, span);
+			checkKernel(dsp.textureSpan, reference.textureSpan, span);
+			checkKernel(dsp.blendTextureSpan, reference.blendTextureSpan, span);
+		}
+	}
+
+	void checkKernel(void (*kernel)(const TinyGL::TriangleSpan &), void (*referenceKernel)(const TinyGL::TriangleSpan &), TinyGL::TriangleSpan span) {
+		// One guard value on each side of the span
+		uint32 pixels[kMaxCount + 2], referencePixels[kMaxCount + 2];
+		uint depth[kMaxCount + 2], referenceDepth[kMaxCount + 2];
+		uint32 texels[kMaxCount];
+		for (int i = 0; i < kMaxCount + 2; i++) {
+			pixels[i] = referencePixels[i] = nextRandom();
+			depth[i] = referenceDepth[i] = (i & 1) ? span.z + nextRandom() % 0x800 - 0x400 : nextRandom();
+		}
+		for (int i = 0; i < kMaxCount; i++)
+			texels[i] = nextRandom();
+
+		span.texels = texels;
+		TinyGL::TriangleSpan referenceSpan = span;
+		span.pixels = pixels + 1;
+		span.depth = depth + 1;
+		referenceSpan.pixels = referencePixels + 1;
+		referenceSpan.depth = referenceDepth + 1;
+
+		kernel(span);
+		referenceKernel(referenceSpan);
+
+		TS_ASSERT_SAME_DATA(pixels, referencePixels, sizeof(pixels));
+		TS_ASSERT_SAME_DATA(depth, referenceDepth, sizeof(depth));
+	}
+#endif
+};
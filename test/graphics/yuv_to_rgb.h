@@ -0,0 +1,206 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/system.h"
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include "../null_osystem.h"
+
+/**
+ * Compares the SIMD conversions against the lookup tables, which they have
+ * to match exactly. The planes are filled with pseudo random values, so that
+ * every channel gets clamped at both ends.
+ */
+class YUVToRGBTestSuite : public CxxTest::TestSuite {
+public:
+	enum {
+		kMaxWidth = 70,
+		kMaxHeight = 16,
+		kRowWidth = 2 * 256 + 5
+	};
+
+	YUVToRGBTestSuite() {
+		uint32 seed = 1;
+		for (int i = 0; i < kMaxWidth * kMaxHeight; ++i) {
+			seed = seed * 1103515245 + 12345;
+			_y[i] = (byte)(seed >> 16);
+			_a[i] = (byte)(seed >> 24);
+			seed = seed * 1103515245 + 12345;
+			_u[i] = (byte)(seed >> 16);
+			_v[i] = (byte)(seed >> 24);
+		}
+	}
+
+	void setUp() {
+		if (!g_system)
+			Common::install_null_g_system();
+	}
+
+	void tearDown() {
+		YUVToRGBMan.setSIMDEnabled(true);
+	}
+
+	void test_convert444() {
+		const int widths[] = { 70, 64, 17, 3 };
+		for (int i = 0; i < ARRAYSIZE(widths); ++i)
+			checkAllFormats(k444, widths[i], kMaxHeight);
+	}
+
+	void test_convert420() {
+		const int widths[] = { 70, 64, 18, 2 };
+		for (int i = 0; i < ARRAYSIZE(widths); ++i)
+			checkAllFormats(k420, widths[i], kMaxHeight);
+	}
+
+	void test_convert420Alpha() {
+		const int widths[] = { 70, 64, 18, 2 };
+		for (int i = 0; i < ARRAYSIZE(widths); ++i)
+			checkAllFormats(k420Alpha, widths[i], kMaxHeight);
+	}
+
+	void test_row_kernels() {
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasCpuFeature(OSystem::kCpuFeatureSSE2))
+			checkRowKernel(Graphics::convertYUVToRGBRowSSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasCpuFeature(OSystem::kCpuFeatureAVX2))
+			checkRowKernel(Graphics::convertYUVToRGBRowAVX2);
+#endif
+#ifdef SCUMMVM_NEON
+		if (g_system->hasCpuFeature(OSystem::kCpuFeatureNEON))
+			checkRowKernel(Graphics::convertYUVToRGBRowNEON);
+#endif
+	}
+
+private:
+	enum Mode {
+		k444,
+		k420,
+		k420Alpha
+	};
+
+	void checkAllFormats(Mode mode, int width, int height) {
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),     // RGB565
+			Graphics::PixelFormat(2, 5, 5, 5, 0, 10, 5, 0, 0),     // RGB555
+			Graphics::PixelFormat(2, 4, 4, 4, 4, 12, 8, 4, 0),     // RGBA4444
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24),    // ARGB8888
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),    // RGBA8888
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24),    // ABGR8888
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0)      // XRGB8888
+		};
+
+		for (int i = 0; i < ARRAYSIZE(formats); ++i) {
+			check(mode, formats[i], Graphics::YUVToRGBManager::kScaleFull, width, height);
+			check(mode, formats[i], Graphics::YUVToRGBManager::kScaleITU, width, height);
+		}
+	}
+
+	/**
+	 * Check a kernel on its own, whichever one the manager picked, against
+	 * the formulas the color tables are built from.
+	 */
+	void checkRowKernel(Graphics::YUVToRGBRowProc rowProc) {
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0)
+		};
+
+		for (int i = 0; i < ARRAYSIZE(formats); ++i) {
+			for (int mode = 0; mode < 8; ++mode) {
+				const Graphics::PixelFormat &format = formats[i];
+				const bool itu = mode & 1;
+				const bool subsampled = mode & 2;
+				const bool alpha = mode & 4;
+
+				Graphics::YUVToRGBRowFormat rowFormat;
+				rowFormat.bytesPerPixel = format.bytesPerPixel;
+				rowFormat.scaleITU = itu;
+				rowFormat.subsampled = subsampled;
+				rowFormat.rLoss = format.rLoss;
+				rowFormat.gLoss = format.gLoss;
+				rowFormat.bLoss = format.bLoss;
+				rowFormat.aLoss = format.aLoss;
+				rowFormat.rShift = format.rShift;
+				rowFormat.gShift = format.gShift;
+				rowFormat.bShift = format.bShift;
+				rowFormat.aShift = format.aShift;
+				rowFormat.opaqueAlpha = format.ARGBToColor(255, 0, 0, 0);
+
+				// Two rows, going through every chroma value
+				uint32 pixels[2 * kRowWidth];
+				byte y[2 * kRowWidth], u[kRowWidth], v[kRowWidth];
+				for (int x = 0; x < kRowWidth; ++x) {
+					y[x] = _y[x];
+					y[kRowWidth + x] = _y[kRowWidth - x];
+					u[x] = (byte)x;
+					v[x] = (byte)(x * 3 + 1);
+				}
+
+				const int rows = subsampled ? 2 : 1;
+				const int done = rowProc((byte *)pixels, kRowWidth * format.bytesPerPixel, y, alpha ? _a : nullptr, kRowWidth, u, v, kRowWidth, rowFormat);
+				TS_ASSERT(done > kRowWidth - 64 && done <= kRowWidth);
+
+				for (int p = 0; p < rows * kRowWidth; ++p) {
+					const int x = p % kRowWidth;
+					if (x >= done)
+						continue;
+
+					const int16 cr = v[subsampled ? x / 2 : x] - 128;
+					const int16 cb = u[subsampled ? x / 2 : x] - 128;
+					const int r = y[p] + (int16)((0.419 / 0.299) * cr);
+					const int g = y[p] + (int16)(-(0.299 / 0.419) * cr) + (int16)(-(0.114 / 0.331) * cb);
+					const int b = y[p] + (int16)((0.587 / 0.331) * cb);
+
+					const uint32 expected = format.ARGBToColor(alpha ? _a[p] : 255, channel(r, itu), channel(g, itu), channel(b, itu));
+					const uint32 actual = format.bytesPerPixel == 2 ? ((const uint16 *)pixels)[p] : pixels[p];
+					TS_ASSERT_EQUALS(actual, expected);
+				}
+			}
+		}
+	}
+
+	static uint8 channel(int value, bool itu) {
+		if (!itu)
+			return CLIP(value, 0, 255);
+		return (CLIP(value, 16, 235) - 16) * 255 / 219;
+	}
+
+	void check(Mode mode, const Graphics::PixelFormat &format, Graphics::YUVToRGBManager::LuminanceScale scale, int width, int height) {
+		Graphics::Surface expected, actual;
+		expected.create(width, height, format);
+		actual.create(width, height, format);
+
+		YUVToRGBMan.setSIMDEnabled(false);
+		convert(mode, &expected, scale, width, height);
+		YUVToRGBMan.setSIMDEnabled(true);
+		convert(mode, &actual, scale, width, height);
+
+		for (int y = 0; y < height; ++y)
+			TS_ASSERT_EQUALS(memcmp(expected.getBasePtr(0, y), actual.getBasePtr(0, y), width * format.bytesPerPixel), 0);
+
+		expected.free();
+		actual.free();
+	}
+
+	void convert(Mode mode, Graphics::Surface *dst, Graphics::YUVToRGBManager::LuminanceScale scale, int width, int height) {
+		switch (mode) {
+		case k444:
+			YUVToRGBMan.convert444(dst, scale, _y, _u, _v, width, height, kMaxWidth, kMaxWidth);
+			break;
+		case k420:
+			YUVToRGBMan.convert420(dst, scale, _y, _u, _v, width, height, kMaxWidth, kMaxWidth / 2);
+			break;
+		case k420Alpha:
+			YUVToRGBMan.convert420Alpha(dst, scale, _y, _u, _v, _a, width, height, kMaxWidth, kMaxWidth / 2);
+			break;
+		}
+	}
+
+	byte _y[kMaxWidth * kMaxHeight];
+	byte _u[kMaxWidth * kMaxHeight];
+	byte _v[kMaxWidth * kMaxHeight];
+	byte _a[kMaxWidth * kMaxHeight];
+};
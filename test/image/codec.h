@@ -0,0 +1,107 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memstream.h"
+#include "graphics/surface.h"
+#include "image/codecs/bmp_raw.h"
+#include "image/codecs/surface_pool.h"
+
+class CodecTestSuite : public CxxTest::TestSuite {
+public:
+	void test_surface_pool_reuse() {
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+
+		SurfacePoolMan.clear();
+		Graphics::Surface *surface = SurfacePoolMan.acquire(16, 8, format);
+		memset(surface->getPixels(), 0x55, surface->pitch * surface->h);
+		SurfacePoolMan.release(surface);
+		TS_ASSERT_EQUALS(SurfacePoolMan.getFreeCount(), 1U);
+
+		// A different size or format gets a new surface
+		Graphics::Surface *other = SurfacePoolMan.acquire(16, 8, Graphics::PixelFormat::createFormatCLUT8());
+		TS_ASSERT_DIFFERS(other, surface);
+		TS_ASSERT_EQUALS(SurfacePoolMan.getFreeCount(), 1U);
+
+		// The same size and format gets the released one back, cleared
+		Graphics::Surface *again = SurfacePoolMan.acquire(16, 8, format);
+		TS_ASSERT_EQUALS(again, surface);
+		TS_ASSERT_EQUALS(again->format, format);
+		TS_ASSERT_EQUALS(((const byte *)again->getPixels())[0], 0);
+		TS_ASSERT_EQUALS(((const byte *)again->getPixels())[again->pitch * again->h - 1], 0);
+
+		SurfacePoolMan.release(again);
+		SurfacePoolMan.release(other);
+		TS_ASSERT_EQUALS(SurfacePoolMan.getFreeCount(), 2U);
+
+		SurfacePoolMan.clear();
+		TS_ASSERT_EQUALS(SurfacePoolMan.getFreeCount(), 0U);
+	}
+
+	void test_surface_pool_limit() {
+		const Graphics::PixelFormat format = Graphics::PixelFormat::createFormatCLUT8();
+
+		SurfacePoolMan.clear();
+		for (uint i = 0; i < Image::SurfacePool::kMaxFreeSurfaces + 2; i++)
+			SurfacePoolMan.release(SurfacePoolMan.acquire(i + 1, 1, format));
+		TS_ASSERT_EQUALS(SurfacePoolMan.getFreeCount(), Image::SurfacePool::kMaxFreeSurfaces);
+
+		// The surfaces unused for the longest time went first
+		Graphics::Surface *surface = SurfacePoolMan.acquire(1, 1, format);
+		SurfacePoolMan.release(surface);
+		TS_ASSERT_EQUALS(SurfacePoolMan.getFreeCount(), Image::SurfacePool::kMaxFreeSurfaces);
+
+		// Surfaces whose size was changed by a codec are not reused
+		surface = SurfacePoolMan.acquire(4, 4, format);
+		surface->w = 3;
+		SurfacePoolMan.clear();
+		SurfacePoolMan.release(surface);
+		TS_ASSERT_EQUALS(SurfacePoolMan.getFreeCount(), 0U);
+	}
+
+	void test_decode_frame_into() {
+		// A 3x2 24bpp bottom up bitmap, with rows padded to 4 bytes
+		const byte data[] = {
+			0x00, 0x00, 0xFF,  0x00, 0xFF, 0x00,  0xFF, 0x00, 0x00,  0x00, 0x00, 0x00,
+			0x10, 0x20, 0x30,  0x40, 0x50, 0x60,  0x70, 0x80, 0x90,  0x00, 0x00, 0x00
+		};
+
+		Image::BitmapRawDecoder decoder(3, 2, 24, false);
+		Common::MemoryReadStream stream(data, sizeof(data));
+		const Graphics::Surface *frame = decoder.decodeFrame(stream);
+		TS_ASSERT(frame);
+		if (!frame)
+			return;
+
+		// The same format is copied, another one converted
+		const Graphics::PixelFormat formats[] = {
+			decoder.getPixelFormat(),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0)
+		};
+
+		for (uint i = 0; i < ARRAYSIZE(formats); i++) {
+			Graphics::Surface *expected = frame->convertTo(formats[i]);
+
+			Graphics::Surface dst;
+			dst.create(3, 2, formats[i]);
+			stream.seek(0);
+			TS_ASSERT(decoder.decodeFrameInto(stream, dst));
+			for (int y = 0; y < dst.h; y++)
+				TS_ASSERT_SAME_DATA(dst.getBasePtr(0, y), expected->getBasePtr(0, y), dst.w * dst.format.bytesPerPixel);
+
+			dst.free();
+			expected->free();
+			delete expected;
+		}
+
+		// A surface of the wrong size is refused
+		Graphics::Surface dst;
+		dst.create(2, 2, decoder.getPixelFormat());
+		stream.seek(0);
+		TS_ASSERT(!decoder.decodeFrameInto(stream, dst));
+		dst.free();
+
+		// Only codecs which convert their frames take another output format
+		TS_ASSERT(decoder.canOutputPixelFormat(decoder.getPixelFormat()));
+		TS_ASSERT(!decoder.canOutputPixelFormat(formats[1]));
+	}
+};
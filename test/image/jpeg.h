@@ -0,0 +1,109 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/memstream.h"
+#include "graphics/surface.h"
+#include "image/jpeg.h"
+
+#ifdef USE_JPEG
+// 16x8 gradient, with red and blue along x and green along y
+static const byte jpegBuf[314] = {
+			0xff, 0xd8, 0xff, 0xe0, 0x00, 0x10, 0x4a, 0x46, 0x49, 0x46, 0x00, 0x01,
+			0x01, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0xff, 0xdb, 0x00, 0x43,
+			0x00, 0x08, 0x06, 0x06, 0x07, 0x06, 0x05, 0x08, 0x07, 0x07, 0x07, 0x09,
+			0x09, 0x08, 0x0a, 0x0c, 0x14, 0x0d, 0x0c, 0x0b, 0x0b, 0x0c, 0x19, 0x12,
+			0x13, 0x0f, 0x14, 0x1d, 0x1a, 0x1f, 0x1e, 0x1d, 0x1a, 0x1c, 0x1c, 0x20,
+			0x24, 0x2e, 0x27, 0x20, 0x22, 0x2c, 0x23, 0x1c, 0x1c, 0x28, 0x37, 0x29,
+			0x2c, 0x30, 0x31, 0x34, 0x34, 0x34, 0x1f, 0x27, 0x39, 0x3d, 0x38, 0x32,
+			0x3c, 0x2e, 0x33, 0x34, 0x32, 0xff, 0xdb, 0x00, 0x43, 0x01, 0x09, 0x09,
+			0x09, 0x0c, 0x0b, 0x0c, 0x18, 0x0d, 0x0d, 0x18, 0x32, 0x21, 0x1c, 0x21,
+			0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32,
+			0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32,
+			0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32,
+			0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32,
+			0x32, 0x32, 0xff, 0xc0, 0x00, 0x11, 0x08, 0x00, 0x08, 0x00, 0x10, 0x03,
+			0x01, 0x22, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11, 0x01, 0xff, 0xc4, 0x00,
+			0x16, 0x00, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x06, 0xff, 0xc4, 0x00,
+			0x19, 0x10, 0x00, 0x01, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x06, 0x22, 0x31, 0xa1,
+			0xff, 0xc4, 0x00, 0x15, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x06, 0xff,
+			0xc4, 0x00, 0x19, 0x11, 0x00, 0x02, 0x03, 0x01, 0x00, 0x00, 0x00, 0x00,
+			0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x21, 0x03, 0x04,
+			0x05, 0x06, 0xff, 0xda, 0x00, 0x0c, 0x03, 0x01, 0x00, 0x02, 0x11, 0x03,
+			0x11, 0x00, 0x3f, 0x00, 0xc9, 0xa3, 0x6d, 0xd4, 0x30, 0xbe, 0x8d, 0xb7,
+			0x50, 0xc0, 0x0a, 0x7d, 0xbb, 0x72, 0xb6, 0x2e, 0x72, 0xf4, 0xc9, 0x9f,
+			0xff, 0xd9,
+			/* 314 */
+};
+#endif
+
+class JPEGDecoderTestSuite : public CxxTest::TestSuite {
+public:
+	void test_load_into() {
+#ifdef USE_JPEG
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 16, 8, 0, 24);
+
+		Common::MemoryReadStream stream(jpegBuf, sizeof(jpegBuf));
+		Image::JPEGDecoder decoder;
+		TS_ASSERT(decoder.loadStream(stream));
+		Graphics::Surface *expected = decoder.getSurface()->convertTo(format);
+		TS_ASSERT_EQUALS(expected->w, 16);
+		TS_ASSERT_EQUALS(expected->h, 8);
+
+		Graphics::Surface target;
+		target.create(20, 10, format);
+
+		stream.seek(0);
+		Image::JPEGDecoder intoDecoder;
+		TS_ASSERT(intoDecoder.loadStreamInto(stream, target));
+		for (int y = 0; y < 8; y++)
+			TS_ASSERT_SAME_DATA(target.getBasePtr(0, y), expected->getBasePtr(0, y), 16 * 4);
+
+		target.free();
+		expected->free();
+		delete expected;
+#endif
+	}
+
+	void test_load_into_too_small() {
+#ifdef USE_JPEG
+		Graphics::Surface target;
+		target.create(16, 7, Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24));
+
+		Common::MemoryReadStream stream(jpegBuf, sizeof(jpegBuf));
+		Image::JPEGDecoder decoder;
+		TS_ASSERT(!decoder.loadStreamInto(stream, target));
+
+		target.free();
+#endif
+	}
+
+	void test_scale_factor() {
+#ifdef USE_JPEG
+		Common::MemoryReadStream stream(jpegBuf, sizeof(jpegBuf));
+		Image::JPEGDecoder decoder;
+		decoder.setScaleFactor(2);
+		TS_ASSERT(decoder.loadStream(stream));
+
+		const Graphics::Surface *surface = decoder.getSurface();
+		TS_ASSERT_EQUALS(surface->w, 8);
+		TS_ASSERT_EQUALS(surface->h, 4);
+
+		// The gradient survives scaling, give or take the compression
+		byte a, r, g, b;
+		surface->format.colorToARGB(surface->getPixel(0, 0), a, r, g, b);
+		TS_ASSERT_LESS_THAN(r, 32);
+		TS_ASSERT_LESS_THAN(g, 32);
+		TS_ASSERT_LESS_THAN(224, b);
+		surface->format.colorToARGB(surface->getPixel(7, 3), a, r, g, b);
+		TS_ASSERT_LESS_THAN(208, r);
+		TS_ASSERT_LESS_THAN(112, g);
+		TS_ASSERT_LESS_THAN(b, 176);
+#endif
+	}
+};
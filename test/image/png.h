@@ -0,0 +1,217 @@
+#include <cxxtest/TestSuite.h>
+
+#if defined(HAVE_CONFIG_H)
+#include "config.h"
+#endif
+
+#include "common/memstream.h"
+#include "graphics/surface.h"
+#include "image/png.h"
+
+class PNGDecoderTestSuite : public CxxTest::TestSuite {
+#ifdef USE_PNG
+private:
+	enum {
+		kWidth = 7,
+		kHeight = 5
+	};
+
+	Graphics::Surface _source;
+	Common::MemoryWriteStreamDynamic *_encoded;
+
+	static byte colorAt(int x, int y, int channel) {
+		return (byte)(x * 37 + y * 23 + channel * 61);
+	}
+
+	void encodeSource() {
+		_source.create(kWidth, kHeight, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
+		for (int y = 0; y < kHeight; y++) {
+			for (int x = 0; x < kWidth; x++)
+				_source.setPixel(x, y, _source.format.ARGBToColor(colorAt(x, y, 0) | 0x80, colorAt(x, y, 1), colorAt(x, y, 2), colorAt(x, y, 3)));
+		}
+
+		_encoded = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::YES);
+		TS_ASSERT(Image::writePNG(*_encoded, _source));
+	}
+
+	Common::MemoryReadStream *openEncoded() const {
+		return new Common::MemoryReadStream(_encoded->getData(), _encoded->size());
+	}
+
+	void assertSameColor(uint32 expected, const Graphics::PixelFormat &expectedFormat, uint32 actual, const Graphics::PixelFormat &actualFormat) {
+		byte a1, r1, g1, b1, a2, r2, g2, b2;
+		expectedFormat.colorToARGB(expected, a1, r1, g1, b1);
+		actualFormat.colorToARGB(actual, a2, r2, g2, b2);
+		TS_ASSERT_EQUALS(a1, a2);
+		TS_ASSERT_EQUALS(r1, r2);
+		TS_ASSERT_EQUALS(g1, g2);
+		TS_ASSERT_EQUALS(b1, b2);
+	}
+#endif
+
+public:
+	void setUp() {
+#ifdef USE_PNG
+		encodeSource();
+#endif
+	}
+
+	void tearDown() {
+#ifdef USE_PNG
+		delete _encoded;
+		_source.free();
+#endif
+	}
+
+	void test_load_rgba() {
+#ifdef USE_PNG
+		Common::ScopedPtr<Common::MemoryReadStream> stream(openEncoded());
+		Image::PNGDecoder decoder;
+		TS_ASSERT(decoder.loadStream(*stream));
+
+		const Graphics::Surface *surface = decoder.getSurface();
+		TS_ASSERT_EQUALS(surface->w, kWidth);
+		TS_ASSERT_EQUALS(surface->h, kHeight);
+		for (int y = 0; y < kHeight; y++) {
+			for (int x = 0; x < kWidth; x++)
+				assertSameColor(_source.getPixel(x, y), _source.format, surface->getPixel(x, y), surface->format);
+		}
+#endif
+	}
+
+	void test_output_pixel_format() {
+#ifdef USE_PNG
+		const Graphics::PixelFormat format(2, 5, 6, 5, 0, 11, 5, 0, 0);
+
+		Common::ScopedPtr<Common::MemoryReadStream> stream(openEncoded());
+		Image::PNGDecoder decoder;
+		decoder.setOutputPixelFormat(format);
+		TS_ASSERT(decoder.loadStream(*stream));
+
+		const Graphics::Surface *surface = decoder.getSurface();
+		TS_ASSERT_EQUALS(surface->format, format);
+
+		Graphics::Surface *expected = _source.convertTo(format);
+		for (int y = 0; y < kHeight; y++)
+			TS_ASSERT_SAME_DATA(surface->getBasePtr(0, y), expected->getBasePtr(0, y), kWidth * 2);
+		expected->free();
+		delete expected;
+#endif
+	}
+
+	void test_load_into_subarea() {
+#ifdef USE_PNG
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 16, 8, 0, 24);
+
+		Graphics::Surface target;
+		target.create(kWidth + 4, kHeight + 4, format);
+		memset(target.getPixels(), 0xCD, target.pitch * target.h);
+		Graphics::Surface area = target.getSubArea(Common::Rect(2, 2, kWidth + 4, kHeight + 4));
+
+		Common::ScopedPtr<Common::MemoryReadStream> stream(openEncoded());
+		Image::PNGDecoder decoder;
+		TS_ASSERT(decoder.loadStreamInto(*stream, area));
+		TS_ASSERT(!decoder.getSurface());
+
+		for (int y = 0; y < target.h; y++) {
+			for (int x = 0; x < target.w; x++) {
+				if (x >= 2 && x < kWidth + 2 && y >= 2 && y < kHeight + 2)
+					assertSameColor(_source.getPixel(x - 2, y - 2), _source.format, target.getPixel(x, y), format);
+				else
+					TS_ASSERT_EQUALS(target.getPixel(x, y), 0xCDCDCDCDU);
+			}
+		}
+
+		target.free();
+#endif
+	}
+
+	void test_load_into_too_small() {
+#ifdef USE_PNG
+		Graphics::Surface target;
+		target.create(kWidth - 1, kHeight, Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24));
+
+		Common::ScopedPtr<Common::MemoryReadStream> stream(openEncoded());
+		Image::PNGDecoder decoder;
+		TS_ASSERT(!decoder.loadStreamInto(*stream, target));
+
+		target.free();
+#endif
+	}
+
+	void test_scale_factor() {
+#ifdef USE_PNG
+		Common::ScopedPtr<Common::MemoryReadStream> stream(openEncoded());
+		Image::PNGDecoder decoder;
+		decoder.setScaleFactor(2);
+		TS_ASSERT(decoder.loadStream(*stream));
+
+		const Graphics::Surface *surface = decoder.getSurface();
+		TS_ASSERT_EQUALS(surface->w, (kWidth + 1) / 2);
+		TS_ASSERT_EQUALS(surface->h, (kHeight + 1) / 2);
+
+		// Every pixel is the average of its block, which is cut off at the
+		// right and bottom edges
+		for (int y = 0; y < surface->h; y++) {
+			for (int x = 0; x < surface->w; x++) {
+				uint sums[4] = { 0, 0, 0, 0 };
+				uint count = 0;
+				for (int sy = y * 2; sy < MIN<int>(y * 2 + 2, kHeight); sy++) {
+					for (int sx = x * 2; sx < MIN<int>(x * 2 + 2, kWidth); sx++) {
+						byte a, r, g, b;
+						_source.format.colorToARGB(_source.getPixel(sx, sy), a, r, g, b);
+						sums[0] += a;
+						sums[1] += r;
+						sums[2] += g;
+						sums[3] += b;
+						count++;
+					}
+				}
+
+				const uint32 expected = _source.format.ARGBToColor(sums[0] / count, sums[1] / count, sums[2] / count, sums[3] / count);
+				assertSameColor(expected, _source.format, surface->getPixel(x, y), surface->format);
+			}
+		}
+#endif
+	}
+
+	void test_paletted_to_true_color() {
+#ifdef USE_PNG
+		// 3x2 paletted image with the colors red, green, blue and white
+		const byte pngBuf[97] = {
+			0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d,
+			0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x02,
+			0x08, 0x03, 0x00, 0x00, 0x00, 0xaa, 0xaa, 0x96, 0x28, 0x00, 0x00, 0x00,
+			0x0c, 0x50, 0x4c, 0x54, 0x45, 0xff, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00,
+			0x00, 0xff, 0xff, 0xff, 0xff, 0xfb, 0x00, 0x60, 0xf6, 0x00, 0x00, 0x00,
+			0x10, 0x49, 0x44, 0x41, 0x54, 0x78, 0xda, 0x63, 0x60, 0x60, 0x64, 0x62,
+			0x60, 0x66, 0x62, 0x04, 0x00, 0x00, 0x26, 0x00, 0x0a, 0xf3, 0x1d, 0xa6,
+			0xf6, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60,
+			0x82
+		};
+		const uint32 expected[6] = {
+			0xFF0000FF, 0x00FF00FF, 0x0000FFFF,
+			0xFFFFFFFF, 0x0000FFFF, 0x00FF00FF
+		};
+
+		{
+			Common::MemoryReadStream stream(pngBuf, sizeof(pngBuf));
+			Image::PNGDecoder decoder;
+			TS_ASSERT(decoder.loadStream(stream));
+			TS_ASSERT_EQUALS(decoder.getSurface()->format.bytesPerPixel, 1);
+			TS_ASSERT_EQUALS(decoder.getPaletteColorCount(), 4);
+		}
+
+		const Graphics::PixelFormat format(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		Common::MemoryReadStream stream(pngBuf, sizeof(pngBuf));
+		Image::PNGDecoder decoder;
+		decoder.setOutputPixelFormat(format);
+		TS_ASSERT(decoder.loadStream(stream));
+
+		const Graphics::Surface *surface = decoder.getSurface();
+		TS_ASSERT_EQUALS(surface->format, format);
+		for (int i = 0; i < 6; i++)
+			assertSameColor(expected[i], format, surface->getPixel(i % 3, i / 3), format);
+#endif
+	}
+};
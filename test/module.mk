@@ -5,10 +5,24 @@
 #
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h $(srcdir)/test/image/*.h
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h $(srcdir)/test/image/*.h $(srcdir)/test/graphics/*.h $(srcdir)/test/video/*.h
 TEST_LIBS    :=
+# Tests of engine code which needs the whole engine are linked like the
+# benchmarks
+TEST_DEPS    :=
+TEST_FRONTEND_LIBS :=
+
+# Benchmarks use the same framework, but are run separately via the
+# 'benchmark' target, since they take a while and only report timings.
+BENCHMARKS   := $(wildcard $(srcdir)/test/benchmark/*/*.h)
+# The mass add benchmark runs the advanced detector, which needs the rest of
+# the frontend, so the benchmarks link everything the executable is linked
+# from, except for the backend. The libraries depend on each other, and get
+# listed twice.
+BENCHMARK_LIBS = $(DETECT_OBJS) $(filter %.a,$(OBJS)) $(filter %.a,$(OBJS))
 
 ifdef POSIX
+TESTS += $(srcdir)/test/backends/fs/*.h
 TEST_LIBS += test/null_osystem.o \
 	backends/fs/posix/posix-fs-factory.o \
 	backends/fs/posix/posix-fs.o \
@@ -16,6 +30,11 @@ TEST_LIBS += test/null_osystem.o \
 	backends/fs/abstract-fs.o \
 	backends/fs/stdiostream.o \
 	backends/modular-backend.o
+ifdef HAS_PTHREAD
+TEST_LIBS += backends/mutex/pthread/pthread-mutex.o \
+	backends/threads/default/default-threadpool.o \
+	backends/threads/pthread/pthread-threadpool.o
+endif
 endif
 
 ifdef WIN32
@@ -28,7 +47,7 @@ TEST_LIBS += test/null_osystem.o \
 	backends/platform/sdl/win32/win32_wrapper.o
 endif
 
-TEST_LIBS +=	audio/libaudio.a math/libmath.a common/libcommon.a image/libimage.a graphics/libgraphics.a
+TEST_LIBS +=	video/libvideo.a audio/libaudio.a math/libmath.a image/libimage.a graphics/libgraphics.a common/libcommon.a
 
 ifeq ($(ENABLE_WINTERMUTE), STATIC_PLUGIN)
 	TESTS += $(srcdir)/test/engines/wintermute/*.h
@@ -40,6 +59,14 @@ ifeq ($(ENABLE_ULTIMA), STATIC_PLUGIN)
 	TEST_LIBS += engines/ultima/libultima.a
 endif
 
+ifeq ($(ENABLE_SCI), STATIC_PLUGIN)
+ifdef ENABLE_SCI32
+	TESTS += $(srcdir)/test/engines/sci/*.h
+	TEST_DEPS += $(EXECUTABLE)
+	TEST_FRONTEND_LIBS = $(BENCHMARK_LIBS)
+endif
+endif
+
 #
 TEST_FLAGS   := --runner=StdioPrinter --no-std --no-eh
 TEST_CFLAGS  := $(CFLAGS) -I$(srcdir)/test/cxxtest
@@ -68,15 +95,23 @@ endif
 
 test: test/runner
 	./test/runner
-test/runner: test/runner.cpp $(TEST_LIBS) copy-dat
-	+$(QUIET_CXX)$(LD) $(TEST_CXXFLAGS) $(CPPFLAGS) $(TEST_CFLAGS) -o $@ test/runner.cpp $(TEST_LIBS) $(TEST_LDFLAGS)
+test/runner: test/runner.cpp $(TEST_DEPS) $(TEST_LIBS) copy-dat
+	+$(QUIET_CXX)$(LD) $(TEST_CXXFLAGS) $(CPPFLAGS) $(TEST_CFLAGS) -o $@ test/runner.cpp $(TEST_LIBS) $(TEST_FRONTEND_LIBS) $(TEST_LDFLAGS)
 test/runner.cpp: $(TESTS) $(srcdir)/test/module.mk
 	@mkdir -p test
 	$(srcdir)/test/cxxtest/cxxtestgen.py $(TEST_FLAGS) -o $@ $+
 
+benchmark: test/benchmark_runner
+	./test/benchmark_runner
+test/benchmark_runner: test/benchmark_runner.cpp $(EXECUTABLE) $(TEST_LIBS) copy-dat
+	+$(QUIET_CXX)$(LD) $(TEST_CXXFLAGS) $(CPPFLAGS) $(TEST_CFLAGS) -o $@ test/benchmark_runner.cpp $(TEST_LIBS) $(BENCHMARK_LIBS) $(TEST_LDFLAGS)
+test/benchmark_runner.cpp: $(BENCHMARKS) $(srcdir)/test/module.mk
+	@mkdir -p test
+	$(srcdir)/test/cxxtest/cxxtestgen.py $(TEST_FLAGS) -o $@ $+
+
 clean: clean-test
 clean-test:
-	-$(RM) test/runner.cpp test/runner test/engine-data/encoding.dat test/null_osystem.o
+	-$(RM) test/runner.cpp test/runner test/benchmark_runner.cpp test/benchmark_runner test/engine-data/encoding.dat test/null_osystem.o
 	-rmdir test/engine-data
 
 test/engine-data/encoding.dat: $(srcdir)/dists/engine-data/encoding.dat
@@ -85,4 +120,4 @@ test/engine-data/encoding.dat: $(srcdir)/dists/engine-data/encoding.dat
 
 copy-dat: test/engine-data/encoding.dat
 
-.PHONY: test clean-test copy-dat
+.PHONY: test benchmark clean-test copy-dat
@@ -0,0 +1,103 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/system.h"
+#include "video/bink_dsp.h"
+
+#include "../null_osystem.h"
+
+/**
+ * Compares the SIMD kernels of the Bink decoder against the C++ ones, which
+ * they have to match exactly, wrap around of the byte results included.
+ */
+class BinkDSPTestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+		if (!g_system)
+			Common::install_null_g_system();
+	}
+
+	void test_kernels() {
+#ifdef USE_BINK
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasCpuFeature(OSystem::kCpuFeatureSSE2)) {
+			Video::BinkDSP dsp;
+			Video::initBinkDSP(dsp);
+			Video::initBinkDSPSSE2(dsp);
+			checkKernels(dsp);
+		}
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasCpuFeature(OSystem::kCpuFeatureAVX2)) {
+			Video::BinkDSP dsp;
+			Video::initBinkDSP(dsp);
+			Video::initBinkDSPAVX2(dsp);
+			checkKernels(dsp);
+		}
+#endif
+#ifdef SCUMMVM_NEON
+		if (g_system->hasCpuFeature(OSystem::kCpuFeatureNEON)) {
+			Video::BinkDSP dsp;
+			Video::initBinkDSP(dsp);
+			Video::initBinkDSPNEON(dsp);
+			checkKernels(dsp);
+		}
+#endif
+#endif
+	}
+
+private:
+	enum {
+		kPitch = 37,
+		kOffset = 3
+	};
+
+	uint32 _seed;
+
+	int nextRandom(int range) {
+		_seed = _seed * 1103515245 + 12345;
+		return (int)((_seed >> 8) % (2 * range + 1)) - range;
+	}
+
+#ifdef USE_BINK
+	void checkKernels(const Video::BinkDSP &dsp) {
+		Video::BinkDSP reference;
+		Video::initBinkDSP(reference);
+
+		// Small and large coefficients, with some columns left without AC
+		// values, which the C++ code takes a shortcut for
+		const int ranges[] = { 0, 3, 64, 2048, 32767 };
+
+		_seed = 1;
+		for (int i = 0; i < ARRAYSIZE(ranges); i++) {
+			for (int pass = 0; pass < 50; pass++) {
+				int32 coeffs[64];
+				int16 residue[64];
+				for (int j = 0; j < 64; j++) {
+					coeffs[j] = nextRandom(ranges[i]);
+					residue[j] = nextRandom(ranges[i] > 255 ? 255 : ranges[i]);
+				}
+				coeffs[0] = nextRandom(4096);
+				for (int j = 8; j < 64; j += 8)
+					coeffs[j + (pass & 7)] = 0;
+
+				checkKernel(dsp.idctPut, reference.idctPut, coeffs);
+				checkKernel(dsp.idctAdd, reference.idctAdd, coeffs);
+				checkKernel(dsp.idctPutScaled, reference.idctPutScaled, coeffs);
+				checkKernel(dsp.addResidue, reference.addResidue, residue);
+			}
+		}
+	}
+
+	template<class T>
+	void checkKernel(void (*kernel)(byte *, int, const T *), void (*referenceKernel)(byte *, int, const T *), const T *block) {
+		byte plane[kPitch * 20], referencePlane[kPitch * 20];
+		for (int i = 0; i < ARRAYSIZE(plane); i++)
+			plane[i] = referencePlane[i] = (byte)nextRandom(255);
+
+		kernel(plane + kPitch + kOffset, kPitch, block);
+		referenceKernel(referencePlane + kPitch + kOffset, kPitch, block);
+
+		TS_ASSERT_EQUALS(memcmp(plane, referencePlane, sizeof(plane)), 0);
+	}
+#endif
+};
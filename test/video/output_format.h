@@ -0,0 +1,202 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memstream.h"
+#include "common/system.h"
+#include "graphics/surface.h"
+#include "video/avi_decoder.h"
+
+#include "../null_osystem.h"
+
+/**
+ * Decoder with two video tracks, of which only the first one can output
+ * other formats.
+ */
+class TwoTrackVideoDecoder : public Video::VideoDecoder {
+public:
+	bool loadStream(Common::SeekableReadStream *stream) override {
+		addTrack(new FormatVideoTrack(true));
+		addTrack(new FormatVideoTrack(false));
+		return true;
+	}
+
+	static Graphics::PixelFormat trackFormat() { return Graphics::PixelFormat(2, 5, 5, 5, 0, 10, 5, 0, 0); }
+
+private:
+	class FormatVideoTrack : public FixedRateVideoTrack {
+	public:
+		FormatVideoTrack(bool canSwitch) : _canSwitch(canSwitch), _format(trackFormat()) {}
+
+		uint16 getWidth() const override { return 1; }
+		uint16 getHeight() const override { return 1; }
+		Graphics::PixelFormat getPixelFormat() const override { return _format; }
+		int getCurFrame() const override { return -1; }
+		int getFrameCount() const override { return 1; }
+		const Graphics::Surface *decodeNextFrame() override { return nullptr; }
+
+		bool canOutputPixelFormat(const Graphics::PixelFormat &format) const override { return _canSwitch; }
+		void setOutputPixelFormat(const Graphics::PixelFormat &format) override { _format = format; }
+
+	protected:
+		Common::Rational getFrameRate() const override { return 10; }
+
+	private:
+		bool _canSwitch;
+		Graphics::PixelFormat _format;
+	};
+};
+
+class OutputFormatTestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+		if (!g_system)
+			Common::install_null_g_system();
+	}
+
+	void test_all_tracks_or_none() {
+		TwoTrackVideoDecoder decoder;
+		decoder.loadStream(nullptr);
+
+		// The second track cannot switch, so the first one must not either
+		TS_ASSERT(!decoder.setOutputPixelFormat(Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0)));
+		TS_ASSERT_EQUALS(decoder.getPixelFormat(), TwoTrackVideoDecoder::trackFormat());
+	}
+
+	void test_avi_converted_frames() {
+		const Graphics::PixelFormat format(2, 5, 6, 5, 0, 11, 5, 0, 0);
+
+		Video::AVIDecoder plain, converted;
+		TS_ASSERT(plain.loadStream(createAVI(24)));
+		TS_ASSERT(converted.loadStream(createAVI(24)));
+
+		// Raw frames have no other format of their own, so they get
+		// converted as they are decoded
+		TS_ASSERT(converted.setOutputPixelFormat(format));
+		TS_ASSERT_EQUALS(converted.getPixelFormat(), format);
+
+		plain.start();
+		converted.start();
+		for (int i = 0; i < kFrameCount; i++) {
+			const Graphics::Surface *expected = plain.decodeNextFrame();
+			const Graphics::Surface *frame = converted.decodeNextFrame();
+			TS_ASSERT(expected && frame);
+			if (!expected || !frame)
+				return;
+
+			Graphics::Surface *expectedConverted = expected->convertTo(format);
+			TS_ASSERT_EQUALS(frame->format, format);
+			TS_ASSERT_EQUALS(frame->w, expectedConverted->w);
+			TS_ASSERT_EQUALS(frame->h, expectedConverted->h);
+			for (int y = 0; y < frame->h; y++)
+				TS_ASSERT_SAME_DATA(frame->getBasePtr(0, y), expectedConverted->getBasePtr(0, y), frame->w * format.bytesPerPixel);
+
+			expectedConverted->free();
+			delete expectedConverted;
+		}
+
+		// Frames come in the format after rewinding as well
+		TS_ASSERT(converted.rewind());
+		const Graphics::Surface *frame = converted.decodeNextFrame();
+		TS_ASSERT(frame && frame->format == format);
+	}
+
+	void test_avi_palettized_frames() {
+		Video::AVIDecoder decoder;
+		TS_ASSERT(decoder.loadStream(createAVI(8)));
+
+		TS_ASSERT(!decoder.setOutputPixelFormat(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0)));
+		TS_ASSERT_EQUALS(decoder.getPixelFormat(), Graphics::PixelFormat::createFormatCLUT8());
+	}
+
+private:
+	enum {
+		kWidth = 4,
+		kHeight = 2,
+		kFrameCount = 3
+	};
+
+	/**
+	 * Create an AVI with a single uncompressed video stream, whose pixels
+	 * differ from frame to frame.
+	 */
+	static Common::SeekableReadStream *createAVI(int bitsPerPixel) {
+		const uint32 rowSize = (kWidth * bitsPerPixel / 8 + 3) & ~3;
+		const uint32 frameSize = rowSize * kHeight;
+		const uint32 paletteSize = bitsPerPixel == 8 ? 256 * 4 : 0;
+
+		Common::MemoryWriteStreamDynamic avi(DisposeAfterUse::NO);
+
+		avi.writeUint32BE(MKTAG('R', 'I', 'F', 'F'));
+		avi.writeUint32LE(0); // Filled in at the end
+		avi.writeUint32BE(MKTAG('A', 'V', 'I', ' '));
+
+		avi.writeUint32BE(MKTAG('L', 'I', 'S', 'T'));
+		avi.writeUint32LE(4 + 8 + 56 + 12 + 8 + 56 + 8 + 40 + paletteSize);
+		avi.writeUint32BE(MKTAG('h', 'd', 'r', 'l'));
+
+		avi.writeUint32BE(MKTAG('a', 'v', 'i', 'h'));
+		avi.writeUint32LE(56);
+		avi.writeUint32LE(100000); // Microseconds per frame
+		avi.writeUint32LE(0);
+		avi.writeUint32LE(0);
+		avi.writeUint32LE(0);
+		avi.writeUint32LE(kFrameCount);
+		avi.writeUint32LE(0);
+		avi.writeUint32LE(1); // Streams
+		avi.writeUint32LE(frameSize);
+		avi.writeUint32LE(kWidth);
+		avi.writeUint32LE(kHeight);
+		for (int i = 0; i < 4; i++)
+			avi.writeUint32LE(0);
+
+		avi.writeUint32BE(MKTAG('L', 'I', 'S', 'T'));
+		avi.writeUint32LE(4 + 8 + 56 + 8 + 40 + paletteSize);
+		avi.writeUint32BE(MKTAG('s', 't', 'r', 'l'));
+
+		avi.writeUint32BE(MKTAG('s', 't', 'r', 'h'));
+		avi.writeUint32LE(56);
+		avi.writeUint32BE(MKTAG('v', 'i', 'd', 's'));
+		avi.writeUint32BE(0); // Handler
+		avi.writeUint32LE(0);
+		avi.writeUint16LE(0);
+		avi.writeUint16LE(0);
+		avi.writeUint32LE(0);
+		avi.writeUint32LE(1);  // Scale
+		avi.writeUint32LE(10); // Rate
+		avi.writeUint32LE(0);
+		avi.writeUint32LE(kFrameCount);
+		avi.writeUint32LE(frameSize);
+		avi.writeUint32LE(0);
+		avi.writeUint32LE(0);
+		for (int i = 0; i < 4; i++)
+			avi.writeUint16LE(0); // Frame rectangle
+
+		avi.writeUint32BE(MKTAG('s', 't', 'r', 'f'));
+		avi.writeUint32LE(40 + paletteSize);
+		avi.writeUint32LE(40);
+		avi.writeUint32LE(kWidth);
+		avi.writeUint32LE(kHeight);
+		avi.writeUint16LE(1);
+		avi.writeUint16LE(bitsPerPixel);
+		avi.writeUint32BE(0); // Uncompressed
+		avi.writeUint32LE(frameSize);
+		for (int i = 0; i < 4; i++)
+			avi.writeUint32LE(0);
+		for (uint32 i = 0; i < paletteSize; i++)
+			avi.writeByte(i);
+
+		avi.writeUint32BE(MKTAG('L', 'I', 'S', 'T'));
+		avi.writeUint32LE(4 + kFrameCount * (8 + frameSize));
+		avi.writeUint32BE(MKTAG('m', 'o', 'v', 'i'));
+		for (int frame = 0; frame < kFrameCount; frame++) {
+			avi.writeUint32BE(MKTAG('0', '0', 'd', 'b'));
+			avi.writeUint32LE(frameSize);
+			for (uint32 i = 0; i < frameSize; i++)
+				avi.writeByte(frame * 37 + i * 11);
+		}
+
+		const uint32 size = avi.size();
+		byte *data = avi.getData();
+		WRITE_LE_UINT32(data + 4, size - 8);
+		return new Common::MemoryReadStream(data, size, DisposeAfterUse::YES);
+	}
+};
@@ -0,0 +1,166 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/system.h"
+#include "graphics/surface.h"
+#include "video/video_decoder.h"
+
+#include "../null_osystem.h"
+
+/**
+ * Decoder with a single video track, whose frames are filled with their
+ * frame number, and whose palette changes every other frame.
+ */
+class CountingVideoDecoder : public Video::VideoDecoder {
+public:
+	enum {
+		kFrameCount = 30
+	};
+
+	bool loadStream(Common::SeekableReadStream *stream) override {
+		addTrack(new CountingVideoTrack());
+		return true;
+	}
+
+	static byte paletteEntry(int frame, int i) {
+		return (byte)(frame / 2 * 7 + i);
+	}
+
+private:
+	class CountingVideoTrack : public FixedRateVideoTrack {
+	public:
+		CountingVideoTrack() : _curFrame(-1), _reversed(false), _dirtyPalette(false) {
+			_surface.create(4, 4, Graphics::PixelFormat::createFormatCLUT8());
+		}
+		~CountingVideoTrack() { _surface.free(); }
+
+		uint16 getWidth() const override { return _surface.w; }
+		uint16 getHeight() const override { return _surface.h; }
+		Graphics::PixelFormat getPixelFormat() const override { return _surface.format; }
+		int getCurFrame() const override { return _curFrame; }
+		int getFrameCount() const override { return kFrameCount; }
+		bool isSeekable() const override { return true; }
+
+		bool seek(const Audio::Timestamp &time) override {
+			_curFrame = getFrameAtTime(time) - 1;
+			return true;
+		}
+
+		bool setReverse(bool reverse) override {
+			_reversed = reverse;
+			return true;
+		}
+		bool isReversed() const override { return _reversed; }
+
+		bool endOfTrack() const override {
+			return _reversed ? _curFrame <= 0 : FixedRateVideoTrack::endOfTrack();
+		}
+
+		const Graphics::Surface *decodeNextFrame() override {
+			_curFrame += _reversed ? -1 : 1;
+			_surface.fillRect(Common::Rect(_surface.w, _surface.h), (uint32)_curFrame);
+
+			_dirtyPalette = _curFrame % 2 == 0;
+			for (int i = 0; i < 256 * 3; ++i)
+				_palette[i] = paletteEntry(_curFrame, i);
+			return &_surface;
+		}
+
+		const byte *getPalette() const override {
+			_dirtyPalette = false;
+			return _palette;
+		}
+		bool hasDirtyPalette() const override { return _dirtyPalette; }
+
+	protected:
+		Common::Rational getFrameRate() const override { return 30; }
+
+	private:
+		Graphics::Surface _surface;
+		int _curFrame;
+		bool _reversed;
+		mutable bool _dirtyPalette;
+		byte _palette[256 * 3];
+	};
+};
+
+class ReadAheadTestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+		if (!g_system)
+			Common::install_null_g_system();
+	}
+
+	void test_same_frames() {
+		CountingVideoDecoder plain, readAhead;
+		plain.loadStream(nullptr);
+		readAhead.loadStream(nullptr);
+		if (!readAhead.setReadAhead(3))
+			return;
+
+		plain.start();
+		readAhead.start();
+
+		Common::Array<int> plainFrames, readAheadFrames;
+		decodeFrames(plain, 12, plainFrames);
+		decodeFrames(readAhead, 12, readAheadFrames);
+
+		// Turning around has to start from the frame which is displayed,
+		// and not from the one the worker got to
+		TS_ASSERT(plain.setReverse(true));
+		TS_ASSERT(readAhead.setReverse(true));
+		decodeFrames(plain, 5, plainFrames);
+		decodeFrames(readAhead, 5, readAheadFrames);
+
+		TS_ASSERT(plain.setReverse(false));
+		TS_ASSERT(readAhead.setReverse(false));
+		decodeFrames(plain, 6, plainFrames);
+		decodeFrames(readAhead, 6, readAheadFrames);
+
+		// Seeking as well
+		TS_ASSERT(plain.seekToFrame(20));
+		TS_ASSERT(readAhead.seekToFrame(20));
+		decodeFrames(plain, CountingVideoDecoder::kFrameCount, plainFrames);
+		decodeFrames(readAhead, CountingVideoDecoder::kFrameCount, readAheadFrames);
+
+		TS_ASSERT(plain.endOfVideo());
+		TS_ASSERT(readAhead.endOfVideo());
+		TS_ASSERT_EQUALS(plainFrames.size(), readAheadFrames.size());
+		for (uint i = 0; i < plainFrames.size() && i < readAheadFrames.size(); ++i)
+			TS_ASSERT_EQUALS(plainFrames[i], readAheadFrames[i]);
+	}
+
+	void test_palette_outlives_frame() {
+		CountingVideoDecoder decoder;
+		decoder.loadStream(nullptr);
+		if (!decoder.setReadAhead(1))
+			return;
+
+		decoder.start();
+		decoder.decodeNextFrame();
+		TS_ASSERT(decoder.hasDirtyPalette());
+		decoder.decodeNextFrame();
+
+		// By now the worker has decoded frame 2 into the slot of frame 0,
+		// along with a new palette. Pausing waits for the worker.
+		decoder.pauseVideo(true);
+		const byte *palette = decoder.getPalette();
+		for (int i = 0; i < 256 * 3; ++i)
+			TS_ASSERT_EQUALS(palette[i], CountingVideoDecoder::paletteEntry(0, i));
+		decoder.pauseVideo(false);
+	}
+
+private:
+	/**
+	 * Decode up to the given number of frames. Each frame is recorded by
+	 * its number, its first pixel and the palette entry set with it.
+	 */
+	static void decodeFrames(CountingVideoDecoder &decoder, int count, Common::Array<int> &frames) {
+		for (int i = 0; i < count && !decoder.endOfVideo(); ++i) {
+			const Graphics::Surface *surface = decoder.decodeNextFrame();
+			frames.push_back(decoder.getCurFrame());
+			frames.push_back(surface ? *(const byte *)surface->getPixels() : -1);
+			frames.push_back(decoder.hasDirtyPalette() ? decoder.getPalette()[1] : -1);
+		}
+	}
+};
@@ -37,6 +37,7 @@
 
 // Video Codecs
 #include "image/codecs/codec.h"
+#include "image/codecs/surface_pool.h"
 
 namespace Video {
 
@@ -951,18 +952,22 @@ AVIDecoder::AVIVideoTrack::AVIVideoTrack(int frameCount, const AVIStreamHeader &
 	_lastFrame = 0;
 	_curFrame = -1;
 	_reversed = false;
+	_outputFrame = 0;
 
 	useInitialPalette();
 }
 
 AVIDecoder::AVIVideoTrack::~AVIVideoTrack() {
+	SurfacePoolMan.release(_outputFrame);
 	delete _videoCodec;
 	delete[] _initialPalette;
 }
 
 void AVIDecoder::AVIVideoTrack::decodeFrame(Common::SeekableReadStream *stream) {
 	if (stream) {
-		if (_videoCodec)
+		if (_videoCodec && _outputFrame)
+			_lastFrame = _videoCodec->decodeFrameInto(*stream, *_outputFrame) ? _outputFrame : 0;
+		else if (_videoCodec)
 			_lastFrame = _videoCodec->decodeFrame(*stream);
 	} else {
 		// Empty frame
@@ -979,6 +984,9 @@ void AVIDecoder::AVIVideoTrack::decodeFrame(Common::SeekableReadStream *stream)
 }
 
 Graphics::PixelFormat AVIDecoder::AVIVideoTrack::getPixelFormat() const {
+	if (_outputFrame)
+		return _outputFrame->format;
+
 	if (_videoCodec)
 		return _videoCodec->getPixelFormat();
 
@@ -1040,6 +1048,7 @@ bool AVIDecoder::AVIVideoTrack::rewind() {
 	delete _videoCodec;
 	_videoCodec = createCodec();
 	_lastFrame = 0;
+	applyOutputPixelFormat();
 	return true;
 }
 
@@ -1093,6 +1102,33 @@ void AVIDecoder::AVIVideoTrack::setDither(const byte *palette) {
 	_videoCodec->setDither(Image::Codec::kDitherTypeVFW, palette);
 }
 
+bool AVIDecoder::AVIVideoTrack::canOutputPixelFormat(const Graphics::PixelFormat &format) const {
+	if (!_videoCodec)
+		return false;
+
+	// True color frames can always be converted, palettized ones cannot
+	return _videoCodec->canOutputPixelFormat(format) || (_videoCodec->getPixelFormat().bytesPerPixel != 1 && format.bytesPerPixel != 1);
+}
+
+void AVIDecoder::AVIVideoTrack::setOutputPixelFormat(const Graphics::PixelFormat &format) {
+	assert(canOutputPixelFormat(format));
+	_outputFormat = format;
+	applyOutputPixelFormat();
+}
+
+void AVIDecoder::AVIVideoTrack::applyOutputPixelFormat() {
+	SurfacePoolMan.release(_outputFrame);
+	_outputFrame = 0;
+
+	if (!_videoCodec || _outputFormat.bytesPerPixel == 0)
+		return;
+
+	if (_videoCodec->canOutputPixelFormat(_outputFormat))
+		_videoCodec->setOutputPixelFormat(_outputFormat);
+	else
+		_outputFrame = SurfacePoolMan.acquire(getWidth(), getHeight(), _outputFormat);
+}
+
 AVIDecoder::AVIAudioTrack::AVIAudioTrack(const AVIStreamHeader &streamHeader, const PCMWaveFormat &waveFormat, Audio::Mixer::SoundType soundType) :
 		AudioTrack(soundType),
 		_audsHeader(streamHeader),
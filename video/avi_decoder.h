@@ -224,6 +224,8 @@ protected:
 		void useInitialPalette();
 		bool canDither() const;
 		void setDither(const byte *palette);
+		bool canOutputPixelFormat(const Graphics::PixelFormat &format) const;
+		void setOutputPixelFormat(const Graphics::PixelFormat &format);
 		bool isValid() const { return _videoCodec != nullptr; }
 
 		bool isTruemotion1() const;
@@ -276,6 +278,13 @@ protected:
 		Image::Codec *_videoCodec;
 		const Graphics::Surface *_lastFrame;
 		Image::Codec *createCodec();
+
+		// Output format set by the caller, and the surface from the
+		// surface pool which frames are converted into if the codec
+		// cannot output that format itself
+		Graphics::PixelFormat _outputFormat;
+		Graphics::Surface *_outputFrame;
+		void applyOutputPixelFormat();
 	};
 
 	class AVIAudioTrack : public AudioTrack {
@@ -38,12 +38,14 @@
 #include "common/rdft.h"
 #include "common/dct.h"
 #include "common/system.h"
+#include "common/threadpool.h"
 
 #include "graphics/yuv_to_rgb.h"
 #include "graphics/surface.h"
 
 #include "video/binkdata.h"
 #include "video/bink_decoder.h"
+#include "video/bink_dsp.h"
 
 static const uint32 kBIKfID = MKTAG('B', 'I', 'K', 'f');
 static const uint32 kBIKgID = MKTAG('B', 'I', 'K', 'g');
@@ -58,6 +60,9 @@ static const uint16 kAudioFlagStereo = 0x2000;
 // Number of bits used to store first DC value in bundle
 static const uint32 kDCStartBits = 11;
 
+// Number of block rows whose DCT blocks go to one slice task
+static const uint32 kSliceBlockRows = 4;
+
 namespace Video {
 
 BinkDecoder::BinkDecoder() {
@@ -248,6 +253,16 @@ BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, const G
 	for (int i = 0; i < 16; i++)
 		_huffman[i] = 0;
 
+	_dsp = &getBinkDSP();
+	_sliceTasks = 0;
+
+	for (int i = 0; i < 4; i++) {
+		_dctBlocks[i].blocks = 0;
+		_dctBlocks[i].coeffs = 0;
+		_dctBlocks[i].count = 0;
+		_dctBlocks[i].sliceStart = 0;
+	}
+
 	for (int i = 0; i < kSourceMAX; i++) {
 		_bundles[i].countLength = 0;
 
@@ -307,9 +322,13 @@ BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, const G
 
 	initBundles();
 	initHuffman();
+
+	setSliceThreading(true);
 }
 
 BinkDecoder::BinkVideoTrack::~BinkVideoTrack() {
+	setSliceThreading(false);
+
 	for (int i = 0; i < 4; i++) {
 		delete[] _curPlanes[i]; _curPlanes[i] = 0;
 		delete[] _oldPlanes[i]; _oldPlanes[i] = 0;
@@ -346,6 +365,13 @@ private:
 	bool _isStereo;
 };
 
+void BinkDecoder::setSliceThreading(bool enable) {
+	BinkVideoTrack *videoTrack = (BinkVideoTrack *)getTrack(0);
+
+	if (videoTrack)
+		videoTrack->setSliceThreading(enable);
+}
+
 Common::Rational BinkDecoder::getFrameRate() {
 	BinkVideoTrack *videoTrack = (BinkVideoTrack *)getTrack(0);
 
@@ -443,6 +469,44 @@ bool BinkDecoder::BinkAudioTrack::seek(const Audio::Timestamp &time) {
 	return true;
 }
 
+void BinkDecoder::BinkVideoTrack::setSliceThreading(bool enable) {
+	if (enable == (_sliceTasks != 0))
+		return;
+
+	if (!enable) {
+		// Waits for the tasks still running
+		delete _sliceTasks;
+		_sliceTasks = 0;
+
+		for (int i = 0; i < 4; i++) {
+			delete[] _dctBlocks[i].blocks;
+			delete[] _dctBlocks[i].coeffs;
+			_dctBlocks[i].blocks = 0;
+			_dctBlocks[i].coeffs = 0;
+		}
+
+		return;
+	}
+
+	Common::ThreadPool &pool = g_system->getThreadPool();
+	if (pool.getThreadCount() == 0) {
+		// Without worker threads, the slices would only add overhead
+		return;
+	}
+
+	_sliceTasks = new Common::TaskGroup(pool);
+
+	for (int i = 0; i < 4; i++) {
+		if (i == 3 && !_hasAlpha)
+			continue;
+
+		// Every 8x8 block of a plane may be a DCT block
+		uint32 blockCount = (i == 1 || i == 2) ? _uvBlockWidth * _uvBlockHeight : _yBlockWidth * _yBlockHeight;
+		_dctBlocks[i].blocks = new DCTBlock[blockCount];
+		_dctBlocks[i].coeffs = new int32[blockCount * 64];
+	}
+}
+
 bool BinkDecoder::BinkVideoTrack::rewind() {
 	if (!VideoTrack::rewind()) {
 		return false;
@@ -485,6 +549,10 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 			break;
 	}
 
+	// The slice tasks have to finish the planes first
+	if (_sliceTasks)
+		_sliceTasks->wait();
+
 	// Convert the YUV data we have to our format
 	// The width used here is the surface-width, and not the video-width
 	// to allow for odd-sized videos.
@@ -520,6 +588,12 @@ void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, b
 	ctx.prevStart = _oldPlanes[planeIdx];
 	ctx.prevEnd   = _oldPlanes[planeIdx] + width * height;
 	ctx.pitch     = width;
+	ctx.dctBlocks = _sliceTasks ? &_dctBlocks[planeIdx] : 0;
+
+	if (ctx.dctBlocks) {
+		ctx.dctBlocks->count      = 0;
+		ctx.dctBlocks->sliceStart = 0;
+	}
 
 	for (int i = 0; i < 64; i++) {
 		ctx.coordMap[i] = (i & 7) + (i >> 3) * ctx.pitch;
@@ -598,13 +672,71 @@ void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, b
 
 		}
 
+		if (ctx.dctBlocks && ((ctx.blockY + 1) % kSliceBlockRows) == 0)
+			submitDCTSlice(*ctx.dctBlocks, ctx.destStart, ctx.pitch);
 	}
 
+	if (ctx.dctBlocks)
+		submitDCTSlice(*ctx.dctBlocks, ctx.destStart, ctx.pitch);
+
 	if (video.bits->pos() & 0x1F) // next plane data starts at 32-bit boundary
 		video.bits->skip(32 - (video.bits->pos() & 0x1F));
 
 }
 
+int32 *BinkDecoder::BinkVideoTrack::startDCTBlock(DecodeContext &ctx) {
+	int32 *block = ctx.dctBlocks ? ctx.dctBlocks->coeffs + ctx.dctBlocks->count * 64 : ctx.coeffs;
+	memset(block, 0, 64 * sizeof(int32));
+
+	return block;
+}
+
+void BinkDecoder::BinkVideoTrack::finishDCTBlock(DecodeContext &ctx, int32 *block, BlockType type) {
+	if (!ctx.dctBlocks) {
+		transformDCTBlock(*_dsp, ctx.dest, ctx.pitch, block, type);
+		return;
+	}
+
+	DCTBlock &dctBlock = ctx.dctBlocks->blocks[ctx.dctBlocks->count++];
+	dctBlock.offset = ctx.dest - ctx.destStart;
+	dctBlock.type   = type;
+}
+
+void BinkDecoder::BinkVideoTrack::submitDCTSlice(DCTBlockList &list, byte *plane, uint32 pitch) {
+	if (list.sliceStart == list.count)
+		return;
+
+	// The task only touches the blocks of its slice, which no other code
+	// writes to until the frame is done
+	const BinkDSP *dsp = _dsp;
+	const DCTBlock *blocks = list.blocks;
+	const int32 *coeffs = list.coeffs;
+	const uint32 start = list.sliceStart;
+	const uint32 end = list.count;
+	_sliceTasks->run([=]() {
+		for (uint32 i = start; i < end; i++)
+			transformDCTBlock(*dsp, plane + blocks[i].offset, pitch, coeffs + i * 64, blocks[i].type);
+	});
+
+	list.sliceStart = list.count;
+}
+
+void BinkDecoder::BinkVideoTrack::transformDCTBlock(const BinkDSP &dsp, byte *dest, uint32 pitch, const int32 *block, byte type) {
+	switch (type) {
+	case kBlockIntra:
+		dsp.idctPut(dest, pitch, block);
+		break;
+	case kBlockInter:
+		dsp.idctAdd(dest, pitch, block);
+		break;
+	case kBlockScaled:
+		dsp.idctPutScaled(dest, pitch, block);
+		break;
+	default:
+		break;
+	}
+}
+
 void BinkDecoder::BinkVideoTrack::readBundle(VideoFrame &video, Source source) {
 	if (source == kSourceColors) {
 		for (int i = 0; i < 16; i++)
@@ -815,24 +947,13 @@ void BinkDecoder::BinkVideoTrack::blockScaledRun(DecodeContext &ctx) {
 }
 
 void BinkDecoder::BinkVideoTrack::blockScaledIntra(DecodeContext &ctx) {
-	int32 block[64];
-	memset(block, 0, 64 * sizeof(int32));
+	int32 *block = startDCTBlock(ctx);
 
 	block[0] = getBundleValue(kSourceIntraDC);
 
 	readDCTCoeffs(*ctx.video, block, true);
 
-	IDCT(block);
-
-	int32 *src   = block;
-	byte  *dest1 = ctx.dest;
-	byte  *dest2 = ctx.dest + ctx.pitch;
-	for (int j = 0; j < 8; j++, dest1 += (ctx.pitch << 1) - 16, dest2 += (ctx.pitch << 1) - 16, src += 8) {
-
-		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2)
-			dest1[0] = dest1[1] = dest2[0] = dest2[1] = src[i];
-
-	}
+	finishDCTBlock(ctx, block, kBlockScaled);
 }
 
 void BinkDecoder::BinkVideoTrack::blockScaledFill(DecodeContext &ctx) {
@@ -952,22 +1073,17 @@ void BinkDecoder::BinkVideoTrack::blockResidue(DecodeContext &ctx) {
 
 	readResidue(*ctx.video, block, v);
 
-	byte  *dst = ctx.dest;
-	int16 *src = block;
-	for (int i = 0; i < 8; i++, dst += ctx.pitch, src += 8)
-		for (int j = 0; j < 8; j++)
-			dst[j] += src[j];
+	_dsp->addResidue(ctx.dest, ctx.pitch, block);
 }
 
 void BinkDecoder::BinkVideoTrack::blockIntra(DecodeContext &ctx) {
-	int32 block[64];
-	memset(block, 0, 64 * sizeof(int32));
+	int32 *block = startDCTBlock(ctx);
 
 	block[0] = getBundleValue(kSourceIntraDC);
 
 	readDCTCoeffs(*ctx.video, block, true);
 
-	IDCTPut(ctx, block);
+	finishDCTBlock(ctx, block, kBlockIntra);
 }
 
 void BinkDecoder::BinkVideoTrack::blockFill(DecodeContext &ctx) {
@@ -981,14 +1097,13 @@ void BinkDecoder::BinkVideoTrack::blockFill(DecodeContext &ctx) {
 void BinkDecoder::BinkVideoTrack::blockInter(DecodeContext &ctx) {
 	blockMotion(ctx);
 
-	int32 block[64];
-	memset(block, 0, 64 * sizeof(int32));
+	int32 *block = startDCTBlock(ctx);
 
 	block[0] = getBundleValue(kSourceInterDC);
 
 	readDCTCoeffs(*ctx.video, block, false);
 
-	IDCTAdd(ctx, block);
+	finishDCTBlock(ctx, block, kBlockInter);
 }
 
 void BinkDecoder::BinkVideoTrack::blockPattern(DecodeContext &ctx) {
@@ -1417,88 +1532,6 @@ void BinkDecoder::BinkVideoTrack::readResidue(VideoFrame &video, int16 *block, i
 	}
 }
 
-#define A1  2896 /* (1/sqrt(2))<<12 */
-#define A2  2217
-#define A3  3784
-#define A4 -5352
-
-#define IDCT_TRANSFORM(dest,s0,s1,s2,s3,s4,s5,s6,s7,d0,d1,d2,d3,d4,d5,d6,d7,munge,src) {\
-	const int a0 = (src)[s0] + (src)[s4]; \
-	const int a1 = (src)[s0] - (src)[s4]; \
-	const int a2 = (src)[s2] + (src)[s6]; \
-	const int a3 = (A1*((src)[s2] - (src)[s6])) >> 11; \
-	const int a4 = (src)[s5] + (src)[s3]; \
-	const int a5 = (src)[s5] - (src)[s3]; \
-	const int a6 = (src)[s1] + (src)[s7]; \
-	const int a7 = (src)[s1] - (src)[s7]; \
-	const int b0 = a4 + a6; \
-	const int b1 = (A3*(a5 + a7)) >> 11; \
-	const int b2 = ((A4*a5) >> 11) - b0 + b1; \
-	const int b3 = (A1*(a6 - a4) >> 11) - b2; \
-	const int b4 = ((A2*a7) >> 11) + b3 - b1; \
-	(dest)[d0] = munge(a0+a2   +b0); \
-	(dest)[d1] = munge(a1+a3-a2+b2); \
-	(dest)[d2] = munge(a1-a3+a2+b3); \
-	(dest)[d3] = munge(a0-a2   -b4); \
-	(dest)[d4] = munge(a0-a2   +b4); \
-	(dest)[d5] = munge(a1-a3+a2-b3); \
-	(dest)[d6] = munge(a1+a3-a2-b2); \
-	(dest)[d7] = munge(a0+a2   -b0); \
-}
-/* end IDCT_TRANSFORM macro */
-
-#define MUNGE_NONE(x) (x)
-#define IDCT_COL(dest,src) IDCT_TRANSFORM(dest,0,8,16,24,32,40,48,56,0,8,16,24,32,40,48,56,MUNGE_NONE,src)
-
-#define MUNGE_ROW(x) (((x) + 0x7F)>>8)
-#define IDCT_ROW(dest,src) IDCT_TRANSFORM(dest,0,1,2,3,4,5,6,7,0,1,2,3,4,5,6,7,MUNGE_ROW,src)
-
-static inline void IDCTCol(int32 *dest, const int32 *src) {
-	if ((src[8] | src[16] | src[24] | src[32] | src[40] | src[48] | src[56]) == 0) {
-		dest[ 0] =
-		dest[ 8] =
-		dest[16] =
-		dest[24] =
-		dest[32] =
-		dest[40] =
-		dest[48] =
-		dest[56] = src[0];
-	} else {
-		IDCT_COL(dest, src);
-	}
-}
-
-void BinkDecoder::BinkVideoTrack::IDCT(int32 *block) {
-	int i;
-	int32 temp[64];
-
-	for (i = 0; i < 8; i++)
-		IDCTCol(&temp[i], &block[i]);
-	for (i = 0; i < 8; i++) {
-		IDCT_ROW( (&block[8*i]), (&temp[8*i]) );
-	}
-}
-
-void BinkDecoder::BinkVideoTrack::IDCTAdd(DecodeContext &ctx, int32 *block) {
-	int i, j;
-
-	IDCT(block);
-	byte *dest = ctx.dest;
-	for (i = 0; i < 8; i++, dest += ctx.pitch, block += 8)
-		for (j = 0; j < 8; j++)
-			 dest[j] += block[j];
-}
-
-void BinkDecoder::BinkVideoTrack::IDCTPut(DecodeContext &ctx, int32 *block) {
-	int i;
-	int32 temp[64];
-	for (i = 0; i < 8; i++)
-		IDCTCol(&temp[i], &block[i]);
-	for (i = 0; i < 8; i++) {
-		IDCT_ROW( (&ctx.dest[i*ctx.pitch]), (&temp[8*i]) );
-	}
-}
-
 BinkDecoder::BinkAudioTrack::BinkAudioTrack(BinkDecoder::AudioInfo &audio, Audio::Mixer::SoundType soundType) :
 		AudioTrack(soundType),
 		_audioInfo(&audio) {
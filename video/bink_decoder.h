@@ -45,6 +45,7 @@ class QueuingAudioStream;
 
 namespace Common {
 class SeekableReadStream;
+class TaskGroup;
 template <class BITSTREAM>
 class Huffman;
 
@@ -58,6 +59,8 @@ struct Surface;
 
 namespace Video {
 
+struct BinkDSP;
+
 /**
  * Decoder for Bink videos.
  *
@@ -74,6 +77,13 @@ public:
 
 	Common::Rational getFrameRate();
 
+	/**
+	 * Enable or disable decoding the frames in slices on worker threads.
+	 * It is enabled by default, if the backend supports threads. This must
+	 * be called after loadStream().
+	 */
+	void setSliceThreading(bool enable);
+
 protected:
 	void readNextPacket();
 	bool supportsAudioTrackSwitching() const { return true; }
@@ -164,7 +174,27 @@ private:
 
 		Common::Rational getFrameRate() const override { return _frameRate; }
 
+		/** Transform DCT blocks on worker threads, see BinkDecoder::setSliceThreading(). */
+		void setSliceThreading(bool enable);
+
 	private:
+		/** A DCT block whose inverse transform is left to a slice task. */
+		struct DCTBlock {
+			uint32 offset; ///< Position of the block in its plane.
+			byte   type;   ///< kBlockIntra, kBlockInter or kBlockScaled.
+		};
+
+		/**
+		 * The DCT blocks of a plane. While the plane is being decoded, they
+		 * are handed to tasks on the thread pool in slices of block rows.
+		 */
+		struct DCTBlockList {
+			DCTBlock *blocks;
+			int32 *coeffs;     ///< The 64 coefficients of each block.
+			uint32 count;
+			uint32 sliceStart; ///< First block not yet handed to a task.
+		};
+
 		/** A decoder state. */
 		struct DecodeContext {
 			VideoFrame *video;
@@ -187,6 +217,10 @@ private:
 			int coordScaledMap2[64];
 			int coordScaledMap3[64];
 			int coordScaledMap4[64];
+
+			/** The DCT blocks to transform in slices, or 0 to transform them right away. */
+			DCTBlockList *dctBlocks;
+			int32 coeffs[64];
 		};
 
 		/** IDs for different data types used in Bink video codec. */
@@ -269,6 +303,11 @@ private:
 		byte *_curPlanes[4]; ///< The 4 color planes, YUVA, current frame.
 		byte *_oldPlanes[4]; ///< The 4 color planes, YUVA, last frame.
 
+		const BinkDSP *_dsp; ///< The pixel kernels for the host CPU.
+
+		Common::TaskGroup *_sliceTasks; ///< The slice tasks of the current frame, if slice threading is enabled.
+		DCTBlockList _dctBlocks[4];      ///< The DCT blocks of each plane.
+
 		/** Initialize the bundles. */
 		void initBundles();
 		/** Deinitialize the bundles. */
@@ -280,6 +319,15 @@ private:
 		/** Decode a plane. */
 		void decodePlane(VideoFrame &video, int planeIdx, bool isChroma);
 
+		/** Get cleared storage for the coefficients of a DCT block. */
+		int32 *startDCTBlock(DecodeContext &ctx);
+		/** Transform a DCT block, or leave it for a slice task. */
+		void finishDCTBlock(DecodeContext &ctx, int32 *block, BlockType type);
+		/** Hand the DCT blocks read since the last slice to a task. */
+		void submitDCTSlice(DCTBlockList &list, byte *plane, uint32 pitch);
+		/** Transform a DCT block into the plane. */
+		static void transformDCTBlock(const BinkDSP &dsp, byte *dest, uint32 pitch, const int32 *block, byte type);
+
 		/** Read/Initialize a bundle for decoding a plane. */
 		void readBundle(VideoFrame &video, Source source);
 
@@ -324,11 +372,6 @@ private:
 		void readDCS         (VideoFrame &video, Bundle &bundle);
 		void readDCTCoeffs   (VideoFrame &video, int32 *block, bool isIntra);
 		void readResidue     (VideoFrame &video, int16 *block, int masksCount);
-
-		// Bink video IDCT
-		void IDCT(int32 *block);
-		void IDCTPut(DecodeContext &ctx, int32 *block);
-		void IDCTAdd(DecodeContext &ctx, int32 *block);
 	};
 
 	class BinkAudioTrack : public AudioTrack {
@@ -0,0 +1,72 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#ifdef USE_BINK
+
+#ifndef VIDEO_BINK_DSP_H
+#define VIDEO_BINK_DSP_H
+
+namespace Video {
+
+/**
+ * The pixel kernels of the Bink video decoder, which are worth running
+ * through SIMD code. The blocks hold 8x8 values, row by row; the planes
+ * are 8-bit with the given pitch. Results wrap around like the original
+ * decoder's byte stores do.
+ */
+struct BinkDSP {
+	/** Inverse transform the DCT coefficients and store the 8x8 pixels. */
+	void (*idctPut)(byte *dest, int pitch, const int32 *block);
+	/** Inverse transform the DCT coefficients and add them to the 8x8 pixels. */
+	void (*idctAdd)(byte *dest, int pitch, const int32 *block);
+	/** Inverse transform the DCT coefficients and store them as 16x16 pixels. */
+	void (*idctPutScaled)(byte *dest, int pitch, const int32 *block);
+	/** Add the motion compensation residue to the 8x8 pixels. */
+	void (*addResidue)(byte *dest, int pitch, const int16 *block);
+};
+
+/** Set up the plain C++ kernels. */
+void initBinkDSP(BinkDSP &dsp);
+
+#ifdef SCUMMVM_SSE2
+void initBinkDSPSSE2(BinkDSP &dsp);
+#endif
+
+#ifdef SCUMMVM_AVX2
+/** Replace the transforms, which gain from the wider vectors. */
+void initBinkDSPAVX2(BinkDSP &dsp);
+#endif
+
+#ifdef SCUMMVM_NEON
+void initBinkDSPNEON(BinkDSP &dsp);
+#endif
+
+/** Return the fastest kernels the host CPU supports. */
+const BinkDSP &getBinkDSP();
+
+} // End of namespace Video
+
+#endif // VIDEO_BINK_DSP_H
+
+#endif // USE_BINK
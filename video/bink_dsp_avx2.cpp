@@ -0,0 +1,195 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#ifdef USE_BINK
+
+#include <immintrin.h>
+
+#include "video/bink_dsp.h"
+
+namespace Video {
+
+namespace {
+
+inline __m256i mulShift(__m256i a, int32 k) {
+	return _mm256_srai_epi32(_mm256_mullo_epi32(a, _mm256_set1_epi32(k)), 11);
+}
+
+/**
+ * The one-dimensional transform of the C++ code, on all eight columns or
+ * rows at once. s[i] and d[i] are the vectors with the input and output
+ * values for index i.
+ */
+template<bool kRound>
+inline void transform(__m256i *d, const __m256i *s) {
+	const __m256i a0 = _mm256_add_epi32(s[0], s[4]);
+	const __m256i a1 = _mm256_sub_epi32(s[0], s[4]);
+	const __m256i a2 = _mm256_add_epi32(s[2], s[6]);
+	const __m256i a3 = mulShift(_mm256_sub_epi32(s[2], s[6]), 2896);
+	const __m256i a4 = _mm256_add_epi32(s[5], s[3]);
+	const __m256i a5 = _mm256_sub_epi32(s[5], s[3]);
+	const __m256i a6 = _mm256_add_epi32(s[1], s[7]);
+	const __m256i a7 = _mm256_sub_epi32(s[1], s[7]);
+	const __m256i b0 = _mm256_add_epi32(a4, a6);
+	const __m256i b1 = mulShift(_mm256_add_epi32(a5, a7), 3784);
+	const __m256i b2 = _mm256_add_epi32(_mm256_sub_epi32(mulShift(a5, -5352), b0), b1);
+	const __m256i b3 = _mm256_sub_epi32(mulShift(_mm256_sub_epi32(a6, a4), 2896), b2);
+	const __m256i b4 = _mm256_sub_epi32(_mm256_add_epi32(mulShift(a7, 2217), b3), b1);
+
+	const __m256i a0a2 = _mm256_add_epi32(a0, a2);
+	const __m256i a0s2 = _mm256_sub_epi32(a0, a2);
+	const __m256i a1a3 = _mm256_sub_epi32(_mm256_add_epi32(a1, a3), a2);
+	const __m256i a1s3 = _mm256_add_epi32(_mm256_sub_epi32(a1, a3), a2);
+	d[0] = _mm256_add_epi32(a0a2, b0);
+	d[1] = _mm256_add_epi32(a1a3, b2);
+	d[2] = _mm256_add_epi32(a1s3, b3);
+	d[3] = _mm256_sub_epi32(a0s2, b4);
+	d[4] = _mm256_add_epi32(a0s2, b4);
+	d[5] = _mm256_sub_epi32(a1s3, b3);
+	d[6] = _mm256_sub_epi32(a1a3, b2);
+	d[7] = _mm256_sub_epi32(a0a2, b0);
+
+	if (kRound) {
+		const __m256i bias = _mm256_set1_epi32(0x7F);
+		for (int i = 0; i < 8; i++)
+			d[i] = _mm256_srai_epi32(_mm256_add_epi32(d[i], bias), 8);
+	}
+}
+
+/** Transpose an 8x8 matrix held as one vector per row. */
+inline void transpose(__m256i *v) {
+	const __m256i t0 = _mm256_unpacklo_epi32(v[0], v[1]);
+	const __m256i t1 = _mm256_unpackhi_epi32(v[0], v[1]);
+	const __m256i t2 = _mm256_unpacklo_epi32(v[2], v[3]);
+	const __m256i t3 = _mm256_unpackhi_epi32(v[2], v[3]);
+	const __m256i t4 = _mm256_unpacklo_epi32(v[4], v[5]);
+	const __m256i t5 = _mm256_unpackhi_epi32(v[4], v[5]);
+	const __m256i t6 = _mm256_unpacklo_epi32(v[6], v[7]);
+	const __m256i t7 = _mm256_unpackhi_epi32(v[6], v[7]);
+
+	const __m256i u0 = _mm256_unpacklo_epi64(t0, t2);
+	const __m256i u1 = _mm256_unpackhi_epi64(t0, t2);
+	const __m256i u2 = _mm256_unpacklo_epi64(t1, t3);
+	const __m256i u3 = _mm256_unpackhi_epi64(t1, t3);
+	const __m256i u4 = _mm256_unpacklo_epi64(t4, t6);
+	const __m256i u5 = _mm256_unpackhi_epi64(t4, t6);
+	const __m256i u6 = _mm256_unpacklo_epi64(t5, t7);
+	const __m256i u7 = _mm256_unpackhi_epi64(t5, t7);
+
+	v[0] = _mm256_permute2x128_si256(u0, u4, 0x20);
+	v[1] = _mm256_permute2x128_si256(u1, u5, 0x20);
+	v[2] = _mm256_permute2x128_si256(u2, u6, 0x20);
+	v[3] = _mm256_permute2x128_si256(u3, u7, 0x20);
+	v[4] = _mm256_permute2x128_si256(u0, u4, 0x31);
+	v[5] = _mm256_permute2x128_si256(u1, u5, 0x31);
+	v[6] = _mm256_permute2x128_si256(u2, u6, 0x31);
+	v[7] = _mm256_permute2x128_si256(u3, u7, 0x31);
+}
+
+/**
+ * Inverse transform a block into the 8-bit results. Each of the returned
+ * vectors holds two rows, rows[i] holds rows 2 * i and 2 * i + 1.
+ */
+inline void idct(__m128i *rows, const int32 *block) {
+	__m256i v[8];
+
+	for (int i = 0; i < 8; i++)
+		v[i] = _mm256_loadu_si256((const __m256i *)(block + 8 * i));
+
+	// Columns first, then the rows turned into columns
+	transform<false>(v, v);
+	transpose(v);
+	transform<true>(v, v);
+	transpose(v);
+
+	// Keep the low byte of every value, like storing it in a byte does.
+	// The packs work within the 128-bit lanes, which leaves the first four
+	// values of four rows in the low lane and the last four in the high one.
+	const __m256i mask = _mm256_set1_epi32(0xFF);
+	for (int i = 0; i < 8; i++)
+		v[i] = _mm256_and_si256(v[i], mask);
+
+	for (int i = 0; i < 2; i++) {
+		const __m256i words0 = _mm256_packs_epi32(v[4 * i + 0], v[4 * i + 1]);
+		const __m256i words1 = _mm256_packs_epi32(v[4 * i + 2], v[4 * i + 3]);
+		const __m256i bytes = _mm256_packus_epi16(words0, words1);
+		const __m128i low = _mm256_castsi256_si128(bytes);
+		const __m128i high = _mm256_extracti128_si256(bytes, 1);
+		rows[2 * i + 0] = _mm_unpacklo_epi32(low, high);
+		rows[2 * i + 1] = _mm_unpackhi_epi32(low, high);
+	}
+}
+
+inline void storeRows(byte *dest, int pitch, __m128i rows) {
+	_mm_storel_epi64((__m128i *)dest, rows);
+	_mm_storel_epi64((__m128i *)(dest + pitch), _mm_srli_si128(rows, 8));
+}
+
+inline __m128i loadRows(const byte *src, int pitch) {
+	return _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)src), _mm_loadl_epi64((const __m128i *)(src + pitch)));
+}
+
+void idctPutAVX2(byte *dest, int pitch, const int32 *block) {
+	__m128i rows[4];
+	idct(rows, block);
+
+	for (int i = 0; i < 4; i++, dest += 2 * pitch)
+		storeRows(dest, pitch, rows[i]);
+}
+
+void idctAddAVX2(byte *dest, int pitch, const int32 *block) {
+	__m128i rows[4];
+	idct(rows, block);
+
+	for (int i = 0; i < 4; i++, dest += 2 * pitch)
+		storeRows(dest, pitch, _mm_add_epi8(loadRows(dest, pitch), rows[i]));
+}
+
+void idctPutScaledAVX2(byte *dest, int pitch, const int32 *block) {
+	__m128i rows[4];
+	idct(rows, block);
+
+	for (int i = 0; i < 4; i++) {
+		const __m128i row0 = _mm_unpacklo_epi8(rows[i], rows[i]);
+		const __m128i row1 = _mm_unpackhi_epi8(rows[i], rows[i]);
+		_mm_storeu_si128((__m128i *)dest, row0);
+		_mm_storeu_si128((__m128i *)(dest + pitch), row0);
+		dest += 2 * pitch;
+		_mm_storeu_si128((__m128i *)dest, row1);
+		_mm_storeu_si128((__m128i *)(dest + pitch), row1);
+		dest += 2 * pitch;
+	}
+}
+
+} // End of anonymous namespace
+
+void initBinkDSPAVX2(BinkDSP &dsp) {
+	dsp.idctPut = idctPutAVX2;
+	dsp.idctAdd = idctAddAVX2;
+	dsp.idctPutScaled = idctPutScaledAVX2;
+}
+
+} // End of namespace Video
+
+#endif // USE_BINK
@@ -0,0 +1,180 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#ifdef USE_BINK
+
+#include <arm_neon.h>
+
+#include "video/bink_dsp.h"
+
+namespace Video {
+
+namespace {
+
+inline int32x4_t mulShift(int32x4_t a, int32 k) {
+	return vshrq_n_s32(vmulq_n_s32(a, k), 11);
+}
+
+/**
+ * The one-dimensional transform of the C++ code, on four columns or rows
+ * at once. s[i] and d[i] are the vectors with the input and output values
+ * for index i.
+ */
+template<bool kRound>
+inline void transform(int32x4_t *d, const int32x4_t *s) {
+	const int32x4_t a0 = vaddq_s32(s[0], s[4]);
+	const int32x4_t a1 = vsubq_s32(s[0], s[4]);
+	const int32x4_t a2 = vaddq_s32(s[2], s[6]);
+	const int32x4_t a3 = mulShift(vsubq_s32(s[2], s[6]), 2896);
+	const int32x4_t a4 = vaddq_s32(s[5], s[3]);
+	const int32x4_t a5 = vsubq_s32(s[5], s[3]);
+	const int32x4_t a6 = vaddq_s32(s[1], s[7]);
+	const int32x4_t a7 = vsubq_s32(s[1], s[7]);
+	const int32x4_t b0 = vaddq_s32(a4, a6);
+	const int32x4_t b1 = mulShift(vaddq_s32(a5, a7), 3784);
+	const int32x4_t b2 = vaddq_s32(vsubq_s32(mulShift(a5, -5352), b0), b1);
+	const int32x4_t b3 = vsubq_s32(mulShift(vsubq_s32(a6, a4), 2896), b2);
+	const int32x4_t b4 = vsubq_s32(vaddq_s32(mulShift(a7, 2217), b3), b1);
+
+	const int32x4_t a0a2 = vaddq_s32(a0, a2);
+	const int32x4_t a0s2 = vsubq_s32(a0, a2);
+	const int32x4_t a1a3 = vsubq_s32(vaddq_s32(a1, a3), a2);
+	const int32x4_t a1s3 = vaddq_s32(vsubq_s32(a1, a3), a2);
+	d[0] = vaddq_s32(a0a2, b0);
+	d[1] = vaddq_s32(a1a3, b2);
+	d[2] = vaddq_s32(a1s3, b3);
+	d[3] = vsubq_s32(a0s2, b4);
+	d[4] = vaddq_s32(a0s2, b4);
+	d[5] = vsubq_s32(a1s3, b3);
+	d[6] = vsubq_s32(a1a3, b2);
+	d[7] = vsubq_s32(a0a2, b0);
+
+	if (kRound) {
+		const int32x4_t bias = vdupq_n_s32(0x7F);
+		for (int i = 0; i < 8; i++)
+			d[i] = vshrq_n_s32(vaddq_s32(d[i], bias), 8);
+	}
+}
+
+/**
+ * Transpose an 8x8 matrix held as v[2 * i + h], with half h of row i in
+ * each vector.
+ */
+inline void transpose(int32x4_t *dst, const int32x4_t *src) {
+	for (int r = 0; r < 2; r++) {
+		for (int c = 0; c < 2; c++) {
+			const int32x4_t *s = src + 8 * r + c;
+			const int32x4x2_t t0 = vtrnq_s32(s[0], s[2]);
+			const int32x4x2_t t1 = vtrnq_s32(s[4], s[6]);
+
+			int32x4_t *d = dst + 8 * c + r;
+			d[0] = vcombine_s32(vget_low_s32(t0.val[0]), vget_low_s32(t1.val[0]));
+			d[2] = vcombine_s32(vget_low_s32(t0.val[1]), vget_low_s32(t1.val[1]));
+			d[4] = vcombine_s32(vget_high_s32(t0.val[0]), vget_high_s32(t1.val[0]));
+			d[6] = vcombine_s32(vget_high_s32(t0.val[1]), vget_high_s32(t1.val[1]));
+		}
+	}
+}
+
+/** Inverse transform a block into the 8-bit results, one row per vector. */
+inline void idct(uint8x8_t *rows, const int32 *block) {
+	int32x4_t in[16], temp[16], s[8], d[8];
+
+	for (int i = 0; i < 16; i++)
+		in[i] = vld1q_s32(block + 4 * i);
+
+	// Columns first, four of them side by side
+	for (int h = 0; h < 2; h++) {
+		for (int i = 0; i < 8; i++)
+			s[i] = in[2 * i + h];
+		transform<false>(d, s);
+		for (int i = 0; i < 8; i++)
+			temp[2 * i + h] = d[i];
+	}
+
+	// Then the rows, turned into columns
+	transpose(in, temp);
+	for (int h = 0; h < 2; h++) {
+		for (int i = 0; i < 8; i++)
+			s[i] = in[2 * i + h];
+		transform<true>(d, s);
+		for (int i = 0; i < 8; i++)
+			temp[2 * i + h] = d[i];
+	}
+	transpose(in, temp);
+
+	// Keep the low byte of every value, like storing it in a byte does
+	for (int i = 0; i < 8; i++) {
+		const uint16x8_t words = vcombine_u16(vmovn_u32(vreinterpretq_u32_s32(in[2 * i])), vmovn_u32(vreinterpretq_u32_s32(in[2 * i + 1])));
+		rows[i] = vmovn_u16(words);
+	}
+}
+
+void idctPutNEON(byte *dest, int pitch, const int32 *block) {
+	uint8x8_t rows[8];
+	idct(rows, block);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		vst1_u8(dest, rows[i]);
+}
+
+void idctAddNEON(byte *dest, int pitch, const int32 *block) {
+	uint8x8_t rows[8];
+	idct(rows, block);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		vst1_u8(dest, vadd_u8(vld1_u8(dest), rows[i]));
+}
+
+void idctPutScaledNEON(byte *dest, int pitch, const int32 *block) {
+	uint8x8_t rows[8];
+	idct(rows, block);
+
+	for (int i = 0; i < 8; i++, dest += 2 * pitch) {
+		const uint8x8x2_t pixels = vzip_u8(rows[i], rows[i]);
+		const uint8x16_t row = vcombine_u8(pixels.val[0], pixels.val[1]);
+		vst1q_u8(dest, row);
+		vst1q_u8(dest + pitch, row);
+	}
+}
+
+void addResidueNEON(byte *dest, int pitch, const int16 *block) {
+	for (int i = 0; i < 8; i++, dest += pitch, block += 8) {
+		const uint8x8_t residue = vmovn_u16(vreinterpretq_u16_s16(vld1q_s16(block)));
+		vst1_u8(dest, vadd_u8(vld1_u8(dest), residue));
+	}
+}
+
+} // End of anonymous namespace
+
+void initBinkDSPNEON(BinkDSP &dsp) {
+	dsp.idctPut = idctPutNEON;
+	dsp.idctAdd = idctAddNEON;
+	dsp.idctPutScaled = idctPutScaledNEON;
+	dsp.addResidue = addResidueNEON;
+}
+
+} // End of namespace Video
+
+#endif // USE_BINK
@@ -0,0 +1,206 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#ifdef USE_BINK
+
+#include <emmintrin.h>
+
+#include "video/bink_dsp.h"
+
+namespace Video {
+
+namespace {
+
+/**
+ * Multiply by a constant, keeping the low 32 bits of the products like
+ * plain int arithmetic does. SSE2 lacks a 32-bit multiply for that.
+ */
+inline __m128i mul32(__m128i a, int32 k) {
+	const __m128i factor = _mm_set1_epi32(k);
+	const __m128i even = _mm_mul_epu32(a, factor);
+	const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), factor);
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+/**
+ * The one-dimensional transform of the C++ code, on four columns or rows
+ * at once. s[i] and d[i] are the vectors with the input and output values
+ * for index i.
+ */
+template<bool kRound>
+inline void transform(__m128i *d, const __m128i *s) {
+	const __m128i a0 = _mm_add_epi32(s[0], s[4]);
+	const __m128i a1 = _mm_sub_epi32(s[0], s[4]);
+	const __m128i a2 = _mm_add_epi32(s[2], s[6]);
+	const __m128i a3 = _mm_srai_epi32(mul32(_mm_sub_epi32(s[2], s[6]), 2896), 11);
+	const __m128i a4 = _mm_add_epi32(s[5], s[3]);
+	const __m128i a5 = _mm_sub_epi32(s[5], s[3]);
+	const __m128i a6 = _mm_add_epi32(s[1], s[7]);
+	const __m128i a7 = _mm_sub_epi32(s[1], s[7]);
+	const __m128i b0 = _mm_add_epi32(a4, a6);
+	const __m128i b1 = _mm_srai_epi32(mul32(_mm_add_epi32(a5, a7), 3784), 11);
+	const __m128i b2 = _mm_add_epi32(_mm_sub_epi32(_mm_srai_epi32(mul32(a5, -5352), 11), b0), b1);
+	const __m128i b3 = _mm_sub_epi32(_mm_srai_epi32(mul32(_mm_sub_epi32(a6, a4), 2896), 11), b2);
+	const __m128i b4 = _mm_sub_epi32(_mm_add_epi32(_mm_srai_epi32(mul32(a7, 2217), 11), b3), b1);
+
+	const __m128i a0a2 = _mm_add_epi32(a0, a2);
+	const __m128i a0s2 = _mm_sub_epi32(a0, a2);
+	const __m128i a1a3 = _mm_sub_epi32(_mm_add_epi32(a1, a3), a2);
+	const __m128i a1s3 = _mm_add_epi32(_mm_sub_epi32(a1, a3), a2);
+	d[0] = _mm_add_epi32(a0a2, b0);
+	d[1] = _mm_add_epi32(a1a3, b2);
+	d[2] = _mm_add_epi32(a1s3, b3);
+	d[3] = _mm_sub_epi32(a0s2, b4);
+	d[4] = _mm_add_epi32(a0s2, b4);
+	d[5] = _mm_sub_epi32(a1s3, b3);
+	d[6] = _mm_sub_epi32(a1a3, b2);
+	d[7] = _mm_sub_epi32(a0a2, b0);
+
+	if (kRound) {
+		const __m128i bias = _mm_set1_epi32(0x7F);
+		for (int i = 0; i < 8; i++)
+			d[i] = _mm_srai_epi32(_mm_add_epi32(d[i], bias), 8);
+	}
+}
+
+/**
+ * Transpose an 8x8 matrix held as v[2 * i + h], with half h of row i in
+ * each vector.
+ */
+inline void transpose(__m128i *dst, const __m128i *src) {
+	for (int r = 0; r < 2; r++) {
+		for (int c = 0; c < 2; c++) {
+			const __m128i *s = src + 8 * r + c;
+			const __m128i t0 = _mm_unpacklo_epi32(s[0], s[2]);
+			const __m128i t1 = _mm_unpacklo_epi32(s[4], s[6]);
+			const __m128i t2 = _mm_unpackhi_epi32(s[0], s[2]);
+			const __m128i t3 = _mm_unpackhi_epi32(s[4], s[6]);
+
+			__m128i *d = dst + 8 * c + r;
+			d[0] = _mm_unpacklo_epi64(t0, t1);
+			d[2] = _mm_unpackhi_epi64(t0, t1);
+			d[4] = _mm_unpacklo_epi64(t2, t3);
+			d[6] = _mm_unpackhi_epi64(t2, t3);
+		}
+	}
+}
+
+/** Inverse transform a block into the 8-bit results, two rows per vector. */
+inline void idct(__m128i *rows, const int32 *block) {
+	__m128i in[16], temp[16], s[8], d[8];
+
+	for (int i = 0; i < 16; i++)
+		in[i] = _mm_loadu_si128((const __m128i *)(block + 4 * i));
+
+	// Columns first, four of them side by side
+	for (int h = 0; h < 2; h++) {
+		for (int i = 0; i < 8; i++)
+			s[i] = in[2 * i + h];
+		transform<false>(d, s);
+		for (int i = 0; i < 8; i++)
+			temp[2 * i + h] = d[i];
+	}
+
+	// Then the rows, turned into columns
+	transpose(in, temp);
+	for (int h = 0; h < 2; h++) {
+		for (int i = 0; i < 8; i++)
+			s[i] = in[2 * i + h];
+		transform<true>(d, s);
+		for (int i = 0; i < 8; i++)
+			temp[2 * i + h] = d[i];
+	}
+	transpose(in, temp);
+
+	// Keep the low byte of every value, like storing it in a byte does
+	const __m128i mask = _mm_set1_epi32(0xFF);
+	for (int i = 0; i < 4; i++) {
+		const __m128i row0 = _mm_packs_epi32(_mm_and_si128(in[4 * i + 0], mask), _mm_and_si128(in[4 * i + 1], mask));
+		const __m128i row1 = _mm_packs_epi32(_mm_and_si128(in[4 * i + 2], mask), _mm_and_si128(in[4 * i + 3], mask));
+		rows[i] = _mm_packus_epi16(row0, row1);
+	}
+}
+
+inline void storeRows(byte *dest, int pitch, __m128i rows) {
+	_mm_storel_epi64((__m128i *)dest, rows);
+	_mm_storel_epi64((__m128i *)(dest + pitch), _mm_srli_si128(rows, 8));
+}
+
+inline __m128i loadRows(const byte *src, int pitch) {
+	return _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)src), _mm_loadl_epi64((const __m128i *)(src + pitch)));
+}
+
+void idctPutSSE2(byte *dest, int pitch, const int32 *block) {
+	__m128i rows[4];
+	idct(rows, block);
+
+	for (int i = 0; i < 4; i++, dest += 2 * pitch)
+		storeRows(dest, pitch, rows[i]);
+}
+
+void idctAddSSE2(byte *dest, int pitch, const int32 *block) {
+	__m128i rows[4];
+	idct(rows, block);
+
+	for (int i = 0; i < 4; i++, dest += 2 * pitch)
+		storeRows(dest, pitch, _mm_add_epi8(loadRows(dest, pitch), rows[i]));
+}
+
+void idctPutScaledSSE2(byte *dest, int pitch, const int32 *block) {
+	__m128i rows[4];
+	idct(rows, block);
+
+	for (int i = 0; i < 4; i++) {
+		const __m128i row0 = _mm_unpacklo_epi8(rows[i], rows[i]);
+		const __m128i row1 = _mm_unpackhi_epi8(rows[i], rows[i]);
+		_mm_storeu_si128((__m128i *)dest, row0);
+		_mm_storeu_si128((__m128i *)(dest + pitch), row0);
+		dest += 2 * pitch;
+		_mm_storeu_si128((__m128i *)dest, row1);
+		_mm_storeu_si128((__m128i *)(dest + pitch), row1);
+		dest += 2 * pitch;
+	}
+}
+
+void addResidueSSE2(byte *dest, int pitch, const int16 *block) {
+	const __m128i mask = _mm_set1_epi16(0xFF);
+	for (int i = 0; i < 4; i++, dest += 2 * pitch, block += 16) {
+		const __m128i row0 = _mm_and_si128(_mm_loadu_si128((const __m128i *)block), mask);
+		const __m128i row1 = _mm_and_si128(_mm_loadu_si128((const __m128i *)(block + 8)), mask);
+		storeRows(dest, pitch, _mm_add_epi8(loadRows(dest, pitch), _mm_packus_epi16(row0, row1)));
+	}
+}
+
+} // End of anonymous namespace
+
+void initBinkDSPSSE2(BinkDSP &dsp) {
+	dsp.idctPut = idctPutSSE2;
+	dsp.idctAdd = idctAddSSE2;
+	dsp.idctPutScaled = idctPutScaledSSE2;
+	dsp.addResidue = addResidueSSE2;
+}
+
+} // End of namespace Video
+
+#endif // USE_BINK
@@ -18,7 +18,27 @@ MODULE_OBJS := \
 
 ifdef USE_BINK
 MODULE_OBJS += \
-	bink_decoder.o
+	bink_decoder.o \
+	bink_dsp.o
+
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	bink_dsp_sse2.o
+
+$(MODULE)/bink_dsp_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	bink_dsp_avx2.o
+
+$(MODULE)/bink_dsp_avx2.o: CXXFLAGS += -mavx2
+endif
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	bink_dsp_neon.o
+endif
 endif
 
 ifdef USE_THEORADEC
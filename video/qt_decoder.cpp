@@ -40,6 +40,7 @@
 
 // Video codecs
 #include "image/codecs/codec.h"
+#include "image/codecs/surface_pool.h"
 
 namespace Video {
 
@@ -310,6 +311,7 @@ QuickTimeDecoder::VideoTrackHandler::VideoTrackHandler(QuickTimeDecoder *decoder
 	_forcedDitherPalette = 0;
 	_ditherTable = 0;
 	_ditherFrame = 0;
+	_outputFrame = 0;
 }
 
 // FIXME: This check breaks valid QuickTime movies, such as the KQ6 Mac opening.
@@ -357,6 +359,7 @@ QuickTimeDecoder::VideoTrackHandler::~VideoTrackHandler() {
 
 	delete[] _forcedDitherPalette;
 	delete[] _ditherTable;
+	SurfacePoolMan.release(_outputFrame);
 
 	if (_ditherFrame) {
 		_ditherFrame->free();
@@ -458,6 +461,9 @@ Graphics::PixelFormat QuickTimeDecoder::VideoTrackHandler::getPixelFormat() cons
 	if (_forcedDitherPalette)
 		return Graphics::PixelFormat::createFormatCLUT8();
 
+	if (_outputFormat.bytesPerPixel != 0)
+		return _outputFormat;
+
 	return ((VideoSampleDesc *)_parent->sampleDescs[0])->_videoCodec->getPixelFormat();
 }
 
@@ -818,7 +824,11 @@ const Graphics::Surface *QuickTimeDecoder::VideoTrackHandler::bufferNextFrame()
 		return 0;
 	}
 
-	const Graphics::Surface *frame = entry->_videoCodec->decodeFrame(*frameData);
+	const Graphics::Surface *frame;
+	if (_outputFrame && entry->_videoCodec->getPixelFormat() != _outputFormat)
+		frame = entry->_videoCodec->decodeFrameInto(*frameData, *_outputFrame) ? _outputFrame : 0;
+	else
+		frame = entry->_videoCodec->decodeFrame(*frameData);
 	delete frameData;
 
 	// Update the palette
@@ -918,6 +928,45 @@ void QuickTimeDecoder::VideoTrackHandler::setDither(const byte *palette) {
 	}
 }
 
+bool QuickTimeDecoder::VideoTrackHandler::canOutputPixelFormat(const Graphics::PixelFormat &format) const {
+	if (_forcedDitherPalette)
+		return false;
+
+	for (uint i = 0; i < _parent->sampleDescs.size(); i++) {
+		VideoSampleDesc *desc = (VideoSampleDesc *)_parent->sampleDescs[i];
+
+		if (!desc || !desc->_videoCodec)
+			return false;
+
+		// True color frames can always be converted, palettized ones cannot
+		Image::Codec *codec = desc->_videoCodec;
+		if (!codec->canOutputPixelFormat(format) && (codec->getPixelFormat().bytesPerPixel == 1 || format.bytesPerPixel == 1))
+			return false;
+	}
+
+	return true;
+}
+
+void QuickTimeDecoder::VideoTrackHandler::setOutputPixelFormat(const Graphics::PixelFormat &format) {
+	assert(canOutputPixelFormat(format));
+
+	bool convert = false;
+
+	for (uint i = 0; i < _parent->sampleDescs.size(); i++) {
+		Image::Codec *codec = ((VideoSampleDesc *)_parent->sampleDescs[i])->_videoCodec;
+
+		if (codec->canOutputPixelFormat(format))
+			codec->setOutputPixelFormat(format);
+		else
+			convert = true;
+	}
+
+	_outputFormat = format;
+
+	SurfacePoolMan.release(_outputFrame);
+	_outputFrame = convert ? SurfacePoolMan.acquire(_parent->width, _parent->height, format) : 0;
+}
+
 namespace {
 
 // Return a pixel in RGB554
@@ -146,6 +146,8 @@ private:
 		bool isReversed() const { return _reversed; }
 		bool canDither() const;
 		void setDither(const byte *palette);
+		bool canOutputPixelFormat(const Graphics::PixelFormat &format) const;
+		void setOutputPixelFormat(const Graphics::PixelFormat &format);
 
 		Common::Rational getScaledWidth() const;
 		Common::Rational getScaledHeight() const;
@@ -169,6 +171,12 @@ private:
 		Graphics::Surface *_ditherFrame;
 		const Graphics::Surface *forceDither(const Graphics::Surface &frame);
 
+		// Output format set by the caller, and the surface from the
+		// surface pool which frames are converted into for the codecs
+		// which cannot output that format themselves
+		Graphics::PixelFormat _outputFormat;
+		Graphics::Surface *_outputFrame;
+
 		Common::SeekableReadStream *getNextFramePacket(uint32 &descId);
 		uint32 getCurFrameDuration();            // media time
 		uint32 findKeyFrame(uint32 frame) const;
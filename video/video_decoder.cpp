@@ -24,14 +24,230 @@
 #include "audio/audiostream.h"
 #include "audio/mixer.h" // for kMaxChannelVolume
 
+#include "common/atomic.h"
 #include "common/rational.h"
 #include "common/file.h"
+#include "common/rect.h"
 #include "common/system.h"
+#include "common/threadpool.h"
 
 #include "graphics/palette.h"
+#include "graphics/surface.h"
 
 namespace Video {
 
+/**
+ * Decodes the frames of a video track in advance on a worker thread, into a
+ * ring of surfaces. The caller holds on to the slot handed out last, while
+ * the worker fills the others.
+ */
+class VideoDecoder::ReadAhead : public Common::ThreadPoolTask {
+public:
+	/** A decoded frame, along with the state of the track right after it */
+	struct Frame {
+		Graphics::Surface surface;
+		bool hasSurface;
+		bool dirtyPalette;
+		byte palette[256 * 3];
+		int curFrame;
+		uint32 nextFrameStartTime;
+		bool endOfTrack;
+	};
+
+	ReadAhead(VideoDecoder *decoder, VideoTrack *track, uint frameCount);
+	~ReadAhead() override;
+
+	bool isAvailable() const { return _pool.getThreadCount() != 0; }
+	VideoTrack *getTrack() const { return _track; }
+
+	/** Whether the track is ahead of the caller, who has to use getCurrent() instead */
+	bool isActive() const { return _active; }
+
+	/** Return the state of the track as of the last frame handed out */
+	const Frame &getCurrent() const { return *_current; }
+
+	/** Hand out the next frame, waiting for it if necessary. */
+	const Frame &nextFrame();
+
+	/** Make the worker stop, keeping the frames decoded so far. */
+	void pause();
+
+	/**
+	 * Drop all frames decoded in advance, e.g. because the track is about to
+	 * be seeked anyway.
+	 */
+	void discard();
+
+	/**
+	 * Drop all frames decoded in advance, and move the track back to the
+	 * frame handed out last, e.g. because the track changes direction.
+	 */
+	void reset();
+
+	void run() override;
+
+private:
+	void start();
+	void resume();
+
+	VideoDecoder *_decoder;
+	VideoTrack *_track;
+	/** The shared thread pool, which the worker runs on */
+	Common::ThreadPool &_pool;
+
+	Common::Array<Frame> _frames;
+	Frame _initial;
+	const Frame *_current;
+
+	bool _active;
+	bool _running;
+	bool _holding;
+
+	/** Number of frames decoded, only written by the worker */
+	Common::Atomic<uint> _produced;
+	/** Number of frames the caller is done with, only written by the caller */
+	Common::Atomic<uint> _released;
+	/** Asks the worker to return after the frame it is decoding */
+	Common::Atomic<bool> _stop;
+};
+
+VideoDecoder::ReadAhead::ReadAhead(VideoDecoder *decoder, VideoTrack *track, uint frameCount) :
+		_decoder(decoder), _track(track), _pool(g_system->getThreadPool()), _current(&_initial),
+		_active(false), _running(false), _holding(false), _produced(0), _released(0), _stop(false) {
+	// One more slot for the frame the caller holds
+	_frames.resize(frameCount + 1);
+	for (uint i = 0; i < _frames.size(); ++i) {
+		_frames[i].hasSurface = false;
+		_frames[i].dirtyPalette = false;
+	}
+}
+
+VideoDecoder::ReadAhead::~ReadAhead() {
+	pause();
+
+	for (uint i = 0; i < _frames.size(); ++i)
+		_frames[i].surface.free();
+}
+
+const VideoDecoder::ReadAhead::Frame &VideoDecoder::ReadAhead::nextFrame() {
+	if (!_active)
+		start();
+
+	if (_holding) {
+		_released.fetchAdd(1, Common::kMemoryOrderRelease);
+		_holding = false;
+	}
+
+	const uint released = _released.load(Common::kMemoryOrderRelaxed);
+	if (_produced.load(Common::kMemoryOrderAcquire) == released) {
+		// The worker fell behind: make it return as soon as the frame is
+		// there, and wait for it
+		resume();
+		pause();
+	}
+
+	_current = &_frames[released % _frames.size()];
+	_holding = true;
+
+	resume();
+	return *_current;
+}
+
+void VideoDecoder::ReadAhead::pause() {
+	if (!_running)
+		return;
+
+	_stop.store(true, Common::kMemoryOrderRelaxed);
+	_pool.wait(this);
+	_stop.store(false, Common::kMemoryOrderRelaxed);
+	_running = false;
+}
+
+void VideoDecoder::ReadAhead::reset() {
+	pause();
+
+	// The track went past the frame the caller has, e.g. a change of
+	// direction has to start from the frame which is displayed
+	if (_active && _track->getCurFrame() != _current->curFrame)
+		_decoder->seekIntern(_track->getFrameTime(_current->curFrame + 1));
+
+	discard();
+}
+
+void VideoDecoder::ReadAhead::discard() {
+	pause();
+
+	_active = false;
+	_holding = false;
+	_current = &_initial;
+	_produced.store(0, Common::kMemoryOrderRelaxed);
+	_released.store(0, Common::kMemoryOrderRelaxed);
+}
+
+void VideoDecoder::ReadAhead::start() {
+	_initial.hasSurface = false;
+	_initial.dirtyPalette = false;
+	_initial.curFrame = _track->getCurFrame();
+	_initial.nextFrameStartTime = _track->getNextFrameStartTime();
+	_initial.endOfTrack = _track->endOfTrack();
+
+	_current = &_initial;
+	_active = true;
+}
+
+void VideoDecoder::ReadAhead::resume() {
+	if (_running && isDone()) {
+		_pool.wait(this);
+		_running = false;
+	}
+
+	if (_running)
+		return;
+
+	// The worker is idle, so the frames are safe to look at
+	const uint produced = _produced.load(Common::kMemoryOrderRelaxed);
+	const Frame &last = produced ? _frames[(produced - 1) % _frames.size()] : _initial;
+	if (last.endOfTrack || produced - _released.load(Common::kMemoryOrderRelaxed) == _frames.size())
+		return;
+
+	_running = true;
+	_pool.submit(this);
+}
+
+void VideoDecoder::ReadAhead::run() {
+	uint produced = _produced.load(Common::kMemoryOrderRelaxed);
+
+	// The caller only starts the worker when a slot is free
+	do {
+		Frame &frame = _frames[produced % _frames.size()];
+
+		_decoder->readNextPacket();
+		const Graphics::Surface *surface = _track->decodeNextFrame();
+
+		frame.hasSurface = surface != nullptr;
+		if (surface) {
+			if (frame.surface.w != surface->w || frame.surface.h != surface->h || frame.surface.format != surface->format) {
+				frame.surface.free();
+				frame.surface.create(surface->w, surface->h, surface->format);
+			}
+			frame.surface.copyRectToSurface(*surface, 0, 0, Common::Rect(surface->w, surface->h));
+		}
+
+		frame.dirtyPalette = _track->hasDirtyPalette();
+		if (frame.dirtyPalette)
+			memcpy(frame.palette, _track->getPalette(), sizeof(frame.palette));
+
+		frame.curFrame = _track->getCurFrame();
+		frame.nextFrameStartTime = _track->getNextFrameStartTime();
+		frame.endOfTrack = _track->endOfTrack();
+
+		_produced.store(++produced, Common::kMemoryOrderRelease);
+
+		if (frame.endOfTrack)
+			break;
+	} while (!_stop.load(Common::kMemoryOrderRelaxed) && produced - _released.load(Common::kMemoryOrderAcquire) < _frames.size());
+}
+
 VideoDecoder::VideoDecoder() {
 	_startTime = 0;
 	_dirtyPalette = false;
@@ -48,6 +264,7 @@ VideoDecoder::VideoDecoder() {
 	_nextVideoTrack = 0;
 	_mainAudioTrack = 0;
 	_canSetDither = true;
+	_readAhead = nullptr;
 
 	// Find the best format for output
 	_defaultHighColorFormat = g_system->getScreenFormat();
@@ -56,10 +273,17 @@ VideoDecoder::VideoDecoder() {
 		_defaultHighColorFormat = Graphics::PixelFormat(4, 8, 8, 8, 8, 8, 16, 24, 0);
 }
 
+VideoDecoder::~VideoDecoder() {
+	delete _readAhead;
+}
+
 void VideoDecoder::close() {
 	if (isPlaying())
 		stop();
 
+	delete _readAhead;
+	_readAhead = nullptr;
+
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		delete *it;
 
@@ -132,6 +356,9 @@ void VideoDecoder::pauseVideo(bool pause) {
 	}
 
 	if (_pauseLevel == 1 && pause) {
+		if (_readAhead)
+			_readAhead->pause();
+
 		_pauseStartTime = g_system->getMillis(); // Store the starting time from pausing to keep it for later
 
 		for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
@@ -209,6 +436,26 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	_needsUpdate = false;
 	_canSetDither = false;
 
+	// Frames are only read ahead while playing forward
+	if (_readAhead && _nextVideoTrack && !_nextVideoTrack->isReversed()) {
+		const ReadAhead::Frame &frame = _readAhead->nextFrame();
+
+		// The worker reuses the frame's slot, so the palette is copied
+		if (frame.dirtyPalette) {
+			memcpy(_readAheadPalette, frame.palette, sizeof(_readAheadPalette));
+			_palette = _readAheadPalette;
+			_dirtyPalette = true;
+		}
+
+		findNextVideoTrack();
+		return frame.hasSurface ? &frame.surface : nullptr;
+	}
+
+	// Once the video track is done, or plays in reverse, packets are read
+	// here again
+	if (_readAhead)
+		_readAhead->reset();
+
 	readNextPacket();
 
 	// If we have no next video track at this point, there shouldn't be
@@ -237,6 +484,11 @@ bool VideoDecoder::setReverse(bool reverse) {
 	// Attempt to make sure all the tracks are in the requested direction
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo && ((VideoTrack *)*it)->isReversed() != reverse) {
+			// The frames decoded in advance go the wrong way now, and the
+			// track has to turn around at the displayed frame
+			if (_readAhead)
+				_readAhead->reset();
+
 			if (!((VideoTrack *)*it)->setReverse(reverse))
 				return false;
 
@@ -258,7 +510,7 @@ int VideoDecoder::getCurFrame() const {
 
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo)
-			frame += ((VideoTrack *)*it)->getCurFrame() + 1;
+			frame += getVideoTrackCurFrame((const VideoTrack *)*it) + 1;
 
 	return frame;
 }
@@ -299,7 +551,7 @@ uint32 VideoDecoder::getTimeToNextFrame() const {
 		return 0;
 
 	uint32 currentTime = getTime();
-	uint32 nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
+	uint32 nextFrameStartTime = getVideoTrackNextFrameStartTime(_nextVideoTrack);
 
 	if (_nextVideoTrack->isReversed()) {
 		// For reversed videos, we need to handle the time difference the opposite way.
@@ -320,8 +572,15 @@ bool VideoDecoder::endOfVideo() const {
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		const Track *track = *it;
 
-		bool videoEndTimeReached = _endTimeSet && track->getTrackType() == Track::kTrackTypeVideo && ((const VideoTrack *)track)->getNextFrameStartTime() >= (uint)_endTime.msecs();
-		bool endReached = track->endOfTrack() || (isPlaying() && videoEndTimeReached);
+		bool endReached;
+		if (track->getTrackType() == Track::kTrackTypeVideo) {
+			const VideoTrack *videoTrack = (const VideoTrack *)track;
+			bool videoEndTimeReached = _endTimeSet && getVideoTrackNextFrameStartTime(videoTrack) >= (uint)_endTime.msecs();
+			endReached = videoTrackEnded(videoTrack) || (isPlaying() && videoEndTimeReached);
+		} else {
+			endReached = track->endOfTrack();
+		}
+
 		if (!endReached)
 			return false;
 	}
@@ -348,6 +607,9 @@ bool VideoDecoder::rewind() {
 	if (isPlaying())
 		stopAudio();
 
+	if (_readAhead)
+		_readAhead->discard();
+
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if (!(*it)->rewind())
 			return false;
@@ -382,6 +644,9 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 	if (isPlaying())
 		stopAudio();
 
+	if (_readAhead)
+		_readAhead->discard();
+
 	// Do the actual seeking
 	if (!seekIntern(time))
 		return false;
@@ -447,6 +712,9 @@ void VideoDecoder::stop() {
 	// Stop audio here so we don't have it affect getTime()
 	stopAudio();
 
+	if (_readAhead)
+		_readAhead->pause();
+
 	// Keep the time marked down in case we start up again
 	// We do this before _playbackRate is set so we don't get
 	// _lastTimeChange returned, but before _pauseLevel is
@@ -547,6 +815,30 @@ bool VideoDecoder::setDitheringPalette(const byte *palette) {
 	return result;
 }
 
+bool VideoDecoder::setOutputPixelFormat(const Graphics::PixelFormat &format) {
+	// Just like dithering, this can only be set before decoding any frame
+	if (!_canSetDither || _readAhead)
+		return false;
+
+	bool result = false;
+
+	// Leave all tracks alone unless each of them can switch
+	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo) {
+			if (!((VideoTrack *)*it)->canOutputPixelFormat(format))
+				return false;
+
+			result = true;
+		}
+	}
+
+	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo)
+			((VideoTrack *)*it)->setOutputPixelFormat(format);
+
+	return result;
+}
+
 VideoDecoder::Track::Track() {
 	_paused = false;
 }
@@ -739,6 +1031,9 @@ bool VideoDecoder::StreamFileAudioTrack::loadFromFile(const Common::String &base
 }
 
 void VideoDecoder::addTrack(Track *track, bool isExternal) {
+	if (_readAhead)
+		_readAhead->pause();
+
 	_tracks.push_back(track);
 
 	if (isExternal)
@@ -805,6 +1100,9 @@ bool VideoDecoder::setAudioTrack(int index) {
 	if (_mainAudioTrack == audioTrack)
 		return true;
 
+	if (_readAhead)
+		_readAhead->pause();
+
 	_mainAudioTrack->setMute(true);
 	audioTrack->setMute(false);
 	_mainAudioTrack = audioTrack;
@@ -824,6 +1122,9 @@ uint VideoDecoder::getAudioTrackCount() const {
 void VideoDecoder::setEndTime(const Audio::Timestamp &endTime) {
 	Audio::Timestamp startTime = 0;
 
+	if (_readAhead)
+		_readAhead->pause();
+
 	if (isPlaying()) {
 		startTime = getTime();
 		stopAudio();
@@ -885,7 +1186,7 @@ const VideoDecoder::Track *VideoDecoder::getTrack(uint track) const {
 
 bool VideoDecoder::endOfVideoTracks() const {
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
-		if ((*it)->getTrackType() == Track::kTrackTypeVideo && !(*it)->endOfTrack())
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo && !videoTrackEnded((const VideoTrack *)*it))
 			return false;
 
 	return true;
@@ -896,9 +1197,9 @@ VideoDecoder::VideoTrack *VideoDecoder::findNextVideoTrack() {
 	uint32 bestTime = 0xFFFFFFFF;
 
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
-		if ((*it)->getTrackType() == Track::kTrackTypeVideo && !(*it)->endOfTrack()) {
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo && !videoTrackEnded((const VideoTrack *)*it)) {
 			VideoTrack *track = (VideoTrack *)*it;
-			uint32 time = track->getNextFrameStartTime();
+			uint32 time = getVideoTrackNextFrameStartTime(track);
 
 			if (time < bestTime) {
 				bestTime = time;
@@ -945,8 +1246,8 @@ bool VideoDecoder::hasFramesLeft() const {
 
 		const VideoTrack *track = (const VideoTrack *)*it;
 
-		bool videoEndTimeReached = _endTimeSet && track->getNextFrameStartTime() >= (uint)_endTime.msecs();
-		bool endReached = track->endOfTrack() || (isPlaying() && videoEndTimeReached);
+		bool videoEndTimeReached = _endTimeSet && getVideoTrackNextFrameStartTime(track) >= (uint)_endTime.msecs();
+		bool endReached = videoTrackEnded(track) || (isPlaying() && videoEndTimeReached);
 		if (!endReached)
 			return true;
 	}
@@ -963,6 +1264,15 @@ bool VideoDecoder::hasAudio() const {
 }
 
 void VideoDecoder::eraseTrack(Track *track) {
+	if (_readAhead) {
+		_readAhead->pause();
+
+		if (_readAhead->getTrack() == track) {
+			delete _readAhead;
+			_readAhead = nullptr;
+		}
+	}
+
 	for (uint idx = 0; idx < _externalTracks.size(); ++idx) {
 		if (_externalTracks[idx] == track)
 			_externalTracks.remove_at(idx);
@@ -979,4 +1289,63 @@ void VideoDecoder::eraseTrack(Track *track) {
 	}
 }
 
+bool VideoDecoder::setReadAhead(uint frameCount) {
+	// Switching now would lose the frames decoded in advance
+	if (_readAhead && _readAhead->isActive())
+		return false;
+
+	delete _readAhead;
+	_readAhead = nullptr;
+
+	if (frameCount == 0)
+		return false;
+
+	VideoTrack *track = 0;
+
+	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo) {
+			// We only allow read ahead when one video track is present
+			if (track)
+				return false;
+
+			track = (VideoTrack *)*it;
+		}
+	}
+
+	// The track has to be moved back to the displayed frame when the frames
+	// decoded in advance get dropped
+	if (!track || !isSeekable() || track->getFrameTime(0) < 0)
+		return false;
+
+	_readAhead = new ReadAhead(this, track, frameCount);
+	if (!_readAhead->isAvailable()) {
+		delete _readAhead;
+		_readAhead = nullptr;
+		return false;
+	}
+
+	return true;
+}
+
+bool VideoDecoder::videoTrackEnded(const VideoTrack *track) const {
+	if (_readAhead && _readAhead->isActive() && _readAhead->getTrack() == track)
+		return _readAhead->getCurrent().endOfTrack;
+
+	return track->endOfTrack();
+}
+
+uint32 VideoDecoder::getVideoTrackNextFrameStartTime(const VideoTrack *track) const {
+	if (_readAhead && _readAhead->isActive() && _readAhead->getTrack() == track)
+		return _readAhead->getCurrent().nextFrameStartTime;
+
+	return track->getNextFrameStartTime();
+}
+
+int VideoDecoder::getVideoTrackCurFrame(const VideoTrack *track) const {
+	if (_readAhead && _readAhead->isActive() && _readAhead->getTrack() == track)
+		return _readAhead->getCurrent().curFrame;
+
+	return track->getCurFrame();
+}
+
 } // End of namespace Video
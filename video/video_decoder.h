@@ -52,7 +52,7 @@ namespace Video {
 class VideoDecoder {
 public:
 	VideoDecoder();
-	virtual ~VideoDecoder() {}
+	virtual ~VideoDecoder();
 
 	/////////////////////////////////////////
 	// Opening/Closing a Video
@@ -396,6 +396,48 @@ public:
 	 */
 	bool setDitheringPalette(const byte *palette);
 
+	/**
+	 * Ask the video tracks to output their frames in the given format,
+	 * e.g. the screen format, so that the caller does not need to convert
+	 * every frame.
+	 *
+	 * Codecs which output true color frames write them in the format
+	 * where they can. Otherwise AVI and QuickTime tracks convert each
+	 * frame as it is decoded. Videos with 8bpp frames cannot switch.
+	 * If any video track cannot switch, none of them does.
+	 *
+	 * This should be called after loadStream(), but before a decodeNextFrame()
+	 * call and before read ahead is switched on. This is enforced.
+	 *
+	 * @param format The format to output the frames in
+	 * @return true if all video tracks now output the given format
+	 */
+	bool setOutputPixelFormat(const Graphics::PixelFormat &format);
+
+	/**
+	 * Decode frames in advance on a worker thread.
+	 *
+	 * decodeNextFrame() then hands out frames which are already decoded,
+	 * so that an expensive frame does not stall the caller. Seeking,
+	 * rewinding and changing the direction drop the frames decoded in
+	 * advance, and move the track back to the frame displayed last. Frames
+	 * are only decoded in advance while the video plays forward.
+	 *
+	 * This only works for seekable videos with exactly one video track,
+	 * which has to support getFrameTime(), and only if the backend supports
+	 * threads. It must be called after loadStream().
+	 *
+	 * While read ahead is active, readNextPacket() and the video track's
+	 * decodeNextFrame() run on the worker thread. A subclass must therefore
+	 * not share state between those and code running on the caller's
+	 * thread, other than the audio streams, which are thread safe.
+	 *
+	 * @param frameCount Number of frames to decode in advance, or 0 to
+	 *                   switch read ahead off
+	 * @return true if read ahead is active, false otherwise
+	 */
+	bool setReadAhead(uint frameCount);
+
 	/////////////////////////////////////////
 	// Audio Control
 	/////////////////////////////////////////
@@ -645,6 +687,17 @@ protected:
 		 * Activate dithering mode with a palette
 		 */
 		virtual void setDither(const byte *palette) {}
+
+		/**
+		 * Can the frames be output in the given format?
+		 */
+		virtual bool canOutputPixelFormat(const Graphics::PixelFormat &format) const { return false; }
+
+		/**
+		 * Output frames in the given format. Only called if
+		 * canOutputPixelFormat() returned true for it.
+		 */
+		virtual void setOutputPixelFormat(const Graphics::PixelFormat &format) {}
 	};
 
 	/**
@@ -959,6 +1012,17 @@ private:
 	// Default PixelFormat settings
 	Graphics::PixelFormat _defaultHighColorFormat;
 
+	// Frames decoded in advance, see setReadAhead()
+	class ReadAhead;
+	ReadAhead *_readAhead;
+	byte _readAheadPalette[256 * 3];
+
+	// State of a video track as seen by the caller, which lags behind the
+	// track itself when frames are decoded in advance
+	bool videoTrackEnded(const VideoTrack *track) const;
+	uint32 getVideoTrackNextFrameStartTime(const VideoTrack *track) const;
+	int getVideoTrackCurFrame(const VideoTrack *track) const;
+
 protected:
 	// Internal helper functions
 	void stopAudio();